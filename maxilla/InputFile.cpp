@@ -0,0 +1,673 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "threads.h"
+#include "gzindex.h"
+#include "zstdfile.h"
+#include "zipfile.h"
+
+#define INFLATE_RING_BUFFERS (3)
+#define INFLATE_BUFFERSIZE (4*1024*1024)
+
+/*===========================================================================
+ * Name:	InflateRing
+ * Purpose:	Buffers filled by the inflate thread and drained by
+ *		InputFile::read_block(), so that decompression overlaps
+ *		with tokenizing and parsing.
+ */
+class InflateRing {
+public:
+	gzFile gzfile;
+	ZstdReader *zstd;		// Used instead of gzfile if set.
+	GzIndexBuilder *builder;	// Likewise.
+	unsigned char *buffers [INFLATE_RING_BUFFERS];
+	int sizes [INFLATE_RING_BUFFERS];	// 0 at end of file, -1 on error.
+	Semaphore full;			// Counts buffers ready to read.
+	Semaphore empty;		// Counts buffers free to fill.
+	volatile bool stop;
+	void *thread;
+
+	// Used only by the reading thread.
+	int read_slot;
+	int read_ix;			// -1 when waiting for a buffer.
+	int final_result;		// Set once the end is reached.
+	bool done;
+
+	InflateRing () : full (0), empty (INFLATE_RING_BUFFERS) {
+		gzfile = NULL;
+		zstd = NULL;
+		builder = NULL;
+		stop = done = false;
+		thread = NULL;
+		read_slot = 0;
+		read_ix = -1;
+		final_result = 0;
+		for (int i = 0; i < INFLATE_RING_BUFFERS; i++) {
+			buffers[i] = NULL;
+			sizes[i] = 0;
+		}
+	}
+};
+
+//---------------------------------------------------------------------------
+// Name:	inflate_thread
+// Purpose:	Fills the ring buffers in turn until the end of the file,
+//		an error, or a request to stop.
+//---------------------------------------------------------------------------
+static void *
+inflate_thread (void *arg)
+{
+	InflateRing *ring = (InflateRing*) arg;
+	int slot = 0;
+
+	while (true) {
+		ring->empty.wait ();
+		if (ring->stop)
+			break;
+
+		int n;
+		if (ring->zstd)
+			n = ring->zstd->read (ring->buffers[slot], INFLATE_BUFFERSIZE);
+		else if (ring->builder)
+			n = ring->builder->read (ring->buffers[slot], INFLATE_BUFFERSIZE);
+		else
+			n = gzread (ring->gzfile, ring->buffers[slot], INFLATE_BUFFERSIZE);
+		ring->sizes[slot] = n;
+		ring->full.post ();
+		if (n <= 0)
+			break;
+
+		slot = (slot + 1) % INFLATE_RING_BUFFERS;
+	}
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::capture_first_line
+// Purpose:	Stores the first line of the file, on the first-ever read.
+//---------------------------------------------------------------------------
+void
+InputFile::capture_first_line (const unsigned char *data, int size)
+{
+	if (first_line || !data)
+		return;
+
+	if (size > INPUTFILE_BUFFERSIZE)
+		size = INPUTFILE_BUFFERSIZE;
+
+	int i = 0;
+	while (i < size && data[i] != '\n')
+		i++;
+
+	unsigned long chunk_size = i + 1;
+	first_line = (char*) malloc (chunk_size);
+	if (!first_line)
+		return;
+	memcpy (first_line, data, i);
+	first_line[i] = 0;
+
+	total_allocated += chunk_size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	gzip_data_size
+// Purpose:	Reads the uncompressed size from the end of a gzip file.
+//		It is stored modulo 4 GB, so a larger file is reported
+//		as unknown.
+// Returns:	The size, or 0 if it is not known.
+//---------------------------------------------------------------------------
+unsigned long
+gzip_data_size (const char *path)
+{
+	FILE *f = fopen (path, "rb");
+	if (!f)
+		return 0;
+
+	unsigned char magic[2] = { 0, 0 };
+	unsigned char trailer[4];
+	unsigned long size = 0;
+	if (2 == fread (magic, 1, 2, f) &&
+	    magic[0] == 0x1f && magic[1] == 0x8b &&
+	    !fseek (f, -4, SEEK_END) &&
+	    4 == fread (trailer, 1, 4, f)) {
+		long compressed = ftell (f);
+		size = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) |
+			((unsigned long) trailer[3] << 24);
+		if (compressed <= 0 || size < (unsigned long) compressed)
+			size = 0;
+	}
+	fclose (f);
+	return size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	map_whole_file
+// Purpose:	Maps a whole file into memory for reading, for the
+//		mesh parsers.
+// Returns:	The mapping, or NULL.
+//---------------------------------------------------------------------------
+const unsigned char *
+map_whole_file (const char *path, unsigned long *size_return)
+{
+#ifdef WIN32
+	HANDLE fh = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fh == INVALID_HANDLE_VALUE)
+		return NULL;
+	DWORD size = GetFileSize (fh, NULL);
+	void *view = NULL;
+	if (size != INVALID_FILE_SIZE && size > 0) {
+		HANDLE mh = CreateFileMapping (fh, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mh) {
+			// The view keeps the mapping open.
+			view = MapViewOfFile (mh, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle (mh);
+		}
+	}
+	CloseHandle (fh);
+	*size_return = size;
+	return (const unsigned char*) view;
+#else
+	int fd = ::open (path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	struct stat st;
+	void *view = MAP_FAILED;
+	if (!fstat (fd, &st) && st.st_size > 0)
+		view = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close (fd);
+	if (view == MAP_FAILED)
+		return NULL;
+#ifdef MADV_SEQUENTIAL
+	madvise (view, st.st_size, MADV_SEQUENTIAL);
+#endif
+	*size_return = st.st_size;
+	return (const unsigned char*) view;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	unmap_whole_file
+// Purpose:	Releases a mapping made by map_whole_file.
+//---------------------------------------------------------------------------
+void
+unmap_whole_file (const unsigned char *data, unsigned long size)
+{
+#ifdef WIN32
+	UnmapViewOfFile ((void*) data);
+#else
+	munmap ((void*) data, size);
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::open_mapped
+// Purpose:	Opens the file for block-level reading. An uncompressed
+//		file is memory-mapped in its entirety; a gzipped one
+//		is opened with zlib and a zstd one with libzstd, and
+//		both are read via read_block().
+// Returns:	False if the file could not be opened.
+//---------------------------------------------------------------------------
+bool
+InputFile::open_mapped ()
+{
+	if (!path)
+		return false;
+	if (archive)
+		return open_archived ();
+
+	unsigned char magic[4] = { 0, 0, 0, 0 };
+
+#ifdef WIN32
+	HANDLE fh = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fh != INVALID_HANDLE_VALUE) {
+		DWORD nread = 0;
+		DWORD size = GetFileSize (fh, NULL);
+		ReadFile (fh, magic, 4, &nread, NULL);
+
+		if (size != INVALID_FILE_SIZE && size > 0 &&
+		    !(magic[0] == 0x1f && magic[1] == 0x8b) &&
+		    !zstd_magic (magic, nread)) {
+			HANDLE mh = CreateFileMapping (fh, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (mh) {
+				void *view = MapViewOfFile (mh, FILE_MAP_READ, 0, 0, 0);
+				if (view) {
+					map_file_handle = (void*) fh;
+					map_handle = (void*) mh;
+					mapped = (unsigned char*) view;
+					mapped_size = size;
+					data_size = size;
+					capture_first_line (mapped, (int) (size < INPUTFILE_BUFFERSIZE ? size : INPUTFILE_BUFFERSIZE));
+					return true;
+				}
+				CloseHandle (mh);
+			}
+		}
+		CloseHandle (fh);
+	}
+#else
+	int fd = ::open (path, O_RDONLY);
+	if (fd >= 0) {
+		struct stat st;
+		ssize_t nread;
+		if (!fstat (fd, &st) && st.st_size > 0 &&
+		    (nread = read (fd, magic, 4)) >= 2 &&
+		    !(magic[0] == 0x1f && magic[1] == 0x8b) &&
+		    !zstd_magic (magic, (unsigned long) nread)) {
+			void *view = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (view != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+				madvise (view, st.st_size, MADV_SEQUENTIAL);
+#endif
+				::close (fd);
+				mapped = (unsigned char*) view;
+				mapped_size = st.st_size;
+				data_size = mapped_size;
+				capture_first_line (mapped, (int) (mapped_size < INPUTFILE_BUFFERSIZE ? mapped_size : INPUTFILE_BUFFERSIZE));
+				return true;
+			}
+		}
+		::close (fd);
+	}
+#endif
+
+	if (open_zstd ()) {
+		if (!zstd)
+			return false;
+		data_size = zstd->data_size;
+		start_inflating ();
+		return true;
+	}
+
+	//----------------------------------------
+	// Compressed, empty or unmappable:
+	// fall back to zlib, which reads both.
+	//
+	gzfile = gzopen (path, "rb");
+	if (!gzfile)
+		return false;
+
+	data_size = gzip_data_size (path);
+	start_building ();
+	start_inflating ();
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::set_archive
+// Purpose:	Makes the file a member of a ZIP archive, or if zip_path
+//		is NULL, an ordinary file again.
+//---------------------------------------------------------------------------
+void
+InputFile::set_archive (const char *zip_path, const char *member_name)
+{
+	if (archive) {
+		total_allocated -= strlen (archive) + strlen (member) + 2;
+		free (archive);
+		free (member);
+		archive = member = NULL;
+	}
+	if (!zip_path || !member_name)
+		return;
+
+	archive = (char*) malloc (strlen (zip_path) + 1);
+	member = (char*) malloc (strlen (member_name) + 1);
+	if (!archive || !member)
+		fatal ("Out of memory!");
+	strcpy (archive, zip_path);
+	strcpy (member, member_name);
+	total_allocated += strlen (archive) + strlen (member) + 2;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::open_archived
+// Purpose:	Inflates the file from its ZIP archive into memory, and
+//		if it is gzipped, inflates it again, so that it can be
+//		scanned in place as if mapped.
+// Returns:	False if the file could not be read.
+//---------------------------------------------------------------------------
+bool
+InputFile::open_archived ()
+{
+	unsigned long size = 0;
+	unsigned char *data = zip_read_member (archive, member, &size);
+	if (!data)
+		return false;
+
+	if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b) {
+		unsigned long plain_size = 0;
+		unsigned char *plain = gunzip_memory (data, size, &plain_size);
+		free (data);
+		total_allocated -= size;
+		if (!plain) {
+			warning ("Gzipped file in ZIP archive is damaged.");
+			return false;
+		}
+		data = plain;
+		size = plain_size;
+	}
+	else if (zstd_magic (data, size)) {
+		free (data);
+		total_allocated -= size;
+		warning ("A zstd-compressed file cannot be read from a ZIP archive.");
+		return false;
+	}
+
+	mapped = data;
+	mapped_size = size;
+	data_size = size;
+	capture_first_line (mapped, (int) (size < INPUTFILE_BUFFERSIZE ? size : INPUTFILE_BUFFERSIZE));
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::open_zstd
+// Purpose:	Opens the file with libzstd if it begins with a zstd
+//		frame, setting zstd.
+// Returns:	True if the file is zstd-compressed, whether or not it
+//		could be opened.
+//---------------------------------------------------------------------------
+bool
+InputFile::open_zstd ()
+{
+	if (!path || !zstd_path_magic (path))
+		return false;
+
+	zstd = new ZstdReader;
+	if (!zstd->open (path))
+		close_zstd ();
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::close_zstd
+// Purpose:	Closes the file if it was opened with libzstd.
+//---------------------------------------------------------------------------
+void
+InputFile::close_zstd ()
+{
+	delete zstd;
+	zstd = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::unmap
+// Purpose:	Releases the memory mapping, if any, or the data read
+//		from an archive.
+//---------------------------------------------------------------------------
+void
+InputFile::unmap ()
+{
+	if (!mapped)
+		return;
+
+	if (archive) {
+		free (mapped);
+		total_allocated -= mapped_size;
+	} else {
+#ifdef WIN32
+		UnmapViewOfFile (mapped);
+		CloseHandle ((HANDLE) map_handle);
+		CloseHandle ((HANDLE) map_file_handle);
+		map_handle = map_file_handle = NULL;
+#else
+		munmap (mapped, mapped_size);
+#endif
+	}
+	mapped = NULL;
+	mapped_size = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::start_inflating
+// Purpose:	Starts the thread that reads ahead from gzfile or zstd.
+//		On a single processor, or if the thread cannot be
+//		started, read_block() simply reads the file itself. A
+//		file with an index is read at random, so nothing is
+//		read ahead.
+//---------------------------------------------------------------------------
+void
+InputFile::start_inflating ()
+{
+	if (ring || (!gzfile && !zstd) || index || processor_count () < 2)
+		return;
+
+	InflateRing *r = new InflateRing;
+	r->gzfile = gzfile;
+	r->zstd = zstd;
+	r->builder = builder;
+	for (int i = 0; i < INFLATE_RING_BUFFERS; i++) {
+		r->buffers[i] = (unsigned char*) malloc (INFLATE_BUFFERSIZE);
+		if (!r->buffers[i])
+			fatal ("Out of memory!");
+	}
+
+	r->thread = thread_start (inflate_thread, r);
+	if (!r->thread) {
+		for (int i = 0; i < INFLATE_RING_BUFFERS; i++)
+			free (r->buffers[i]);
+		delete r;
+		return;
+	}
+
+	total_allocated += INFLATE_RING_BUFFERS * INFLATE_BUFFERSIZE;
+	ring = r;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::stop_inflating
+// Purpose:	Stops the read-ahead thread and frees the ring. The
+//		thread owns gzfile, zstd or builder until this returns.
+//---------------------------------------------------------------------------
+void
+InputFile::stop_inflating ()
+{
+	if (!ring)
+		return;
+
+	//----------------------------------------
+	// Wake the thread if it is waiting for a
+	// free buffer; it checks stop after each.
+	//
+	ring->stop = true;
+	ring->empty.post ();
+	thread_join (ring->thread);
+
+	for (int i = 0; i < INFLATE_RING_BUFFERS; i++)
+		free (ring->buffers[i]);
+	total_allocated -= INFLATE_RING_BUFFERS * INFLATE_BUFFERSIZE;
+
+	delete ring;
+	ring = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::read_block
+// Purpose:	Reads up to size bytes of (decompressed) data, from the
+//		inflate thread's buffers if it is running.
+// Returns:	Number of bytes read, 0 at end of file, -1 on error.
+//---------------------------------------------------------------------------
+int
+InputFile::read_block (unsigned char *dest, int size)
+{
+	if (index_reader)
+		return dest && size > 0 ? index_reader->read (dest, size) : -1;
+
+	if ((!gzfile && !zstd) || !dest || size <= 0)
+		return -1;
+
+	if (!ring) {
+		int n;
+		if (zstd)
+			n = zstd->read (dest, size);
+		else if (builder)
+			n = builder->read (dest, size);
+		else
+			n = gzread (gzfile, dest, size);
+		if (n > 0)
+			capture_first_line (dest, n);
+		return n;
+	}
+
+	int total = 0;
+	while (total < size && !ring->done) {
+		if (ring->read_ix < 0) {
+			ring->full.wait ();
+			if (ring->sizes[ring->read_slot] <= 0) {
+				ring->final_result = ring->sizes[ring->read_slot];
+				ring->done = true;
+				break;
+			}
+			ring->read_ix = 0;
+		}
+
+		int slot = ring->read_slot;
+		int available = ring->sizes[slot] - ring->read_ix;
+		int n = size - total < available ? size - total : available;
+		memcpy (dest + total, ring->buffers[slot] + ring->read_ix, n);
+		ring->read_ix += n;
+		total += n;
+
+		//----------------------------------------
+		// Hand an emptied buffer back.
+		//
+		if (ring->read_ix == ring->sizes[slot]) {
+			ring->read_ix = -1;
+			ring->read_slot = (slot + 1) % INFLATE_RING_BUFFERS;
+			ring->empty.post ();
+		}
+	}
+
+	if (!total)
+		return ring->final_result;
+
+	capture_first_line (dest, total);
+	return total;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::start_building
+// Purpose:	Arranges for a gzipped file that has no current index
+//		to be inflated via a GzIndexBuilder, so that reading
+//		it through once leaves it indexed.
+//---------------------------------------------------------------------------
+void
+InputFile::start_building ()
+{
+	if (builder || index || !gzfile || gzindex_current (path))
+		return;
+
+	builder = new GzIndexBuilder;
+	if (!builder->open (path))
+		stop_building ();
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::stop_building
+// Purpose:	Abandons the index being built, if any.
+//---------------------------------------------------------------------------
+void
+InputFile::stop_building ()
+{
+	delete builder;
+	builder = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::seek
+// Purpose:	Makes the next read_block() start at an offset in the
+//		(decompressed) data. A gzipped file with an index is
+//		inflated from the nearest checkpoint. One without is
+//		not indexed here, which would mean inflating all of it,
+//		and like a zstd file, which has no checkpoints, it is
+//		simply read forward.
+// Returns:	False if the offset cannot be reached.
+//---------------------------------------------------------------------------
+bool
+InputFile::seek (unsigned long offset)
+{
+	if (mapped)
+		return offset <= mapped_size;
+	if (!gzfile && !zstd)
+		return false;
+
+	stop_inflating ();
+	stop_building ();
+	end_seek ();
+
+	if (zstd)
+		return zstd->seek (offset);
+
+	if (!index)
+		index = gzindex_open (path);
+	if (index)
+		index_reader = index->open_at (path, offset);
+	if (index_reader)
+		return true;
+
+	return gzseek (gzfile, offset, SEEK_SET) == (z_off_t) offset;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::end_seek
+// Purpose:	Stops reading from the place last sought.
+//---------------------------------------------------------------------------
+void
+InputFile::end_seek ()
+{
+	delete index_reader;
+	index_reader = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	InputFile::drop_index
+// Purpose:	Frees the file's index, if it was loaded.
+//---------------------------------------------------------------------------
+void
+InputFile::drop_index ()
+{
+	end_seek ();
+	delete index;
+	index = NULL;
+}
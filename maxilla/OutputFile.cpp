@@ -0,0 +1,293 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "gzindex.h"
+#include "zstdfile.h"
+
+#define OUTPUTFILE_BUFFERSIZE (256*1024)
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::OutputFile
+//---------------------------------------------------------------------------
+OutputFile::OutputFile ()
+{
+	f = NULL;
+	memset (&stream, 0, sizeof(stream));
+	zstd = NULL;
+	buffer = NULL;
+	buffer_length = 0;
+	output = NULL;
+	failed = false;
+	path = NULL;
+	index = NULL;
+	last = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::~OutputFile
+// Purpose:	Abandons the file if it was not closed.
+//---------------------------------------------------------------------------
+OutputFile::~OutputFile ()
+{
+	if (f) {
+		deflateEnd (&stream);
+		fclose (f);
+	}
+	delete zstd;
+	delete index;
+	if (path) {
+		total_allocated -= strlen (path) + 1;
+		free (path);
+	}
+	if (buffer) {
+		free (buffer);
+		free (output);
+		total_allocated -= 2 * OUTPUTFILE_BUFFERSIZE;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::open
+// Purpose:	Creates the file, to be gzipped, or if use_zstd is set,
+//		written as a zstd frame. A gzipped file gets a
+//		checkpoint for its index at the start of the data.
+// Returns:	False if it cannot be created.
+//---------------------------------------------------------------------------
+bool
+OutputFile::open (const char *path_, bool use_zstd)
+{
+	ASSERT_NONZERO (path_,"path")
+	//----------
+
+	if (f || zstd)
+		return false;
+
+	if (use_zstd) {
+		zstd = new ZstdWriter;
+		if (!zstd->open (path_, ZSTDFILE_LEVEL)) {
+			delete zstd;
+			zstd = NULL;
+			return false;
+		}
+	} else {
+		f = fopen (path_, "wb");
+		if (!f)
+			return false;
+		if (Z_OK != deflateInit2 (&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+				31, 8, Z_DEFAULT_STRATEGY))	// gzip
+			fatal ("Out of memory!");
+	}
+
+	buffer = (unsigned char*) malloc (OUTPUTFILE_BUFFERSIZE);
+	output = (unsigned char*) malloc (OUTPUTFILE_BUFFERSIZE);
+	if (!buffer || !output)
+		fatal ("Out of memory!");
+	total_allocated += 2 * OUTPUTFILE_BUFFERSIZE;
+
+	if (!use_zstd) {
+#ifdef WIN32
+		path = _strdup (path_);
+#else
+		path = strdup (path_);
+#endif
+		if (!path)
+			fatal ("Out of memory!");
+		total_allocated += strlen (path) + 1;
+
+		//----------------------------------------
+		// Deflate's gzip header, with no name or
+		// time, is 10 bytes. Nothing precedes
+		// the first checkpoint, so its window is
+		// empty.
+		//
+		index = new GzIndex ();
+		index->compressed = true;
+		memset (buffer, 0, GZINDEX_WINDOWSIZE);
+		if (!index->add_point (0, 10, 0, buffer, GZINDEX_WINDOWSIZE))
+			fatal ("Out of memory!");
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::deflate_buffer
+// Purpose:	Deflates the buffered data and writes out the result.
+//---------------------------------------------------------------------------
+void
+OutputFile::deflate_buffer (int flush)
+{
+	stream.next_in = buffer;
+	stream.avail_in = (uInt) buffer_length;
+	int result;
+	do {
+		stream.next_out = output;
+		stream.avail_out = OUTPUTFILE_BUFFERSIZE;
+		result = deflate (&stream, flush);
+		unsigned long n = OUTPUTFILE_BUFFERSIZE - stream.avail_out;
+		if (result == Z_STREAM_ERROR || n != fwrite (output, 1, n, f)) {
+			failed = true;
+			break;
+		}
+	} while (!stream.avail_out || (flush == Z_FINISH && result != Z_STREAM_END));
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::compress
+// Purpose:	Compresses the buffered data and writes out the result,
+//		and if finish is set, ends the stream. A gzipped file
+//		is flushed to a byte boundary, where inflating can
+//		start afresh, after every GZINDEX_SPAN bytes; its index
+//		records those places and the data before them.
+//---------------------------------------------------------------------------
+void
+OutputFile::compress (bool finish)
+{
+	if (failed)
+		return;
+
+	if (zstd) {
+		zstd->write (buffer, buffer_length);
+		buffer_length = 0;
+		return;
+	}
+
+	index->add_data (buffer, buffer_length);
+	deflate_buffer (finish ? Z_FINISH : Z_NO_FLUSH);
+
+	if (!finish && !failed && index->data_size - last >= GZINDEX_SPAN &&
+	    buffer_length >= GZINDEX_WINDOWSIZE) {
+		unsigned long length = buffer_length;
+		buffer_length = 0;
+		deflate_buffer (Z_FULL_FLUSH);
+		if (!index->add_point (index->data_size, stream.total_out, 0,
+				buffer + length - GZINDEX_WINDOWSIZE, GZINDEX_WINDOWSIZE))
+			fatal ("Out of memory!");
+		last = index->data_size;
+	}
+	buffer_length = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::write
+// Purpose:	Adds data to the file.
+//---------------------------------------------------------------------------
+void
+OutputFile::write (const unsigned char *data, unsigned long size)
+{
+	if (!f && !zstd)
+		return;
+
+	while (size) {
+		unsigned long n = OUTPUTFILE_BUFFERSIZE - buffer_length;
+		if (n > size)
+			n = size;
+		memcpy (buffer + buffer_length, data, n);
+		buffer_length += n;
+		data += n;
+		size -= n;
+		if (buffer_length == OUTPUTFILE_BUFFERSIZE)
+			compress (false);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::printf
+// Purpose:	Adds formatted text to the file, as gzprintf() would.
+//---------------------------------------------------------------------------
+void
+OutputFile::printf (const char *format, ...)
+{
+	va_list args;
+	char text [1024];
+
+	if (!f && !zstd)
+		return;
+
+	va_start (args, format);
+	int n = vsnprintf (text, sizeof(text), format, args);
+	va_end (args);
+	if (n < 0)
+		return;
+	if (n < (int) sizeof(text)) {
+		write ((const unsigned char*) text, n);
+		return;
+	}
+
+	//----------------------------------------
+	// Only a long string, such as the
+	// text of a Text node, needs more room.
+	//
+	char *long_text = (char*) malloc (n + 1);
+	if (!long_text)
+		fatal ("Out of memory!");
+	va_start (args, format);
+	vsnprintf (long_text, n + 1, format, args);
+	va_end (args);
+	write ((const unsigned char*) long_text, n);
+	free (long_text);
+}
+
+//---------------------------------------------------------------------------
+// Name:	OutputFile::close
+// Purpose:	Ends the compressed stream and closes the file, then
+//		saves the index of a gzipped one.
+// Returns:	False if anything could not be written.
+//---------------------------------------------------------------------------
+bool
+OutputFile::close ()
+{
+	if (!f && !zstd)
+		return false;
+
+	compress (true);
+
+	if (zstd) {
+		if (!zstd->close ())
+			failed = true;
+		delete zstd;
+		zstd = NULL;
+	} else {
+		deflateEnd (&stream);
+		if (fclose (f))
+			failed = true;
+		f = NULL;
+		if (!failed && index->finish () && !index->save (path))
+			::printf ("Unable to save the index of %s.\n", path);
+	}
+	return !failed;
+}
@@ -1,25 +1,32 @@
-
-
-#include "Point.h"
-
-#ifndef _RENDER_CONTEXT_H
-#define _RENDER_CONTEXT_H
-
-
-class CRenderContext
-{
-
-public:
-	virtual void PushMatrix()=0;
-	virtual void PopMatrix()=0;
-
-	virtual void Translatef(float x, float y, float z)=0;
-	virtual void Rotatef(float angle, float x, float y, float z)=0;
-	virtual void Scalef(float x, float y, float z)=0;
-
-	virtual void Triangle( Point* normal, Point* p1, Point* p2, Point* p3) =0;
-	virtual void TriangleSmooth( Point* p1, Point* p2, Point* p3) =0;
-
-};
-
+
+
+#include "Point.h"
+
+#ifndef _RENDER_CONTEXT_H
+#define _RENDER_CONTEXT_H
+
+
+class CRenderContext
+{
+
+public:
+	virtual void PushMatrix()=0;
+	virtual void PopMatrix()=0;
+
+	virtual void Translatef(float x, float y, float z)=0;
+	virtual void Rotatef(float angle, float x, float y, float z)=0;
+	virtual void Scalef(float x, float y, float z)=0;
+
+	virtual void Triangle( Point* normal, Point* p1, Point* p2, Point* p3) =0;
+	virtual void TriangleSmooth( Point* p1, Point* p2, Point* p3) =0;
+
+	// The same, given x, y, z arrays such as those of a FlatMesh.
+	virtual void MeshTriangle( const float* normal, const float* p1, const float* p2, const float* p3) =0;
+	virtual void MeshTriangleSmooth( const float* p1, const float* n1, const float* p2, const float* n2, const float* p3, const float* n3) =0;
+
+	// The level of detail of the meshes to give: 0 for the full ones.
+	virtual int LevelOfDetail() { return 0; }
+
+};
+
 #endif
\ No newline at end of file
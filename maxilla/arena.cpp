@@ -0,0 +1,177 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "arena.h"
+
+//---------------------------------------------------------------------------
+// Name:	Arena::Arena
+// Purpose:	Creates an empty arena. No memory is taken until the
+//		first allocation.
+//---------------------------------------------------------------------------
+Arena::Arena (unsigned long chunk_size_)
+{
+	chunk = NULL;
+	chunk_used = 0;
+	chunk_limit = 0;
+	chunk_size = chunk_size_;
+	n_bytes = 0;
+	adopted = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::~Arena
+// Purpose:	Frees every chunk and adopted block in one pass.
+//---------------------------------------------------------------------------
+Arena::~Arena ()
+{
+	// The list of adopted blocks lives in the chunks.
+	while (adopted) {
+		free (adopted->block);
+		adopted = adopted->next;
+	}
+
+	while (chunk) {
+		char *previous;
+		memcpy (&previous, chunk, sizeof (char*));
+		free (chunk);
+		chunk = previous;
+	}
+
+	total_allocated -= n_bytes;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::new_chunk
+// Purpose:	Starts a chunk with room for at least size bytes. The
+//		rest of the current chunk, if any, goes unused.
+//---------------------------------------------------------------------------
+void
+Arena::new_chunk (unsigned long size)
+{
+	unsigned long size2 = chunk_size;
+	if (ARENA_ALIGNMENT + size > size2)
+		size2 = ARENA_ALIGNMENT + size;
+
+	char *c = (char*) malloc (size2);
+	if (!c)
+		fatal ("Out of memory!");
+	memcpy (c, &chunk, sizeof (char*));
+	chunk = c;
+	chunk_used = ARENA_ALIGNMENT;
+	chunk_limit = size2;
+
+	n_bytes += size2;
+	total_allocated += size2;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::take
+// Purpose:	Takes size bytes from the current position, starting a
+//		new chunk when they do not fit. A request larger than
+//		the chunk size gets a chunk of its own.
+//---------------------------------------------------------------------------
+void *
+Arena::take (unsigned long size)
+{
+	if (!chunk || chunk_used + size > chunk_limit)
+		new_chunk (size);
+
+	void *p = chunk + chunk_used;
+	chunk_used += size;
+	return p;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::alloc
+// Purpose:	Allocates aligned, uninitialized memory.
+//---------------------------------------------------------------------------
+void *
+Arena::alloc (unsigned long size)
+{
+	chunk_used = ARENA_ALIGNED (chunk_used);
+	return take (ARENA_ALIGNED (size));
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::store
+// Purpose:	Copies a string into the arena, unaligned.
+// Returns:	The null-terminated copy.
+//---------------------------------------------------------------------------
+char *
+Arena::store (const char *str, int len)
+{
+	char *s = (char*) take (len + 1);
+	memcpy (s, str, len);
+	s[len] = 0;
+	return s;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::reserve
+// Purpose:	Makes sure that the next size bytes of aligned
+//		allocations fit in the current chunk, starting one
+//		of that size if need be, so that a mesh whose size is
+//		known is carved from a single block.
+//---------------------------------------------------------------------------
+void
+Arena::reserve (unsigned long size)
+{
+	chunk_used = ARENA_ALIGNED (chunk_used);
+	if (!chunk || chunk_used + size > chunk_limit)
+		new_chunk (size);
+}
+
+//---------------------------------------------------------------------------
+// Name:	Arena::adopt
+// Purpose:	Takes ownership of a malloc'd block of the given size,
+//		which will be freed along with the arena.
+//---------------------------------------------------------------------------
+void
+Arena::adopt (void *block, unsigned long size)
+{
+	if (!block)
+		return;
+
+	AdoptedBlock *a = (AdoptedBlock*) alloc (sizeof (AdoptedBlock));
+	a->block = block;
+	a->next = adopted;
+	adopted = a;
+
+	n_bytes += size;
+	total_allocated += size;
+}
@@ -0,0 +1,66 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+// Alignment of alloc(); the chunk header is this size too,
+// holding the link to the previous chunk.
+#define ARENA_ALIGNMENT (8)
+#define ARENA_ALIGNED(SIZE) (((SIZE) + ARENA_ALIGNMENT - 1) & ~(unsigned long) (ARENA_ALIGNMENT - 1))
+
+/*===========================================================================
+ * Name:	Arena
+ * Purpose:	Bump-pointer allocator for data that are all freed at
+ *		once, such as the InputWord tree of a file. Memory is
+ *		carved out of large chunks; there is no per-object free.
+ *		Blocks that were malloc'd elsewhere can be handed over
+ *		with adopt() so that they are freed along with the rest.
+ */
+class Arena {
+public:
+	Arena (unsigned long chunk_size);
+	~Arena ();
+
+	void *alloc (unsigned long size);
+	char *store (const char *str, int len);
+	void adopt (void *block, unsigned long size);
+	void reserve (unsigned long size);
+
+	unsigned long size () { return n_bytes; }
+
+private:
+	char *chunk;		// Chunks are chained by their first bytes.
+	unsigned long chunk_used;
+	unsigned long chunk_limit;	// Size of the current chunk.
+	unsigned long chunk_size;
+	unsigned long n_bytes;	// As added to total_allocated.
+
+	struct AdoptedBlock {
+		void *block;
+		AdoptedBlock *next;
+	} *adopted;
+
+	void *take (unsigned long size);
+	void new_chunk (unsigned long size);
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "atoms.h"
+
+#define ATOM_CHUNK_SIZE (64*1024)
+
+// Indexed by atom, these are interned first, in order.
+static const char *predefined_atoms [ATOM_FIRST_UNNAMED] = {
+	"",
+#define ATOM(NAME) #NAME,
+	ATOM_LIST
+#undef ATOM
+	",", "[", "]", "{", "}"
+};
+
+//---------------------------------------------------------------------------
+// Name:	atom_hash
+// Purpose:	Hashes a string of the given length (FNV-1a).
+//---------------------------------------------------------------------------
+unsigned int
+atom_hash (const char *str, int len)
+{
+	unsigned int h = 2166136261U;
+	int i;
+	for (i = 0; i < len; i++) {
+		h ^= (unsigned char) str[i];
+		h *= 16777619U;
+	}
+	return h;
+}
+
+//---------------------------------------------------------------------------
+// Name:	AtomTable::AtomTable
+// Purpose:	Creates a table holding just the predefined atoms.
+//---------------------------------------------------------------------------
+AtomTable::AtomTable () : text (ATOM_CHUNK_SIZE)
+{
+	int i;
+
+	atoms_size = 256;
+	n_slots = 512;
+	strings = (char**) malloc (atoms_size * sizeof (char*));
+	lengths = (int*) malloc (atoms_size * sizeof (int));
+	hashes = (unsigned int*) malloc (atoms_size * sizeof (unsigned int));
+	slots = (int*) calloc (n_slots, sizeof (int));
+	if (!strings || !lengths || !hashes || !slots)
+		fatal ("Out of memory!");
+	n_bytes = atoms_size * (sizeof (char*) + sizeof (int) + sizeof (unsigned int))
+		+ n_slots * sizeof (int);
+	total_allocated += n_bytes;
+
+	//----------------------------------------
+	// Atom 0 is ATOM_NONE and is never
+	// found, since no slot refers to it.
+	//
+	strings[0] = (char*) predefined_atoms[0];
+	lengths[0] = 0;
+	hashes[0] = 0;
+	n_atoms = 1;
+
+	for (i = 1; i < ATOM_FIRST_UNNAMED; i++)
+		intern (predefined_atoms[i], strlen (predefined_atoms[i]), NULL);
+}
+
+//---------------------------------------------------------------------------
+// Name:	AtomTable::~AtomTable
+// Purpose:	Frees the table; the arena frees the interned strings.
+//---------------------------------------------------------------------------
+AtomTable::~AtomTable ()
+{
+	free (strings);
+	free (lengths);
+	free (hashes);
+	free (slots);
+
+	total_allocated -= n_bytes;
+}
+
+//---------------------------------------------------------------------------
+// Name:	AtomTable::grow_slots
+// Purpose:	Doubles the hash table and reinserts every atom.
+//---------------------------------------------------------------------------
+void
+AtomTable::grow_slots ()
+{
+	int size = n_slots * 2;
+	int *s = (int*) calloc (size, sizeof (int));
+	if (!s)
+		fatal ("Out of memory!");
+
+	unsigned int mask = size - 1;
+	int atom;
+	for (atom = 1; atom < n_atoms; atom++) {
+		unsigned int i = hashes[atom] & mask;
+		while (s[i])
+			i = (i + 1) & mask;
+		s[i] = atom;
+	}
+
+	free (slots);
+	n_bytes += (size - n_slots) * sizeof (int);
+	total_allocated += (size - n_slots) * sizeof (int);
+	slots = s;
+	n_slots = size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	AtomTable::intern
+// Purpose:	Looks up a word, adding it if it is new.
+// Returns:	The word's atom; the interned copy via str_return.
+//---------------------------------------------------------------------------
+int
+AtomTable::intern (const char *str, int len, char **str_return)
+{
+	ASSERT_NONZERO (str,"string")
+	//----------
+
+	unsigned int h = atom_hash (str, len);
+	unsigned int mask = n_slots - 1;
+	unsigned int i = h & mask;
+	int atom;
+
+	while ((atom = slots[i])) {
+		if (hashes[atom] == h && lengths[atom] == len && 
+		    !memcmp (strings[atom], str, len)) {
+			if (str_return)
+				*str_return = strings[atom];
+			return atom;
+		}
+		i = (i + 1) & mask;
+	}
+
+	//----------------------------------------
+	// A new word.
+	//
+	if (n_atoms >= atoms_size) {
+		int size = atoms_size * 2;
+		strings = (char**) realloc (strings, size * sizeof (char*));
+		lengths = (int*) realloc (lengths, size * sizeof (int));
+		hashes = (unsigned int*) realloc (hashes, size * sizeof (unsigned int));
+		if (!strings || !lengths || !hashes)
+			fatal ("Out of memory!");
+
+		unsigned long added = (size - atoms_size) * 
+			(sizeof (char*) + sizeof (int) + sizeof (unsigned int));
+		n_bytes += added;
+		total_allocated += added;
+		atoms_size = size;
+	}
+
+	atom = n_atoms++;
+	strings[atom] = text.store (str, len);
+	lengths[atom] = len;
+	hashes[atom] = h;
+	slots[i] = atom;
+
+	if (2 * n_atoms > n_slots)
+		grow_slots ();
+
+	if (str_return)
+		*str_return = strings[atom];
+	return atom;
+}
@@ -0,0 +1,108 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _ATOMS_H
+#define _ATOMS_H
+
+#include "arena.h"
+
+/*===========================================================================
+ * Name:	ATOM_LIST
+ * Purpose:	The VRML keywords that the parser dispatches on. Each
+ *		becomes an enumerator ATOM_<keyword>, so the parser can
+ *		switch on a word's atom instead of calling strcmp().
+ */
+#define ATOM_LIST \
+	ATOM(Appearance) ATOM(Background) ATOM(Box) ATOM(Color) \
+	ATOM(Cone) ATOM(Coordinate) ATOM(CoordinateInterpolator) \
+	ATOM(Cylinder) ATOM(DEF) ATOM(DirectionalLight) \
+	ATOM(EXTERNPROTO) ATOM(Group) ATOM(IndexedFaceSet) \
+	ATOM(IndexedLineSet) ATOM(Inline) ATOM(Material) \
+	ATOM(NavigationInfo) ATOM(Normal) ATOM(PROTO) \
+	ATOM(PositionInterpolator) \
+	ATOM(ROUTE) ATOM(Separator) ATOM(Shape) ATOM(Sphere) \
+	ATOM(Switch) ATOM(Text) ATOM(TimeSensor) ATOM(Transform) \
+	ATOM(USE) ATOM(Viewpoint) ATOM(WorldInfo) \
+	ATOM(ambientIntensity) ATOM(appearance) ATOM(bboxCenter) \
+	ATOM(bboxSize) ATOM(bindTime) ATOM(bottom) ATOM(bottomRadius) \
+	ATOM(center) ATOM(children) ATOM(choice) ATOM(color) \
+	ATOM(colorPerVertex) ATOM(coord) ATOM(coordIndex) ATOM(creaseAngle) \
+	ATOM(description) ATOM(diffuseColor) ATOM(emissiveColor) \
+	ATOM(eventIn) ATOM(eventOut) ATOM(field) ATOM(fieldOfView) \
+	ATOM(geometry) ATOM(height) ATOM(info) ATOM(isBound) ATOM(jump) \
+	ATOM(material) ATOM(normal) ATOM(normalIndex) ATOM(normalPerVertex) \
+	ATOM(orientation) ATOM(point) ATOM(position) \
+	ATOM(radius) ATOM(rotation) ATOM(scale) ATOM(set_bind) \
+	ATOM(shininess) ATOM(side) ATOM(size) ATOM(solid) \
+	ATOM(specularColor) ATOM(string) ATOM(texture) \
+	ATOM(textureTransform) ATOM(title) ATOM(top) ATOM(translation) \
+	ATOM(vector) ATOM(whichChoice)
+
+enum {
+	ATOM_NONE = 0,		// Numbers, and words read without a table.
+#define ATOM(NAME) ATOM_##NAME,
+	ATOM_LIST
+#undef ATOM
+	ATOM_COMMA,
+	ATOM_OPEN_BRACKET,
+	ATOM_CLOSE_BRACKET,
+	ATOM_OPEN_BRACE,
+	ATOM_CLOSE_BRACE,
+	ATOM_FIRST_UNNAMED	// First atom given to any other word.
+};
+
+extern unsigned int atom_hash (const char *str, int len);
+
+/*===========================================================================
+ * Name:	AtomTable
+ * Purpose:	Interns the words of a VRML file: each distinct word is
+ *		stored once and given a small integer, its atom. The
+ *		strings live in an Arena that is freed together with
+ *		the table, so reading a file costs no per-word
+ *		allocation, and node names and Text strings taken from
+ *		the words remain valid for as long as the table does,
+ *		even once the InputWord tree is gone.
+ */
+class AtomTable {
+public:
+	AtomTable ();
+	~AtomTable ();
+
+	int intern (const char *str, int len, char **str_return);
+	int count () { return n_atoms; }
+
+private:
+	char **strings;		// Indexed by atom.
+	int *lengths;		// Indexed by atom.
+	unsigned int *hashes;	// Indexed by atom.
+	int n_atoms;
+	int atoms_size;
+
+	int *slots;		// Open-addressed; 0 is an empty slot.
+	int n_slots;		// Always a power of 2.
+
+	Arena text;		// The interned strings.
+	unsigned long n_bytes;	// As added to total_allocated.
+
+	void grow_slots ();
+};
+
+#endif
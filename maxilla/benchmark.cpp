@@ -0,0 +1,1306 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "tokenizer.h"
+#include "numbers.h"
+#include "benchmark.h"
+#include "parser.h"
+#include "cache.h"
+#include "gzindex.h"
+#include "mesh.h"
+#include "bvh.h"
+#include "ply.h"
+#include "stl.h"
+
+extern long millisecond_time ();
+extern InputWord *vrml_reader (InputFile *);
+extern Model *vrml_read_metadata (InputFile *);
+
+#define BENCHMARK_REPETITIONS (10)
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_numbers
+// Purpose:	Collects the words of every point list in a file, then
+//		times atof() against vrml_atof() on them and verifies
+//		that both give bit-identical results, and that each
+//		value printed with %.17g parses back exactly.
+//---------------------------------------------------------------------------
+static bool
+benchmark_numbers (char *path)
+{
+	InputFile *file = new InputFile (path);
+	Tokenizer *tokenizer = new Tokenizer (file);
+
+	if (!file->valid || !tokenizer->open ()) {
+		printf ("Unable to open %s.\n", path);
+		delete tokenizer;
+		delete file;
+		return false;
+	}
+
+	//----------------------------------------
+	// Gather the numbers as NUL-terminated
+	// strings, packed one after another.
+	//
+	unsigned long size = 1 << 20;
+	unsigned long used = 0;
+	unsigned long count = 0;
+	char *words = (char*) malloc (size);
+	if (!words)
+		fatal ("Out of memory!");
+
+	bool after_point = false;
+	bool in_list = false;
+	while (true) {
+		const char *word;
+		bool is_number;
+		int len = tokenizer->next (&word, MAXWORDLEN-1, &is_number);
+		if (len == EOF)
+			break;
+
+		if (in_list) {
+			if (len == 1 && *word == ']')
+				in_list = false;
+			else if (is_number) {
+				if (used + len + 1 > size) {
+					size *= 2;
+					char *tmp = (char*) realloc (words, size);
+					if (!tmp)
+						fatal ("Out of memory!");
+					words = tmp;
+				}
+				memcpy (words + used, word, len);
+				words [used + len] = 0;
+				used += len + 1;
+				count++;
+			}
+		}
+		else if (after_point && len == 1 && *word == '[')
+			in_list = true;
+
+		after_point = len == 5 && !strncmp (word, "point", 5);
+	}
+
+	delete tokenizer;
+	delete file;
+
+	if (!count) {
+		printf ("No point lists in %s.\n", path);
+		free (words);
+		return false;
+	}
+
+	//----------------------------------------
+	// Time both conversions.
+	//
+	double sum1 = 0.0, sum2 = 0.0;
+	long t0 = millisecond_time ();
+	for (int rep = 0; rep < BENCHMARK_REPETITIONS; rep++) {
+		char *s = words;
+		while (s < words + used) {
+			sum1 += atof (s);
+			s += strlen (s) + 1;
+		}
+	}
+	long t1 = millisecond_time ();
+	for (int rep = 0; rep < BENCHMARK_REPETITIONS; rep++) {
+		char *s = words;
+		while (s < words + used) {
+			int len = strlen (s);
+			sum2 += vrml_atof (s, len);
+			s += len + 1;
+		}
+	}
+	long t2 = millisecond_time ();
+
+	//----------------------------------------
+	// Verify the results.
+	//
+	unsigned long mismatches = 0;
+	unsigned long round_trip_failures = 0;
+	char *s = words;
+	while (s < words + used) {
+		int len = strlen (s);
+		double a = atof (s);
+		double b = vrml_atof (s, len);
+		if (memcmp (&a, &b, sizeof (double))) {
+			if (mismatches++ < 10)
+				printf ("Mismatch: %s gives %.17g versus %.17g\n", s, a, b);
+		}
+
+		char printed [64];
+		sprintf (printed, "%.17g", b);
+		double c = vrml_atof (printed, strlen (printed));
+		if (memcmp (&b, &c, sizeof (double))) {
+			if (round_trip_failures++ < 10)
+				printf ("Round trip failed: %s gives %s\n", s, printed);
+		}
+		s += len + 1;
+	}
+
+	free (words);
+
+	double n = (double) count * BENCHMARK_REPETITIONS;
+	printf ("%lu numbers, %d repetitions.\n", count, BENCHMARK_REPETITIONS);
+	printf ("atof:      %5ld ms, %.1f ns per number\n", t1 - t0, 1e6 * (t1 - t0) / n);
+	printf ("vrml_atof: %5ld ms, %.1f ns per number\n", t2 - t1, 1e6 * (t2 - t1) / n);
+	printf ("Mismatches: %lu. Round-trip failures: %lu.\n", mismatches, round_trip_failures);
+
+	return sum1 == sum2 && !mismatches && !round_trip_failures;
+}
+
+//---------------------------------------------------------------------------
+// Name:	same_string
+// Purpose:	Compares two strings, either of which may be NULL.
+//---------------------------------------------------------------------------
+static bool
+same_string (const char *a, const char *b)
+{
+	if (!a || !b)
+		return a == b;
+	return !strcmp (a, b);
+}
+
+//---------------------------------------------------------------------------
+// Name:	same_point
+// Purpose:	Compares the coordinates of two points bit for bit.
+//---------------------------------------------------------------------------
+static bool
+same_point (const Point *a, const Point *b)
+{
+	return !memcmp (&a->x, &b->x, sizeof(float)) &&
+		!memcmp (&a->y, &b->y, sizeof(float)) &&
+		!memcmp (&a->z, &b->z, sizeof(float));
+}
+
+//---------------------------------------------------------------------------
+// Name:	same_floats
+// Purpose:	Compares n floats bit for bit.
+//---------------------------------------------------------------------------
+static bool
+same_floats (const float *a, const float *b, int n)
+{
+	return !memcmp (a, b, n * sizeof(float));
+}
+
+//---------------------------------------------------------------------------
+// Name:	compare_nodes
+// Purpose:	Compares two node trees, as parsed and as read from the
+//		mesh cache.
+// Returns:	The number of differences found.
+//---------------------------------------------------------------------------
+static unsigned long
+compare_nodes (Node *a, Node *b)
+{
+	unsigned long differences = 0;
+
+	while (a && b) {
+		if (strcmp (a->type, b->type) || !same_string (a->name, b->name)) {
+			printf ("Node %s %s differs from %s %s\n", a->type,
+				a->name ? a->name : "-", b->type, b->name ? b->name : "-");
+			return differences + 1;
+		}
+
+		if (!strcmp (a->type, "IndexedFaceSet")) {
+			IndexedFaceSet *f1 = (IndexedFaceSet*) a;
+			IndexedFaceSet *f2 = (IndexedFaceSet*) b;
+			if (f1->n_points != f2->n_points || f1->n_triangles != f2->n_triangles ||
+			    f1->normals_given != f2->normals_given ||
+			    f1->minx != f2->minx || f1->maxx != f2->maxx ||
+			    f1->miny != f2->miny || f1->maxy != f2->maxy ||
+			    f1->minz != f2->minz || f1->maxz != f2->maxz) {
+				printf ("IndexedFaceSet sizes or bounds differ.\n");
+				return differences + 1;
+			}
+			FlatMesh *m1 = f1->flat;
+			FlatMesh *m2 = f2->flat;
+			int i;
+			for (i = 0; i < f1->n_points; i++) {
+				if (!same_floats (flat_position (m1, i), flat_position (m2, i), 3))
+					differences++;
+				else if (f1->normals_given &&
+				    (!same_floats (flat_normal (m1, i), flat_normal (m2, i), 3) ||
+				     m1->smooth [i] != m2->smooth [i]))
+					differences++;
+			}
+			for (i = 0; i < f1->n_triangles; i++) {
+				if (memcmp (flat_face (m1, i), flat_face (m2, i), 3 * sizeof(uint32)) ||
+				    !same_floats (flat_face_normal (m1, i), flat_face_normal (m2, i), 3) ||
+				    !same_floats (m1->face_areas + i, m2->face_areas + i, 1))
+					differences++;
+			}
+		}
+		else if (!strcmp (a->type, "IndexedLineSet")) {
+			IndexedLineSet *l1 = (IndexedLineSet*) a;
+			IndexedLineSet *l2 = (IndexedLineSet*) b;
+			if (l1->n_points != l2->n_points || l1->n_colors != l2->n_colors ||
+			    l1->color_per_vertex != l2->color_per_vertex) {
+				printf ("IndexedLineSet sizes differ.\n");
+				return differences + 1;
+			}
+			PolyLine *p1 = l1->polyline;
+			PolyLine *p2 = l2->polyline;
+			while (p1 && p2) {
+				if (!same_point (p1->point, p2->point) || (l1->color_per_vertex &&
+				    memcmp (p1->color, p2->color, sizeof(p1->color))))
+					differences++;
+				p1 = p1->next;
+				p2 = p2->next;
+			}
+			if (p1 || p2)
+				differences++;
+		}
+		else if (!strcmp (a->type, "Transform")) {
+			Transform *t1 = (Transform*) a;
+			Transform *t2 = (Transform*) b;
+			if (t1->translate_x != t2->translate_x || t1->translate_y != t2->translate_y ||
+			    t1->translate_z != t2->translate_z || t1->rotate_angle != t2->rotate_angle ||
+			    t1->op_index != t2->op_index ||
+			    memcmp (t1->operations, t2->operations, TRANSFORM_MAX_OPS))
+				differences++;
+		}
+		else if (!strcmp (a->type, "Switch")) {
+			if (((Switch*) a)->which != ((Switch*) b)->which ||
+			    ((Switch*) a)->total_choices != ((Switch*) b)->total_choices)
+				differences++;
+		}
+		else if (!strcmp (a->type, "Text")) {
+			if (!same_string (((Text*) a)->text, ((Text*) b)->text))
+				differences++;
+		}
+
+		differences += compare_nodes (a->children, b->children);
+		a = a->next;
+		b = b->next;
+	}
+	if (a || b) {
+		printf ("Node lists differ in length.\n");
+		differences++;
+	}
+	return differences;
+}
+
+//---------------------------------------------------------------------------
+// Name:	count_shared_appearances
+// Purpose:	Counts the Shapes whose Appearance is that of an
+//		earlier Shape, checking that only the first owns it.
+// Returns:	The count, or -1 if a shared Appearance is owned twice.
+//---------------------------------------------------------------------------
+static int
+count_shared_appearances (Node *n, Appearance **first)
+{
+	int count = 0;
+
+	for (; n; n = n->next) {
+		if (!strcmp (n->type, "Shape") && ((Shape*) n)->appearance) {
+			Shape *shape = (Shape*) n;
+			if (!*first)
+				*first = shape->appearance;
+			else if (shape->appearance == *first) {
+				if (shape->owns_appearance)
+					return -1;
+				count++;
+			}
+		}
+		int k = count_shared_appearances (n->children, first);
+		if (k < 0)
+			return -1;
+		count += k;
+	}
+	return count;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_shared_appearance
+// Purpose:	Parses, caches and tears down a scene in which one Shape
+//		USEs the Appearance of another, which must be freed once.
+//		The scene is written beside the cache of the given file.
+// Returns:	The number of differences found.
+//---------------------------------------------------------------------------
+static unsigned long
+benchmark_shared_appearance (char *path)
+{
+	static const char *scene =
+		"#VRML V2.0 utf8\n"
+		"Group { children [\n"
+		" Shape { appearance DEF Felt Appearance { material Material { diffuseColor 1 0 0 } }\n"
+		"  geometry IndexedFaceSet { coord Coordinate { point [ 0 0 0, 1 0 0, 0 1 0 ] }\n"
+		"   coordIndex [ 0 1 2 -1 ] } }\n"
+		" Shape { appearance USE Felt\n"
+		"  geometry IndexedFaceSet { coord Coordinate { point [ 0 0 1, 1 0 1, 0 1 1 ] }\n"
+		"   coordIndex [ 0 1 2 -1 ] } }\n"
+		"] }\n";
+	char scene_path [PATH_MAX];
+	char full_source [PATH_MAX];
+
+	if (!cache_path (path, ".wrl", scene_path, full_source))
+		return 1;
+	FILE *f = fopen (scene_path, "wb");
+	if (!f)
+		return 1;
+	bool written = strlen (scene) == fwrite (scene, 1, strlen (scene), f);
+	if (fclose (f) || !written) {
+		remove (scene_path);
+		return 1;
+	}
+
+	unsigned long before = total_allocated;
+	unsigned long differences = 0;
+
+	InputFile *file = new InputFile (scene_path);
+	InputWord *words = file->valid ? vrml_reader (file) : NULL;
+	Model *parsed = words ? vrml_parser (words) : NULL;
+	if (parsed) {
+		parsed->atoms = file->atoms;
+		file->atoms = NULL;
+	}
+	Appearance *first = NULL;
+	if (!parsed || count_shared_appearances (parsed->nodes, &first) != 1 ||
+	    !mesh_cache_save (file, parsed, NULL))
+		differences++;
+
+	InputFile *file2 = new InputFile (scene_path);
+	Model *cached = mesh_cache_load (file2);
+	if (cached) {
+		cached->atoms = file2->atoms;
+		file2->atoms = NULL;
+	}
+	first = NULL;
+	if (!cached || count_shared_appearances (cached->nodes, &first) != 1)
+		differences++;
+
+	delete file->words;
+	file->words = NULL;
+	delete parsed;
+	delete cached;
+	delete file;
+	delete file2;
+
+	char cache_file [PATH_MAX];
+	if (cache_path (scene_path, ".mxc", cache_file, full_source))
+		remove (cache_file);
+	remove (scene_path);
+
+	long residue = (long) (total_allocated - before);
+	if (residue)
+		differences++;
+
+	printf ("Shared appearance: %d differences, %ld bytes not freed.\n",
+		(int) differences, residue);
+	return differences;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_cache
+// Purpose:	Times reading and parsing a file against reading its
+//		mesh cache, and verifies that both give the same Model.
+//		Then checks a scene with a USE'd Appearance likewise.
+//---------------------------------------------------------------------------
+static bool
+benchmark_cache (char *path)
+{
+	InputFile *file = new InputFile (path);
+	if (!file->valid) {
+		printf ("Unable to open %s.\n", path);
+		delete file;
+		return false;
+	}
+
+	long t0 = millisecond_time ();
+	InputWord *words = vrml_reader (file);
+	Model *parsed = words ? vrml_parser (words) : NULL;
+	long t1 = millisecond_time ();
+	if (!parsed) {
+		printf ("Unable to parse %s.\n", path);
+		delete file;
+		return false;
+	}
+	parsed->atoms = file->atoms;
+	file->atoms = NULL;
+
+	// Saving builds the Switch choices the parser deferred,
+	// so these are compared with the cache as well.
+	int deferred = 0;
+	Deferred *d;
+	for (d = parsed->pending; d; d = d->next_pending)
+		deferred++;
+
+	if (!mesh_cache_save (file, parsed, NULL)) {
+		printf ("Unable to write the mesh cache of %s.\n", path);
+		delete parsed;
+		delete file;
+		return false;
+	}
+	long t2 = millisecond_time ();
+
+	InputFile *file2 = new InputFile (path);
+	Model *cached = mesh_cache_load (file2);
+	long t3 = millisecond_time ();
+	if (!cached) {
+		printf ("Unable to read the mesh cache of %s.\n", path);
+		delete parsed;
+		delete file;
+		delete file2;
+		return false;
+	}
+	cached->atoms = file2->atoms;
+	file2->atoms = NULL;
+
+	unsigned long differences = compare_nodes (parsed->nodes, cached->nodes);
+	if (parsed->pending || cached->pending)
+		differences++;
+
+	NameMap *n1 = parsed->names;
+	NameMap *n2 = cached->names;
+	while (n1 && n2) {
+		if (strcmp (n1->name, n2->name) || strcmp (n1->node->type, n2->node->type))
+			differences++;
+		n1 = n1->next;
+		n2 = n2->next;
+	}
+	if (n1 || n2)
+		differences++;
+
+	if (!same_string (parsed->title, cached->title) ||
+	    !same_string (file->first_line, file2->first_line) ||
+	    parsed->background_provided != cached->background_provided ||
+	    parsed->viewpoint_fields != cached->viewpoint_fields ||
+	    parsed->viewpoint_x != cached->viewpoint_x ||
+	    parsed->viewpoint_y != cached->viewpoint_y ||
+	    parsed->viewpoint_z != cached->viewpoint_z ||
+	    parsed->orientation_x != cached->orientation_x ||
+	    parsed->orientation_y != cached->orientation_y ||
+	    parsed->orientation_z != cached->orientation_z ||
+	    parsed->field_of_view != cached->field_of_view ||
+	    parsed->n_names != cached->n_names)
+		differences++;
+#ifdef ORTHOCAST
+	if (!same_string (parsed->patient_firstname, cached->patient_firstname) ||
+	    !same_string (parsed->patient_lastname, cached->patient_lastname) ||
+	    !same_string (parsed->patient_birthdate, cached->patient_birthdate) ||
+	    !same_string (parsed->case_date, cached->case_date) ||
+	    !same_string (parsed->case_number, cached->case_number) ||
+	    !same_string (parsed->control_number, cached->control_number) ||
+	    parsed->isTopAndBottomAligned != cached->isTopAndBottomAligned ||
+	    !parsed->main_switch != !cached->main_switch ||
+	    !parsed->top_and_bottom_node != !cached->top_and_bottom_node)
+		differences++;
+#endif
+
+	delete file->words;
+	file->words = NULL;
+	delete parsed;
+	delete cached;
+	delete file;
+	delete file2;
+
+	differences += benchmark_shared_appearance (path);
+
+	printf ("Read and parse: %5ld ms\n", t1 - t0);
+	printf ("Write cache:    %5ld ms\n", t2 - t1);
+	printf ("Read cache:     %5ld ms\n", t3 - t2);
+	printf ("Deferred choices: %d.\n", deferred);
+	printf ("Differences: %lu.\n", differences);
+
+	return !differences;
+}
+
+//---------------------------------------------------------------------------
+// Name:	metadata_differences
+// Purpose:	Compares the title, patient and case data and manual
+//		spacing of a parsed model with those read as metadata.
+// Returns:	The number of differing groups.
+//---------------------------------------------------------------------------
+static unsigned long
+metadata_differences (Model *parsed, Model *m)
+{
+	unsigned long differences = 0;
+	if (!same_string (parsed->title, m->title))
+		differences++;
+#ifdef ORTHOCAST
+	if (!same_string (parsed->patient_firstname, m->patient_firstname) ||
+	    !same_string (parsed->patient_lastname, m->patient_lastname) ||
+	    !same_string (parsed->patient_birthdate, m->patient_birthdate) ||
+	    !same_string (parsed->case_date, m->case_date) ||
+	    !same_string (parsed->case_number, m->case_number) ||
+	    !same_string (parsed->control_number, m->control_number) ||
+	    parsed->isTopAndBottomAligned != m->isTopAndBottomAligned)
+		differences++;
+#endif
+	Text *spacing1 = (Text*) parsed->nodes->find_by_name ("manual_spacing");
+	Text *spacing2 = (Text*) m->nodes->find_by_name ("manual_spacing");
+	if (!spacing1 != !spacing2 ||
+	    (spacing1 && !same_string (spacing1->text, spacing2->text)))
+		differences++;
+	return differences;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_metadata
+// Purpose:	Times reading only a file's metadata, first by scanning
+//		it, then via the index that reading and parsing the
+//		whole file leaves behind for a gzipped file, and
+//		verifies that all three give the same title, patient
+//		and case data.
+//---------------------------------------------------------------------------
+static bool
+benchmark_metadata (char *path)
+{
+	char index_path [PATH_MAX];
+	char full_source [PATH_MAX];
+
+	//----------------------------------------
+	// Start without an index.
+	//
+	if (cache_path (path, ".mxi", index_path, full_source))
+		remove (index_path);
+
+	InputFile *file = new InputFile (path);
+	if (!file->valid) {
+		printf ("Unable to open %s.\n", path);
+		delete file;
+		return false;
+	}
+
+	long t0 = millisecond_time ();
+	Model *scanned = vrml_read_metadata (file);
+	delete file;
+	file = new InputFile (path);
+	long t1 = millisecond_time ();
+	InputWord *words = scanned ? vrml_reader (file) : NULL;
+	Model *parsed = words ? vrml_parser (words) : NULL;
+	long t2 = millisecond_time ();
+	if (!parsed) {
+		printf ("Unable to parse %s.\n", path);
+		delete scanned;
+		delete file;
+		return false;
+	}
+	parsed->atoms = file->atoms;
+	file->atoms = NULL;
+
+	InputFile *file2 = new InputFile (path);
+	Model *indexed = vrml_read_metadata (file2);
+	long t3 = millisecond_time ();
+	if (!indexed) {
+		printf ("Unable to read the metadata of %s.\n", path);
+		delete scanned;
+		delete parsed;
+		delete file;
+		delete file2;
+		return false;
+	}
+
+	unsigned long differences = metadata_differences (parsed, scanned) +
+		metadata_differences (parsed, indexed);
+	bool has_index = gzindex_current (path);
+
+	delete file->words;
+	file->words = NULL;
+	delete parsed;
+	delete scanned;
+	delete indexed;
+	delete file;
+	delete file2;
+
+	printf ("Metadata, scanned:     %5ld ms\n", t1 - t0);
+	printf ("Read and parse:        %5ld ms\n", t2 - t1);
+	printf ("Metadata, %s %5ld ms\n", has_index ? "indexed: " : "scanned: ", t3 - t2);
+	printf ("Differences: %lu.\n", differences);
+
+	return !differences;
+}
+
+//---------------------------------------------------------------------------
+// Name:	collect_face_sets
+// Purpose:	Gathers up to max IndexedFaceSets from a node tree.
+//---------------------------------------------------------------------------
+void
+collect_face_sets (Node *n, IndexedFaceSet **list, int *count, int max)
+{
+	for (; n; n = n->next) {
+		if (!strcmp (n->type, "IndexedFaceSet") && *count < max)
+			list [(*count)++] = (IndexedFaceSet*) n;
+		collect_face_sets (n->children, list, count, max);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	corner_work
+// Purpose:	The work done per face by the traversal benchmark: the
+//		squared length of the cross product of two edges, as
+//		ensure_tiny_triangles computes it.
+//---------------------------------------------------------------------------
+static double
+corner_work (const float *p1, const float *p2, const float *p3)
+{
+	double v1x = p2[0] - p1[0];
+	double v1y = p2[1] - p1[1];
+	double v1z = p2[2] - p1[2];
+	double v2x = p3[0] - p1[0];
+	double v2y = p3[1] - p1[1];
+	double v2z = p3[2] - p1[2];
+	double x = v1y * v2z - v1z * v2y;
+	double y = v1z * v2x - v1x * v2z;
+	double z = v1x * v2y - v1y * v2x;
+	return x*x + y*y + z*z;
+}
+
+#define BENCHMARK_MAX_FACE_SETS (64)
+
+#ifdef WIN32
+#define strcasecmp stricmp
+#endif
+
+//---------------------------------------------------------------------------
+// Name:	load_benchmark_model
+// Purpose:	Reads an STL or PLY mesh, or a VRML or DST file.
+// Returns:	The Model, or NULL. A VRML file's InputFile is returned
+//		too, to be deleted after the Model.
+//---------------------------------------------------------------------------
+Model *
+load_benchmark_model (char *path, InputFile **file_return)
+{
+	InputFile *file = NULL;
+	Model *model = NULL;
+	int length = strlen (path);
+
+	*file_return = NULL;
+	if ((length >= 4 && !strcasecmp ("stl", path + length - 3)) || is_ply_path (path))
+		model = stl_parser_one_file (path);
+	else {
+		file = new InputFile (path);
+		if (!file->valid) {
+			printf ("Unable to open %s.\n", path);
+			delete file;
+			return NULL;
+		}
+		InputWord *words = vrml_reader (file);
+		model = words ? vrml_parser (words) : NULL;
+		if (model) {
+			model->atoms = file->atoms;
+			file->atoms = NULL;
+		}
+	}
+	if (!model) {
+		printf ("Unable to parse %s.\n", path);
+		delete file;
+		return NULL;
+	}
+	*file_return = file;
+	return model;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_mesh
+// Purpose:	Reports the memory taken by the FlatMesh of each face
+//		set, which is all that a loaded model keeps, and by the
+//		Point and Triangle objects made from it for picking,
+//		and times walking every face's corners both ways,
+//		verifying that both walks give the same result.
+//---------------------------------------------------------------------------
+static bool
+benchmark_mesh (char *path)
+{
+	InputFile *file;
+	Model *model = load_benchmark_model (path, &file);
+	if (!model)
+		return false;
+
+	IndexedFaceSet *sets [BENCHMARK_MAX_FACE_SETS];
+	int n_sets = 0;
+	collect_face_sets (model->nodes, sets, &n_sets, BENCHMARK_MAX_FACE_SETS);
+
+	unsigned long n_faces = 0;
+	unsigned long object_bytes = 0;
+	unsigned long flat_bytes = 0;
+	int i, j, k;
+
+	long t0 = millisecond_time ();
+	for (i = 0; i < n_sets; i++) {
+		IndexedFaceSet *ifs = sets [i];
+		flat_bytes += ifs->flat->size;
+		n_faces += ifs->n_triangles;
+
+		ifs->make_objects ();
+		object_bytes += ifs->pool->size ()
+			+ ifs->n_points * sizeof(Point*)
+			+ ifs->n_triangles * sizeof(Triangle*);
+	}
+	long t1 = millisecond_time ();
+
+	double sum1 = 0., sum2 = 0.;
+	for (k = 0; k < BENCHMARK_REPETITIONS; k++) {
+		for (i = 0; i < n_sets; i++) {
+			IndexedFaceSet *ifs = sets [i];
+			for (j = 0; j < ifs->n_triangles; j++) {
+				Triangle *t = ifs->triangles [j];
+				sum1 += corner_work (&t->p1->x, &t->p2->x, &t->p3->x);
+			}
+		}
+	}
+	long t2 = millisecond_time ();
+
+	for (k = 0; k < BENCHMARK_REPETITIONS; k++) {
+		for (i = 0; i < n_sets; i++) {
+			FlatMesh *m = sets [i]->flat;
+			for (j = 0; j < m->n_faces; j++) {
+				const uint32 *v = flat_face (m, j);
+				sum2 += corner_work (flat_position (m, v[0]),
+					flat_position (m, v[1]), flat_position (m, v[2]));
+			}
+		}
+	}
+	long t3 = millisecond_time ();
+
+	for (i = 0; i < n_sets; i++)
+		sets [i]->drop_objects ();
+	delete model;
+	delete file;
+
+	double n = (double) n_faces * BENCHMARK_REPETITIONS;
+	if (!n)
+		n = 1.;
+	printf ("%d face sets, %lu faces, %d repetitions.\n", n_sets, n_faces, BENCHMARK_REPETITIONS);
+	printf ("Flat:    %10lu bytes, as kept by a loaded model\n", flat_bytes);
+	printf ("Objects: %10lu bytes, made in %ld ms, only for picking\n", object_bytes, t1 - t0);
+	printf ("Objects: %5ld ms, %.1f ns per face\n", t2 - t1, 1e6 * (t2 - t1) / n);
+	printf ("Flat:    %5ld ms, %.1f ns per face\n", t3 - t2, 1e6 * (t3 - t2) / n);
+	printf ("Differences: %d.\n", sum1 != sum2);
+
+	return sum1 == sum2;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_adjacency
+// Purpose:	Times making the MeshAdjacency of each face set, and
+//		checks that twins are mutual and join the same two
+//		vertices, and that the boundary loops take every
+//		boundary half-edge once.
+//---------------------------------------------------------------------------
+static bool
+benchmark_adjacency (char *path)
+{
+	InputFile *file;
+	Model *model = load_benchmark_model (path, &file);
+	if (!model)
+		return false;
+
+	IndexedFaceSet *sets [BENCHMARK_MAX_FACE_SETS];
+	int n_sets = 0;
+	collect_face_sets (model->nodes, sets, &n_sets, BENCHMARK_MAX_FACE_SETS);
+
+	unsigned long errors = 0;
+	unsigned long n_faces = 0;
+	long build_ms = 0, ring_ms = 0;
+	int i, k, h;
+
+	for (i = 0; i < n_sets; i++) {
+		FlatMesh *m = sets [i]->flat;
+		n_faces += m->n_faces;
+
+		long t0 = millisecond_time ();
+		for (k = 0; k < BENCHMARK_REPETITIONS; k++) {
+			flatmesh_drop_adjacency (m);
+			flatmesh_adjacency (m);
+		}
+		long t1 = millisecond_time ();
+		build_ms += t1 - t0;
+
+		MeshAdjacency *a = m->adjacency;
+		for (h = 0; h < a->n_halfedges; h++) {
+			int t = a->twin [h];
+			if (t < 0)
+				continue;
+			int v1 = halfedge_vertex (m, h);
+			int v2 = halfedge_vertex (m, halfedge_next (h));
+			int w1 = halfedge_vertex (m, t);
+			int w2 = halfedge_vertex (m, halfedge_next (t));
+			if (a->twin [t] != h || a->on_boundary [h] ||
+			    !((v1 == w2 && v2 == w1) || (v1 == w1 && v2 == w2)))
+				errors++;
+		}
+
+		int *edges = (int*) malloc ((2 * a->n_boundary_edges + 1) * sizeof(int));
+		if (!edges)
+			fatal ("Out of memory!");
+		int n_loops = mesh_boundary_loops (m, a, edges);
+		int n_taken = 0, n_ends = 0;
+		for (h = 0; n_ends < n_loops; h++)
+			if (edges [h] < 0)
+				n_ends++;
+			else
+				n_taken++;
+		if (n_taken != a->n_boundary_edges)
+			errors++;
+		free (edges);
+
+		int neighbors [256];
+		unsigned long n_neighbors = 0;
+		long t2 = millisecond_time ();
+		for (k = 0; k < m->n_vertices; k++)
+			n_neighbors += mesh_one_ring (m, a, k, neighbors, 256);
+		long t3 = millisecond_time ();
+		ring_ms += t3 - t2;
+
+		printf ("%d vertices, %d faces: %d boundary edges in %d loops, %d non-manifold edges, mean valence %.2f, %lu bytes\n",
+			m->n_vertices, m->n_faces, a->n_boundary_edges, n_loops,
+			a->n_nonmanifold_edges,
+			m->n_vertices ? (double) n_neighbors / m->n_vertices : 0.,
+			a->size);
+	}
+
+	delete model;
+	delete file;
+
+	double n = (double) n_faces * BENCHMARK_REPETITIONS;
+	if (!n)
+		n = 1.;
+	printf ("%d face sets, %lu faces, %d repetitions.\n", n_sets, n_faces, BENCHMARK_REPETITIONS);
+	printf ("Build:    %5ld ms, %.1f ns per face\n", build_ms, 1e6 * build_ms / n);
+	printf ("One-ring: %5ld ms for every vertex once\n", ring_ms);
+	printf ("Errors: %lu.\n", errors);
+
+	return !errors;
+}
+
+#define BENCHMARK_BVH_QUERIES (100000)
+#define BENCHMARK_BVH_SLICES (1000)
+#define BENCHMARK_BVH_CHECK (97)	// One query in this many is checked.
+#define BENCHMARK_BVH_K (8)
+#define BENCHMARK_BVH_CONTACT (0.0005)	// Meters, within which the jaws are taken to touch.
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_random
+// Purpose:	A small generator that gives every run the same queries.
+// Returns:	A number in [0,1).
+//---------------------------------------------------------------------------
+static double
+benchmark_random (uint32 *state)
+{
+	*state = *state * 1664525 + 1013904223;
+	return (*state >> 8) / 16777216.;
+}
+
+static void
+random_point (uint32 *state, const double *lo, const double *hi, double *p)
+{
+	int k;
+	for (k = 0; k < 3; k++)
+		p [k] = lo [k] + (hi [k] - lo [k]) * benchmark_random (state);
+}
+
+static void
+random_direction (uint32 *state, double *d)
+{
+	double z = 2. * benchmark_random (state) - 1.;
+	double a = 2. * M_PI * benchmark_random (state);
+	double r = sqrt (1. - z*z);
+	d [0] = r * cos (a);
+	d [1] = r * sin (a);
+	d [2] = z;
+}
+
+static void
+brute_corners (const Bvh *bvh, int f, const float **a, const float **b, const float **c)
+{
+	const uint32 *v = flat_face (bvh->mesh, f);
+	*a = bvh->positions + 3 * v[0];
+	*b = bvh->positions + 3 * v[1];
+	*c = bvh->positions + 3 * v[2];
+}
+
+//---------------------------------------------------------------------------
+// Name:	brute_bvh_check
+// Purpose:	Answers each kind of query by looking at every face,
+//		and compares the hierarchy's answers.
+// Returns:	The number of answers that differ.
+//---------------------------------------------------------------------------
+static int
+brute_bvh_check (const Bvh *bvh, const double *p, const double *d,
+	const double *lo, const double *hi, double offset)
+{
+	const FlatMesh *m = bvh->mesh;
+	const float *a, *b, *c;
+	int errors = 0;
+	int f, k;
+
+	//----------------------------------------
+	// Ray.
+	//
+	double t = HUGE_VAL, u, v;
+	int hit_face = -1;
+	for (f = 0; f < m->n_faces; f++) {
+		brute_corners (bvh, f, &a, &b, &c);
+		if (triangle_ray (p, d, a, b, c, &t, &u, &v))
+			hit_face = f;
+	}
+	BvhHit hit;
+	bool hit_any = bvh_ray (bvh, p, d, HUGE_VAL, &hit);
+	if (hit_any != (hit_face >= 0) || (hit_any && hit.t != t))
+		errors++;
+
+	//----------------------------------------
+	// Closest point and k nearest.
+	//
+	double nearest [BENCHMARK_BVH_K];
+	int n = 0;
+	for (f = 0; f < m->n_faces; f++) {
+		brute_corners (bvh, f, &a, &b, &c);
+		double d2 = triangle_distance2 (p, a, b, c, NULL);
+		if (n == BENCHMARK_BVH_K && d2 >= nearest [n-1])
+			continue;
+		if (n < BENCHMARK_BVH_K)
+			n++;
+		for (k = n - 1; k > 0 && nearest [k-1] > d2; k--)
+			nearest [k] = nearest [k-1];
+		nearest [k] = d2;
+	}
+	int face;
+	double distance = bvh_closest (bvh, p, HUGE_VAL, &face, NULL);
+	if (n && distance != sqrt (nearest [0]))
+		errors++;
+
+	int faces [BENCHMARK_BVH_K];
+	double distances [BENCHMARK_BVH_K];
+	if (bvh_nearest (bvh, p, BENCHMARK_BVH_K, faces, distances) != n)
+		errors++;
+	else
+		for (k = 0; k < n; k++)
+			if (distances [k] != sqrt (nearest [k]))
+				errors++;
+
+	//----------------------------------------
+	// Box and plane.
+	//
+	double center [3], half [3];
+	for (k = 0; k < 3; k++) {
+		center [k] = 0.5 * (lo[k] + hi[k]);
+		half [k] = 0.5 * (hi[k] - lo[k]);
+	}
+	int in_box = 0, on_plane = 0;
+	for (f = 0; f < m->n_faces; f++) {
+		brute_corners (bvh, f, &a, &b, &c);
+		if (triangle_box (center, half, a, b, c))
+			in_box++;
+		double da = d[0]*a[0] + d[1]*a[1] + d[2]*a[2] - offset;
+		double db = d[0]*b[0] + d[1]*b[1] + d[2]*b[2] - offset;
+		double dc = d[0]*c[0] + d[1]*c[1] + d[2]*c[2] - offset;
+		if (!((da > 0. && db > 0. && dc > 0.) || (da < 0. && db < 0. && dc < 0.)))
+			on_plane++;
+	}
+	if (bvh_box (bvh, lo, hi, NULL, 0) != in_box)
+		errors++;
+	if (bvh_plane (bvh, d, offset, NULL, 0) != on_plane)
+		errors++;
+
+	return errors;
+}
+
+//---------------------------------------------------------------------------
+// Name:	benchmark_bvh
+// Purpose:	Times building each face set's bounding volume hierarchy
+//		and the queries it answers, checks some of each kind of
+//		query against looking at every face, checks refitting
+//		under a rotation, and finds how near the first two face
+//		sets come, as placed by their Transforms: for a pair of
+//		arches, how near the jaws come.
+//---------------------------------------------------------------------------
+static bool
+benchmark_bvh (char *path)
+{
+	InputFile *file;
+	Model *model = load_benchmark_model (path, &file);
+	if (!model)
+		return false;
+
+	IndexedFaceSet *sets [BENCHMARK_MAX_FACE_SETS];
+	int n_sets = 0;
+	collect_face_sets (model->nodes, sets, &n_sets, BENCHMARK_MAX_FACE_SETS);
+
+	unsigned long errors = 0;
+	unsigned long n_faces = 0;
+	long build_ms = 0;
+	long query_ms [6] = { 0, 0, 0, 0, 0, 0 };
+	unsigned long found [6] = { 0, 0, 0, 0, 0, 0 };
+	int i, j, k;
+
+	int *list = NULL;
+	int list_size = 0;
+
+	for (i = 0; i < n_sets; i++) {
+		FlatMesh *m = sets [i]->flat;
+		n_faces += m->n_faces;
+
+		long t0 = millisecond_time ();
+		for (k = 0; k < BENCHMARK_REPETITIONS; k++) {
+			flatmesh_drop_bvh (m);
+			flatmesh_bvh (m);
+		}
+		build_ms += millisecond_time () - t0;
+
+		Bvh *bvh = m->bvh;
+		int n_leaves = 0, max_leaf = 0;
+		for (j = 0; j < bvh->n_nodes; j++)
+			if (bvh->nodes [j].count) {
+				n_leaves++;
+				if ((int) bvh->nodes [j].count > max_leaf)
+					max_leaf = bvh->nodes [j].count;
+			}
+		printf ("%d faces: %d nodes, %d leaves of at most %d faces, %lu bytes\n",
+			m->n_faces, bvh->n_nodes, n_leaves, max_leaf, bvh->size);
+		if (!bvh->n_nodes)
+			continue;
+
+		if (list_size < m->n_faces) {
+			list_size = m->n_faces;
+			list = (int*) realloc (list, list_size * sizeof(int));
+			if (!list)
+				fatal ("Out of memory!");
+		}
+
+		//----------------------------------------
+		// Queries come from a box a little larger
+		// than the mesh's. Probe boxes are a
+		// fiftieth of its size.
+		//
+		double lo [3], hi [3], size = 0.;
+		for (k = 0; k < 3; k++) {
+			double margin = 0.1 * (bvh->nodes[0].hi[k] - bvh->nodes[0].lo[k]);
+			lo [k] = bvh->nodes[0].lo[k] - margin;
+			hi [k] = bvh->nodes[0].hi[k] + margin;
+			if (hi [k] - lo [k] > size)
+				size = hi [k] - lo [k];
+		}
+		double probe = size / 50.;
+
+		uint32 state = 1;
+		double p [3], d [3], box_lo [3], box_hi [3];
+		BvhHit hit;
+		long t;
+
+		t = millisecond_time ();
+		for (j = 0; j < BENCHMARK_BVH_QUERIES; j++) {
+			random_point (&state, lo, hi, p);
+			random_direction (&state, d);
+			found [0] += bvh_ray (bvh, p, d, HUGE_VAL, &hit);
+		}
+		query_ms [0] += millisecond_time () - t;
+
+		t = millisecond_time ();
+		for (j = 0; j < BENCHMARK_BVH_QUERIES; j++) {
+			random_point (&state, lo, hi, p);
+			int face;
+			bvh_closest (bvh, p, HUGE_VAL, &face, NULL);
+			found [1] += face >= 0;
+		}
+		query_ms [1] += millisecond_time () - t;
+
+		t = millisecond_time ();
+		for (j = 0; j < BENCHMARK_BVH_QUERIES; j++) {
+			int faces [BENCHMARK_BVH_K];
+			random_point (&state, lo, hi, p);
+			found [2] += bvh_nearest (bvh, p, BENCHMARK_BVH_K, faces, NULL);
+		}
+		query_ms [2] += millisecond_time () - t;
+
+		t = millisecond_time ();
+		for (j = 0; j < BENCHMARK_BVH_QUERIES; j++) {
+			random_point (&state, lo, hi, box_lo);
+			for (k = 0; k < 3; k++)
+				box_hi [k] = box_lo [k] + probe;
+			found [3] += bvh_box (bvh, box_lo, box_hi, list, list_size);
+		}
+		query_ms [3] += millisecond_time () - t;
+
+		t = millisecond_time ();
+		for (j = 0; j < BENCHMARK_BVH_SLICES; j++) {
+			random_point (&state, lo, hi, p);
+			random_direction (&state, d);
+			double offset = d[0]*p[0] + d[1]*p[1] + d[2]*p[2];
+			found [4] += bvh_plane (bvh, d, offset, list, list_size);
+		}
+		query_ms [4] += millisecond_time () - t;
+
+		for (j = 0; j < BENCHMARK_BVH_QUERIES; j += BENCHMARK_BVH_CHECK) {
+			random_point (&state, lo, hi, p);
+			random_direction (&state, d);
+			random_point (&state, lo, hi, box_lo);
+			for (k = 0; k < 3; k++)
+				box_hi [k] = box_lo [k] + probe;
+			errors += brute_bvh_check (bvh, p, d, box_lo, box_hi,
+				d[0]*p[0] + d[1]*p[1] + d[2]*p[2]);
+		}
+
+		//----------------------------------------
+		// Refit under a rotation about the middle
+		// and a shift: a moved point must be as far
+		// from the moved mesh as before, but for
+		// the rounding of the moved positions.
+		//
+		double matrix [12], middle [3], angle = 0.5;
+		double c = cos (angle), s = sin (angle);
+		memset (matrix, 0, sizeof (matrix));
+		matrix [0] = c;		matrix [1] = -s;
+		matrix [4] = s;		matrix [5] = c;
+		matrix [10] = 1.;
+		for (k = 0; k < 3; k++)
+			middle [k] = 0.5 * (lo[k] + hi[k]);
+		for (k = 0; k < 3; k++)
+			matrix [4*k + 3] = middle [k] + size - (matrix [4*k] * middle [0] +
+				matrix [4*k + 1] * middle [1] + matrix [4*k + 2] * middle [2]);
+		double before [BENCHMARK_BVH_QUERIES / BENCHMARK_BVH_CHECK + 1];
+		uint32 saved = state;
+		for (j = 0; j < BENCHMARK_BVH_QUERIES / BENCHMARK_BVH_CHECK; j++) {
+			random_point (&state, lo, hi, p);
+			before [j] = bvh_closest (bvh, p, HUGE_VAL, NULL, NULL);
+		}
+
+		t = millisecond_time ();
+		for (k = 0; k < BENCHMARK_REPETITIONS; k++)
+			bvh_refit (bvh, matrix);
+		query_ms [5] += millisecond_time () - t;
+
+		state = saved;
+		for (j = 0; j < BENCHMARK_BVH_QUERIES / BENCHMARK_BVH_CHECK; j++) {
+			double q [3];
+			random_point (&state, lo, hi, p);
+			for (k = 0; k < 3; k++)
+				q [k] = matrix [4*k] * p[0] + matrix [4*k + 1] * p[1] +
+					matrix [4*k + 2] * p[2] + matrix [4*k + 3];
+			double after = bvh_closest (bvh, q, HUGE_VAL, NULL, NULL);
+			if (fabs (after - before [j]) > 1e-5 * size)
+				errors++;
+		}
+		bvh_refit (bvh, NULL);
+		if (bvh_closest (bvh, p, HUGE_VAL, NULL, NULL) != before [j - 1])
+			errors++;
+	}
+	free (list);
+
+	//----------------------------------------
+	// Jaw to jaw: the nearest that any vertex
+	// of the first face set comes to the
+	// second, and how many are in contact,
+	// with both where the Model puts them.
+	//
+	double approach = -1.;
+	long approach_ms = 0;
+	int n_contacts = 0;
+	if (n_sets >= 2 && sets [0]->flat->n_faces && sets [1]->flat->n_faces) {
+		double matrix_a [12], matrix_b [12];
+		model->face_set_matrix (sets [0], matrix_a);
+		model->face_set_matrix (sets [1], matrix_b);
+
+		long t = millisecond_time ();
+		Bvh *a = sets [0]->bvh ();
+		Bvh *b = sets [1]->bvh ();
+		bvh_refit (a, matrix_a);
+		bvh_refit (b, matrix_b);
+		approach = HUGE_VAL;
+		for (j = 0; j < a->mesh->n_vertices; j++) {
+			const float *v = a->positions + 3 * j;
+			double p [3] = { v[0], v[1], v[2] };
+			double d = bvh_closest (b, p,
+				approach > BENCHMARK_BVH_CONTACT ? approach : BENCHMARK_BVH_CONTACT,
+				NULL, NULL);
+			if (d < BENCHMARK_BVH_CONTACT)
+				n_contacts++;
+			if (d < approach)
+				approach = d;
+		}
+		approach_ms = millisecond_time () - t;
+		bvh_refit (a, NULL);
+		bvh_refit (b, NULL);
+	}
+
+	delete model;
+	delete file;
+
+	double n = (double) n_faces * BENCHMARK_REPETITIONS;
+	if (!n)
+		n = 1.;
+	double nq = (double) n_sets * BENCHMARK_BVH_QUERIES;
+	double ns = (double) n_sets * BENCHMARK_BVH_SLICES;
+	if (!n_sets)
+		nq = ns = 1.;
+	printf ("%d face sets, %lu faces, %d repetitions.\n", n_sets, n_faces, BENCHMARK_REPETITIONS);
+	printf ("Build:   %5ld ms, %.1f ns per face\n", build_ms, 1e6 * build_ms / n);
+	printf ("Ray:     %5ld ms, %.2f us per query, %.1f%% hit\n",
+		query_ms [0], 1e3 * query_ms [0] / nq, 100. * found [0] / nq);
+	printf ("Closest: %5ld ms, %.2f us per query\n", query_ms [1], 1e3 * query_ms [1] / nq);
+	printf ("Nearest: %5ld ms, %.2f us per query of %d\n",
+		query_ms [2], 1e3 * query_ms [2] / nq, BENCHMARK_BVH_K);
+	printf ("Box:     %5ld ms, %.2f us per query, %.1f faces each\n",
+		query_ms [3], 1e3 * query_ms [3] / nq, found [3] / nq);
+	printf ("Plane:   %5ld ms, %.2f us per query, %.1f faces each\n",
+		query_ms [4], 1e3 * query_ms [4] / ns, found [4] / ns);
+	printf ("Refit:   %5ld ms, %.1f ns per face\n", query_ms [5], 1e6 * query_ms [5] / n);
+	if (approach >= 0.)
+		printf ("Face sets 1 and 2: %.3f mm apart, %d vertices within %g mm, found in %ld ms\n",
+			1000. * approach, n_contacts, 1000. * BENCHMARK_BVH_CONTACT, approach_ms);
+	printf ("Errors: %lu.\n", errors);
+
+	return !errors;
+}
+
+//---------------------------------------------------------------------------
+// Name:	run_benchmark
+//---------------------------------------------------------------------------
+bool
+run_benchmark (const char *name, char *path)
+{
+	ASSERT_NONZERO (name,"name")
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	if (!strcmp (name, "numbers"))
+		return benchmark_numbers (path);
+	if (!strcmp (name, "cache"))
+		return benchmark_cache (path);
+	if (!strcmp (name, "metadata"))
+		return benchmark_metadata (path);
+	if (!strcmp (name, "mesh"))
+		return benchmark_mesh (path);
+	if (!strcmp (name, "adjacency"))
+		return benchmark_adjacency (path);
+	if (!strcmp (name, "bvh"))
+		return benchmark_bvh (path);
+
+	printf ("Unknown benchmark: %s\n", name);
+	return false;
+}
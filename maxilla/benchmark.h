@@ -0,0 +1,47 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _BENCHMARK_H
+#define _BENCHMARK_H
+
+/*===========================================================================
+ * Name:	run_benchmark
+ * Purpose:	Runs one of the timing benchmarks selected with
+ *		-benchmark-<name> on the command line, e.g.
+ *		maxilla -benchmark-numbers model.wrl
+ * Returns:	False if the benchmark failed or is unknown.
+ */
+extern bool run_benchmark (const char *name, char *path);
+
+class Model;
+class Node;
+class InputFile;
+class IndexedFaceSet;
+
+/*===========================================================================
+ * Name:	load_benchmark_model, collect_face_sets
+ * Purpose:	Read a model from a mesh, VRML or DST file, and gather
+ *		its IndexedFaceSets; -decimate uses them as well.
+ */
+extern Model *load_benchmark_model (char *path, InputFile **file_return);
+extern void collect_face_sets (Node *, IndexedFaceSet **list, int *count, int max);
+
+#endif
@@ -0,0 +1,1433 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+//----------------------------------------------------------------------------
+// Picking, slicing and measuring all come down to finding the few faces
+// of a mesh near a point, a ray or a plane. Looking at every face makes
+// each such query take time in proportion to the size of the mesh.
+//
+// The bounding volume hierarchy is a binary tree of boxes over the faces
+// of a FlatMesh, so that a query need only open the boxes that it could
+// be interested in. Each node is split where the surface area heuristic
+// says that a ray would least expect to have to test: faces are sorted
+// by centroid into a few bins along each axis, and the split between
+// two bins with the least sum of area times faces on either side wins.
+//
+// The top of the tree is built first, down to 64 or so subtrees, and
+// the subtrees are then built in parallel, each into its own array, and
+// copied after the top. The nodes are 32 bytes, stored in one array with
+// 32-bit indices, and each node's children come after it, so that a
+// refit after the mesh is moved rigidly is a pass over the leaves and
+// then one backwards over the array.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "mesh.h"
+#include "bvh.h"
+#include "threads.h"
+
+#define BVH_BLOCK_SIZE (4096)	// Faces, vertices or nodes per parallel_for call.
+#define BVH_TASKS (64)		// Subtrees built in parallel, roughly.
+#define BVH_MIN_TASK (1024)	// Faces, below which a subtree is not worth a task.
+#define BVH_MAX_DEPTH (64)	// Below which no node is split.
+#define BVH_STACK_SIZE (2 * BVH_MAX_DEPTH + 2)
+
+//----------------------------------------
+// A subtree built by one parallel_for
+// call, into its own array. Its nodes[0]
+// goes in the top's node slot.
+//
+typedef struct {
+	uint32 slot;
+	uint32 first;
+	uint32 count;
+	int depth;
+	BvhNode *nodes;
+	int n_nodes;
+	int max_nodes;
+} BvhTask;
+
+//----------------------------------------
+// A face as the build sees it. These are
+// partitioned, rather than face numbers,
+// so that each node's faces are read in
+// order from one run of memory.
+//
+typedef struct {
+	float lo [3];
+	float hi [3];
+	float centroid [3];
+	uint32 face;
+} BvhRef;
+
+typedef struct {
+	const FlatMesh *mesh;
+	BvhRef *refs;
+	uint32 task_faces;	// Subtrees this small become tasks.
+	BvhNode *top;
+	int n_top;
+	int max_top;
+	BvhTask *tasks;
+	int n_tasks;
+	int max_tasks;
+} BvhBuild;
+
+typedef struct {
+	uint32 node;
+	uint32 first;
+	uint32 count;
+	int depth;
+} BvhRange;
+
+//---------------------------------------------------------------------------
+// Name:	grow
+// Purpose:	Makes room in an array for one more element.
+//---------------------------------------------------------------------------
+static void *
+grow (void *array, int n, int *max, unsigned long element_size)
+{
+	if (n < *max)
+		return array;
+	*max = *max ? 2 * *max : 64;
+	array = realloc (array, *max * element_size);
+	if (!array)
+		fatal ("Out of memory!");
+	return array;
+}
+
+//---------------------------------------------------------------------------
+// Name:	box_area
+// Returns:	Half the surface area of a box, which is all that the
+//		heuristic needs.
+//---------------------------------------------------------------------------
+static inline float
+box_area (const float *lo, const float *hi)
+{
+	float x = hi[0] - lo[0], y = hi[1] - lo[1], z = hi[2] - lo[2];
+	return x*y + y*z + z*x;
+}
+
+static inline void
+box_empty (float *lo, float *hi)
+{
+	lo[0] = lo[1] = lo[2] = FLT_MAX;
+	hi[0] = hi[1] = hi[2] = -FLT_MAX;
+}
+
+static inline void
+box_add (float *lo, float *hi, const float *add_lo, const float *add_hi)
+{
+	// Written to become min and max, not branches.
+	int k;
+	for (k = 0; k < 3; k++) {
+		lo[k] = add_lo[k] < lo[k] ? add_lo[k] : lo[k];
+		hi[k] = add_hi[k] > hi[k] ? add_hi[k] : hi[k];
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_box
+// Purpose:	Finds the box of a face, from the positions given.
+//---------------------------------------------------------------------------
+static inline void
+face_box (const FlatMesh *m, const float *positions, uint32 f, float *lo, float *hi)
+{
+	const uint32 *v = flat_face (m, f);
+	const float *p1 = positions + 3 * v[0];
+	const float *p2 = positions + 3 * v[1];
+	const float *p3 = positions + 3 * v[2];
+	int k;
+	for (k = 0; k < 3; k++) {
+		float a = p1[k] < p2[k] ? p1[k] : p2[k];
+		float b = p1[k] < p2[k] ? p2[k] : p1[k];
+		lo[k] = a < p3[k] ? a : p3[k];
+		hi[k] = b > p3[k] ? b : p3[k];
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_box_block
+// Purpose:	Finds the boxes and centroids of one block of faces,
+//		for parallel_for.
+//---------------------------------------------------------------------------
+static void
+face_box_block (void *arg, int block)
+{
+	BvhBuild *b = (BvhBuild*) arg;
+	int first = block * BVH_BLOCK_SIZE;
+	int last = first + BVH_BLOCK_SIZE;
+	if (last > b->mesh->n_faces)
+		last = b->mesh->n_faces;
+
+	int f, k;
+	for (f = first; f < last; f++) {
+		BvhRef *r = b->refs + f;
+		face_box (b->mesh, b->mesh->positions, f, r->lo, r->hi);
+		for (k = 0; k < 3; k++)
+			r->centroid [k] = 0.5f * (r->lo[k] + r->hi[k]);
+		r->face = f;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	range_box
+// Purpose:	Finds the box of a range of faces.
+//---------------------------------------------------------------------------
+static void
+range_box (const BvhBuild *b, uint32 first, uint32 count, float *lo, float *hi)
+{
+	uint32 i;
+	box_empty (lo, hi);
+	for (i = first; i < first + count; i++)
+		box_add (lo, hi, b->refs [i].lo, b->refs [i].hi);
+}
+
+//---------------------------------------------------------------------------
+// Name:	split_range
+// Purpose:	Chooses where to split a node's faces by the surface
+//		area heuristic, binning them by centroid along each
+//		axis, and partitions them. A node with too many faces
+//		to be a leaf is split even if that costs more, in half
+//		if its faces' centroids coincide.
+// Returns:	False if the node is better as a leaf; else true, with
+//		the faces of the first child before *mid_return and the
+//		boxes of both children.
+//---------------------------------------------------------------------------
+static bool
+split_range (BvhBuild *b, const BvhNode *node, uint32 first, uint32 count, int depth,
+	uint32 *mid_return, float *left, float *right)
+{
+	BvhRef *refs = b->refs;
+	uint32 i;
+	int k, j;
+
+	if (count <= BVH_LEAF_SIZE || depth >= BVH_MAX_DEPTH)
+		return false;
+
+	float clo [3], chi [3];
+	box_empty (clo, chi);
+	for (i = first; i < first + count; i++)
+		box_add (clo, chi, refs [i].centroid, refs [i].centroid);
+
+	//----------------------------------------
+	// Bin the faces along all three axes at
+	// once. Small nodes need no more bins
+	// than faces.
+	//
+	int n_bins = count < BVH_BINS ? count : BVH_BINS;
+	float scale [3];
+	for (k = 0; k < 3; k++)
+		scale [k] = chi[k] > clo[k] ? n_bins / (chi[k] - clo[k]) : 0.f;
+
+	uint32 bin_count [3][BVH_BINS];
+	float bin_box [3][BVH_BINS][6];
+	for (k = 0; k < 3; k++)
+		for (j = 0; j < n_bins; j++) {
+			bin_count [k][j] = 0;
+			box_empty (bin_box [k][j], bin_box [k][j] + 3);
+		}
+	for (i = first; i < first + count; i++) {
+		const BvhRef *r = refs + i;
+		for (k = 0; k < 3; k++) {
+			int bin = (int) ((r->centroid [k] - clo[k]) * scale [k]);
+			if (bin >= n_bins)
+				bin = n_bins - 1;
+			bin_count [k][bin]++;
+			box_add (bin_box [k][bin], bin_box [k][bin] + 3, r->lo, r->hi);
+		}
+	}
+
+	//----------------------------------------
+	// The cost of a leaf is its faces; that
+	// of a split, one box test plus the faces
+	// of each side times the chance of going
+	// there, its share of the node's area.
+	//
+	float parent_area = box_area (node->lo, node->hi);
+	if (parent_area <= 0.f)
+		parent_area = 1.f;
+	float best_cost = count;
+	int best_axis = -1, best_bin = 0;
+	for (k = 0; k < 3; k++) {
+		if (scale [k] == 0.f)
+			continue;
+
+		float left_area [BVH_BINS];
+		uint32 left_count [BVH_BINS];
+		float box [6];
+		uint32 n = 0;
+		box_empty (box, box + 3);
+		for (j = 0; j < n_bins - 1; j++) {
+			n += bin_count [k][j];
+			if (bin_count [k][j])
+				box_add (box, box + 3, bin_box [k][j], bin_box [k][j] + 3);
+			left_area [j] = n ? box_area (box, box + 3) : 0.f;
+			left_count [j] = n;
+		}
+
+		n = 0;
+		box_empty (box, box + 3);
+		for (j = n_bins - 1; j > 0; j--) {
+			n += bin_count [k][j];
+			if (bin_count [k][j])
+				box_add (box, box + 3, bin_box [k][j], bin_box [k][j] + 3);
+			if (!n || !left_count [j - 1])
+				continue;
+			float cost = 1.f + (left_area [j - 1] * left_count [j - 1] +
+				box_area (box, box + 3) * n) / parent_area;
+			if (cost < best_cost || (best_axis < 0 && count > BVH_MAX_LEAF_SIZE)) {
+				best_cost = cost;
+				best_axis = k;
+				best_bin = j - 1;
+			}
+		}
+	}
+
+	uint32 mid;
+	if (best_axis >= 0) {
+		//----------------------------------------
+		// Partition about the chosen split, as
+		// the faces were binned.
+		//
+		uint32 hi_i = first + count;
+		mid = first;
+		while (mid < hi_i) {
+			int bin = (int) ((refs [mid].centroid [best_axis] - clo[best_axis]) * scale [best_axis]);
+			if (bin >= n_bins)
+				bin = n_bins - 1;
+			if (bin <= best_bin)
+				mid++;
+			else {
+				BvhRef r = refs [mid];
+				refs [mid] = refs [--hi_i];
+				refs [hi_i] = r;
+			}
+		}
+	}
+	else if (count > BVH_MAX_LEAF_SIZE)
+		mid = first + count / 2;	// The centroids coincide.
+	else
+		return false;
+
+	range_box (b, first, mid - first, left, left + 3);
+	range_box (b, mid, first + count - mid, right, right + 3);
+	*mid_return = mid;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	build_nodes
+// Purpose:	Builds the tree below node *slot of an array, depth
+//		first, putting each pair of children at the end of the
+//		array. Nodes of no more than task_faces faces, if that
+//		is nonzero, are left for build_task and listed.
+//---------------------------------------------------------------------------
+static void
+build_nodes (BvhBuild *b, BvhNode **nodes, int *n_nodes, int *max_nodes,
+	uint32 slot, uint32 first, uint32 count, int depth, uint32 task_faces)
+{
+	BvhRange stack [BVH_STACK_SIZE];
+	int sp = 0;
+
+	stack [sp].node = slot;
+	stack [sp].first = first;
+	stack [sp].count = count;
+	stack [sp++].depth = depth;
+
+	while (sp > 0) {
+		BvhRange r = stack [--sp];
+		BvhNode *node = *nodes + r.node;
+
+		if (task_faces && r.count <= task_faces && r.count > BVH_LEAF_SIZE) {
+			b->tasks = (BvhTask*) grow (b->tasks, b->n_tasks, &b->max_tasks, sizeof (BvhTask));
+			BvhTask *t = b->tasks + b->n_tasks++;
+			t->slot = r.node;
+			t->first = r.first;
+			t->count = r.count;
+			t->depth = r.depth;
+			t->nodes = NULL;
+			t->n_nodes = 0;
+			t->max_nodes = 0;
+			node->first = r.first;
+			node->count = r.count;
+			continue;
+		}
+
+		uint32 mid;
+		float left [6], right [6];
+		if (!split_range (b, node, r.first, r.count, r.depth, &mid, left, right)) {
+			node->first = r.first;
+			node->count = r.count;
+			continue;
+		}
+
+		int child = *n_nodes;
+		*nodes = (BvhNode*) grow (*nodes, child + 1, max_nodes, sizeof (BvhNode));
+		*n_nodes = child + 2;
+		node = *nodes + r.node;
+		node->first = child;
+		node->count = 0;
+
+		BvhNode *c = *nodes + child;
+		memcpy (c[0].lo, left, 6 * sizeof(float));
+		memcpy (c[1].lo, right, 6 * sizeof(float));
+
+		// The first child is popped first.
+		stack [sp].node = child + 1;
+		stack [sp].first = mid;
+		stack [sp].count = r.first + r.count - mid;
+		stack [sp++].depth = r.depth + 1;
+		stack [sp].node = child;
+		stack [sp].first = r.first;
+		stack [sp].count = mid - r.first;
+		stack [sp++].depth = r.depth + 1;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	build_task
+// Purpose:	Builds one subtree into its own array, for parallel_for.
+//		Its faces are a range that no other task touches.
+//---------------------------------------------------------------------------
+static void
+build_task (void *arg, int i)
+{
+	BvhBuild *b = (BvhBuild*) arg;
+	BvhTask *t = b->tasks + i;
+
+	t->nodes = (BvhNode*) grow (NULL, 0, &t->max_nodes, sizeof (BvhNode));
+	t->nodes [0] = b->top [t->slot];
+	t->n_nodes = 1;
+	build_nodes (b, &t->nodes, &t->n_nodes, &t->max_nodes,
+		0, t->first, t->count, t->depth, 0);
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_build
+// Purpose:	Builds a bounding volume hierarchy over a mesh's faces.
+// Returns:	The hierarchy, which does not own the mesh.
+//---------------------------------------------------------------------------
+Bvh *
+bvh_build (const FlatMesh *m)
+{
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	uint32 nf = m->n_faces;
+	uint32 f;
+	int i;
+
+	BvhBuild b;
+	memset (&b, 0, sizeof (BvhBuild));
+	b.mesh = m;
+	b.refs = (BvhRef*) malloc ((nf ? nf : 1) * sizeof (BvhRef));
+	uint32 *faces = (uint32*) malloc ((nf ? nf : 1) * sizeof(uint32));
+	if (!b.refs || !faces)
+		fatal ("Out of memory!");
+
+	parallel_for ((nf + BVH_BLOCK_SIZE - 1) / BVH_BLOCK_SIZE, face_box_block, &b);
+
+	//----------------------------------------
+	// Split the top serially, then build the
+	// subtrees in parallel.
+	//
+	if (nf) {
+		b.task_faces = nf / BVH_TASKS;
+		if (b.task_faces < BVH_MIN_TASK)
+			b.task_faces = BVH_MIN_TASK;
+		b.top = (BvhNode*) grow (NULL, 0, &b.max_top, sizeof (BvhNode));
+		range_box (&b, 0, nf, b.top[0].lo, b.top[0].hi);
+		b.n_top = 1;
+		build_nodes (&b, &b.top, &b.n_top, &b.max_top, 0, 0, nf, 0, b.task_faces);
+		parallel_for (b.n_tasks, build_task, &b);
+	}
+
+	int n_nodes = b.n_top;
+	for (i = 0; i < b.n_tasks; i++)
+		n_nodes += b.tasks [i].n_nodes - 1;
+
+	unsigned long size = sizeof (Bvh)
+		+ (unsigned long) n_nodes * sizeof (BvhNode)
+		+ (unsigned long) nf * sizeof(uint32);
+	Bvh *bvh = (Bvh*) malloc (sizeof (Bvh));
+	BvhNode *nodes = (BvhNode*) malloc ((n_nodes ? n_nodes : 1) * sizeof (BvhNode));
+	if (!bvh || !nodes)
+		fatal ("Out of memory!");
+
+	bvh->mesh = m;
+	bvh->n_nodes = n_nodes;
+	bvh->nodes = nodes;
+	bvh->faces = faces;
+	for (f = 0; f < nf; f++)
+		faces [f] = b.refs [f].face;
+	bvh->positions = m->positions;
+	bvh->moved = NULL;
+	bvh->size = size;
+	memset (bvh->matrix, 0, sizeof (bvh->matrix));
+	bvh->matrix [0] = bvh->matrix [5] = bvh->matrix [10] = 1.;
+
+	//----------------------------------------
+	// Each task's root takes its slot in the
+	// top, and the rest of its nodes follow
+	// the top, in task order.
+	//
+	if (b.n_top)
+		memcpy (nodes, b.top, b.n_top * sizeof (BvhNode));
+	int base = b.n_top;
+	for (i = 0; i < b.n_tasks; i++) {
+		BvhTask *t = b.tasks + i;
+		int j;
+		for (j = 0; j < t->n_nodes; j++) {
+			BvhNode *node = nodes + (j ? base + j - 1 : t->slot);
+			*node = t->nodes [j];
+			if (!node->count)
+				node->first += base - 1;
+		}
+		base += t->n_nodes - 1;
+		free (t->nodes);
+	}
+
+	free (b.tasks);
+	free (b.top);
+	free (b.refs);
+
+	total_allocated += size;
+	return bvh;
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_free
+//---------------------------------------------------------------------------
+void
+bvh_free (Bvh *bvh)
+{
+	if (!bvh)
+		return;
+	if (bvh->moved) {
+		total_allocated -= bvh->mesh->n_vertices * 3 * sizeof(float);
+		free (bvh->moved);
+	}
+	total_allocated -= bvh->size;
+	free (bvh->nodes);
+	free (bvh->faces);
+	free (bvh);
+}
+
+//----------------------------------------
+// Refitting.
+//
+typedef struct {
+	Bvh *bvh;
+	const double *matrix;
+} BvhRefit;
+
+//---------------------------------------------------------------------------
+// Name:	refit_vertex_block
+// Purpose:	Moves one block of vertices by the refit's matrix,
+//		for parallel_for.
+//---------------------------------------------------------------------------
+static void
+refit_vertex_block (void *arg, int block)
+{
+	BvhRefit *r = (BvhRefit*) arg;
+	const FlatMesh *m = r->bvh->mesh;
+	const double *a = r->matrix;
+	int first = block * BVH_BLOCK_SIZE;
+	int last = first + BVH_BLOCK_SIZE;
+	if (last > m->n_vertices)
+		last = m->n_vertices;
+
+	int i;
+	for (i = first; i < last; i++) {
+		const float *p = m->positions + 3 * i;
+		float *q = r->bvh->moved + 3 * i;
+		q[0] = a[0]*p[0] + a[1]*p[1] + a[2]*p[2] + a[3];
+		q[1] = a[4]*p[0] + a[5]*p[1] + a[6]*p[2] + a[7];
+		q[2] = a[8]*p[0] + a[9]*p[1] + a[10]*p[2] + a[11];
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	refit_leaf_block
+// Purpose:	Remakes the boxes of the leaves in one block of nodes,
+//		for parallel_for.
+//---------------------------------------------------------------------------
+static void
+refit_leaf_block (void *arg, int block)
+{
+	BvhRefit *r = (BvhRefit*) arg;
+	Bvh *bvh = r->bvh;
+	int first = block * BVH_BLOCK_SIZE;
+	int last = first + BVH_BLOCK_SIZE;
+	if (last > bvh->n_nodes)
+		last = bvh->n_nodes;
+
+	int i;
+	uint32 j;
+	for (i = first; i < last; i++) {
+		BvhNode *node = bvh->nodes + i;
+		if (!node->count)
+			continue;
+		box_empty (node->lo, node->hi);
+		for (j = node->first; j < node->first + node->count; j++) {
+			float lo [3], hi [3];
+			face_box (bvh->mesh, bvh->positions, bvh->faces [j], lo, hi);
+			box_add (node->lo, node->hi, lo, hi);
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_refit
+// Purpose:	Moves the hierarchy with its mesh by a rigid transform,
+//		keeping the tree and remaking only the boxes, so that
+//		queries are answered in the space that the matrix, 3
+//		rows of 4, moves the mesh's positions to. NULL returns
+//		it to the mesh's own positions. The tree stays as good
+//		as it was built only for as long as the mesh is moved
+//		rigidly.
+//---------------------------------------------------------------------------
+void
+bvh_refit (Bvh *bvh, const double *matrix)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	//----------
+
+	const FlatMesh *m = bvh->mesh;
+	BvhRefit r;
+	r.bvh = bvh;
+	r.matrix = matrix;
+
+	if (matrix) {
+		if (!bvh->moved) {
+			bvh->moved = (float*) malloc ((m->n_vertices ? m->n_vertices : 1) * 3 * sizeof(float));
+			if (!bvh->moved)
+				fatal ("Out of memory!");
+			total_allocated += m->n_vertices * 3 * sizeof(float);
+		}
+		parallel_for ((m->n_vertices + BVH_BLOCK_SIZE - 1) / BVH_BLOCK_SIZE,
+			refit_vertex_block, &r);
+		bvh->positions = bvh->moved;
+		memcpy (bvh->matrix, matrix, sizeof (bvh->matrix));
+	} else {
+		if (bvh->moved) {
+			total_allocated -= m->n_vertices * 3 * sizeof(float);
+			free (bvh->moved);
+			bvh->moved = NULL;
+		}
+		bvh->positions = m->positions;
+		memset (bvh->matrix, 0, sizeof (bvh->matrix));
+		bvh->matrix [0] = bvh->matrix [5] = bvh->matrix [10] = 1.;
+	}
+
+	parallel_for ((bvh->n_nodes + BVH_BLOCK_SIZE - 1) / BVH_BLOCK_SIZE,
+		refit_leaf_block, &r);
+
+	// Children come after their parents.
+	int i;
+	for (i = bvh->n_nodes - 1; i >= 0; i--) {
+		BvhNode *node = bvh->nodes + i;
+		if (node->count)
+			continue;
+		const BvhNode *c = bvh->nodes + node->first;
+		memcpy (node->lo, c[0].lo, 6 * sizeof(float));
+		box_add (node->lo, node->hi, c[1].lo, c[1].hi);
+	}
+}
+
+//----------------------------------------
+// Queries.
+//
+
+//---------------------------------------------------------------------------
+// Name:	triangle_distance2
+// Purpose:	Finds the closest point of a triangle to p, by the
+//		regions of the triangle's plane (Ericson, Real-Time
+//		Collision Detection, 5.1.5).
+// Returns:	The squared distance to it, and the point itself
+//		if closest_return is not NULL.
+//---------------------------------------------------------------------------
+double
+triangle_distance2 (const double *p, const float *a, const float *b, const float *c,
+	double *closest_return)
+{
+	double ab [3], ac [3], ap [3], q [3];
+	int k;
+	for (k = 0; k < 3; k++) {
+		ab [k] = b [k] - a [k];
+		ac [k] = c [k] - a [k];
+		ap [k] = p [k] - a [k];
+	}
+	double d1 = ab[0]*ap[0] + ab[1]*ap[1] + ab[2]*ap[2];
+	double d2 = ac[0]*ap[0] + ac[1]*ap[1] + ac[2]*ap[2];
+
+	double bp [3], cp [3];
+	for (k = 0; k < 3; k++) {
+		bp [k] = p [k] - b [k];
+		cp [k] = p [k] - c [k];
+	}
+	double d3 = ab[0]*bp[0] + ab[1]*bp[1] + ab[2]*bp[2];
+	double d4 = ac[0]*bp[0] + ac[1]*bp[1] + ac[2]*bp[2];
+	double d5 = ab[0]*cp[0] + ab[1]*cp[1] + ab[2]*cp[2];
+	double d6 = ac[0]*cp[0] + ac[1]*cp[1] + ac[2]*cp[2];
+
+	double va = d3*d6 - d5*d4;
+	double vb = d5*d2 - d1*d6;
+	double vc = d1*d4 - d3*d2;
+
+	if (d1 <= 0. && d2 <= 0.)
+		for (k = 0; k < 3; k++) q [k] = a [k];
+	else if (d3 >= 0. && d4 <= d3)
+		for (k = 0; k < 3; k++) q [k] = b [k];
+	else if (d6 >= 0. && d5 <= d6)
+		for (k = 0; k < 3; k++) q [k] = c [k];
+	else if (vc <= 0. && d1 >= 0. && d3 <= 0.) {
+		double t = d1 / (d1 - d3);
+		for (k = 0; k < 3; k++) q [k] = a [k] + t * ab [k];
+	}
+	else if (vb <= 0. && d2 >= 0. && d6 <= 0.) {
+		double t = d2 / (d2 - d6);
+		for (k = 0; k < 3; k++) q [k] = a [k] + t * ac [k];
+	}
+	else if (va <= 0. && d4 - d3 >= 0. && d5 - d6 >= 0.) {
+		double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+		for (k = 0; k < 3; k++) q [k] = b [k] + t * (c [k] - b [k]);
+	}
+	else {
+		double sum = va + vb + vc;
+		double v = sum != 0. ? vb / sum : 0.;
+		double w = sum != 0. ? vc / sum : 0.;
+		for (k = 0; k < 3; k++) q [k] = a [k] + v * ab [k] + w * ac [k];
+	}
+
+	if (closest_return)
+		for (k = 0; k < 3; k++) closest_return [k] = q [k];
+
+	double x = p[0] - q[0], y = p[1] - q[1], z = p[2] - q[2];
+	return x*x + y*y + z*z;
+}
+
+//---------------------------------------------------------------------------
+// Name:	box_distance2
+// Returns:	The squared distance from a point to a node's box.
+//---------------------------------------------------------------------------
+static inline double
+box_distance2 (const BvhNode *node, const double *p)
+{
+	double sum = 0.;
+	int k;
+	for (k = 0; k < 3; k++) {
+		double below = node->lo[k] - p[k];
+		double above = p[k] - node->hi[k];
+		double d = below > above ? below : above;
+		d = d > 0. ? d : 0.;
+		sum += d * d;
+	}
+	return sum;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ray_box
+// Purpose:	Clips a ray to a node's box by the slab method.
+// Returns:	The t at which the ray enters the box, or -1 if it
+//		misses it within [0, max_t].
+//---------------------------------------------------------------------------
+static inline double
+ray_box (const BvhNode *node, const double *origin, const double *inverse, double max_t)
+{
+	double t0 = 0., t1 = max_t;
+	int k;
+	for (k = 0; k < 3; k++) {
+		double a = (node->lo[k] - origin[k]) * inverse[k];
+		double b = (node->hi[k] - origin[k]) * inverse[k];
+		if (a > b) {
+			double t = a; a = b; b = t;
+		}
+		// NaN, from 0 * infinity, is ignored.
+		if (a > t0) t0 = a;
+		if (b < t1) t1 = b;
+		if (t0 > t1)
+			return -1.;
+	}
+	return t0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	triangle_ray
+// Purpose:	Intersects a ray with a face, by Moller and Trumbore's
+//		method. Faces are hit from either side.
+// Returns:	True if the ray meets the face at some t in (0, *t),
+//		with *t, *u and *v set.
+//---------------------------------------------------------------------------
+bool
+triangle_ray (const double *origin, const double *direction,
+	const float *a, const float *b, const float *c, double *t, double *u, double *v)
+{
+	double e1 [3], e2 [3], s [3];
+	int k;
+	for (k = 0; k < 3; k++) {
+		e1 [k] = b[k] - a[k];
+		e2 [k] = c[k] - a[k];
+		s [k] = origin[k] - a[k];
+	}
+	double p [3] = {
+		direction[1]*e2[2] - direction[2]*e2[1],
+		direction[2]*e2[0] - direction[0]*e2[2],
+		direction[0]*e2[1] - direction[1]*e2[0]
+	};
+	double det = e1[0]*p[0] + e1[1]*p[1] + e1[2]*p[2];
+	if (det == 0.)
+		return false;
+	double inv = 1. / det;
+	double uu = (s[0]*p[0] + s[1]*p[1] + s[2]*p[2]) * inv;
+	if (uu < 0. || uu > 1.)
+		return false;
+	double q [3] = {
+		s[1]*e1[2] - s[2]*e1[1],
+		s[2]*e1[0] - s[0]*e1[2],
+		s[0]*e1[1] - s[1]*e1[0]
+	};
+	double vv = (direction[0]*q[0] + direction[1]*q[1] + direction[2]*q[2]) * inv;
+	if (vv < 0. || uu + vv > 1.)
+		return false;
+	double tt = (e2[0]*q[0] + e2[1]*q[1] + e2[2]*q[2]) * inv;
+	if (tt <= 0. || tt >= *t)
+		return false;
+	*t = tt;
+	*u = uu;
+	*v = vv;
+	return true;
+}
+
+static inline void
+face_corners (const Bvh *bvh, uint32 f, const float **a, const float **b, const float **c)
+{
+	const uint32 *v = flat_face (bvh->mesh, f);
+	*a = bvh->positions + 3 * v[0];
+	*b = bvh->positions + 3 * v[1];
+	*c = bvh->positions + 3 * v[2];
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_ray
+// Purpose:	Finds the first face that a ray meets, opening the
+//		nearer child first and skipping boxes beyond the
+//		nearest hit so far. The direction need not be a unit.
+// Returns:	True if one is met before max_t, with the hit.
+//---------------------------------------------------------------------------
+bool
+bvh_ray (const Bvh *bvh, const double *origin, const double *direction,
+	double max_t, BvhHit *hit_return)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	//----------
+
+	if (!bvh->n_nodes)
+		return false;
+
+	double inverse [3];
+	int k;
+	for (k = 0; k < 3; k++)
+		inverse [k] = 1. / direction[k];
+
+	BvhHit hit;
+	hit.face = -1;
+	hit.t = max_t;
+	hit.u = hit.v = 0.;
+
+	if (ray_box (bvh->nodes, origin, inverse, hit.t) < 0.)
+		return false;
+
+	uint32 stack [BVH_STACK_SIZE];
+	int sp = 0;
+	stack [sp++] = 0;
+	while (sp > 0) {
+		const BvhNode *node = bvh->nodes + stack [--sp];
+		if (node->count) {
+			uint32 i;
+			for (i = node->first; i < node->first + node->count; i++) {
+				const float *a, *b, *c;
+				uint32 f = bvh->faces [i];
+				face_corners (bvh, f, &a, &b, &c);
+				if (triangle_ray (origin, direction, a, b, c, &hit.t, &hit.u, &hit.v))
+					hit.face = f;
+			}
+			continue;
+		}
+
+		uint32 near = node->first, far = node->first + 1;
+		double t_near = ray_box (bvh->nodes + near, origin, inverse, hit.t);
+		double t_far = ray_box (bvh->nodes + far, origin, inverse, hit.t);
+		if (t_far >= 0. && (t_near < 0. || t_far < t_near)) {
+			uint32 n = near; near = far; far = n;
+			double t = t_near; t_near = t_far; t_far = t;
+		}
+		if (t_far >= 0.)
+			stack [sp++] = far;
+		if (t_near >= 0.)
+			stack [sp++] = near;
+	}
+
+	if (hit.face < 0)
+		return false;
+	if (hit_return)
+		*hit_return = hit;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_closest
+// Purpose:	Finds the closest point of the mesh to a point, opening
+//		the nearer child first and skipping boxes farther than
+//		the best so far.
+// Returns:	The distance to it, or max_distance if no face is
+//		nearer than that, in which case the face is -1.
+//---------------------------------------------------------------------------
+double
+bvh_closest (const Bvh *bvh, const double *point, double max_distance,
+	int *face_return, double *closest_return)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	//----------
+
+	double best = max_distance * max_distance;
+	int best_face = -1;
+
+	uint32 stack [BVH_STACK_SIZE];
+	int sp = 0;
+	if (bvh->n_nodes && box_distance2 (bvh->nodes, point) < best)
+		stack [sp++] = 0;
+
+	while (sp > 0) {
+		const BvhNode *node = bvh->nodes + stack [--sp];
+		if (box_distance2 (node, point) >= best)
+			continue;
+		if (node->count) {
+			uint32 i;
+			for (i = node->first; i < node->first + node->count; i++) {
+				const float *a, *b, *c;
+				uint32 f = bvh->faces [i];
+				face_corners (bvh, f, &a, &b, &c);
+				double q [3];
+				double d2 = triangle_distance2 (point, a, b, c, q);
+				if (d2 < best) {
+					best = d2;
+					best_face = f;
+					if (closest_return)
+						memcpy (closest_return, q, sizeof (q));
+				}
+			}
+			continue;
+		}
+
+		uint32 near = node->first, far = node->first + 1;
+		double d_near = box_distance2 (bvh->nodes + near, point);
+		double d_far = box_distance2 (bvh->nodes + far, point);
+		if (d_far < d_near) {
+			uint32 n = near; near = far; far = n;
+			double d = d_near; d_near = d_far; d_far = d;
+		}
+		if (d_far < best)
+			stack [sp++] = far;
+		if (d_near < best)
+			stack [sp++] = near;
+	}
+
+	if (face_return)
+		*face_return = best_face;
+	return best_face < 0 ? max_distance : sqrt (best);
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_nearest
+// Purpose:	Finds the k faces nearest to a point, keeping the best
+//		so far in a heap with the farthest on top, and skipping
+//		boxes farther than that once there are k.
+// Returns:	How many were found, at most k, nearest first in faces
+//		and their distances in distances, which may be NULL.
+//---------------------------------------------------------------------------
+int
+bvh_nearest (const Bvh *bvh, const double *point, int k, int *faces, double *distances)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	ASSERT_NONZERO (faces,"faces")
+	//----------
+
+	if (k <= 0 || !bvh->n_nodes)
+		return 0;
+
+	double *heap = (double*) malloc (k * sizeof(double));
+	if (!heap)
+		fatal ("Out of memory!");
+	int n = 0;
+
+	uint32 stack [BVH_STACK_SIZE];
+	int sp = 0;
+	stack [sp++] = 0;
+	while (sp > 0) {
+		const BvhNode *node = bvh->nodes + stack [--sp];
+		double bound = n == k ? heap [0] : HUGE_VAL;
+		if (box_distance2 (node, point) >= bound)
+			continue;
+
+		if (!node->count) {
+			uint32 near = node->first, far = node->first + 1;
+			if (box_distance2 (bvh->nodes + far, point) <
+			    box_distance2 (bvh->nodes + near, point)) {
+				near = far;
+				far = node->first;
+			}
+			stack [sp++] = far;
+			stack [sp++] = near;
+			continue;
+		}
+
+		uint32 i;
+		for (i = node->first; i < node->first + node->count; i++) {
+			const float *a, *b, *c;
+			int f = bvh->faces [i];
+			face_corners (bvh, f, &a, &b, &c);
+			double d2 = triangle_distance2 (point, a, b, c, NULL);
+
+			//----------------------------------------
+			// Sift up a new entry, or down one that
+			// replaces the farthest.
+			//
+			int j;
+			if (n < k) {
+				j = n++;
+				while (j > 0 && heap [(j - 1) / 2] < d2) {
+					heap [j] = heap [(j - 1) / 2];
+					faces [j] = faces [(j - 1) / 2];
+					j = (j - 1) / 2;
+				}
+			}
+			else if (d2 < heap [0]) {
+				j = 0;
+				for (;;) {
+					int child = 2 * j + 1;
+					if (child >= n)
+						break;
+					if (child + 1 < n && heap [child + 1] > heap [child])
+						child++;
+					if (heap [child] <= d2)
+						break;
+					heap [j] = heap [child];
+					faces [j] = faces [child];
+					j = child;
+				}
+			}
+			else
+				continue;
+			heap [j] = d2;
+			faces [j] = f;
+		}
+	}
+
+	//----------------------------------------
+	// Sort nearest first: n is small.
+	//
+	int i, j;
+	for (i = 1; i < n; i++) {
+		double d2 = heap [i];
+		int f = faces [i];
+		for (j = i; j > 0 && (heap [j - 1] > d2 || (heap [j - 1] == d2 && faces [j - 1] > f)); j--) {
+			heap [j] = heap [j - 1];
+			faces [j] = faces [j - 1];
+		}
+		heap [j] = d2;
+		faces [j] = f;
+	}
+	if (distances)
+		for (i = 0; i < n; i++)
+			distances [i] = sqrt (heap [i]);
+
+	free (heap);
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	triangle_box
+// Purpose:	Tests a face against a box, given by its center and
+//		half its size, by separating axes: those of the box,
+//		the face's normal, and the nine crossings of the box's
+//		axes with the face's edges (Akenine-Moller).
+//---------------------------------------------------------------------------
+bool
+triangle_box (const double *center, const double *half,
+	const float *a, const float *b, const float *c)
+{
+	double v [3][3], e [3][3];
+	int i, k;
+	for (k = 0; k < 3; k++) {
+		v[0][k] = a[k] - center[k];
+		v[1][k] = b[k] - center[k];
+		v[2][k] = c[k] - center[k];
+	}
+	for (k = 0; k < 3; k++) {
+		e[0][k] = v[1][k] - v[0][k];
+		e[1][k] = v[2][k] - v[1][k];
+		e[2][k] = v[0][k] - v[2][k];
+	}
+
+	//----------------------------------------
+	// Edge crossings: axis (box k) x (edge i).
+	//
+	for (i = 0; i < 3; i++) {
+		for (k = 0; k < 3; k++) {
+			int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+			double axis [3];
+			axis [k] = 0.;
+			axis [k1] = -e[i][k2];
+			axis [k2] = e[i][k1];
+			double p0 = axis[k1]*v[0][k1] + axis[k2]*v[0][k2];
+			double p1 = axis[k1]*v[1][k1] + axis[k2]*v[1][k2];
+			double p2 = axis[k1]*v[2][k1] + axis[k2]*v[2][k2];
+			double lo = p0 < p1 ? p0 : p1, hi = p0 < p1 ? p1 : p0;
+			if (p2 < lo) lo = p2;
+			if (p2 > hi) hi = p2;
+			double r = half[k1] * fabs (axis[k1]) + half[k2] * fabs (axis[k2]);
+			if (lo > r || hi < -r)
+				return false;
+		}
+	}
+
+	for (k = 0; k < 3; k++) {
+		double lo = v[0][k], hi = v[0][k];
+		for (i = 1; i < 3; i++) {
+			if (v[i][k] < lo) lo = v[i][k];
+			if (v[i][k] > hi) hi = v[i][k];
+		}
+		if (lo > half[k] || hi < -half[k])
+			return false;
+	}
+
+	double n [3] = {
+		e[0][1]*e[1][2] - e[0][2]*e[1][1],
+		e[0][2]*e[1][0] - e[0][0]*e[1][2],
+		e[0][0]*e[1][1] - e[0][1]*e[1][0]
+	};
+	double d = n[0]*v[0][0] + n[1]*v[0][1] + n[2]*v[0][2];
+	double r = half[0] * fabs (n[0]) + half[1] * fabs (n[1]) + half[2] * fabs (n[2]);
+	return fabs (d) <= r;
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_box
+// Purpose:	Finds the faces that overlap a box.
+// Returns:	How many there are. The first max of them are put in
+//		faces, in the order of the tree.
+//---------------------------------------------------------------------------
+int
+bvh_box (const Bvh *bvh, const double *lo, const double *hi, int *faces, int max)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	//----------
+
+	double center [3], half [3];
+	int k, n = 0;
+	for (k = 0; k < 3; k++) {
+		center [k] = 0.5 * (lo[k] + hi[k]);
+		half [k] = 0.5 * (hi[k] - lo[k]);
+	}
+
+	uint32 stack [BVH_STACK_SIZE];
+	int sp = 0;
+	if (bvh->n_nodes)
+		stack [sp++] = 0;
+	while (sp > 0) {
+		const BvhNode *node = bvh->nodes + stack [--sp];
+		for (k = 0; k < 3; k++)
+			if (node->lo[k] > hi[k] || node->hi[k] < lo[k])
+				break;
+		if (k < 3)
+			continue;
+
+		if (!node->count) {
+			stack [sp++] = node->first + 1;
+			stack [sp++] = node->first;
+			continue;
+		}
+
+		uint32 i;
+		for (i = node->first; i < node->first + node->count; i++) {
+			const float *a, *b, *c;
+			int f = bvh->faces [i];
+			face_corners (bvh, f, &a, &b, &c);
+			if (triangle_box (center, half, a, b, c)) {
+				if (n < max && faces)
+					faces [n] = f;
+				n++;
+			}
+		}
+	}
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	bvh_plane
+// Purpose:	Finds the faces that a plane cuts or touches, the plane
+//		being the points x with normal . x = offset.
+// Returns:	How many there are. The first max of them are put in
+//		faces, in the order of the tree.
+//---------------------------------------------------------------------------
+int
+bvh_plane (const Bvh *bvh, const double *normal, double offset, int *faces, int max)
+{
+	ASSERT_NONZERO (bvh,"bvh")
+	//----------
+
+	int n = 0;
+	uint32 stack [BVH_STACK_SIZE];
+	int sp = 0;
+	if (bvh->n_nodes)
+		stack [sp++] = 0;
+	while (sp > 0) {
+		const BvhNode *node = bvh->nodes + stack [--sp];
+
+		// The box's corners nearest and farthest along the normal.
+		double lo = -offset, hi = -offset;
+		int k;
+		for (k = 0; k < 3; k++) {
+			if (normal[k] >= 0.) {
+				lo += normal[k] * node->lo[k];
+				hi += normal[k] * node->hi[k];
+			} else {
+				lo += normal[k] * node->hi[k];
+				hi += normal[k] * node->lo[k];
+			}
+		}
+		if (lo > 0. || hi < 0.)
+			continue;
+
+		if (!node->count) {
+			stack [sp++] = node->first + 1;
+			stack [sp++] = node->first;
+			continue;
+		}
+
+		uint32 i;
+		for (i = node->first; i < node->first + node->count; i++) {
+			const float *a, *b, *c;
+			int f = bvh->faces [i];
+			face_corners (bvh, f, &a, &b, &c);
+			double da = normal[0]*a[0] + normal[1]*a[1] + normal[2]*a[2] - offset;
+			double db = normal[0]*b[0] + normal[1]*b[1] + normal[2]*b[2] - offset;
+			double dc = normal[0]*c[0] + normal[1]*c[1] + normal[2]*c[2] - offset;
+			if ((da > 0. && db > 0. && dc > 0.) || (da < 0. && db < 0. && dc < 0.))
+				continue;
+			if (n < max && faces)
+				faces [n] = f;
+			n++;
+		}
+	}
+	return n;
+}
+
+//----------------------------------------
+// Per mesh.
+//
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_bvh
+// Purpose:	Gives the mesh's hierarchy, building it on first use.
+//		It is freed with the mesh.
+//---------------------------------------------------------------------------
+Bvh *
+flatmesh_bvh (FlatMesh *m)
+{
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	if (!m->bvh)
+		m->bvh = bvh_build (m);
+	return m->bvh;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_drop_bvh
+//---------------------------------------------------------------------------
+void
+flatmesh_drop_bvh (FlatMesh *m)
+{
+	if (m->bvh) {
+		bvh_free (m->bvh);
+		m->bvh = NULL;
+	}
+}
+
+//----------------------------------------
+// Transforms, as 3 rows of 4.
+//
+
+static void
+matrix_identity (double *m)
+{
+	memset (m, 0, 12 * sizeof(double));
+	m[0] = m[5] = m[10] = 1.;
+}
+
+//---------------------------------------------------------------------------
+// Name:	matrix_multiply
+// Purpose:	Sets c to a times b, as affine transforms: b first.
+//		c may be a or b.
+//---------------------------------------------------------------------------
+static void
+matrix_multiply (const double *a, const double *b, double *c)
+{
+	double r [12];
+	int i, j;
+	for (i = 0; i < 3; i++) {
+		for (j = 0; j < 4; j++)
+			r [4*i + j] = a [4*i] * b [j] + a [4*i + 1] * b [4 + j] +
+				a [4*i + 2] * b [8 + j];
+		r [4*i + 3] += a [4*i + 3];
+	}
+	memcpy (c, r, sizeof (r));
+}
+
+//---------------------------------------------------------------------------
+// Name:	matrix_rotation
+// Purpose:	Makes the rotation by an angle in radians about an
+//		axis, which need not be a unit, as glRotate does.
+//---------------------------------------------------------------------------
+static void
+matrix_rotation (double *m, double x, double y, double z, double angle)
+{
+	matrix_identity (m);
+	double length = sqrt (x*x + y*y + z*z);
+	if (length == 0. || angle == 0.)
+		return;
+	x /= length;
+	y /= length;
+	z /= length;
+	double c = cos (angle), s = sin (angle), t = 1. - c;
+	m[0] = t*x*x + c;	m[1] = t*x*y - s*z;	m[2] = t*x*z + s*y;
+	m[4] = t*x*y + s*z;	m[5] = t*y*y + c;	m[6] = t*y*z - s*x;
+	m[8] = t*x*z - s*y;	m[9] = t*y*z + s*x;	m[10] = t*z*z + c;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Transform::get_matrix
+// Purpose:	Gives the transform as 3 rows of 4. express gives the
+//		last operation to OpenGL first, so the first operation
+//		is the first applied to a point.
+//---------------------------------------------------------------------------
+void
+Transform::get_matrix (double *matrix)
+{
+	ASSERT_NONZERO (matrix,"matrix")
+	//----------
+
+	matrix_identity (matrix);
+
+	int i;
+	for (i = 0; i < op_index; i++) {
+		double op [12];
+		matrix_identity (op);
+		switch (operations [i]) {
+		case ROTATE:
+			matrix_rotation (op, rotate_x, rotate_y, rotate_z, rotate_angle);
+			break;
+		case ROTATE2:
+			matrix_rotation (op, second_rotate_x, second_rotate_y, second_rotate_z,
+				second_rotate_angle);
+			break;
+		case SCALE:
+			op[0] = scale_x;
+			op[5] = scale_y;
+			op[10] = scale_z;
+			break;
+		case TRANSLATE:
+			op[3] = translate_x;
+			op[7] = translate_y;
+			op[11] = translate_z;
+			break;
+		case TRANSLATE2:
+			op[3] = second_translate_x;
+			op[7] = second_translate_y;
+			op[11] = second_translate_z;
+			break;
+		}
+		matrix_multiply (op, matrix, matrix);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	Model::face_set_matrix
+// Purpose:	Finds the Transforms above a face set and multiplies
+//		them out.
+// Returns:	False if the face set is not in the Model, in which
+//		case the matrix is the identity.
+//---------------------------------------------------------------------------
+bool
+Model::face_set_matrix (IndexedFaceSet *ifs, double *matrix)
+{
+	ASSERT_NONZERO (ifs,"face set")
+	ASSERT_NONZERO (matrix,"matrix")
+	//----------
+
+	matrix_identity (matrix);
+	if (face_set_matrix_core (nodes, ifs, matrix))
+		return true;
+	matrix_identity (matrix);
+	return false;
+}
+
+bool
+Model::face_set_matrix_core (Node *n, IndexedFaceSet *ifs, double *matrix)
+{
+	for (; n; n = n->next) {
+		if (n == (Node*) ifs)
+			return true;
+		if (!n->children)
+			continue;
+
+		double m [12];
+		memcpy (m, matrix, sizeof (m));
+		if (!strcmp (n->type, "Transform")) {
+			double local [12];
+			((Transform*) n)->get_matrix (local);
+			matrix_multiply (m, local, m);
+		}
+		if (face_set_matrix_core (n->children, ifs, m)) {
+			memcpy (matrix, m, sizeof (m));
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,92 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _BVH_H
+#define _BVH_H
+
+#define BVH_LEAF_SIZE (4)	// Faces below which a node is not split.
+#define BVH_MAX_LEAF_SIZE (16)	// Faces above which a node is always split.
+#define BVH_BINS (16)		// Per axis, for the surface area heuristic.
+
+/*===========================================================================
+ * Name:	BvhNode
+ * Purpose:	A box of a bounding volume hierarchy. An inner node's
+ *		two children are nodes first and first+1, which come
+ *		after it; a leaf has count faces, from faces[first].
+ */
+typedef struct {
+	float lo [3];
+	float hi [3];
+	uint32 first;
+	uint32 count;		// 0 for an inner node.
+} BvhNode;
+
+/*===========================================================================
+ * Name:	Bvh
+ * Purpose:	A bounding volume hierarchy over the faces of a FlatMesh,
+ *		built by the surface area heuristic. Node 0 is the root.
+ *		After bvh_refit with a matrix, the boxes and the queries
+ *		are in the space that it moves the mesh to.
+ */
+typedef struct Bvh {
+	const FlatMesh *mesh;
+	int n_nodes;
+	BvhNode *nodes;
+	uint32 *faces;		// Face numbers, in the order of the leaves.
+	const float *positions;	// The mesh's, or moved after a refit.
+	float *moved;		// Owned copy of the positions, if moved.
+	double matrix [12];	// Of the refit: 3 rows of 4.
+	unsigned long size;
+} Bvh;
+
+/*===========================================================================
+ * Name:	BvhHit
+ * Purpose:	Where a ray meets a face: at origin + t * direction,
+ *		and at (1-u-v) p1 + u p2 + v p3 on the face.
+ */
+typedef struct {
+	int face;
+	double t, u, v;
+} BvhHit;
+
+extern Bvh *bvh_build (const FlatMesh *);
+extern void bvh_free (Bvh *);
+extern void bvh_refit (Bvh *, const double *matrix);
+
+extern bool bvh_ray (const Bvh *, const double *origin, const double *direction,
+	double max_t, BvhHit *hit_return);
+extern double bvh_closest (const Bvh *, const double *point, double max_distance,
+	int *face_return, double *closest_return);
+extern int bvh_nearest (const Bvh *, const double *point, int k,
+	int *faces, double *distances);
+extern int bvh_box (const Bvh *, const double *lo, const double *hi, int *faces, int max);
+extern int bvh_plane (const Bvh *, const double *normal, double offset, int *faces, int max);
+
+extern double triangle_distance2 (const double *p, const float *a, const float *b,
+	const float *c, double *closest_return);
+extern bool triangle_ray (const double *origin, const double *direction,
+	const float *a, const float *b, const float *c, double *t, double *u, double *v);
+extern bool triangle_box (const double *center, const double *half,
+	const float *a, const float *b, const float *c);
+
+extern Bvh *flatmesh_bvh (FlatMesh *);
+extern void flatmesh_drop_bvh (FlatMesh *);
+
+#endif
@@ -0,0 +1,1623 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+//----------------------------------------------------------------------------
+// The mesh cache is a binary copy of the Model parsed from a VRML file,
+// kept in the user's cache directory so that the next load of the same
+// file needs neither the tokenizer nor the parser.
+//
+// All values are little-endian. The file begins with a fixed header:
+//
+//	"MXMC", version, source size, source time, source hash,
+//	body size, body hash
+//
+// The body holds the source path, the Model's own fields (title,
+// background, viewpoint, patient data), its node tree in depth-first
+// order and finally its list of names. Each node is numbered in the
+// order it is written, so that USE and names can refer to it.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+	#include <sys/types.h>
+	#include <sys/stat.h>
+#else
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "cache.h"
+
+bool using_mesh_cache = true;
+
+// Increment whenever the layout below or the parser's output changes.
+#define MESH_CACHE_VERSION (3)
+
+#define MESH_CACHE_MAGIC "MXMC"
+#define MESH_CACHE_HEADERSIZE (48)
+#define MESH_CACHE_BUFFERSIZE (64*1024)	// Must be a multiple of 8.
+#define MESH_CACHE_NULL_STRING (0xffffffff)
+#define MESH_CACHE_NO_NODE (0xffffffff)
+
+#define CACHE_HASH_MULTIPLIER ((((uint64) 0x9e3779b9) << 32) | 0x7f4a7c15)
+
+// Node records.
+enum {
+	CACHE_END = 0,		// Ends a list of siblings.
+	CACHE_GROUP,
+	CACHE_SEPARATOR,
+	CACHE_TRANSFORM,
+	CACHE_SWITCH,
+	CACHE_SHAPE,
+	CACHE_INDEXEDFACESET,
+	CACHE_INDEXEDLINESET,
+	CACHE_TEXT,
+	CACHE_SPHERE,
+	CACHE_BOX,
+	CACHE_CONE,
+	CACHE_CYLINDER,
+	CACHE_REPLICATED,
+};
+
+// How a Shape record gives its Appearance.
+enum {
+	CACHE_NO_APPEARANCE = 0,
+	CACHE_SHARED_APPEARANCE,	// Number of an earlier Appearance.
+	CACHE_NEW_APPEARANCE,		// Appearance record follows.
+};
+
+// Model flags.
+#define CACHE_BACKGROUND_PROVIDED (1)
+#define CACHE_TOP_AND_BOTTOM_ALIGNED (2)
+
+//---------------------------------------------------------------------------
+// Name:	cache_hash
+// Purpose:	Continues a 64-bit hash over a block of bytes. A long
+//		run may be hashed piecewise provided that every piece
+//		but the last is a multiple of 8 bytes long.
+//---------------------------------------------------------------------------
+static uint64
+cache_hash (uint64 h, const unsigned char *p, unsigned long n)
+{
+	while (n >= 8) {
+		uint64 word;
+		memcpy (&word, p, 8);
+		h = (h ^ word) * CACHE_HASH_MULTIPLIER;
+		h ^= h >> 29;
+		p += 8;
+		n -= 8;
+	}
+	while (n--) {
+		h = (h ^ *p++) * CACHE_HASH_MULTIPLIER;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+//---------------------------------------------------------------------------
+// Name:	encode_u32, encode_u64, decode_u32, decode_u64
+// Purpose:	Converts to and from little-endian bytes.
+//---------------------------------------------------------------------------
+void
+encode_u32 (unsigned char *p, uint32 value)
+{
+	p[0] = (unsigned char) value;
+	p[1] = (unsigned char) (value >> 8);
+	p[2] = (unsigned char) (value >> 16);
+	p[3] = (unsigned char) (value >> 24);
+}
+
+void
+encode_u64 (unsigned char *p, uint64 value)
+{
+	encode_u32 (p, (uint32) value);
+	encode_u32 (p + 4, (uint32) (value >> 32));
+}
+
+uint32
+decode_u32 (const unsigned char *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32) p[3] << 24);
+}
+
+uint64
+decode_u64 (const unsigned char *p)
+{
+	return decode_u32 (p) | ((uint64) decode_u32 (p + 4) << 32);
+}
+
+//---------------------------------------------------------------------------
+// Name:	source_identity
+// Purpose:	Gets the size and modification time of a source file.
+// Returns:	False if the file cannot be examined.
+//---------------------------------------------------------------------------
+bool
+source_identity (const char *path, uint64 &size_return, int64 &time_return)
+{
+#ifdef WIN32
+	struct _stat64 st;
+	if (_stat64 (path, &st))
+		return false;
+#else
+	struct stat st;
+	if (stat (path, &st))
+		return false;
+#endif
+	size_return = (uint64) st.st_size;
+	time_return = (int64) st.st_mtime;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	source_hash
+// Purpose:	Hashes the contents of a source file, as stored on disk.
+// Returns:	False if the file cannot be read, or if *cancel was set.
+//---------------------------------------------------------------------------
+static bool
+source_hash (const char *path, uint64 &hash_return, volatile bool *cancel)
+{
+	FILE *f = fopen (path, "rb");
+	if (!f)
+		return false;
+
+	unsigned long size = 16 * MESH_CACHE_BUFFERSIZE;
+	unsigned char *buffer = (unsigned char*) malloc (size);
+	if (!buffer)
+		fatal ("Out of memory!");
+
+	uint64 h = CACHE_HASH_MULTIPLIER;
+	unsigned long n;
+	bool ok = true;
+	while ((n = (unsigned long) fread (buffer, 1, size, f)) > 0) {
+		h = cache_hash (h, buffer, n);
+		if (cancel && *cancel) {
+			ok = false;
+			break;
+		}
+	}
+
+	if (ferror (f))
+		ok = false;
+	fclose (f);
+	free (buffer);
+
+	hash_return = h;
+	return ok;
+}
+
+//---------------------------------------------------------------------------
+// Name:	cache_path
+// Purpose:	Finds a cache file for a source file. Its name is a
+//		hash of the source's full path plus the extension; the
+//		directory is made if necessary.
+// Returns:	False if there is no cache directory.
+//---------------------------------------------------------------------------
+bool
+cache_path (const char *source, const char *extension, char *path_return, char *full_source_return)
+{
+	char dir [PATH_MAX];
+	char *base;
+
+#ifdef WIN32
+	if (!_fullpath (full_source_return, source, PATH_MAX))
+		return false;
+
+	base = getenv ("LOCALAPPDATA");
+	if (!base)
+		base = getenv ("APPDATA");	// Windows XP
+	if (!base || strlen (base) + 40 >= PATH_MAX)
+		return false;
+	sprintf (dir, "%s\\maxilla", base);
+	CreateDirectoryA (dir, NULL);
+	strcat (dir, "\\");
+#else
+	if (!realpath (source, full_source_return))
+		return false;
+
+	base = getenv ("HOME");
+	if (!base || strlen (base) + 40 >= PATH_MAX)
+		return false;
+#ifdef __APPLE__
+	sprintf (dir, "%s/Library/Caches/maxilla", base);
+#else
+	char *xdg = getenv ("XDG_CACHE_HOME");
+	if (xdg && *xdg == '/' && strlen (xdg) + 40 < PATH_MAX)
+		strcpy (dir, xdg);
+	else
+		sprintf (dir, "%s/.cache", base);
+	mkdir (dir, 0755);
+	strcat (dir, "/maxilla");
+#endif
+	mkdir (dir, 0755);
+	strcat (dir, "/");
+#endif
+
+	uint64 h = cache_hash (CACHE_HASH_MULTIPLIER,
+		(const unsigned char*) full_source_return, strlen (full_source_return));
+	sprintf (path_return, "%s%08lx%08lx%s", dir,
+		(unsigned long) (uint32) (h >> 32), (unsigned long) (uint32) h,
+		extension);
+	return true;
+}
+
+/*===========================================================================
+ * Name:	CacheWriter
+ * Purpose:	Buffers the body of a cache file, hashing it as it goes,
+ *		and numbers the nodes that are written.
+ */
+class CacheWriter {
+public:
+	FILE *f;
+	unsigned char *buffer;
+	unsigned long n;	// Bytes waiting in buffer.
+	uint64 size;		// Bytes of body written.
+	uint64 hash;
+	bool failed;
+	volatile bool *cancel;	// Stops the writing when set.
+
+	// Open-addressed index from Node to its number, so that
+	// numbering is not a scan of every node written so far.
+	Node **slots;
+	uint32 *numbers;
+	uint32 n_nodes;
+	uint32 slots_size;	// A power of two.
+
+	CacheWriter (FILE *f_, volatile bool *cancel_) {
+		f = f_;
+		cancel = cancel_;
+		buffer = (unsigned char*) malloc (MESH_CACHE_BUFFERSIZE);
+		if (!buffer)
+			fatal ("Out of memory!");
+		n = 0;
+		size = 0;
+		hash = CACHE_HASH_MULTIPLIER;
+		failed = false;
+		slots = NULL;
+		numbers = NULL;
+		n_nodes = slots_size = 0;
+	}
+
+	~CacheWriter () {
+		free (buffer);
+		free (slots);
+		free (numbers);
+	}
+};
+
+//---------------------------------------------------------------------------
+// Name:	flush
+// Purpose:	Writes out the buffered bytes.
+//---------------------------------------------------------------------------
+static void
+flush (CacheWriter *w)
+{
+	if (!w->n)
+		return;
+	w->hash = cache_hash (w->hash, w->buffer, w->n);
+	if (w->n != fwrite (w->buffer, 1, w->n, w->f))
+		w->failed = true;
+	w->size += w->n;
+	w->n = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	put_bytes, put_u32, put_f32, put_f64, put_string
+// Purpose:	Appends values to the body.
+//---------------------------------------------------------------------------
+static void
+put_bytes (CacheWriter *w, const void *data, unsigned long n)
+{
+	const unsigned char *p = (const unsigned char*) data;
+	while (n > 0) {
+		unsigned long room = MESH_CACHE_BUFFERSIZE - w->n;
+		unsigned long chunk = n < room ? n : room;
+		memcpy (w->buffer + w->n, p, chunk);
+		w->n += chunk;
+		p += chunk;
+		n -= chunk;
+		if (w->n == MESH_CACHE_BUFFERSIZE)
+			flush (w);
+	}
+}
+
+static void
+put_u32 (CacheWriter *w, uint32 value)
+{
+	unsigned char bytes [4];
+	encode_u32 (bytes, value);
+	put_bytes (w, bytes, 4);
+}
+
+static void
+put_f32 (CacheWriter *w, float value)
+{
+	uint32 bits;
+	memcpy (&bits, &value, 4);
+	put_u32 (w, bits);
+}
+
+static void
+put_f64 (CacheWriter *w, double value)
+{
+	uint64 bits;
+	unsigned char bytes [8];
+	memcpy (&bits, &value, 8);
+	encode_u64 (bytes, bits);
+	put_bytes (w, bytes, 8);
+}
+
+static void
+put_string (CacheWriter *w, const char *s)
+{
+	if (!s) {
+		put_u32 (w, MESH_CACHE_NULL_STRING);
+		return;
+	}
+	unsigned long len = strlen (s);
+	put_u32 (w, len);
+	put_bytes (w, s, len);
+}
+
+//---------------------------------------------------------------------------
+// Name:	node_slot
+// Purpose:	Finds the slot of a node in the index, or the empty slot
+//		where it would go.
+//---------------------------------------------------------------------------
+static uint32
+node_slot (CacheWriter *w, Node *n)
+{
+	uint64 h = (uint64) (size_t) n * CACHE_HASH_MULTIPLIER;
+	uint32 mask = w->slots_size - 1;
+	uint32 i = (uint32) (h >> 32) & mask;
+	while (w->slots [i] && w->slots [i] != n)
+		i = (i + 1) & mask;
+	return i;
+}
+
+//---------------------------------------------------------------------------
+// Name:	number_node
+// Purpose:	Gives a node the next number.
+//---------------------------------------------------------------------------
+static void
+number_node (CacheWriter *w, Node *n)
+{
+	if (2 * (w->n_nodes + 1) > w->slots_size) {
+		Node **old_slots = w->slots;
+		uint32 *old_numbers = w->numbers;
+		uint32 old_size = w->slots_size;
+
+		w->slots_size = old_size ? 2 * old_size : 512;
+		w->slots = (Node**) calloc (w->slots_size, sizeof(Node*));
+		w->numbers = (uint32*) malloc (w->slots_size * sizeof(uint32));
+		if (!w->slots || !w->numbers)
+			fatal ("Out of memory!");
+
+		for (uint32 i = 0; i < old_size; i++) {
+			if (old_slots [i]) {
+				uint32 slot = node_slot (w, old_slots [i]);
+				w->slots [slot] = old_slots [i];
+				w->numbers [slot] = old_numbers [i];
+			}
+		}
+		free (old_slots);
+		free (old_numbers);
+	}
+
+	uint32 slot = node_slot (w, n);
+	if (!w->slots [slot]) {
+		w->slots [slot] = n;
+		w->numbers [slot] = w->n_nodes;
+	}
+	w->n_nodes++;
+}
+
+//---------------------------------------------------------------------------
+// Name:	node_number
+// Purpose:	Finds the number given to a node.
+// Returns:	MESH_CACHE_NO_NODE if none.
+//---------------------------------------------------------------------------
+static uint32
+node_number (CacheWriter *w, Node *n)
+{
+	if (!w->slots_size)
+		return MESH_CACHE_NO_NODE;
+	uint32 slot = node_slot (w, n);
+	return w->slots [slot] ? w->numbers [slot] : MESH_CACHE_NO_NODE;
+}
+
+//---------------------------------------------------------------------------
+// Name:	write_appearance
+// Purpose:	Writes a Shape's Appearance, or a reference to one
+//		that was already written.
+//---------------------------------------------------------------------------
+static void
+write_appearance (CacheWriter *w, Appearance *appearance)
+{
+	if (!appearance) {
+		put_u32 (w, CACHE_NO_APPEARANCE);
+		return;
+	}
+
+	uint32 number = node_number (w, appearance);
+	if (number != MESH_CACHE_NO_NODE) {
+		put_u32 (w, CACHE_SHARED_APPEARANCE);
+		put_u32 (w, number);
+		return;
+	}
+
+	put_u32 (w, CACHE_NEW_APPEARANCE);
+	put_string (w, appearance->name);
+	number_node (w, appearance);
+
+	Material *material = appearance->material;
+	put_u32 (w, material ? 1 : 0);
+	if (material) {
+		int i;
+		put_string (w, material->name);
+		number_node (w, material);
+		for (i = 0; i < 4; i++)
+			put_f32 (w, material->diffuseColor [i]);
+		put_f32 (w, material->ambientIntensity);
+		for (i = 0; i < 4; i++)
+			put_f32 (w, material->specularColor [i]);
+		for (i = 0; i < 4; i++)
+			put_f32 (w, material->emissiveColor [i]);
+		put_f32 (w, material->shininess);
+		put_f32 (w, material->transparency);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	write_indexedfaceset
+// Purpose:	Writes the arrays of vertices, triangle indices, triangle
+//		normals and areas of an IndexedFaceSet, and the vertex
+//		normals if the file gave them.
+// Returns:	False if a triangle uses a point that is not its own.
+//---------------------------------------------------------------------------
+static bool
+write_indexedfaceset (CacheWriter *w, IndexedFaceSet *ifs)
+{
+	FlatMesh *m = ifs->flat;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		put_f32 (w, ifs->color [i]);
+	put_u32 (w, ifs->color_specified ? 1 : 0);
+	put_f64 (w, ifs->minx);
+	put_f64 (w, ifs->maxx);
+	put_f64 (w, ifs->miny);
+	put_f64 (w, ifs->maxy);
+	put_f64 (w, ifs->minz);
+	put_f64 (w, ifs->maxz);
+
+	put_u32 (w, ifs->n_points);
+	put_u32 (w, ifs->n_triangles);
+
+	for (i = 0; i < 3 * ifs->n_points; i++)
+		put_f32 (w, m->positions [i]);
+
+	for (i = 0; i < 3 * ifs->n_triangles; i++) {
+		if (m->indices [i] >= (uint32) ifs->n_points)
+			return false;
+		put_u32 (w, m->indices [i]);
+	}
+
+	for (i = 0; i < 3 * ifs->n_triangles; i++)
+		put_f32 (w, m->face_normals [i]);
+
+	for (i = 0; i < ifs->n_triangles; i++)
+		put_f32 (w, m->face_areas [i]);
+
+	// Of the flags, a point that is smoothed has only the
+	// first, "valid"; one that is not has neither, or also
+	// the second, "along a crease".
+	//
+	put_f64 (w, ifs->crease_angle);
+	put_u32 (w, ifs->normals_given ? 1 : 0);
+	if (ifs->normals_given) {
+		for (i = 0; i < ifs->n_points; i++) {
+			const float *normal = flat_normal (m, i);
+			put_f32 (w, normal [0]);
+			put_f32 (w, normal [1]);
+			put_f32 (w, normal [2]);
+			put_u32 (w, m->smooth [i] ? 1 : 0);
+		}
+	}
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	write_indexedlineset
+// Purpose:	Writes the points, colors and polyline of an IndexedLineSet.
+// Returns:	False if the polyline uses a point that is not its own.
+//---------------------------------------------------------------------------
+static bool
+write_indexedlineset (CacheWriter *w, IndexedLineSet *ils)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		put_f32 (w, ils->color [i]);
+	put_u32 (w, ils->color_per_vertex ? 1 : 0);
+	put_f64 (w, ils->minx);
+	put_f64 (w, ils->maxx);
+	put_f64 (w, ils->miny);
+	put_f64 (w, ils->maxy);
+	put_f64 (w, ils->minz);
+	put_f64 (w, ils->maxz);
+
+	put_u32 (w, ils->n_points);
+	for (i = 0; i < ils->n_points; i++) {
+		Point *p = ils->points [i];
+		p->id = i;
+		put_f32 (w, p->x);
+		put_f32 (w, p->y);
+		put_f32 (w, p->z);
+	}
+
+	put_u32 (w, ils->n_colors);
+	for (i = 0; i < ils->n_colors; i++)
+		put_f32 (w, ils->colors [i]);
+
+	uint32 count = 0;
+	PolyLine *pl;
+	for (pl = ils->polyline; pl; pl = pl->next)
+		count++;
+	put_u32 (w, count);
+	for (pl = ils->polyline; pl; pl = pl->next) {
+		Point *p = pl->point;
+		if (!p || p->id < 0 || p->id >= ils->n_points || ils->points [p->id] != p)
+			return false;
+		put_u32 (w, p->id);
+		if (ils->color_per_vertex)
+			for (i = 0; i < 4; i++)
+				put_f32 (w, pl->color [i]);
+	}
+	return true;
+}
+
+static bool write_nodes (CacheWriter *w, Node *n, Model *m);
+
+//---------------------------------------------------------------------------
+// Name:	write_node
+// Purpose:	Writes one node and, recursively, its children.
+// Returns:	False if the node is of a kind the cache cannot hold.
+//---------------------------------------------------------------------------
+static bool
+write_node (CacheWriter *w, Node *n, Model *m)
+{
+	int i;
+	uint32 kind;
+
+	if (!strcmp (n->type, "Group"))
+		kind = CACHE_GROUP;
+	else if (!strcmp (n->type, "Separator"))
+		kind = CACHE_SEPARATOR;
+	else if (!strcmp (n->type, "Transform"))
+		kind = CACHE_TRANSFORM;
+	else if (!strcmp (n->type, "Switch"))
+		kind = CACHE_SWITCH;
+	else if (!strcmp (n->type, "Shape"))
+		kind = CACHE_SHAPE;
+	else if (!strcmp (n->type, "IndexedFaceSet"))
+		kind = CACHE_INDEXEDFACESET;
+	else if (!strcmp (n->type, "IndexedLineSet"))
+		kind = CACHE_INDEXEDLINESET;
+	else if (!strcmp (n->type, "Text"))
+		kind = CACHE_TEXT;
+	else if (!strcmp (n->type, "Sphere"))
+		kind = CACHE_SPHERE;
+	else if (!strcmp (n->type, "Box"))
+		kind = CACHE_BOX;
+	else if (!strcmp (n->type, "Cone"))
+		kind = CACHE_CONE;
+	else if (!strcmp (n->type, "Cylinder"))
+		kind = CACHE_CYLINDER;
+	else if (!strcmp (n->type, "Replicated (USE)"))
+		kind = CACHE_REPLICATED;
+	else {
+		printf ("Mesh cache cannot hold a %s node.\n", n->type);
+		return false;
+	}
+
+	put_u32 (w, kind);
+	put_string (w, n->name);
+	number_node (w, n);
+
+	switch (kind) {
+	case CACHE_TRANSFORM: {
+		Transform *t = (Transform*) n;
+		put_f64 (w, t->translate_x);
+		put_f64 (w, t->translate_y);
+		put_f64 (w, t->translate_z);
+		put_f64 (w, t->second_translate_x);
+		put_f64 (w, t->second_translate_y);
+		put_f64 (w, t->second_translate_z);
+		put_f64 (w, t->scale_x);
+		put_f64 (w, t->scale_y);
+		put_f64 (w, t->scale_z);
+		put_f64 (w, t->rotate_x);
+		put_f64 (w, t->rotate_y);
+		put_f64 (w, t->rotate_z);
+		put_f64 (w, t->rotate_angle);
+		put_f64 (w, t->second_rotate_x);
+		put_f64 (w, t->second_rotate_y);
+		put_f64 (w, t->second_rotate_z);
+		put_f64 (w, t->second_rotate_angle);
+		put_f64 (w, t->center_x);
+		put_f64 (w, t->center_y);
+		put_f64 (w, t->center_z);
+		put_u32 (w, t->op_index);
+		for (i = 0; i < TRANSFORM_MAX_OPS; i++)
+			put_u32 (w, t->operations [i]);
+		break;
+	}
+	case CACHE_SWITCH: {
+		Switch *s = (Switch*) n;
+		int saved = 0;
+		Node *choice = s->children;
+		for (; choice && !choice->dont_save_this_node; choice = choice->next)
+			saved++;
+		put_u32 (w, s->file_which < saved ? s->file_which : -1);
+		put_u32 (w, s->total_choices);
+		break;
+	}
+	case CACHE_SHAPE:
+		write_appearance (w, ((Shape*) n)->appearance);
+		break;
+	case CACHE_INDEXEDFACESET:
+		if (!write_indexedfaceset (w, (IndexedFaceSet*) n))
+			return false;
+		break;
+	case CACHE_INDEXEDLINESET:
+		if (!write_indexedlineset (w, (IndexedLineSet*) n))
+			return false;
+		break;
+	case CACHE_TEXT:
+		put_string (w, ((Text*) n)->text);
+		break;
+	case CACHE_SPHERE:
+		put_f64 (w, ((Sphere*) n)->radius);
+		break;
+	case CACHE_BOX:
+		put_f64 (w, ((Box*) n)->size);
+		break;
+	case CACHE_CONE:
+		put_f64 (w, ((Cone*) n)->radius);
+		put_f64 (w, ((Cone*) n)->height);
+		break;
+	case CACHE_CYLINDER: {
+		Cylinder *c = (Cylinder*) n;
+		put_u32 (w, (c->bottom ? 1 : 0) | (c->top ? 2 : 0) | (c->side ? 4 : 0));
+		put_f64 (w, c->radius);
+		put_f64 (w, c->height);
+		break;
+	}
+	case CACHE_REPLICATED: {
+		Node *original = ((Replicated*) n)->original;
+		uint32 number = MESH_CACHE_NO_NODE;
+		if (original) {
+			number = node_number (w, original);
+			if (number == MESH_CACHE_NO_NODE)
+				return false;
+		}
+		put_u32 (w, number);
+		break;
+	}
+	}
+
+	return write_nodes (w, n->children, m);
+}
+
+//---------------------------------------------------------------------------
+// Name:	write_nodes
+// Purpose:	Writes a node and its siblings. As when a DST file is
+//		saved, the siblings stop at a node that is not saved,
+//		after which come only those the program added.
+//---------------------------------------------------------------------------
+static bool
+write_nodes (CacheWriter *w, Node *n, Model *m)
+{
+	while (n && !n->dont_save_this_node) {
+		if ((w->cancel && *w->cancel) || !write_node (w, n, m))
+			return false;
+		n = n->next;
+	}
+	put_u32 (w, CACHE_END);
+	return !w->failed;
+}
+
+//---------------------------------------------------------------------------
+// Name:	write_model
+// Purpose:	Writes the body of the cache file.
+// Returns:	False if the Model cannot be stored.
+//---------------------------------------------------------------------------
+static bool
+write_model (CacheWriter *w, InputFile *file, Model *m, const char *full_source)
+{
+	put_string (w, full_source);
+	put_string (w, file->first_line);
+	put_string (w, m->title);
+
+	uint32 flags = m->background_provided ? CACHE_BACKGROUND_PROVIDED : 0;
+#ifdef ORTHOCAST
+	if (m->isTopAndBottomAligned)
+		flags |= CACHE_TOP_AND_BOTTOM_ALIGNED;
+#endif
+	put_u32 (w, flags);
+	put_f32 (w, m->bg [0]);
+	put_f32 (w, m->bg [1]);
+	put_f32 (w, m->bg [2]);
+
+	put_u32 (w, m->viewpoint_fields);
+	put_f64 (w, m->viewpoint_x);
+	put_f64 (w, m->viewpoint_y);
+	put_f64 (w, m->viewpoint_z);
+	put_f64 (w, m->orientation_x);
+	put_f64 (w, m->orientation_y);
+	put_f64 (w, m->orientation_z);
+	put_f64 (w, m->field_of_view);
+
+#ifdef ORTHOCAST
+	put_string (w, m->patient_firstname);
+	put_string (w, m->patient_lastname);
+	put_string (w, m->patient_birthdate);
+	put_string (w, m->case_date);
+	put_string (w, m->case_number);
+	put_string (w, m->control_number);
+#else
+	for (int i = 0; i < 6; i++)
+		put_string (w, NULL);
+#endif
+
+	if (!m->nodes || !write_nodes (w, m->nodes->children, m))
+		return false;
+
+	// Names given to nodes that were not saved are left out.
+	uint32 count = 0;
+	NameMap *nm;
+	for (nm = m->names; nm; nm = nm->next)
+		if (node_number (w, nm->node) != MESH_CACHE_NO_NODE)
+			count++;
+	put_u32 (w, count);
+	for (nm = m->names; nm; nm = nm->next) {
+		uint32 number = node_number (w, nm->node);
+		if (number == MESH_CACHE_NO_NODE)
+			continue;
+		put_string (w, nm->name);
+		put_u32 (w, number);
+	}
+
+	flush (w);
+	return !w->failed;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_cache_save
+// Purpose:	Writes the binary mesh cache of a Model. The file is
+//		written under a temporary name and then renamed, so that
+//		a reader never sees it half-written.
+// Returns:	False if the Model could not be stored, or if *cancel
+//		was set meanwhile.
+//---------------------------------------------------------------------------
+bool
+mesh_cache_save (InputFile *file, Model *m, volatile bool *cancel)
+{
+	char path [PATH_MAX];
+	char temporary [PATH_MAX + 8];
+	char full_source [PATH_MAX];
+	uint64 source_size, source_contents;
+	int64 source_time;
+
+	ASSERT_NONZERO (file,"file")
+	ASSERT_NONZERO (m,"model")
+	//----------
+
+	if (!file->path || !cache_path (file->path, ".mxc", path, full_source))
+		return false;
+	m->build_all ();
+	if (!source_identity (file->path, source_size, source_time) ||
+	    !source_hash (file->path, source_contents, cancel))
+		return false;
+
+	sprintf (temporary, "%s.tmp", path);
+	FILE *f = fopen (temporary, "wb");
+	if (!f)
+		return false;
+
+	unsigned char header [MESH_CACHE_HEADERSIZE];
+	memset (header, 0, MESH_CACHE_HEADERSIZE);
+	fwrite (header, 1, MESH_CACHE_HEADERSIZE, f);
+
+	CacheWriter *w = new CacheWriter (f, cancel);
+	bool ok = write_model (w, file, m, full_source);
+
+	if (ok) {
+		memcpy (header, MESH_CACHE_MAGIC, 4);
+		encode_u32 (header + 4, MESH_CACHE_VERSION);
+		encode_u64 (header + 8, source_size);
+		encode_u64 (header + 16, (uint64) source_time);
+		encode_u64 (header + 24, source_contents);
+		encode_u64 (header + 32, w->size);
+		encode_u64 (header + 40, w->hash);
+		ok = !fseek (f, 0, SEEK_SET) &&
+			MESH_CACHE_HEADERSIZE == fwrite (header, 1, MESH_CACHE_HEADERSIZE, f);
+	}
+	delete w;
+
+	if (fclose (f))
+		ok = false;
+	if (ok) {
+#ifdef WIN32
+		remove (path);	// rename() does not replace files on Windows.
+#endif
+		ok = !rename (temporary, path);
+	}
+	if (!ok) {
+		remove (temporary);
+		return false;
+	}
+
+	printf ("Wrote mesh cache %s\n", path);
+	return true;
+}
+
+/*===========================================================================
+ * Name:	CacheReader
+ * Purpose:	Reads values from the mapped body of a cache file, failing
+ *		rather than reading past its end, and keeps the nodes read
+ *		so far by number.
+ */
+class CacheReader {
+public:
+	const unsigned char *p;
+	const unsigned char *end;
+	bool failed;
+
+	Model *model;
+	AtomTable *atoms;	// Holds the strings.
+
+	Node **nodes;
+	uint32 n_nodes;
+	uint32 nodes_size;
+
+	CacheReader (const unsigned char *data, uint64 size) {
+		p = data;
+		end = data + size;
+		failed = false;
+		model = NULL;
+		atoms = NULL;
+		nodes = NULL;
+		n_nodes = nodes_size = 0;
+	}
+
+	~CacheReader () {
+		free (nodes);
+	}
+};
+
+//---------------------------------------------------------------------------
+// Name:	available
+// Purpose:	Checks that the body holds count items of the given size.
+//---------------------------------------------------------------------------
+static bool
+available (CacheReader *r, uint64 count, uint64 size)
+{
+	if (r->failed || count > (uint64) (r->end - r->p) / size)
+		r->failed = true;
+	return !r->failed;
+}
+
+//---------------------------------------------------------------------------
+// Name:	get_u32, get_f32, get_f64, get_string
+// Purpose:	Reads values from the body. After a failure, each
+//		returns zero or NULL.
+//---------------------------------------------------------------------------
+static uint32
+get_u32 (CacheReader *r)
+{
+	if (!available (r, 1, 4))
+		return 0;
+	uint32 value = decode_u32 (r->p);
+	r->p += 4;
+	return value;
+}
+
+static float
+get_f32 (CacheReader *r)
+{
+	uint32 bits = get_u32 (r);
+	float value;
+	memcpy (&value, &bits, 4);
+	return value;
+}
+
+static double
+get_f64 (CacheReader *r)
+{
+	if (!available (r, 1, 8))
+		return 0.0;
+	uint64 bits = decode_u64 (r->p);
+	r->p += 8;
+	double value;
+	memcpy (&value, &bits, 8);
+	return value;
+}
+
+static char *
+get_string (CacheReader *r)
+{
+	uint32 len = get_u32 (r);
+	if (len == MESH_CACHE_NULL_STRING || !available (r, len, 1))
+		return NULL;
+
+	char *s = NULL;
+	r->atoms->intern ((const char*) r->p, len, &s);
+	r->p += len;
+	return s;
+}
+
+//---------------------------------------------------------------------------
+// Name:	add_node
+// Purpose:	Gives a node the next number.
+//---------------------------------------------------------------------------
+static void
+add_node (CacheReader *r, Node *n)
+{
+	if (r->n_nodes >= r->nodes_size) {
+		r->nodes_size = r->nodes_size ? 2 * r->nodes_size : 256;
+		Node **tmp = (Node**) realloc (r->nodes, r->nodes_size * sizeof(Node*));
+		if (!tmp)
+			fatal ("Out of memory!");
+		r->nodes = tmp;
+	}
+	r->nodes [r->n_nodes++] = n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	get_node
+// Purpose:	Reads the number of an earlier node.
+// Returns:	The node, or NULL.
+//---------------------------------------------------------------------------
+static Node *
+get_node (CacheReader *r)
+{
+	uint32 number = get_u32 (r);
+	if (number == MESH_CACHE_NO_NODE)
+		return NULL;
+	if (number >= r->n_nodes) {
+		r->failed = true;
+		return NULL;
+	}
+	return r->nodes [number];
+}
+
+//---------------------------------------------------------------------------
+// Name:	read_appearance
+// Purpose:	Reads the Appearance of a Shape.
+//---------------------------------------------------------------------------
+static void
+read_appearance (CacheReader *r, Shape *shape)
+{
+	switch (get_u32 (r)) {
+	case CACHE_NO_APPEARANCE:
+		break;
+	case CACHE_SHARED_APPEARANCE: {
+		Node *n = get_node (r);
+		if (n && !strcmp (n->type, "Appearance"))
+			shape->appearance = (Appearance*) n;
+		else
+			r->failed = true;
+		break;
+	}
+	case CACHE_NEW_APPEARANCE: {
+		Appearance *appearance = new Appearance ();
+		shape->appearance = appearance;
+		shape->owns_appearance = true;
+		appearance->name = get_string (r);
+		add_node (r, appearance);
+
+		if (get_u32 (r)) {
+			int i;
+			Material *material = new Material ();
+			appearance->material = material;
+			material->name = get_string (r);
+			add_node (r, material);
+			for (i = 0; i < 4; i++)
+				material->diffuseColor [i] = get_f32 (r);
+			material->ambientIntensity = get_f32 (r);
+			for (i = 0; i < 4; i++)
+				material->specularColor [i] = get_f32 (r);
+			for (i = 0; i < 4; i++)
+				material->emissiveColor [i] = get_f32 (r);
+			material->shininess = get_f32 (r);
+			material->transparency = get_f32 (r);
+		}
+		break;
+	}
+	default:
+		r->failed = true;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	read_indexedfaceset
+// Purpose:	Fills an IndexedFaceSet from its arrays.
+//---------------------------------------------------------------------------
+static void
+read_indexedfaceset (CacheReader *r, IndexedFaceSet *ifs)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		ifs->color [i] = get_f32 (r);
+	ifs->color_specified = get_u32 (r) != 0;
+	ifs->minx = get_f64 (r);
+	ifs->maxx = get_f64 (r);
+	ifs->miny = get_f64 (r);
+	ifs->maxy = get_f64 (r);
+	ifs->minz = get_f64 (r);
+	ifs->maxz = get_f64 (r);
+
+	uint32 n_points = get_u32 (r);
+	uint32 n_triangles = get_u32 (r);
+	// Below 2^31 each, so the byte count cannot overflow.
+	if (n_points > 0x7fffffff || n_triangles > 0x7fffffff ||
+	    !available (r, (uint64) n_points * (3 * 4) +
+			(uint64) n_triangles * (3 * 4 + 3 * 4 + 4), 1)) {
+		r->failed = true;
+		return;
+	}
+
+	ifs->reserve (n_points, n_triangles);
+
+	const unsigned char *p = r->p;
+	for (i = 0; i < (int) n_points; i++) {
+		float xyz [3];
+		for (int j = 0; j < 3; j++) {
+			uint32 bits = decode_u32 (p);
+			memcpy (&xyz [j], &bits, 4);
+			p += 4;
+		}
+		ifs->add_point (xyz[0], xyz[1], xyz[2]);
+	}
+
+	const unsigned char *indices = p;
+	const unsigned char *normals = indices + 12 * (unsigned long) n_triangles;
+	const unsigned char *areas = normals + 12 * (unsigned long) n_triangles;
+	for (i = 0; i < (int) n_triangles; i++) {
+		uint32 a = decode_u32 (indices);
+		uint32 b = decode_u32 (indices + 4);
+		uint32 c = decode_u32 (indices + 8);
+		indices += 12;
+		if (a >= n_points || b >= n_points || c >= n_points) {
+			r->failed = true;
+			return;
+		}
+
+		float normal [3], area;
+		for (int j = 0; j < 3; j++) {
+			uint32 bits = decode_u32 (normals);
+			memcpy (&normal [j], &bits, 4);
+			normals += 4;
+		}
+		uint32 bits = decode_u32 (areas);
+		memcpy (&area, &bits, 4);
+		areas += 4;
+
+		ifs->add_triangle (a, b, c, normal, area);
+	}
+	r->p = areas;
+
+	ifs->crease_angle = get_f64 (r);
+	ifs->normals_given = get_u32 (r) != 0;
+	if (ifs->normals_given) {
+		if (!available (r, n_points, 4 * 4))
+			return;
+		for (i = 0; i < (int) n_points; i++) {
+			float *normal = flat_normal (ifs->flat, i);
+			normal [0] = get_f32 (r);
+			normal [1] = get_f32 (r);
+			normal [2] = get_f32 (r);
+			uint32 flags = get_u32 (r);
+			ifs->flat->smooth [i] = (flags & 3) == 1;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	read_indexedlineset
+// Purpose:	Fills an IndexedLineSet from its points, colors and polyline.
+//---------------------------------------------------------------------------
+static void
+read_indexedlineset (CacheReader *r, IndexedLineSet *ils)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		ils->color [i] = get_f32 (r);
+	ils->color_per_vertex = get_u32 (r) != 0;
+	ils->minx = get_f64 (r);
+	ils->maxx = get_f64 (r);
+	ils->miny = get_f64 (r);
+	ils->maxy = get_f64 (r);
+	ils->minz = get_f64 (r);
+	ils->maxz = get_f64 (r);
+
+	uint32 n_points = get_u32 (r);
+	if (n_points > 0x7fffffff || !available (r, n_points, 3 * 4))
+		return;
+	while (ils->points_size < (int) n_points)
+		ils->expand_points ();
+	for (i = 0; i < (int) n_points; i++) {
+		float x = get_f32 (r);
+		float y = get_f32 (r);
+		float z = get_f32 (r);
+		ils->points [ils->n_points++] = Point_new (x, y, z);
+	}
+
+	uint32 n_colors = get_u32 (r);
+	if (n_colors > 0x7fffffff || !available (r, n_colors, 4))
+		return;
+	while (ils->colors_size <= (int) n_colors)
+		ils->expand_colors ();
+	for (i = 0; i < (int) n_colors; i++)
+		ils->colors [ils->n_colors++] = get_f32 (r);
+
+	uint32 count = get_u32 (r);
+	while (count-- && !r->failed) {
+		uint32 index = get_u32 (r);
+		if (index >= n_points) {
+			r->failed = true;
+			return;
+		}
+		PolyLine *pl = new PolyLine (ils->points [index]);
+		if (!ils->polyline)
+			ils->polyline = pl;
+		else
+			ils->last_poly->next = pl;
+		ils->last_poly = pl;
+		if (ils->color_per_vertex)
+			for (i = 0; i < 4; i++)
+				pl->color [i] = get_f32 (r);
+	}
+}
+
+static void read_nodes (CacheReader *r, Node *parent);
+
+//---------------------------------------------------------------------------
+// Name:	read_node
+// Purpose:	Reads one node of the given kind and its children,
+//		and adds it to the parent. Names are registered later,
+//		but whatever the parser derives from them is done here
+//		in the parser's order.
+//---------------------------------------------------------------------------
+static void
+read_node (CacheReader *r, Node *parent, uint32 kind)
+{
+	int i;
+	Node *n = NULL;
+	Model *m = r->model;
+
+	switch (kind) {
+	case CACHE_GROUP:
+		n = new Group ();
+		break;
+	case CACHE_SEPARATOR:
+		n = new Separator ();
+		break;
+	case CACHE_TRANSFORM:
+		n = new Transform ();
+		break;
+	case CACHE_SWITCH:
+		n = new Switch ();
+		break;
+	case CACHE_SHAPE:
+		n = new Shape ();
+		break;
+	case CACHE_INDEXEDFACESET:
+		n = new IndexedFaceSet ();
+		break;
+	case CACHE_INDEXEDLINESET:
+		n = new IndexedLineSet ();
+		break;
+	case CACHE_TEXT:
+		n = new Text ();
+		break;
+	case CACHE_SPHERE:
+		n = new Sphere ();
+		break;
+	case CACHE_BOX:
+		n = new Box ();
+		break;
+	case CACHE_CONE:
+		n = new Cone ();
+		break;
+	case CACHE_CYLINDER:
+		n = new Cylinder ();
+		break;
+	case CACHE_REPLICATED: {
+		// As if made by Replicated (Model*, char*).
+		Replicated *replicated = new Replicated ();
+		replicated->type = "Replicated (USE)";
+		total_allocated += sizeof(Replicated);
+		n = replicated;
+		break;
+	}
+	default:
+		r->failed = true;
+		return;
+	}
+
+	n->name = get_string (r);
+	n->parent = parent;
+	parent->add_child (n);
+	add_node (r, n);
+
+	switch (kind) {
+	case CACHE_GROUP:
+#ifdef ORTHOCAST
+		if (n->name && !strncmp (n->name, "TopAndBottom", 12))
+			m->top_and_bottom_node = (Group*) n;
+#endif
+		break;
+	case CACHE_TRANSFORM: {
+		Transform *t = (Transform*) n;
+		t->translate_x = get_f64 (r);
+		t->translate_y = get_f64 (r);
+		t->translate_z = get_f64 (r);
+		t->second_translate_x = get_f64 (r);
+		t->second_translate_y = get_f64 (r);
+		t->second_translate_z = get_f64 (r);
+		t->scale_x = get_f64 (r);
+		t->scale_y = get_f64 (r);
+		t->scale_z = get_f64 (r);
+		t->rotate_x = get_f64 (r);
+		t->rotate_y = get_f64 (r);
+		t->rotate_z = get_f64 (r);
+		t->rotate_angle = get_f64 (r);
+		t->second_rotate_x = get_f64 (r);
+		t->second_rotate_y = get_f64 (r);
+		t->second_rotate_z = get_f64 (r);
+		t->second_rotate_angle = get_f64 (r);
+		t->center_x = get_f64 (r);
+		t->center_y = get_f64 (r);
+		t->center_z = get_f64 (r);
+		t->op_index = (unsigned short) get_u32 (r);
+		for (i = 0; i < TRANSFORM_MAX_OPS; i++)
+			t->operations [i] = (char) get_u32 (r);
+		if (t->op_index > TRANSFORM_MAX_OPS)
+			r->failed = true;
+		break;
+	}
+	case CACHE_SWITCH: {
+		Switch *s = (Switch*) n;
+		s->which = s->file_which = (int) get_u32 (r);
+		s->total_choices = (int) get_u32 (r);
+		break;
+	}
+	case CACHE_SHAPE:
+		read_appearance (r, (Shape*) n);
+		break;
+	case CACHE_INDEXEDFACESET:
+		read_indexedfaceset (r, (IndexedFaceSet*) n);
+		break;
+	case CACHE_INDEXEDLINESET:
+		read_indexedlineset (r, (IndexedLineSet*) n);
+		break;
+	case CACHE_TEXT:
+		((Text*) n)->text = get_string (r);
+		break;
+	case CACHE_SPHERE:
+		((Sphere*) n)->radius = get_f64 (r);
+		break;
+	case CACHE_BOX:
+		((Box*) n)->size = get_f64 (r);
+		break;
+	case CACHE_CONE:
+		((Cone*) n)->radius = get_f64 (r);
+		((Cone*) n)->height = get_f64 (r);
+		break;
+	case CACHE_CYLINDER: {
+		Cylinder *c = (Cylinder*) n;
+		uint32 sides = get_u32 (r);
+		c->bottom = (sides & 1) != 0;
+		c->top = (sides & 2) != 0;
+		c->side = (sides & 4) != 0;
+		c->radius = get_f64 (r);
+		c->height = get_f64 (r);
+		break;
+	}
+	case CACHE_REPLICATED:
+		((Replicated*) n)->original = get_node (r);
+		break;
+	}
+
+	read_nodes (r, n);
+
+	if (kind == CACHE_SWITCH && !r->failed &&
+	    n->name && !strncmp (n->name, "switchNode", 10))
+		m->register_switch ((Switch*) n);
+}
+
+//---------------------------------------------------------------------------
+// Name:	read_nodes
+// Purpose:	Reads a list of sibling nodes.
+//---------------------------------------------------------------------------
+static void
+read_nodes (CacheReader *r, Node *parent)
+{
+	while (!r->failed) {
+		uint32 kind = get_u32 (r);
+		if (kind == CACHE_END)
+			break;
+		read_node (r, parent, kind);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	read_model
+// Purpose:	Reads the body of the cache file into r->model.
+// Returns:	False if the body is not for this source or is damaged.
+//---------------------------------------------------------------------------
+static bool
+read_model (CacheReader *r, InputFile *file, const char *full_source)
+{
+	Model *m = r->model;
+
+	const char *source = get_string (r);
+	if (!source || strcmp (source, full_source))
+		return false;
+
+	char *first_line = get_string (r);
+	if (first_line && !file->first_line)
+		file->capture_first_line ((const unsigned char*) first_line, strlen (first_line));
+
+	m->title = get_string (r);
+
+	uint32 flags = get_u32 (r);
+	m->background_provided = (flags & CACHE_BACKGROUND_PROVIDED) != 0;
+#ifdef ORTHOCAST
+	m->isTopAndBottomAligned = (flags & CACHE_TOP_AND_BOTTOM_ALIGNED) != 0;
+#endif
+	m->bg [0] = get_f32 (r);
+	m->bg [1] = get_f32 (r);
+	m->bg [2] = get_f32 (r);
+
+	m->viewpoint_fields = get_u32 (r);
+	m->viewpoint_x = get_f64 (r);
+	m->viewpoint_y = get_f64 (r);
+	m->viewpoint_z = get_f64 (r);
+	m->orientation_x = get_f64 (r);
+	m->orientation_y = get_f64 (r);
+	m->orientation_z = get_f64 (r);
+	m->field_of_view = get_f64 (r);
+
+#ifdef ORTHOCAST
+	m->patient_firstname = get_string (r);
+	m->patient_lastname = get_string (r);
+	m->patient_birthdate = get_string (r);
+	m->case_date = get_string (r);
+	m->case_number = get_string (r);
+	m->control_number = get_string (r);
+#else
+	for (int i = 0; i < 6; i++)
+		get_string (r);
+#endif
+
+	m->nodes = new Node ();
+	read_nodes (r, m->nodes);
+
+	uint32 count = get_u32 (r);
+	while (count-- && !r->failed) {
+		char *name = get_string (r);
+		Node *n = get_node (r);
+		if (!name || !n)
+			r->failed = true;
+		else
+			m->add_name_mapping (name, n);
+	}
+
+	return !r->failed && r->p == r->end;
+}
+
+/*===========================================================================
+ * Name:	CacheMapping
+ * Purpose:	A cache file mapped into memory.
+ */
+class CacheMapping {
+public:
+	const unsigned char *data;
+	uint64 size;
+#ifdef WIN32
+	HANDLE file_handle;
+	HANDLE map_handle;
+#endif
+
+	CacheMapping () {
+		data = NULL;
+		size = 0;
+#ifdef WIN32
+		file_handle = map_handle = NULL;
+#endif
+	}
+};
+
+//---------------------------------------------------------------------------
+// Name:	map_cache
+// Purpose:	Maps a cache file into memory.
+// Returns:	False if it does not exist or cannot be mapped.
+//---------------------------------------------------------------------------
+static bool
+map_cache (const char *path, CacheMapping *mapping)
+{
+#ifdef WIN32
+	HANDLE fh = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fh == INVALID_HANDLE_VALUE)
+		return false;
+
+	DWORD size = GetFileSize (fh, NULL);
+	if (size != INVALID_FILE_SIZE && size >= MESH_CACHE_HEADERSIZE) {
+		HANDLE mh = CreateFileMapping (fh, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mh) {
+			void *view = MapViewOfFile (mh, FILE_MAP_READ, 0, 0, 0);
+			if (view) {
+				mapping->file_handle = fh;
+				mapping->map_handle = mh;
+				mapping->data = (const unsigned char*) view;
+				mapping->size = size;
+				return true;
+			}
+			CloseHandle (mh);
+		}
+	}
+	CloseHandle (fh);
+	return false;
+#else
+	int fd = ::open (path, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (!fstat (fd, &st) && st.st_size >= MESH_CACHE_HEADERSIZE) {
+		void *view = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view != MAP_FAILED) {
+#ifdef MADV_SEQUENTIAL
+			madvise (view, st.st_size, MADV_SEQUENTIAL);
+#endif
+			::close (fd);
+			mapping->data = (const unsigned char*) view;
+			mapping->size = st.st_size;
+			return true;
+		}
+	}
+	::close (fd);
+	return false;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	unmap_cache
+// Purpose:	Releases a mapped cache file.
+//---------------------------------------------------------------------------
+static void
+unmap_cache (CacheMapping *mapping)
+{
+	if (!mapping->data)
+		return;
+#ifdef WIN32
+	UnmapViewOfFile ((void*) mapping->data);
+	CloseHandle (mapping->map_handle);
+	CloseHandle (mapping->file_handle);
+#else
+	munmap ((void*) mapping->data, mapping->size);
+#endif
+	mapping->data = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_cache_load
+// Purpose:	Builds a Model from the mesh cache of a file, if it is
+//		current. A cache from another version of this program,
+//		or for an older copy of the file, is ignored.
+// Returns:	The Model, or NULL.
+//---------------------------------------------------------------------------
+Model *
+mesh_cache_load (InputFile *file)
+{
+	char path [PATH_MAX];
+	char full_source [PATH_MAX];
+	uint64 source_size, source_contents;
+	int64 source_time;
+
+	ASSERT_NONZERO (file,"file")
+	//----------
+
+	if (!file->path || !cache_path (file->path, ".mxc", path, full_source))
+		return NULL;
+	if (!source_identity (file->path, source_size, source_time))
+		return NULL;
+
+	CacheMapping mapping;
+	if (!map_cache (path, &mapping))
+		return NULL;
+
+	const unsigned char *header = mapping.data;
+	uint64 body_size = mapping.size - MESH_CACHE_HEADERSIZE;
+
+	if (memcmp (header, MESH_CACHE_MAGIC, 4) ||
+	    decode_u32 (header + 4) != MESH_CACHE_VERSION) {
+		printf ("Ignoring mesh cache %s from another version.\n", path);
+		unmap_cache (&mapping);
+		return NULL;
+	}
+	if (decode_u64 (header + 8) != source_size ||
+	    decode_u64 (header + 16) != (uint64) source_time ||
+	    decode_u64 (header + 32) != body_size ||
+	    decode_u64 (header + 40) != cache_hash (CACHE_HASH_MULTIPLIER,
+			header + MESH_CACHE_HEADERSIZE, (unsigned long) body_size) ||
+	    !source_hash (file->path, source_contents, NULL) ||
+	    decode_u64 (header + 24) != source_contents) {
+		printf ("Ignoring stale mesh cache %s.\n", path);
+		unmap_cache (&mapping);
+		return NULL;
+	}
+
+	CacheReader *r = new CacheReader (header + MESH_CACHE_HEADERSIZE, body_size);
+	r->model = new Model ();
+	r->atoms = new AtomTable;
+
+	Model *m = r->model;
+	bool ok = read_model (r, file, full_source);
+	AtomTable *atoms = r->atoms;
+	delete r;
+	unmap_cache (&mapping);
+
+	if (!ok) {
+		printf ("Ignoring damaged mesh cache %s.\n", path);
+		delete m;
+		delete atoms;
+		return NULL;
+	}
+
+	delete file->atoms;
+	file->atoms = atoms;
+	printf ("Read mesh cache %s\n", path);
+	return m;
+}
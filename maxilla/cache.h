@@ -0,0 +1,68 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _CACHE_H
+#define _CACHE_H
+
+class InputFile;
+class Model;
+
+/*===========================================================================
+ * Name:	mesh_cache_load
+ * Purpose:	Builds a Model from the binary mesh cache of a VRML file,
+ *		without reading the file itself, if the cache exists and
+ *		still matches the file's size, time and contents.
+ *		As vrml_reader() does, it leaves the strings that the
+ *		Model's names point to in file->atoms.
+ * Returns:	The Model, or NULL if it must be parsed instead.
+ */
+extern Model *mesh_cache_load (InputFile *);
+
+/*===========================================================================
+ * Name:	mesh_cache_save
+ * Purpose:	Writes the binary mesh cache of a parsed Model, building
+ *		its deferred choices first. Nodes that the program added
+ *		are marked dont_save_this_node and left out. It may run
+ *		on another thread once the tree no longer changes, and
+ *		stops if *cancel, which may be NULL, is set.
+ * Returns:	False if the Model could not be stored.
+ */
+extern bool mesh_cache_save (InputFile *, Model *, volatile bool *cancel);
+
+extern bool using_mesh_cache;
+
+/*===========================================================================
+ * Name:	cache_path
+ * Purpose:	Names a file in the user's cache directory that belongs
+ *		to a source file, e.g. its mesh cache (".mxc").
+ * Returns:	False if there is no cache directory.
+ */
+extern bool cache_path (const char *source, const char *extension,
+			char *path_return, char *full_source_return);
+
+extern bool source_identity (const char *path, uint64 &size_return, int64 &time_return);
+
+extern void encode_u32 (unsigned char *, uint32);
+extern void encode_u64 (unsigned char *, uint64);
+extern uint32 decode_u32 (const unsigned char *);
+extern uint64 decode_u64 (const unsigned char *);
+
+#endif
@@ -0,0 +1,1488 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+//----------------------------------------------------------------------------
+// A full intraoral scan can run to two million triangles, which a modest
+// PC does not turn smoothly. Each large face set is therefore reduced,
+// after loading and on a thread of its own, to a few levels of detail,
+// each with about a quarter of the triangles of the one before.
+//
+// A mesh is reduced by collapsing one edge at a time into a single
+// point, always taking the collapse that moves the surface least as the
+// quadric error metric of Garland and Heckbert measures it: each vertex
+// carries the sum of the squared distances to the planes of its original
+// faces, as a symmetric 4x4 matrix, and the merged point goes where the
+// sum of the two is least. Boundary and crease edges add planes at right
+// angles to their faces, which hold them in place. A collapse that would
+// fold a face over or pinch the surface together is not made.
+//
+// How far a reduced mesh is from the original is measured as the
+// Hausdorff distance between them, sampled at the vertices and face
+// centroids of each and looked up through a uniform grid of faces.
+// Since only those points are measured, the result is a lower bound on
+// the true distance.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "mesh.h"
+#include "bvh.h"
+#include "threads.h"
+#include "decimate.h"
+#include "benchmark.h"
+#include "stl.h"
+#include "cache.h"
+
+extern long millisecond_time ();
+
+#define QUADRIC_SIZE (10)		// The upper triangle of a 4x4 matrix.
+#define CONSTRAINT_WEIGHT (100.)	// Of a boundary or crease plane.
+#define MIN_NORMAL_DOT (0.2)		// Of a face before and after a collapse.
+#define CANCEL_CHECK_INTERVAL (4096)	// Collapses between looks at *cancel.
+
+#define VERTEX_BOUNDARY (1)
+#define VERTEX_LOCKED (2)	// On an edge of three or more faces.
+#define VERTEX_DEAD (4)		// Merged into another.
+
+//----------------------------------------
+// A candidate collapse of vertex v into
+// vertex u. It is out of date once the
+// version of either has changed.
+//
+typedef struct {
+	float cost;
+	int u, v;
+	uint32 stamp;
+} Collapse;
+
+typedef struct {
+	int n_vertices;
+	int n_faces;
+	int live_faces;
+	double center [3];
+	double scale;		// Positions are (p - center) / scale.
+	double *positions;
+	double *quadrics;
+	int *faces;		// Three vertices per face, or -1 once collapsed.
+	int *head;		// The first corner of each vertex, or -1.
+	int *next_corner;	// Per corner; those of dead faces are dropped
+				// as they are found.
+	uint32 *version;
+	unsigned char *flags;
+	int *mark;		// Per vertex, for finding shared neighbors.
+	int mark_stamp;
+	int *corners_u;		// Scratch lists of corners.
+	int *corners_v;
+	int corners_max;
+	Collapse *heap;
+	int heap_size;
+	int heap_max;
+	unsigned long size;
+} Decimator;
+
+static Mutex lod_mutex;
+
+//---------------------------------------------------------------------------
+// Name:	decimate_alloc
+// Purpose:	Allocates memory for the Decimator, counting it.
+//---------------------------------------------------------------------------
+static void *
+decimate_alloc (Decimator *d, unsigned long size)
+{
+	void *p = malloc (size ? size : 1);
+	if (!p)
+		fatal ("Out of memory!");
+	d->size += size;
+	return p;
+}
+
+//---------------------------------------------------------------------------
+// Name:	quadric_add_plane
+// Purpose:	Adds the squared distance to the plane ax+by+cz+d=0,
+//		whose normal is of unit length, times a weight.
+//---------------------------------------------------------------------------
+static inline void
+quadric_add_plane (double *q, double a, double b, double c, double d, double weight)
+{
+	q[0] += weight * a * a;
+	q[1] += weight * a * b;
+	q[2] += weight * a * c;
+	q[3] += weight * a * d;
+	q[4] += weight * b * b;
+	q[5] += weight * b * c;
+	q[6] += weight * b * d;
+	q[7] += weight * c * c;
+	q[8] += weight * c * d;
+	q[9] += weight * d * d;
+}
+
+//---------------------------------------------------------------------------
+// Name:	quadric_error
+// Returns:	The sum of squared distances the quadric gives at p.
+//---------------------------------------------------------------------------
+static inline double
+quadric_error (const double *q, const double *p)
+{
+	double x = p[0], y = p[1], z = p[2];
+	return q[0]*x*x + 2.*q[1]*x*y + 2.*q[2]*x*z + 2.*q[3]*x
+		+ q[4]*y*y + 2.*q[5]*y*z + 2.*q[6]*y
+		+ q[7]*z*z + 2.*q[8]*z
+		+ q[9];
+}
+
+//---------------------------------------------------------------------------
+// Name:	quadric_minimum
+// Purpose:	Finds where a quadric is least, by Cramer's rule.
+// Returns:	False if the quadric is too near singular, as it is on
+//		a flat or evenly curved stretch of surface.
+//---------------------------------------------------------------------------
+static bool
+quadric_minimum (const double *q, double *p)
+{
+	double a = q[0], b = q[1], c = q[2];
+	double e = q[4], f = q[5];
+	double h = q[7];
+	double r0 = -q[3], r1 = -q[6], r2 = -q[8];
+
+	double c00 = e*h - f*f;
+	double c01 = c*f - b*h;
+	double c02 = b*f - c*e;
+	double det = a*c00 + b*c01 + c*c02;
+
+	double trace = a + e + h;
+	if (fabs (det) <= 1e-9 * trace * trace * trace)
+		return false;
+
+	p[0] = (r0*c00 + r1*c01 + r2*c02) / det;
+	p[1] = (r0*c01 + r1*(a*h - c*c) + r2*(b*c - a*f)) / det;
+	p[2] = (r0*c02 + r1*(b*c - a*f) + r2*(a*e - b*b)) / det;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_cross
+// Purpose:	Computes the cross product of two edges of a triangle,
+//		which is its normal times twice its area.
+//---------------------------------------------------------------------------
+static inline void
+face_cross (const double *p1, const double *p2, const double *p3, double *n)
+{
+	double ax = p2[0] - p1[0], ay = p2[1] - p1[1], az = p2[2] - p1[2];
+	double bx = p3[0] - p1[0], by = p3[1] - p1[1], bz = p3[2] - p1[2];
+	n[0] = ay*bz - az*by;
+	n[1] = az*bx - ax*bz;
+	n[2] = ax*by - ay*bx;
+}
+
+//---------------------------------------------------------------------------
+// Name:	collapse_position
+// Purpose:	Finds where the merged vertex of a collapse of v into u
+//		should go, and what that costs. A locked vertex stays
+//		where it is. Failing a well-defined minimum near the
+//		edge, the best of its ends and middle is taken.
+// Returns:	False if the collapse may not be made.
+//---------------------------------------------------------------------------
+static bool
+collapse_position (const Decimator *d, int u, int v, double *p, double *cost)
+{
+	const double *pu = d->positions + 3 * u;
+	const double *pv = d->positions + 3 * v;
+
+	if (d->flags [v] & VERTEX_LOCKED)
+		return false;
+
+	double q [QUADRIC_SIZE];
+	int k;
+	for (k = 0; k < QUADRIC_SIZE; k++)
+		q [k] = d->quadrics [QUADRIC_SIZE * u + k] + d->quadrics [QUADRIC_SIZE * v + k];
+
+	if (d->flags [u] & VERTEX_LOCKED) {
+		memcpy (p, pu, 3 * sizeof(double));
+		*cost = quadric_error (q, p);
+		return true;
+	}
+
+	double mid [3], edge = 0.;
+	for (k = 0; k < 3; k++) {
+		mid [k] = 0.5 * (pu [k] + pv [k]);
+		edge += (pu [k] - pv [k]) * (pu [k] - pv [k]);
+	}
+
+	if (quadric_minimum (q, p)) {
+		double away = 0.;
+		for (k = 0; k < 3; k++)
+			away += (p [k] - mid [k]) * (p [k] - mid [k]);
+		if (away <= edge) {
+			*cost = quadric_error (q, p);
+			return true;
+		}
+	}
+
+	const double *choices [3] = { pu, pv, mid };
+	int best = 0;
+	double best_cost = DBL_MAX;
+	for (k = 0; k < 3; k++) {
+		double c = quadric_error (q, choices [k]);
+		if (c < best_cost) {
+			best_cost = c;
+			best = k;
+		}
+	}
+	memcpy (p, choices [best], 3 * sizeof(double));
+	*cost = best_cost;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	heap_up, heap_down
+// Purpose:	Restore the order of the heap of collapses, cheapest
+//		first, after one entry has changed.
+//---------------------------------------------------------------------------
+static void
+heap_up (Collapse *heap, int i)
+{
+	Collapse c = heap [i];
+	while (i > 0) {
+		int parent = (i - 1) / 2;
+		if (heap [parent].cost <= c.cost)
+			break;
+		heap [i] = heap [parent];
+		i = parent;
+	}
+	heap [i] = c;
+}
+
+static void
+heap_down (Collapse *heap, int size, int i)
+{
+	Collapse c = heap [i];
+	for (;;) {
+		int child = 2 * i + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && heap [child + 1].cost < heap [child].cost)
+			child++;
+		if (c.cost <= heap [child].cost)
+			break;
+		heap [i] = heap [child];
+		i = child;
+	}
+	heap [i] = c;
+}
+
+//---------------------------------------------------------------------------
+// Name:	collapse_current
+// Purpose:	Tells whether neither end of a collapse has changed
+//		since it was pushed.
+//---------------------------------------------------------------------------
+static inline bool
+collapse_current (const Decimator *d, const Collapse *c)
+{
+	return !((d->flags [c->u] | d->flags [c->v]) & VERTEX_DEAD) &&
+		c->stamp == d->version [c->u] + d->version [c->v];
+}
+
+//---------------------------------------------------------------------------
+// Name:	push_collapse
+// Purpose:	Adds the cheaper way of collapsing an edge to the heap.
+//		When the heap is full, entries that are out of date are
+//		dropped first, and it grows only if that is not enough.
+//---------------------------------------------------------------------------
+static void
+push_collapse (Decimator *d, int u, int v)
+{
+	double p [3], cost, cost2;
+	bool ok = collapse_position (d, u, v, p, &cost);
+	bool ok2 = collapse_position (d, v, u, p, &cost2);
+	if (!ok && !ok2)
+		return;
+	if (!ok || (ok2 && cost2 < cost)) {
+		int t = u;
+		u = v;
+		v = t;
+		cost = cost2;
+	}
+
+	if (d->heap_size == d->heap_max) {
+		int i, n = 0;
+		for (i = 0; i < d->heap_size; i++)
+			if (collapse_current (d, d->heap + i))
+				d->heap [n++] = d->heap [i];
+		d->heap_size = n;
+		for (i = n / 2 - 1; i >= 0; i--)
+			heap_down (d->heap, n, i);
+
+		if (n > d->heap_max / 2) {
+			d->size -= d->heap_max * sizeof(Collapse);
+			d->heap_max *= 2;
+			d->heap = (Collapse*) realloc (d->heap, d->heap_max * sizeof(Collapse));
+			if (!d->heap)
+				fatal ("Out of memory!");
+			d->size += d->heap_max * sizeof(Collapse);
+		}
+	}
+
+	Collapse *c = d->heap + d->heap_size;
+	c->cost = (float) cost;
+	c->u = u;
+	c->v = v;
+	c->stamp = d->version [u] + d->version [v];
+	heap_up (d->heap, d->heap_size++);
+}
+
+//---------------------------------------------------------------------------
+// Name:	vertex_corners
+// Purpose:	Lists the corners of the live faces of a vertex,
+//		dropping those of dead faces from its chain.
+// Returns:	How many there are.
+//---------------------------------------------------------------------------
+static int
+vertex_corners (Decimator *d, int v, int **list)
+{
+	int n = 0;
+	int *link = d->head + v;
+	while (*link != -1) {
+		int c = *link;
+		if (d->faces [c - c % 3] == -1) {
+			*link = d->next_corner [c];
+			continue;
+		}
+		if (n == d->corners_max) {
+			d->size -= 2 * d->corners_max * sizeof(int);
+			d->corners_max *= 2;
+			d->corners_u = (int*) realloc (d->corners_u, d->corners_max * sizeof(int));
+			d->corners_v = (int*) realloc (d->corners_v, d->corners_max * sizeof(int));
+			if (!d->corners_u || !d->corners_v)
+				fatal ("Out of memory!");
+			d->size += 2 * d->corners_max * sizeof(int);
+		}
+		(*list) [n++] = c;
+		link = d->next_corner + c;
+	}
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	faces_stay_upright
+// Purpose:	Checks that no face around vertex w that is not one of
+//		the collapsed faces, which hold vertex x as well, would
+//		turn over or shrink to nothing if w moved to p.
+//---------------------------------------------------------------------------
+static bool
+faces_stay_upright (const Decimator *d, const int *corners, int n, int w, int x, const double *p)
+{
+	int i;
+	for (i = 0; i < n; i++) {
+		int c = corners [i];
+		const int *f = d->faces + c - c % 3;
+		if (f[0] == x || f[1] == x || f[2] == x)
+			continue;
+
+		const double *p1 = d->positions + 3 * f[0];
+		const double *p2 = d->positions + 3 * f[1];
+		const double *p3 = d->positions + 3 * f[2];
+		double before [3], after [3];
+		face_cross (p1, p2, p3, before);
+		face_cross (f[0] == w ? p : p1, f[1] == w ? p : p2, f[2] == w ? p : p3, after);
+
+		double dot = before[0]*after[0] + before[1]*after[1] + before[2]*after[2];
+		double b2 = before[0]*before[0] + before[1]*before[1] + before[2]*before[2];
+		double a2 = after[0]*after[0] + after[1]*after[1] + after[2]*after[2];
+		if (a2 <= 0. || dot < MIN_NORMAL_DOT * sqrt (a2 * b2))
+			return false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	try_collapse
+// Purpose:	Merges vertex v into u at the position given, unless
+//		that would change the topology of the mesh: the two
+//		may share no neighbor but the third corners of their
+//		shared faces, and two boundary vertices may not be
+//		joined other than along their boundary edge.
+// Returns:	True if the collapse was made.
+//---------------------------------------------------------------------------
+static bool
+try_collapse (Decimator *d, int u, int v, const double *p)
+{
+	int nu = vertex_corners (d, u, &d->corners_u);
+	int nv = vertex_corners (d, v, &d->corners_v);
+	int i, k;
+
+	d->mark_stamp += 2;
+	int seen = d->mark_stamp - 1;
+	int common_seen = d->mark_stamp;
+	for (i = 0; i < nu; i++) {
+		int c = d->corners_u [i];
+		const int *f = d->faces + c - c % 3;
+		for (k = 0; k < 3; k++)
+			if (f[k] != u)
+				d->mark [f[k]] = seen;
+	}
+
+	int shared = 0, common = 0;
+	for (i = 0; i < nv; i++) {
+		int c = d->corners_v [i];
+		const int *f = d->faces + c - c % 3;
+		if (f[0] == u || f[1] == u || f[2] == u)
+			shared++;
+		for (k = 0; k < 3; k++) {
+			int w = f[k];
+			if (w != u && w != v && d->mark [w] == seen) {
+				d->mark [w] = common_seen;
+				common++;
+			}
+		}
+	}
+
+	if (!shared || shared > 2 || common != shared)
+		return false;
+	if (shared == 2 && (d->flags [u] & VERTEX_BOUNDARY) && (d->flags [v] & VERTEX_BOUNDARY))
+		return false;
+	if (!faces_stay_upright (d, d->corners_u, nu, u, v, p) ||
+	    !faces_stay_upright (d, d->corners_v, nv, v, u, p))
+		return false;
+
+	//----------------------------------------
+	// The shared faces go; v's others become
+	// u's, and its chain is joined to u's.
+	//
+	for (i = 0; i < nv; i++) {
+		int c = d->corners_v [i];
+		int *f = d->faces + c - c % 3;
+		if (f[0] == u || f[1] == u || f[2] == u) {
+			f[0] = f[1] = f[2] = -1;
+			d->live_faces--;
+		} else
+			d->faces [c] = u;
+	}
+	d->next_corner [d->corners_v [nv - 1]] = d->head [u];
+	d->head [u] = d->head [v];
+	d->head [v] = -1;
+
+	memcpy (d->positions + 3 * u, p, 3 * sizeof(double));
+	for (k = 0; k < QUADRIC_SIZE; k++)
+		d->quadrics [QUADRIC_SIZE * u + k] += d->quadrics [QUADRIC_SIZE * v + k];
+	d->flags [u] |= d->flags [v] & VERTEX_BOUNDARY;
+	d->flags [v] |= VERTEX_DEAD;
+	d->version [u]++;
+	d->version [v]++;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	edge_plane
+// Purpose:	Adds to the quadrics of both ends of the edge of half-
+//		edge h the plane through it at right angles to its face.
+//---------------------------------------------------------------------------
+static void
+edge_plane (Decimator *d, const float *normals, int h)
+{
+	const float *n = normals + 3 * (h / 3);
+	int v1 = d->faces [h];
+	int v2 = d->faces [halfedge_next (h)];
+	const double *p1 = d->positions + 3 * v1;
+	const double *p2 = d->positions + 3 * v2;
+	double along [3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+	double side [3] = {
+		along[1] * n[2] - along[2] * n[1],
+		along[2] * n[0] - along[0] * n[2],
+		along[0] * n[1] - along[1] * n[0] };
+	double length = sqrt (side[0]*side[0] + side[1]*side[1] + side[2]*side[2]);
+	if (length <= 0.)
+		return;
+
+	int k;
+	for (k = 0; k < 3; k++)
+		side [k] /= length;
+	double dist = -(side[0]*p1[0] + side[1]*p1[1] + side[2]*p1[2]);
+	quadric_add_plane (d->quadrics + QUADRIC_SIZE * v1, side[0], side[1], side[2], dist, CONSTRAINT_WEIGHT);
+	quadric_add_plane (d->quadrics + QUADRIC_SIZE * v2, side[0], side[1], side[2], dist, CONSTRAINT_WEIGHT);
+}
+
+//---------------------------------------------------------------------------
+// Name:	decimator_setup
+// Purpose:	Copies a mesh into a Decimator, gives each vertex the
+//		quadric of its faces and of its boundary and crease
+//		edges, and pushes a collapse for every edge.
+// Returns:	False if *cancel was set meanwhile; the Decimator must
+//		still be freed.
+//---------------------------------------------------------------------------
+static bool
+decimator_setup (Decimator *d, const FlatMesh *m, double crease_angle,
+	volatile bool *cancel)
+{
+	int nv = m->n_vertices;
+	int nf = m->n_faces;
+	int nh = 3 * nf;
+	int v, f, h, k;
+
+	memset (d, 0, sizeof (Decimator));
+	d->n_vertices = nv;
+	d->n_faces = nf;
+
+	//----------------------------------------
+	// Positions are centered and scaled to
+	// about 1, to keep the quadrics well
+	// conditioned.
+	//
+	double lo [3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+	double hi [3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+	for (v = 0; v < nv; v++) {
+		const float *p = flat_position (m, v);
+		for (k = 0; k < 3; k++) {
+			if (p[k] < lo[k]) lo[k] = p[k];
+			if (p[k] > hi[k]) hi[k] = p[k];
+		}
+	}
+	d->scale = 0.;
+	for (k = 0; k < 3; k++) {
+		d->center [k] = nv ? 0.5 * (lo[k] + hi[k]) : 0.;
+		if (nv && hi[k] - lo[k] > d->scale)
+			d->scale = hi[k] - lo[k];
+	}
+	if (d->scale <= 0.)
+		d->scale = 1.;
+
+	d->positions = (double*) decimate_alloc (d, 3 * (unsigned long) nv * sizeof(double));
+	d->quadrics = (double*) decimate_alloc (d, QUADRIC_SIZE * (unsigned long) nv * sizeof(double));
+	d->faces = (int*) decimate_alloc (d, (unsigned long) nh * sizeof(int));
+	d->head = (int*) decimate_alloc (d, (unsigned long) nv * sizeof(int));
+	d->next_corner = (int*) decimate_alloc (d, (unsigned long) nh * sizeof(int));
+	d->version = (uint32*) decimate_alloc (d, (unsigned long) nv * sizeof(uint32));
+	d->flags = (unsigned char*) decimate_alloc (d, nv);
+	d->mark = (int*) decimate_alloc (d, (unsigned long) nv * sizeof(int));
+	d->corners_max = 64;
+	d->corners_u = (int*) decimate_alloc (d, d->corners_max * sizeof(int));
+	d->corners_v = (int*) decimate_alloc (d, d->corners_max * sizeof(int));
+
+	for (v = 0; v < nv; v++) {
+		const float *p = flat_position (m, v);
+		for (k = 0; k < 3; k++)
+			d->positions [3*v + k] = (p[k] - d->center [k]) / d->scale;
+		d->head [v] = -1;
+	}
+	memset (d->quadrics, 0, QUADRIC_SIZE * (unsigned long) nv * sizeof(double));
+	memset (d->version, 0, (unsigned long) nv * sizeof(uint32));
+	memset (d->flags, 0, nv);
+	memset (d->mark, 0, (unsigned long) nv * sizeof(int));
+
+	//----------------------------------------
+	// Faces with a repeated vertex are left
+	// out; the rest add their planes.
+	//
+	float *normals = (float*) decimate_alloc (d, 3 * (unsigned long) nf * sizeof(float));
+	for (f = 0; f < nf; f++) {
+		const uint32 *fv = flat_face (m, f);
+		int *face = d->faces + 3 * f;
+		float *normal = normals + 3 * f;
+		if (fv[0] == fv[1] || fv[1] == fv[2] || fv[2] == fv[0]) {
+			face[0] = face[1] = face[2] = -1;
+			normal[0] = normal[1] = normal[2] = 0.f;
+			continue;
+		}
+		d->live_faces++;
+		for (k = 0; k < 3; k++) {
+			face [k] = fv [k];
+			d->next_corner [3*f + k] = d->head [fv[k]];
+			d->head [fv[k]] = 3*f + k;
+		}
+
+		const double *p1 = d->positions + 3 * face[0];
+		double n [3];
+		face_cross (p1, d->positions + 3 * face[1], d->positions + 3 * face[2], n);
+		double length = sqrt (n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+		if (length <= 0.) {
+			normal[0] = normal[1] = normal[2] = 0.f;
+			continue;
+		}
+		for (k = 0; k < 3; k++)
+			normal [k] = n [k] /= length;
+		double dist = -(n[0]*p1[0] + n[1]*p1[1] + n[2]*p1[2]);
+		for (k = 0; k < 3; k++)
+			quadric_add_plane (d->quadrics + QUADRIC_SIZE * face[k], n[0], n[1], n[2], dist, 1.);
+	}
+
+	//----------------------------------------
+	// Then the edges: each is counted, with
+	// its first face, to find the boundary,
+	// crease and non-manifold ones.
+	//
+	int *edge_of = (int*) decimate_alloc (d, (unsigned long) nh * sizeof(int));
+	uint32 *edge_ends = (uint32*) decimate_alloc (d, 2 * (unsigned long) nh * sizeof(uint32));
+	int n_edges = flatmesh_edges (m, edge_of, edge_ends);
+	int *edge_count = (int*) decimate_alloc (d, (unsigned long) n_edges * sizeof(int));
+	int *edge_face = (int*) decimate_alloc (d, (unsigned long) n_edges * sizeof(int));
+	memset (edge_count, 0, (unsigned long) n_edges * sizeof(int));
+
+	for (h = 0; h < nh; h++) {
+		int e = edge_of [h];
+		if (e < 0 || d->faces [h] == -1)
+			continue;
+		if (!edge_count [e]++)
+			edge_face [e] = h;
+	}
+
+	//----------------------------------------
+	// A boundary edge adds the plane through
+	// it at right angles to its face, as does
+	// a crease edge for each of its two.
+	//
+	double cos_crease = cos (crease_angle);
+	for (h = 0; h < nh; h++) {
+		int e = edge_of [h];
+		if (e < 0 || d->faces [h] == -1)
+			continue;
+
+		if (edge_count [e] == 1) {
+			edge_plane (d, normals, h);
+			d->flags [edge_ends [2*e]] |= VERTEX_BOUNDARY;
+			d->flags [edge_ends [2*e+1]] |= VERTEX_BOUNDARY;
+		}
+		else if (edge_count [e] == 2 && edge_face [e] != h) {
+			const float *n1 = normals + 3 * (edge_face [e] / 3);
+			const float *n2 = normals + 3 * (h / 3);
+			double dot = (double) n1[0] * n2[0] + (double) n1[1] * n2[1] + (double) n1[2] * n2[2];
+			if (dot < cos_crease) {
+				edge_plane (d, normals, edge_face [e]);
+				edge_plane (d, normals, h);
+			}
+		}
+		else if (edge_count [e] > 2) {
+			d->flags [edge_ends [2*e]] |= VERTEX_LOCKED;
+			d->flags [edge_ends [2*e+1]] |= VERTEX_LOCKED;
+		}
+	}
+
+	d->heap_max = n_edges + n_edges / 2 + 16;
+	d->heap = (Collapse*) decimate_alloc (d, d->heap_max * sizeof(Collapse));
+	bool cancelled = false;
+	for (k = 0; k < n_edges; k++) {
+		if (edge_count [k])
+			push_collapse (d, edge_ends [2*k], edge_ends [2*k+1]);
+		if (cancel && !(k % CANCEL_CHECK_INTERVAL) && *cancel) {
+			cancelled = true;
+			break;
+		}
+	}
+
+	free (normals);
+	free (edge_of);
+	free (edge_ends);
+	free (edge_count);
+	free (edge_face);
+	d->size -= 3 * (unsigned long) nf * sizeof(float)
+		+ 3 * (unsigned long) nh * sizeof(int)
+		+ 2 * (unsigned long) n_edges * sizeof(int);
+	return !cancelled;
+}
+
+//---------------------------------------------------------------------------
+// Name:	decimator_free
+//---------------------------------------------------------------------------
+static void
+decimator_free (Decimator *d)
+{
+	free (d->positions);
+	free (d->quadrics);
+	free (d->faces);
+	free (d->head);
+	free (d->next_corner);
+	free (d->version);
+	free (d->flags);
+	free (d->mark);
+	free (d->corners_u);
+	free (d->corners_v);
+	free (d->heap);
+}
+
+//---------------------------------------------------------------------------
+// Name:	decimator_mesh
+// Purpose:	Makes a FlatMesh of the live faces and the vertices
+//		they use, in their original order, with face normals
+//		and areas.
+//---------------------------------------------------------------------------
+static FlatMesh *
+decimator_mesh (Decimator *d)
+{
+	int nv = d->n_vertices;
+	int nf = d->n_faces;
+	int v, f, k;
+
+	// mark becomes the new number of each vertex.
+	for (v = 0; v < nv; v++)
+		d->mark [v] = -1;
+	for (f = 0; f < nf; f++)
+		if (d->faces [3*f] != -1)
+			for (k = 0; k < 3; k++)
+				d->mark [d->faces [3*f + k]] = 0;
+	int n_vertices = 0;
+	for (v = 0; v < nv; v++)
+		if (!d->mark [v])
+			d->mark [v] = n_vertices++;
+
+	FlatMesh *m = flatmesh_new (n_vertices, d->live_faces);
+	for (v = 0; v < nv; v++) {
+		if (d->mark [v] < 0)
+			continue;
+		float *p = flat_position (m, d->mark [v]);
+		float *n = flat_normal (m, d->mark [v]);
+		for (k = 0; k < 3; k++) {
+			p [k] = d->positions [3*v + k] * d->scale + d->center [k];
+			n [k] = 0.f;
+		}
+		m->smooth [d->mark [v]] = 0;
+	}
+
+	int i = 0;
+	for (f = 0; f < nf; f++) {
+		if (d->faces [3*f] == -1)
+			continue;
+		uint32 *face = flat_face (m, i);
+		for (k = 0; k < 3; k++)
+			face [k] = d->mark [d->faces [3*f + k]];
+
+		double p [3][3], n [3];
+		for (k = 0; k < 3; k++) {
+			const float *q = flat_position (m, face [k]);
+			p [k][0] = q [0];
+			p [k][1] = q [1];
+			p [k][2] = q [2];
+		}
+		face_cross (p[0], p[1], p[2], n);
+		double length = sqrt (n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+		float *normal = flat_face_normal (m, i);
+		for (k = 0; k < 3; k++)
+			normal [k] = length > 0. ? n [k] / length : 0.;
+		m->face_areas [i] = 0.5 * length;
+		i++;
+	}
+	return m;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_decimate
+//---------------------------------------------------------------------------
+FlatMesh *
+mesh_decimate (const FlatMesh *m, int target_faces, double max_error,
+	double crease_angle, volatile bool *cancel)
+{
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	Decimator d;
+	bool cancelled = !decimator_setup (&d, m, crease_angle, cancel);
+	total_allocated += d.size;
+	unsigned long size = d.size;
+
+	// The cost is a sum of squared distances.
+	double max_cost = max_error > 0. ? max_error * max_error / (d.scale * d.scale) : DBL_MAX;
+
+	int collapses = 0;
+	while (!cancelled && d.live_faces > target_faces && d.heap_size) {
+		Collapse c = d.heap [0];
+		d.heap [0] = d.heap [--d.heap_size];
+		if (d.heap_size)
+			heap_down (d.heap, d.heap_size, 0);
+
+		if (!collapse_current (&d, &c))
+			continue;
+		if (c.cost > max_cost)
+			break;
+
+		//----------------------------------------
+		// The position is found again, rather
+		// than kept in each of the many entries.
+		//
+		double p [3], cost;
+		if (!collapse_position (&d, c.u, c.v, p, &cost) || !try_collapse (&d, c.u, c.v, p))
+			continue;
+
+		int i, k;
+		int n = vertex_corners (&d, c.u, &d.corners_u);
+		d.mark_stamp++;
+		for (i = 0; i < n; i++) {
+			int corner = d.corners_u [i];
+			const int *f = d.faces + corner - corner % 3;
+			for (k = 0; k < 3; k++) {
+				int w = f[k];
+				if (w != c.u && d.mark [w] != d.mark_stamp) {
+					d.mark [w] = d.mark_stamp;
+					push_collapse (&d, c.u, w);
+				}
+			}
+		}
+
+		if (cancel && !(++collapses % CANCEL_CHECK_INTERVAL) && *cancel) {
+			cancelled = true;
+			break;
+		}
+	}
+
+	FlatMesh *result = cancelled ? NULL : decimator_mesh (&d);
+
+	decimator_free (&d);
+	total_allocated -= size;
+	return result;
+}
+
+//---------------------------------------------------------------------------
+// The Hausdorff distance. Faces are binned by their bounding boxes into
+// a uniform grid of about as many cells as faces, and the closest face
+// to a point is found by searching shells of cells outward from the
+// point's own, until no closer face can lie in the next shell.
+//---------------------------------------------------------------------------
+
+#define HAUSDORFF_BLOCK_SIZE (4096)	// Samples per parallel_for call.
+
+typedef struct {
+	const FlatMesh *mesh;
+	double origin [3];
+	double cell;
+	int dims [3];
+	int *cell_start;	// Per cell, plus one more.
+	int *cell_faces;
+	unsigned long size;
+} FaceGrid;
+
+//---------------------------------------------------------------------------
+// Name:	grid_cell_range
+// Purpose:	Finds the cells that a face's bounding box overlaps.
+//---------------------------------------------------------------------------
+static void
+grid_cell_range (const FaceGrid *g, int f, int *lo, int *hi)
+{
+	const uint32 *v = flat_face (g->mesh, f);
+	int k, j;
+	for (k = 0; k < 3; k++) {
+		double a = DBL_MAX, b = -DBL_MAX;
+		for (j = 0; j < 3; j++) {
+			double x = flat_position (g->mesh, v[j]) [k];
+			if (x < a) a = x;
+			if (x > b) b = x;
+		}
+		lo [k] = (int) ((a - g->origin [k]) / g->cell);
+		hi [k] = (int) ((b - g->origin [k]) / g->cell);
+		if (lo [k] < 0) lo [k] = 0;
+		if (hi [k] >= g->dims [k]) hi [k] = g->dims [k] - 1;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_grid_build
+//---------------------------------------------------------------------------
+static void
+face_grid_build (FaceGrid *g, const FlatMesh *m)
+{
+	int nf = m->n_faces;
+	int f, k, x, y, z;
+
+	memset (g, 0, sizeof (FaceGrid));
+	g->mesh = m;
+
+	double lo [3] = { DBL_MAX, DBL_MAX, DBL_MAX };
+	double hi [3] = { -DBL_MAX, -DBL_MAX, -DBL_MAX };
+	double area = 0.;
+	for (f = 0; f < nf; f++) {
+		const uint32 *v = flat_face (m, f);
+		double p [3][3], n [3];
+		int j;
+		for (j = 0; j < 3; j++) {
+			const float *q = flat_position (m, v[j]);
+			for (k = 0; k < 3; k++) {
+				p [j][k] = q [k];
+				if (q[k] < lo[k]) lo[k] = q[k];
+				if (q[k] > hi[k]) hi[k] = q[k];
+			}
+		}
+		face_cross (p[0], p[1], p[2], n);
+		area += 0.5 * sqrt (n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+	}
+	if (!nf) {
+		g->dims [0] = g->dims [1] = g->dims [2] = 0;
+		return;
+	}
+
+	//----------------------------------------
+	// Cells about twice the size of a face,
+	// but no more of them than 4 per face.
+	//
+	double extent = 0.;
+	for (k = 0; k < 3; k++) {
+		g->origin [k] = lo [k];
+		if (hi [k] - lo [k] > extent)
+			extent = hi [k] - lo [k];
+	}
+	g->cell = 2. * sqrt (area / nf);
+	if (g->cell <= extent * 1e-6)
+		g->cell = extent > 0. ? extent / 64. : 1.;
+	for (;;) {
+		double cells = 1.;
+		for (k = 0; k < 3; k++) {
+			g->dims [k] = 1 + (int) ((hi [k] - lo [k]) / g->cell);
+			cells *= g->dims [k];
+		}
+		if (cells <= 4. * nf + 64.)
+			break;
+		g->cell *= 1.25;
+	}
+
+	int n_cells = g->dims [0] * g->dims [1] * g->dims [2];
+	g->cell_start = (int*) malloc ((n_cells + 1) * sizeof(int));
+	if (!g->cell_start)
+		fatal ("Out of memory!");
+	memset (g->cell_start, 0, (n_cells + 1) * sizeof(int));
+
+	int clo [3], chi [3];
+	for (f = 0; f < nf; f++) {
+		grid_cell_range (g, f, clo, chi);
+		for (z = clo[2]; z <= chi[2]; z++)
+			for (y = clo[1]; y <= chi[1]; y++)
+				for (x = clo[0]; x <= chi[0]; x++)
+					g->cell_start [1 + x + g->dims[0] * (y + g->dims[1] * z)]++;
+	}
+	for (k = 0; k < n_cells; k++)
+		g->cell_start [k + 1] += g->cell_start [k];
+
+	int n_entries = g->cell_start [n_cells];
+	g->cell_faces = (int*) malloc ((n_entries ? n_entries : 1) * sizeof(int));
+	if (!g->cell_faces)
+		fatal ("Out of memory!");
+	for (f = 0; f < nf; f++) {
+		grid_cell_range (g, f, clo, chi);
+		for (z = clo[2]; z <= chi[2]; z++)
+			for (y = clo[1]; y <= chi[1]; y++)
+				for (x = clo[0]; x <= chi[0]; x++)
+					g->cell_faces [g->cell_start [x + g->dims[0] * (y + g->dims[1] * z)]++] = f;
+	}
+	for (k = n_cells; k > 0; k--)
+		g->cell_start [k] = g->cell_start [k - 1];
+	g->cell_start [0] = 0;
+
+	g->size = (n_cells + 1 + (unsigned long) n_entries) * sizeof(int);
+	total_allocated += g->size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_grid_free
+//---------------------------------------------------------------------------
+static void
+face_grid_free (FaceGrid *g)
+{
+	free (g->cell_start);
+	free (g->cell_faces);
+	total_allocated -= g->size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	grid_cell_nearest
+// Purpose:	Lowers *best to the squared distance from p to the
+//		nearest face in one cell.
+//---------------------------------------------------------------------------
+static inline void
+grid_cell_nearest (const FaceGrid *g, int x, int y, int z, const double *p, double *best)
+{
+	int cell = x + g->dims[0] * (y + g->dims[1] * z);
+	int i;
+	for (i = g->cell_start [cell]; i < g->cell_start [cell + 1]; i++) {
+		const uint32 *v = flat_face (g->mesh, g->cell_faces [i]);
+		double d2 = triangle_distance2 (p, flat_position (g->mesh, v[0]),
+			flat_position (g->mesh, v[1]), flat_position (g->mesh, v[2]), NULL);
+		if (d2 < *best)
+			*best = d2;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	face_grid_distance
+// Returns:	The distance from p to the nearest face of the grid.
+//---------------------------------------------------------------------------
+static double
+face_grid_distance (const FaceGrid *g, const double *p)
+{
+	int c [3], k, x, y, z, r;
+	for (k = 0; k < 3; k++) {
+		c [k] = (int) floor ((p [k] - g->origin [k]) / g->cell);
+		if (c [k] < 0) c [k] = 0;
+		if (c [k] >= g->dims [k]) c [k] = g->dims [k] - 1;
+	}
+
+	double best = DBL_MAX;
+	for (r = 0; ; r++) {
+		//----------------------------------------
+		// The shell of cells r away: all of z
+		// on its x and y faces, only the two
+		// ends of z inside them.
+		//
+		for (x = c[0] - r; x <= c[0] + r; x++) {
+			if (x < 0 || x >= g->dims[0])
+				continue;
+			for (y = c[1] - r; y <= c[1] + r; y++) {
+				if (y < 0 || y >= g->dims[1])
+					continue;
+				bool side = x == c[0] - r || x == c[0] + r || y == c[1] - r || y == c[1] + r;
+				int step = side || !r ? 1 : 2 * r;
+				for (z = c[2] - r; z <= c[2] + r; z += step)
+					if (z >= 0 && z < g->dims[2])
+						grid_cell_nearest (g, x, y, z, p, &best);
+			}
+		}
+
+		//----------------------------------------
+		// Faces not yet seen are outside the box
+		// of cells searched, on a side where the
+		// grid goes on.
+		//
+		double outside = DBL_MAX;
+		for (k = 0; k < 3; k++) {
+			double low = g->origin [k] + (c [k] - r) * g->cell;
+			double high = low + (2 * r + 1) * g->cell;
+			if (c [k] - r > 0 && p [k] - low < outside)
+				outside = p [k] - low;
+			if (c [k] + r < g->dims [k] - 1 && high - p [k] < outside)
+				outside = high - p [k];
+		}
+		if (best <= outside * outside || outside == DBL_MAX)
+			break;
+	}
+	return best < DBL_MAX ? sqrt (best) : 0.;
+}
+
+typedef struct {
+	const FlatMesh *from;
+	const FaceGrid *to;
+	double *block_max;
+	double *block_sum;
+	volatile bool *cancel;
+} HausdorffJob;
+
+//---------------------------------------------------------------------------
+// Name:	hausdorff_block
+// Purpose:	Measures one block of samples, the vertices and then
+//		the face centroids of a mesh, for parallel_for.
+//---------------------------------------------------------------------------
+static void
+hausdorff_block (void *arg, int block)
+{
+	HausdorffJob *job = (HausdorffJob*) arg;
+	const FlatMesh *m = job->from;
+	int n_samples = m->n_vertices + m->n_faces;
+	int first = block * HAUSDORFF_BLOCK_SIZE;
+	int last = first + HAUSDORFF_BLOCK_SIZE;
+	if (last > n_samples)
+		last = n_samples;
+
+	double max = 0., sum = 0.;
+	int i, j, k;
+	if (job->cancel && *job->cancel)
+		last = first;
+	for (i = first; i < last; i++) {
+		double p [3];
+		if (i < m->n_vertices) {
+			const float *q = flat_position (m, i);
+			for (k = 0; k < 3; k++)
+				p [k] = q [k];
+		} else {
+			const uint32 *v = flat_face (m, i - m->n_vertices);
+			for (k = 0; k < 3; k++) {
+				p [k] = 0.;
+				for (j = 0; j < 3; j++)
+					p [k] += flat_position (m, v[j]) [k] / 3.;
+			}
+		}
+		double distance = face_grid_distance (job->to, p);
+		if (distance > max)
+			max = distance;
+		sum += distance;
+	}
+	job->block_max [block] = max;
+	job->block_sum [block] = sum;
+}
+
+//---------------------------------------------------------------------------
+// Name:	directed_hausdorff
+// Purpose:	Measures how far the samples of one mesh are from the
+//		faces of another. Blocks are summed in order, so that
+//		the result does not depend on the number of threads.
+// Returns:	The largest distance; the sum of them in *sum_return.
+//---------------------------------------------------------------------------
+static double
+directed_hausdorff (const FlatMesh *from, const FaceGrid *to, double *sum_return,
+	volatile bool *cancel)
+{
+	int n_samples = from->n_vertices + from->n_faces;
+	int n_blocks = (n_samples + HAUSDORFF_BLOCK_SIZE - 1) / HAUSDORFF_BLOCK_SIZE;
+
+	*sum_return = 0.;
+	if (!n_blocks || !to->mesh->n_faces)
+		return 0.;
+
+	HausdorffJob job;
+	job.from = from;
+	job.to = to;
+	job.block_max = (double*) malloc (2 * n_blocks * sizeof(double));
+	if (!job.block_max)
+		fatal ("Out of memory!");
+	job.block_sum = job.block_max + n_blocks;
+	job.cancel = cancel;
+
+	parallel_for (n_blocks, hausdorff_block, &job);
+
+	double max = 0.;
+	int i;
+	for (i = 0; i < n_blocks; i++) {
+		if (job.block_max [i] > max)
+			max = job.block_max [i];
+		*sum_return += job.block_sum [i];
+	}
+	free (job.block_max);
+	return max;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_hausdorff
+//---------------------------------------------------------------------------
+double
+mesh_hausdorff (const FlatMesh *a, const FlatMesh *b, double *mean_return,
+	volatile bool *cancel)
+{
+	ASSERT_NONZERO (a,"mesh a")
+	ASSERT_NONZERO (b,"mesh b")
+	//----------
+
+	FaceGrid grid_a, grid_b;
+	face_grid_build (&grid_a, a);
+	face_grid_build (&grid_b, b);
+
+	double sum_ab, sum_ba;
+	double ab = directed_hausdorff (a, &grid_b, &sum_ab, cancel);
+	double ba = directed_hausdorff (b, &grid_a, &sum_ba, cancel);
+
+	face_grid_free (&grid_a);
+	face_grid_free (&grid_b);
+
+	if (mean_return) {
+		unsigned long n = a->n_vertices + a->n_faces + b->n_vertices + b->n_faces;
+		*mean_return = n ? (sum_ab + sum_ba) / n : 0.;
+	}
+	return ab > ba ? ab : ba;
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::lod
+//---------------------------------------------------------------------------
+FlatMesh *
+IndexedFaceSet::lod (int level)
+{
+	if (level <= 0)
+		return flat;
+
+	lod_mutex.lock ();
+	int n = n_lods;
+	lod_mutex.unlock ();
+
+	if (!n)
+		return flat;
+	return lods [(level < n ? level : n) - 1];
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::build_lods
+// Purpose:	Each level is made from the one before, which is
+//		quicker than from the full mesh and gives about the
+//		same result; its error is measured against the full
+//		mesh.
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::build_lods (int n_levels, double ratio, double max_error, volatile bool *cancel)
+{
+	FlatMesh *full = flat;
+	FlatMesh *previous = full;
+
+	if (!full || n_levels > IFS_MAX_LODS)
+		return;
+
+	while (n_lods < n_levels && previous->n_faces >= LOD_MIN_FACES) {
+		if (cancel && *cancel)
+			return;
+
+		int target = (int) (ratio * previous->n_faces);
+		FlatMesh *m = mesh_decimate (previous, target, max_error, DECIMATE_CREASE_ANGLE, cancel);
+		if (!m)
+			return;
+
+		// A mesh that will not reduce further is not kept.
+		if (m->n_faces > 0.9 * previous->n_faces) {
+			flatmesh_free (m);
+			return;
+		}
+		flatmesh_smooth (m, crease_angle);
+		float error = mesh_hausdorff (full, m, NULL, cancel);
+		if (cancel && *cancel) {
+			flatmesh_free (m);
+			return;
+		}
+
+		lod_mutex.lock ();
+		lods [n_lods] = m;
+		lod_errors [n_lods] = error;
+		n_lods++;
+		lod_mutex.unlock ();
+
+		previous = m;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::drop_lods
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::drop_lods ()
+{
+	int i;
+	for (i = 0; i < n_lods; i++)
+		flatmesh_free (lods [i]);
+	n_lods = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	build_set_lods
+// Purpose:	Makes the levels of detail of one face set, for
+//		parallel_for.
+//---------------------------------------------------------------------------
+static void
+build_set_lods (void *arg, int i)
+{
+	Model *model = (Model*) arg;
+	model->lod_sets [i]->build_lods (LOD_LEVELS, LOD_RATIO, 0., &model->lod_cancel);
+}
+
+//---------------------------------------------------------------------------
+// Name:	lod_thread_main
+// Purpose:	Saves the mesh cache, if the Model is to be cached;
+//		with every choice built, the tree no longer changes.
+//		Then makes the levels of detail.
+//---------------------------------------------------------------------------
+static void *
+lod_thread_main (void *arg)
+{
+	Model *model = (Model*) arg;
+	if (model->caching && model->inputfile)
+		mesh_cache_save (model->inputfile, model, &model->lod_cancel);
+	parallel_for (model->n_lod_sets, build_set_lods, model);
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	count_face_sets
+//---------------------------------------------------------------------------
+static int
+count_face_sets (Node *n)
+{
+	int count = 0;
+	for (; n; n = n->next) {
+		if (!strcmp (n->type, "IndexedFaceSet"))
+			count++;
+		count += count_face_sets (n->children);
+	}
+	return count;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Model::start_lods
+// Purpose:	Collects the face sets, which the thread only reads,
+//		then starts it.
+//---------------------------------------------------------------------------
+void
+Model::start_lods ()
+{
+	if (lods_started)
+		return;
+	lods_started = true;
+
+	int n = count_face_sets (nodes);
+	if (!n && !caching)
+		return;
+
+	lod_sets = (IndexedFaceSet**) malloc ((n ? n : 1) * sizeof(IndexedFaceSet*));
+	if (!lod_sets)
+		fatal ("Out of memory!");
+	n_lod_sets = 0;
+	collect_face_sets (nodes, lod_sets, &n_lod_sets, n);
+
+	lod_cancel = false;
+	lod_thread = thread_start (lod_thread_main, this);
+}
+
+//---------------------------------------------------------------------------
+// Name:	Model::stop_lods
+//---------------------------------------------------------------------------
+void
+Model::stop_lods ()
+{
+	if (lod_thread) {
+		lod_cancel = true;
+		thread_join (lod_thread);
+		lod_thread = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	Model::lod_error
+//---------------------------------------------------------------------------
+double
+Model::lod_error (int level)
+{
+	double error = 0.;
+	int i;
+
+	if (level <= 0)
+		return 0.;
+	if (!lods_started)
+		return -1.;
+
+	lod_mutex.lock ();
+	for (i = 0; i < n_lod_sets; i++) {
+		IndexedFaceSet *ifs = lod_sets [i];
+		if (!ifs->n_lods) {
+			if (ifs->flat->n_faces >= LOD_MIN_FACES)
+				error = -1.;
+			continue;
+		}
+		if (error >= 0.) {
+			int k = (level < ifs->n_lods ? level : ifs->n_lods) - 1;
+			if (ifs->lod_errors [k] > error)
+				error = ifs->lod_errors [k];
+		}
+	}
+	lod_mutex.unlock ();
+	return error;
+}
+
+//---------------------------------------------------------------------------
+// Name:	decimate_file
+//---------------------------------------------------------------------------
+bool
+decimate_file (char *in_path, char *out_path, double target, double max_error)
+{
+	ASSERT_NONZERO (in_path,"in_path")
+	ASSERT_NONZERO (out_path,"out_path")
+	//----------
+
+	InputFile *file;
+	Model *model = load_benchmark_model (in_path, &file);
+	if (!model)
+		return false;
+	model->build_all ();
+
+	int n_sets = count_face_sets (model->nodes);
+	IndexedFaceSet **sets = (IndexedFaceSet**) malloc ((n_sets ? n_sets : 1) * sizeof(IndexedFaceSet*));
+	if (!sets)
+		fatal ("Out of memory!");
+	int i = 0;
+	collect_face_sets (model->nodes, sets, &i, n_sets);
+
+	unsigned long total_faces = 0;
+	for (i = 0; i < n_sets; i++)
+		total_faces += sets [i]->n_triangles;
+
+	//----------------------------------------
+	// A number of triangles is shared among
+	// the meshes in proportion to their size.
+	//
+	long t0 = millisecond_time ();
+	for (i = 0; i < n_sets; i++) {
+		IndexedFaceSet *ifs = sets [i];
+		FlatMesh *full = ifs->flat;
+		int target_faces = target < 1. ?
+			(int) (target * full->n_faces) :
+			(int) (target * full->n_faces / total_faces);
+
+		FlatMesh *m = mesh_decimate (full, target_faces, max_error, DECIMATE_CREASE_ANGLE, NULL);
+		flatmesh_smooth (m, ifs->crease_angle);
+		double mean;
+		double error = mesh_hausdorff (full, m, &mean, NULL);
+
+		ifs->drop_lods ();
+		ifs->lods [0] = m;
+		ifs->lod_errors [0] = error;
+		ifs->n_lods = 1;
+
+		// Models are in meters.
+		printf ("Mesh %d: %d triangles reduced to %d; sampled Hausdorff distance %.4f mm, mean %.4f mm.\n",
+			i + 1, full->n_faces, m->n_faces, 1000. * error, 1000. * mean);
+	}
+	printf ("Reduced in %ld ms.\n", millisecond_time () - t0);
+
+	// The reduced meshes were smoothed as they were made.
+	model->smoothed = true;
+	saving_lod = 1;
+	bool ok = true;
+	int length = strlen (out_path);
+	if (length >= 4 && !strcasecmp (".stl", out_path + length - 4)) {
+		//----------------------------------------
+		// STL holds one mesh per file, so more
+		// are numbered: "out 1.stl", "out 2.stl".
+		//
+		for (i = 0; i < n_sets; i++) {
+			char path [PATH_MAX];
+			if (n_sets == 1)
+				strcpy (path, out_path);
+			else
+				sprintf (path, "%.*s %d.stl", length - 4, out_path, i + 1);
+
+			if (!stl_export (sets [i], path)) {
+				printf ("Unable to write %s.\n", path);
+				ok = false;
+				break;
+			}
+			printf ("Wrote %s.\n", path);
+		}
+	} else {
+		OutputFile f;
+		if (f.open (out_path, false))
+			model->serialize (&f);
+		ok = f.close ();
+		printf (ok ? "Wrote %s.\n" : "Unable to write %s.\n", out_path);
+	}
+	saving_lod = 0;
+
+	free (sets);
+	delete model;
+	delete file;
+	return ok;
+}
@@ -0,0 +1,67 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _DECIMATE_H
+#define _DECIMATE_H
+
+#define LOD_LEVELS (3)		// Made per face set after loading.
+#define LOD_RATIO (0.25)	// Faces kept from one level to the next.
+#define LOD_MIN_FACES (8192)	// Smaller meshes are not reduced further.
+
+// Edges whose faces meet at more than this are kept as they are,
+// as are boundaries.
+#define DECIMATE_CREASE_ANGLE (M_PI / 3.)
+
+/*===========================================================================
+ * Name:	mesh_decimate
+ * Purpose:	Reduces a mesh by collapsing edges in the order of the
+ *		quadric error of each collapse, until no more than
+ *		target_faces remain or the next collapse would move the
+ *		surface by more than max_error, if that is not 0.
+ *		Boundaries and creases sharper than crease_angle are
+ *		preserved. The vertex normals are left for flatmesh_smooth.
+ * Returns:	The new mesh, or NULL if *cancel was set meanwhile.
+ */
+extern FlatMesh *mesh_decimate (const FlatMesh *, int target_faces, double max_error,
+	double crease_angle, volatile bool *cancel);
+
+/*===========================================================================
+ * Name:	mesh_hausdorff
+ * Purpose:	Measures how far apart two meshes are, sampling the
+ *		vertices and face centroids of each one and finding the
+ *		closest point on the other. Stops early if *cancel is set.
+ * Returns:	The largest distance found, which is a lower bound on the
+ *		Hausdorff distance; the mean one in *mean_return, if that
+ *		is not NULL.
+ */
+extern double mesh_hausdorff (const FlatMesh *, const FlatMesh *, double *mean_return,
+	volatile bool *cancel);
+
+/*===========================================================================
+ * Name:	decimate_file
+ * Purpose:	Tool mode (-decimate): reduces every mesh of a model file
+ *		to target, a number of triangles or, if less than 1, a
+ *		fraction of them, reports the error of each and saves the
+ *		result as STL, DST or VRML, as the output path ends.
+ * Returns:	False on failure.
+ */
+extern bool decimate_file (char *in_path, char *out_path, double target, double max_error);
+
+#endif
@@ -0,0 +1,956 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+//----------------------------------------------------------------------------
+// A gzip file can only be inflated from its start, unless one knows where
+// its deflate blocks begin and what the 32 kB of data before each looked
+// like. The index records both every GZINDEX_SPAN bytes, as in zlib's
+// examples/zran.c, along with the offsets of the file's DEF'd nodes, so
+// that a node such as the patient data can be read without inflating
+// everything before it.
+//
+// The index is a sidecar file in the user's cache directory (see
+// cache_path). All values are little-endian. The file begins with a
+// fixed header:
+//
+//	"MXGI", version, source size, source time, data size,
+//	number of points, number of entries, compressed flag
+//
+// followed by the points (uncompressed offset, compressed offset, bits,
+// size and deflated contents of the window) and then the entries
+// (offset, end, name, type).
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "cache.h"
+#include "gzindex.h"
+#include "zstdfile.h"
+
+// Increment whenever the layout above changes.
+#define GZINDEX_VERSION (1)
+
+#define GZINDEX_MAGIC "MXGI"
+#define GZINDEX_HEADERSIZE (48)
+#define GZINDEX_CHUNKSIZE (64*1024)
+
+// States of the scan for entries.
+enum {
+	SCAN_SPACE = 0,
+	SCAN_WORD,
+	SCAN_COMMENT,
+	SCAN_STRING,
+};
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::GzIndex
+// Purpose:	Creates an empty index.
+//---------------------------------------------------------------------------
+GzIndex::GzIndex ()
+{
+	points = NULL;
+	n_points = points_size = 0;
+	entries = NULL;
+	n_entries = entries_size = 0;
+	open = NULL;
+	n_open = open_size = 0;
+	clear ();
+
+	total_allocated += sizeof(GzIndex);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::~GzIndex
+//---------------------------------------------------------------------------
+GzIndex::~GzIndex ()
+{
+	clear ();
+	total_allocated -= sizeof(GzIndex);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::clear
+// Purpose:	Empties the index.
+//---------------------------------------------------------------------------
+void
+GzIndex::clear ()
+{
+	int i;
+
+	for (i = 0; i < n_points; i++)
+		free (points[i].window);
+	total_allocated -= n_points * GZINDEX_WINDOWSIZE;
+	total_allocated -= points_size * sizeof(GzIndexPoint);
+	free (points);
+	points = NULL;
+	n_points = points_size = 0;
+
+	for (i = 0; i < n_entries; i++) {
+		total_allocated -= strlen (entries[i].name) + strlen (entries[i].type) + 2;
+		free (entries[i].name);
+		free (entries[i].type);
+	}
+	total_allocated -= entries_size * sizeof(GzIndexEntry);
+	free (entries);
+	entries = NULL;
+	n_entries = entries_size = 0;
+
+	total_allocated -= open_size * 2 * sizeof(int);
+	free (open);
+	open = NULL;
+	n_open = open_size = 0;
+
+	compressed = false;
+	data_size = 0;
+	scan_state = SCAN_SPACE;
+	word_len = 0;
+	word_start = 0;
+	depth = 0;
+	def_state = 0;
+	def_offset = 0;
+	awaiting_brace = -1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::add_point
+// Purpose:	Adds a checkpoint. The window is circular: its oldest
+//		byte is the one at window[WINDOWSIZE - left].
+// Returns:	False if out of memory.
+//---------------------------------------------------------------------------
+bool
+GzIndex::add_point (unsigned long out, unsigned long in, int bits,
+		const unsigned char *window, unsigned left)
+{
+	if (n_points == points_size) {
+		int size = points_size ? 2 * points_size : 16;
+		GzIndexPoint *tmp = (GzIndexPoint*) realloc (points, size * sizeof(GzIndexPoint));
+		if (!tmp)
+			return false;
+		total_allocated += (size - points_size) * sizeof(GzIndexPoint);
+		points = tmp;
+		points_size = size;
+	}
+
+	GzIndexPoint *point = points + n_points;
+	point->window = (unsigned char*) malloc (GZINDEX_WINDOWSIZE);
+	if (!point->window)
+		return false;
+	total_allocated += GZINDEX_WINDOWSIZE;
+
+	point->out = out;
+	point->in = in;
+	point->bits = bits;
+	if (window) {
+		if (left)
+			memcpy (point->window, window + GZINDEX_WINDOWSIZE - left, left);
+		if (left < GZINDEX_WINDOWSIZE)
+			memcpy (point->window + left, window, GZINDEX_WINDOWSIZE - left);
+	}
+	n_points++;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::add_entry
+// Purpose:	Adds an entry, whose end is not yet known.
+// Returns:	Its number.
+//---------------------------------------------------------------------------
+int
+GzIndex::add_entry (const char *name, const char *type, unsigned long offset)
+{
+	if (n_entries == entries_size) {
+		int size = entries_size ? 2 * entries_size : 64;
+		GzIndexEntry *tmp = (GzIndexEntry*) realloc (entries, size * sizeof(GzIndexEntry));
+		if (!tmp)
+			fatal ("Out of memory!");
+		total_allocated += (size - entries_size) * sizeof(GzIndexEntry);
+		entries = tmp;
+		entries_size = size;
+	}
+
+	GzIndexEntry *entry = entries + n_entries;
+#ifdef WIN32
+	entry->name = _strdup (name);
+	entry->type = _strdup (type);
+#else
+	entry->name = strdup (name);
+	entry->type = strdup (type);
+#endif
+	if (!entry->name || !entry->type)
+		fatal ("Out of memory!");
+	total_allocated += strlen (name) + strlen (type) + 2;
+	entry->offset = offset;
+	entry->end = 0;
+	return n_entries++;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::scan_word
+// Purpose:	Handles a word found by scan(), in word[].
+//---------------------------------------------------------------------------
+void
+GzIndex::scan_word ()
+{
+	word[word_len] = 0;
+
+	if (def_state == 1) {
+		strcpy (def_name, word);
+		def_state = 2;
+		return;
+	}
+	if (def_state == 2) {
+		def_state = 0;
+		if (strcmp (word, "USE"))
+			awaiting_brace = add_entry (def_name, word, def_offset);
+		return;
+	}
+
+	awaiting_brace = -1;
+	if (!strcmp (word, "DEF")) {
+		def_state = 1;
+		def_offset = word_start;
+	}
+	else if (!strcmp (word, "WorldInfo"))
+		awaiting_brace = add_entry ("", word, word_start);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::scan_delimiter
+// Purpose:	Handles a bracket or brace found by scan(), keeping
+//		track of where the entries' bodies end.
+//---------------------------------------------------------------------------
+void
+GzIndex::scan_delimiter (unsigned char ch, unsigned long offset)
+{
+	def_state = 0;
+
+	if (ch == '{' || ch == '[') {
+		depth++;
+		if (awaiting_brace >= 0) {
+			if (n_open == open_size) {
+				int size = open_size ? 2 * open_size : 64;
+				int *tmp = (int*) realloc (open, size * 2 * sizeof(int));
+				if (!tmp)
+					fatal ("Out of memory!");
+				total_allocated += (size - open_size) * 2 * sizeof(int);
+				open = tmp;
+				open_size = size;
+			}
+			open [2 * n_open] = awaiting_brace;
+			open [2 * n_open + 1] = depth;
+			n_open++;
+		}
+	} else {
+		if (n_open && open [2 * n_open - 1] == depth) {
+			n_open--;
+			entries [open [2 * n_open]].end = offset + 1;
+		}
+		if (depth > 0)
+			depth--;
+	}
+	awaiting_brace = -1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::scan
+// Purpose:	Looks for entries in the next n bytes of uncompressed
+//		data, which begin at offset. Words are split as the
+//		Tokenizer splits them.
+//---------------------------------------------------------------------------
+void
+GzIndex::scan (const unsigned char *p, unsigned long n, unsigned long offset)
+{
+	unsigned long i;
+
+	for (i = 0; i < n; i++) {
+		unsigned char ch = p[i];
+
+		if (scan_state == SCAN_COMMENT) {
+			if (ch == '\n')
+				scan_state = SCAN_SPACE;
+			continue;
+		}
+		if (scan_state == SCAN_STRING) {
+			if (ch == '"')
+				scan_state = SCAN_SPACE;
+			continue;
+		}
+
+		bool space = ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == 0xff;
+		bool delimiter = ch == '#' || ch == '"' || ch == '[' || ch == ']' ||
+				ch == '{' || ch == '}';
+
+		if (scan_state == SCAN_WORD) {
+			if (!space && !delimiter) {
+				if (word_len < GZINDEX_MAXNAME - 1)
+					word [word_len++] = ch;
+				continue;
+			}
+			scan_word ();
+			scan_state = SCAN_SPACE;
+		}
+
+		if (space)
+			continue;
+		if (ch == '#')
+			scan_state = SCAN_COMMENT;
+		else if (ch == '"')
+			scan_state = SCAN_STRING;
+		else if (delimiter)
+			scan_delimiter (ch, offset + i);
+		else {
+			scan_state = SCAN_WORD;
+			word [0] = ch;
+			word_len = 1;
+			word_start = offset + i;
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::add_data
+// Purpose:	Looks for entries in the next n bytes of uncompressed
+//		data, as the file is read or written from its start.
+//---------------------------------------------------------------------------
+void
+GzIndex::add_data (const unsigned char *p, unsigned long n)
+{
+	scan (p, n, data_size);
+	data_size += n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::finish
+// Purpose:	Ends the scan for entries, once all of the data have
+//		been added.
+// Returns:	False if the index is of no use, i.e. a gzipped file
+//		has no checkpoints.
+//---------------------------------------------------------------------------
+bool
+GzIndex::finish ()
+{
+	if (scan_state == SCAN_WORD)
+		scan_word ();
+	scan_state = SCAN_SPACE;
+	return !compressed || n_points;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::save
+// Purpose:	Writes the index to its sidecar file.
+// Returns:	False if it could not be written.
+//---------------------------------------------------------------------------
+bool
+GzIndex::save (const char *path)
+{
+	char index_path [PATH_MAX];
+	char temporary [PATH_MAX + 8];
+	char full_source [PATH_MAX];
+	uint64 source_size;
+	int64 source_time;
+	int i;
+
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	if (!cache_path (path, ".mxi", index_path, full_source) ||
+	    !source_identity (path, source_size, source_time))
+		return false;
+
+	sprintf (temporary, "%s.tmp", index_path);
+	FILE *f = fopen (temporary, "wb");
+	if (!f)
+		return false;
+
+	unsigned char header [GZINDEX_HEADERSIZE];
+	memset (header, 0, GZINDEX_HEADERSIZE);
+	memcpy (header, GZINDEX_MAGIC, 4);
+	encode_u32 (header + 4, GZINDEX_VERSION);
+	encode_u64 (header + 8, source_size);
+	encode_u64 (header + 16, (uint64) source_time);
+	encode_u64 (header + 24, data_size);
+	encode_u32 (header + 32, n_points);
+	encode_u32 (header + 36, n_entries);
+	encode_u32 (header + 40, compressed ? 1 : 0);
+	bool ok = GZINDEX_HEADERSIZE == fwrite (header, 1, GZINDEX_HEADERSIZE, f);
+
+	//----------------------------------------
+	// Windows are mostly text, so they are
+	// stored deflated.
+	//
+	uLongf bound = GZINDEX_WINDOWSIZE + GZINDEX_WINDOWSIZE / 1000 + 64;
+	unsigned char *packed = (unsigned char*) malloc (bound);
+	if (!packed)
+		fatal ("Out of memory!");
+
+	for (i = 0; ok && i < n_points; i++) {
+		unsigned char bytes [24];
+		uLongf packed_size = bound;
+		if (Z_OK != compress (packed, &packed_size, points[i].window, GZINDEX_WINDOWSIZE)) {
+			ok = false;
+			break;
+		}
+		encode_u64 (bytes, points[i].out);
+		encode_u64 (bytes + 8, points[i].in);
+		encode_u32 (bytes + 16, points[i].bits);
+		encode_u32 (bytes + 20, (uint32) packed_size);
+		ok = 24 == fwrite (bytes, 1, 24, f) &&
+			packed_size == fwrite (packed, 1, packed_size, f);
+	}
+	free (packed);
+
+	for (i = 0; ok && i < n_entries; i++) {
+		unsigned char bytes [24];
+		uint32 name_length = (uint32) strlen (entries[i].name);
+		uint32 type_length = (uint32) strlen (entries[i].type);
+		encode_u64 (bytes, entries[i].offset);
+		encode_u64 (bytes + 8, entries[i].end);
+		encode_u32 (bytes + 16, name_length);
+		encode_u32 (bytes + 20, type_length);
+		ok = 24 == fwrite (bytes, 1, 24, f) &&
+			name_length == fwrite (entries[i].name, 1, name_length, f) &&
+			type_length == fwrite (entries[i].type, 1, type_length, f);
+	}
+
+	if (fclose (f))
+		ok = false;
+	if (ok) {
+#ifdef WIN32
+		remove (index_path);	// rename() does not replace files on Windows.
+#endif
+		ok = !rename (temporary, index_path);
+	}
+	if (!ok)
+		remove (temporary);
+	return ok;
+}
+
+//---------------------------------------------------------------------------
+// Name:	open_sidecar
+// Purpose:	Opens the sidecar file of a source file and reads its
+//		header, if it still matches the file's size and time.
+// Returns:	The sidecar file, positioned after the header, or NULL.
+//---------------------------------------------------------------------------
+static FILE *
+open_sidecar (const char *path, unsigned char *header)
+{
+	char index_path [PATH_MAX];
+	char full_source [PATH_MAX];
+	uint64 source_size;
+	int64 source_time;
+
+	if (!cache_path (path, ".mxi", index_path, full_source) ||
+	    !source_identity (path, source_size, source_time))
+		return NULL;
+
+	FILE *f = fopen (index_path, "rb");
+	if (!f)
+		return NULL;
+
+	if (GZINDEX_HEADERSIZE != fread (header, 1, GZINDEX_HEADERSIZE, f) ||
+	    memcmp (header, GZINDEX_MAGIC, 4) ||
+	    decode_u32 (header + 4) != GZINDEX_VERSION ||
+	    decode_u64 (header + 8) != source_size ||
+	    decode_u64 (header + 16) != (uint64) source_time) {
+		fclose (f);
+		return NULL;
+	}
+	return f;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::load
+// Purpose:	Reads the sidecar file of a source file, if it exists
+//		and still matches the file's size and time.
+// Returns:	False if there is no usable index.
+//---------------------------------------------------------------------------
+bool
+GzIndex::load (const char *path)
+{
+	char name [GZINDEX_MAXNAME];
+	char type [GZINDEX_MAXNAME];
+	unsigned char header [GZINDEX_HEADERSIZE];
+	int i;
+
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	clear ();
+
+	FILE *f = open_sidecar (path, header);
+	if (!f)
+		return false;
+
+	data_size = (unsigned long) decode_u64 (header + 24);
+	int count_points = (int) decode_u32 (header + 32);
+	int count_entries = (int) decode_u32 (header + 36);
+	compressed = decode_u32 (header + 40) != 0;
+
+	unsigned char *packed = (unsigned char*) malloc (2 * GZINDEX_WINDOWSIZE);
+	if (!packed)
+		fatal ("Out of memory!");
+
+	bool ok = true;
+	for (i = 0; ok && i < count_points; i++) {
+		unsigned char bytes [24];
+		if (24 != fread (bytes, 1, 24, f)) {
+			ok = false;
+			break;
+		}
+		uLongf packed_size = decode_u32 (bytes + 20);
+		uLongf size = GZINDEX_WINDOWSIZE;
+		ok = packed_size <= 2 * GZINDEX_WINDOWSIZE &&
+			packed_size == fread (packed, 1, packed_size, f) &&
+			add_point ((unsigned long) decode_u64 (bytes),
+				(unsigned long) decode_u64 (bytes + 8),
+				(int) decode_u32 (bytes + 16), NULL, 0) &&
+			Z_OK == uncompress (points[n_points - 1].window, &size, packed, packed_size) &&
+			size == GZINDEX_WINDOWSIZE;
+	}
+	free (packed);
+
+	for (i = 0; ok && i < count_entries; i++) {
+		unsigned char bytes [24];
+		if (24 != fread (bytes, 1, 24, f)) {
+			ok = false;
+			break;
+		}
+		uint32 name_length = decode_u32 (bytes + 16);
+		uint32 type_length = decode_u32 (bytes + 20);
+		ok = name_length < GZINDEX_MAXNAME && type_length < GZINDEX_MAXNAME &&
+			name_length == fread (name, 1, name_length, f) &&
+			type_length == fread (type, 1, type_length, f);
+		if (ok) {
+			name [name_length] = 0;
+			type [type_length] = 0;
+			int k = add_entry (name, type, (unsigned long) decode_u64 (bytes));
+			entries[k].end = (unsigned long) decode_u64 (bytes + 8);
+		}
+	}
+	fclose (f);
+
+	if (!ok || (compressed && !n_points))
+		clear ();
+	return ok && (!compressed || n_points);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::find
+// Purpose:	Finds the first entry with a given DEF name.
+// Returns:	The entry or NULL.
+//---------------------------------------------------------------------------
+const GzIndexEntry *
+GzIndex::find (const char *name)
+{
+	ASSERT_NONZERO (name,"name")
+	//----------
+
+	for (int i = 0; i < n_entries; i++)
+		if (!strcmp (entries[i].name, name))
+			return entries + i;
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndex::open_at
+// Purpose:	Starts reading a gzipped file's data at an offset, from
+//		the last checkpoint at or before it.
+// Returns:	A reader, or NULL if the file is not compressed or
+//		cannot be opened.
+//---------------------------------------------------------------------------
+GzIndexReader *
+GzIndex::open_at (const char *path, unsigned long offset)
+{
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	if (!compressed || !n_points || offset > data_size)
+		return NULL;
+
+	int low = 0, high = n_points - 1;
+	while (low < high) {
+		int middle = (low + high + 1) / 2;
+		if (points[middle].out <= offset)
+			low = middle;
+		else
+			high = middle - 1;
+	}
+	GzIndexPoint *point = points + low;
+
+	GzIndexReader *r = new GzIndexReader ();
+	r->f = fopen (path, "rb");
+	if (!r->f || Z_OK != inflateInit2 (&r->stream, -15)) {	// raw
+		delete r;
+		return NULL;
+	}
+	r->initialized = true;
+
+	bool ok = !fseek (r->f, point->in - (point->bits ? 1 : 0), SEEK_SET);
+	if (ok && point->bits) {
+		int ch = getc (r->f);
+		ok = ch != EOF;
+		if (ok)
+			inflatePrime (&r->stream, point->bits, ch >> (8 - point->bits));
+	}
+	if (ok)
+		ok = Z_OK == inflateSetDictionary (&r->stream, point->window, GZINDEX_WINDOWSIZE);
+	if (!ok) {
+		delete r;
+		return NULL;
+	}
+
+	r->skip = offset - point->out;
+	return r;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexReader::GzIndexReader
+//---------------------------------------------------------------------------
+GzIndexReader::GzIndexReader ()
+{
+	f = NULL;
+	memset (&stream, 0, sizeof(stream));
+	initialized = false;
+	skip = 0;
+	ended = false;
+
+	input = (unsigned char*) malloc (GZINDEX_CHUNKSIZE);
+	if (!input)
+		fatal ("Out of memory!");
+	total_allocated += GZINDEX_CHUNKSIZE + sizeof(GzIndexReader);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexReader::~GzIndexReader
+//---------------------------------------------------------------------------
+GzIndexReader::~GzIndexReader ()
+{
+	if (initialized)
+		inflateEnd (&stream);
+	if (f)
+		fclose (f);
+	free (input);
+	total_allocated -= GZINDEX_CHUNKSIZE + sizeof(GzIndexReader);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexReader::inflate_into
+// Purpose:	Inflates up to size bytes.
+// Returns:	Number of bytes, 0 at the end of the data, -1 on error.
+//---------------------------------------------------------------------------
+int
+GzIndexReader::inflate_into (unsigned char *dest, int size)
+{
+	if (ended)
+		return 0;
+
+	stream.next_out = dest;
+	stream.avail_out = size;
+	while (stream.avail_out) {
+		if (!stream.avail_in) {
+			stream.avail_in = (uInt) fread (input, 1, GZINDEX_CHUNKSIZE, f);
+			stream.next_in = input;
+			if (!stream.avail_in) {
+				ended = true;
+				break;
+			}
+		}
+
+		int result = inflate (&stream, Z_NO_FLUSH);
+		if (result == Z_STREAM_END) {
+			ended = true;
+			break;
+		}
+		if (result != Z_OK)
+			return -1;
+	}
+	return size - (int) stream.avail_out;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexReader::read
+// Purpose:	Reads up to size bytes, having first discarded the data
+//		between the checkpoint and the offset asked for.
+// Returns:	Number of bytes read, 0 at end of file, -1 on error.
+//---------------------------------------------------------------------------
+int
+GzIndexReader::read (unsigned char *dest, int size)
+{
+	ASSERT_NONZERO (dest,"dest")
+	//----------
+
+	while (skip) {
+		int n = inflate_into (dest, skip < (unsigned long) size ? (int) skip : size);
+		if (n <= 0)
+			return n;
+		skip -= n;
+	}
+	return inflate_into (dest, size);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexBuilder::GzIndexBuilder
+//---------------------------------------------------------------------------
+GzIndexBuilder::GzIndexBuilder ()
+{
+	index = NULL;
+	path = NULL;
+	f = NULL;
+	memset (&stream, 0, sizeof(stream));
+	initialized = false;
+	window_ix = 0;
+	total_in = 0;
+	last = 0;
+	ended = false;
+	failed = false;
+
+	input = (unsigned char*) malloc (GZINDEX_CHUNKSIZE);
+	window = (unsigned char*) malloc (GZINDEX_WINDOWSIZE);
+	if (!input || !window)
+		fatal ("Out of memory!");
+	total_allocated += GZINDEX_CHUNKSIZE + GZINDEX_WINDOWSIZE + sizeof(GzIndexBuilder);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexBuilder::~GzIndexBuilder
+//---------------------------------------------------------------------------
+GzIndexBuilder::~GzIndexBuilder ()
+{
+	delete index;
+	if (initialized)
+		inflateEnd (&stream);
+	if (f)
+		fclose (f);
+	if (path) {
+		total_allocated -= strlen (path) + 1;
+		free (path);
+	}
+	free (input);
+	free (window);
+	total_allocated -= GZINDEX_CHUNKSIZE + GZINDEX_WINDOWSIZE + sizeof(GzIndexBuilder);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexBuilder::open
+// Purpose:	Opens a gzip file to be read and indexed.
+// Returns:	False if the file cannot be opened or is not gzipped.
+//---------------------------------------------------------------------------
+bool
+GzIndexBuilder::open (const char *path_)
+{
+	ASSERT_NONZERO (path_,"path")
+	//----------
+
+	if (f)
+		return false;
+	f = fopen (path_, "rb");
+	if (!f)
+		return false;
+
+	stream.avail_in = (uInt) fread (input, 1, GZINDEX_CHUNKSIZE, f);
+	stream.next_in = input;
+	if (stream.avail_in < 2 || input[0] != 0x1f || input[1] != 0x8b)
+		return false;
+
+	if (Z_OK != inflateInit2 (&stream, 47))	// gzip or zlib.
+		fatal ("Out of memory!");
+	initialized = true;
+
+#ifdef WIN32
+	path = _strdup (path_);
+#else
+	path = strdup (path_);
+#endif
+	if (!path)
+		fatal ("Out of memory!");
+	total_allocated += strlen (path) + 1;
+
+	index = new GzIndex ();
+	index->compressed = true;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexBuilder::next_member
+// Purpose:	Goes on to the next gzip member after the end of one,
+//		as gzread() does. Such a file is not indexed, as
+//		the index covers only the first member; trailing
+//		bytes that are not gzip are ignored.
+// Returns:	False at the end of the file.
+//---------------------------------------------------------------------------
+bool
+GzIndexBuilder::next_member ()
+{
+	if (stream.avail_in < 2) {
+		if (stream.avail_in)
+			memmove (input, stream.next_in, stream.avail_in);
+		stream.avail_in += (uInt) fread (input + stream.avail_in, 1,
+			GZINDEX_CHUNKSIZE - stream.avail_in, f);
+		stream.next_in = input;
+	}
+	if (stream.avail_in < 2 || stream.next_in[0] != 0x1f || stream.next_in[1] != 0x8b)
+		return false;
+
+	delete index;
+	index = NULL;
+	return Z_OK == inflateReset (&stream);
+}
+
+//---------------------------------------------------------------------------
+// Name:	GzIndexBuilder::read
+// Purpose:	Reads up to size bytes, adding a checkpoint at the first
+//		deflate block boundary after every GZINDEX_SPAN bytes.
+//		The data are inflated into the window, which the
+//		checkpoints need, and copied out from there. At the
+//		end of the file the index is saved.
+// Returns:	Number of bytes read, 0 at end of file, -1 on error.
+//---------------------------------------------------------------------------
+int
+GzIndexBuilder::read (unsigned char *dest, int size)
+{
+	ASSERT_NONZERO (dest,"dest")
+	//----------
+
+	if (!initialized || failed)
+		return -1;
+
+	int total = 0;
+	while (total < size && !ended) {
+		if (!stream.avail_in) {
+			stream.avail_in = (uInt) fread (input, 1, GZINDEX_CHUNKSIZE, f);
+			stream.next_in = input;
+			if (!stream.avail_in) {
+				printf ("Compressed data is truncated or unreadable.\n");
+				failed = true;
+				break;
+			}
+		}
+
+		if (window_ix == GZINDEX_WINDOWSIZE)
+			window_ix = 0;
+		unsigned long room = GZINDEX_WINDOWSIZE - window_ix;
+		if (room > (unsigned long) (size - total))
+			room = size - total;
+
+		unsigned long before_in = stream.avail_in;
+		stream.next_out = window + window_ix;
+		stream.avail_out = (uInt) room;
+		int result = inflate (&stream, Z_BLOCK);
+		unsigned long n = room - stream.avail_out;
+		total_in += before_in - stream.avail_in;
+
+		memcpy (dest + total, window + window_ix, n);
+		if (index)
+			index->add_data (window + window_ix, n);
+		window_ix += n;
+		total += (int) n;
+
+		if (result == Z_STREAM_END) {
+			if (!next_member ())
+				ended = true;
+			continue;
+		}
+		if (result != Z_OK && result != Z_BUF_ERROR) {
+			printf ("Compressed data is corrupt.\n");
+			failed = true;
+			break;
+		}
+
+		//----------------------------------------
+		// At the end of a block other than the
+		// last, all of its data have been put out
+		// and none of the next one's read, bar
+		// up to 7 bits.
+		//
+		if (index && (stream.data_type & 128) && !(stream.data_type & 64) &&
+		    (!index->data_size || index->data_size - last > GZINDEX_SPAN)) {
+			if (!index->add_point (index->data_size, total_in, stream.data_type & 7,
+					window, GZINDEX_WINDOWSIZE - window_ix))
+				fatal ("Out of memory!");
+			last = index->data_size;
+		}
+	}
+
+	if (ended && index) {
+		if (index->finish () && !index->save (path))
+			printf ("Unable to save the index of %s.\n", path);
+		delete index;
+		index = NULL;
+	}
+
+	if (!total && failed)
+		return -1;
+	return total;
+}
+
+//---------------------------------------------------------------------------
+// Name:	gzindex_open
+// Purpose:	Gets the index of a file from its sidecar file, if that
+//		is current. It is never built here, which would mean
+//		inflating the whole file.
+// Returns:	The index, or NULL if there is none.
+//---------------------------------------------------------------------------
+GzIndex *
+gzindex_open (const char *path)
+{
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	GzIndex *index = new GzIndex ();
+	if (index->load (path))
+		return index;
+	delete index;
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	gzindex_current
+// Purpose:	Checks whether a file's sidecar file is current, without
+//		reading the index.
+//---------------------------------------------------------------------------
+bool
+gzindex_current (const char *path)
+{
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	unsigned char header [GZINDEX_HEADERSIZE];
+	FILE *f = open_sidecar (path, header);
+	if (!f)
+		return false;
+	fclose (f);
+	return true;
+}
@@ -0,0 +1,183 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _GZINDEX_H
+#define _GZINDEX_H
+
+// Uncompressed bytes between the index's inflate checkpoints.
+#define GZINDEX_SPAN (1024*1024)
+
+// Longest DEF name or node type kept in the index.
+#define GZINDEX_MAXNAME (256)
+
+#define GZINDEX_WINDOWSIZE (32768)	// Deflate's maximum distance.
+
+class GzIndexReader;
+
+/*===========================================================================
+ * Name:	GzIndexPoint
+ * Purpose:	A place where inflating can resume in the middle of a
+ *		gzip file: the offsets of a deflate block boundary in
+ *		the compressed and uncompressed data, and the 32 kB of
+ *		data preceding it, which the block may refer back to.
+ */
+struct GzIndexPoint {
+	unsigned long out;	// Offset in the uncompressed data.
+	unsigned long in;	// Offset of the first whole compressed byte.
+	int bits;		// Bits of the byte before in, or 0.
+	unsigned char *window;
+};
+
+/*===========================================================================
+ * Name:	GzIndexEntry
+ * Purpose:	Where a DEF'd node or a WorldInfo lies in the
+ *		uncompressed data: from its DEF (or keyword) to just
+ *		after its closing brace, or 0 if that is not known.
+ */
+struct GzIndexEntry {
+	char *name;		// "" for WorldInfo.
+	char *type;		// Node keyword, e.g. Text.
+	unsigned long offset;
+	unsigned long end;
+};
+
+/*===========================================================================
+ * Name:	GzIndex
+ * Purpose:	Random-access index of a VRML file, mainly for gzipped
+ *		DST files, which otherwise can only be read from the
+ *		start. It is kept as a sidecar file in the cache
+ *		directory, and is made as a side effect of inflating
+ *		the whole file (see GzIndexBuilder) or of saving it
+ *		(see OutputFile); it is stale once the file's size or
+ *		time change. An uncompressed file needs no checkpoints,
+ *		only the node entries, and nor does a zstd one, which
+ *		is instead read forward to the entry.
+ */
+class GzIndex {
+public:
+	bool compressed;
+	unsigned long data_size;	// Size of the uncompressed data.
+
+	GzIndexPoint *points;
+	int n_points;
+	int points_size;
+
+	GzIndexEntry *entries;
+	int n_entries;
+	int entries_size;
+
+	GzIndex ();
+	~GzIndex ();
+
+	bool load (const char *path);
+	bool save (const char *path);
+
+	bool add_point (unsigned long out, unsigned long in, int bits,
+			const unsigned char *window, unsigned left);
+	void add_data (const unsigned char *p, unsigned long n);
+	bool finish ();
+
+	const GzIndexEntry *find (const char *name);
+	GzIndexReader *open_at (const char *path, unsigned long offset);
+
+private:
+	// State of the scan for entries while building.
+	int scan_state;
+	char word [GZINDEX_MAXNAME];
+	int word_len;
+	unsigned long word_start;
+	int depth;
+	int def_state;
+	char def_name [GZINDEX_MAXNAME];
+	unsigned long def_offset;
+	int awaiting_brace;		// Entry whose { is next, or -1.
+	int *open;			// Entries whose } is awaited.
+	int n_open;
+	int open_size;
+
+	int add_entry (const char *name, const char *type, unsigned long offset);
+	void scan (const unsigned char *p, unsigned long n, unsigned long offset);
+	void scan_word ();
+	void scan_delimiter (unsigned char ch, unsigned long offset);
+	void clear ();
+};
+
+/*===========================================================================
+ * Name:	GzIndexReader
+ * Purpose:	Reads the uncompressed data of a gzip file onwards from
+ *		an offset, inflating from the nearest checkpoint.
+ */
+class GzIndexReader {
+public:
+	GzIndexReader ();
+	~GzIndexReader ();
+
+	int read (unsigned char *dest, int size);
+
+private:
+	friend class GzIndex;
+
+	FILE *f;
+	z_stream stream;
+	bool initialized;
+	unsigned char *input;
+	unsigned long skip;		// Bytes still to discard.
+	bool ended;
+
+	int inflate_into (unsigned char *dest, int size);
+};
+
+/*===========================================================================
+ * Name:	GzIndexBuilder
+ * Purpose:	Inflates a gzip file from its start, as gzread() would,
+ *		while building its index, which it saves on reaching
+ *		the end. The InputFile reads through it when the file
+ *		has no index yet.
+ */
+class GzIndexBuilder {
+public:
+	GzIndexBuilder ();
+	~GzIndexBuilder ();
+
+	bool open (const char *path);
+	int read (unsigned char *dest, int size);
+
+private:
+	GzIndex *index;			// NULL once given up.
+	char *path;
+	FILE *f;
+	z_stream stream;
+	bool initialized;
+	unsigned char *input;
+	unsigned char *window;		// The last 32 kB inflated.
+	unsigned long window_ix;	// Where the next byte goes.
+	unsigned long total_in;
+	unsigned long last;		// Offset of the last checkpoint.
+	bool ended;
+	bool failed;
+
+	bool next_member ();
+};
+
+extern GzIndex *gzindex_open (const char *path);
+extern bool gzindex_current (const char *path);
+
+#endif
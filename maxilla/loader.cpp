@@ -0,0 +1,280 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#else
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "threads.h"
+#include "loader.h"
+
+/*===========================================================================
+ * Name:	Load
+ * Purpose:	State of the one background load. The loading thread
+ *		writes the progress fields and done; the GUI thread
+ *		reads them, and writes cancelled.
+ */
+static struct {
+	void *thread;
+	LoadFunction function;
+	void *arg;
+	Model *model;
+	volatile bool done;
+	volatile bool cancelled;
+	volatile unsigned long bytes;
+	volatile unsigned long total;
+	volatile int meshes;
+
+	// Files read at once; see loader_parts.
+	int n_parts;
+	volatile unsigned long part_thread [LOADER_MAX_PARTS];
+	volatile unsigned long part_bytes [LOADER_MAX_PARTS];
+	volatile unsigned long part_total [LOADER_MAX_PARTS];
+} load;
+
+// Guards the mesh count and the parts, which several
+// threads may update at once.
+static Mutex lock;
+
+//---------------------------------------------------------------------------
+// Name:	loader_thread
+// Purpose:	Body of the loading thread.
+//---------------------------------------------------------------------------
+static void *
+loader_thread (void *arg)
+{
+	Model *m = load.function (load.arg);
+
+	//----------------------------------------
+	// A model finished just as the user gave
+	// up on it is not wanted either.
+	//
+	if (m && load.cancelled) {
+		delete m;
+		m = NULL;
+	}
+	load.model = m;
+	load.done = true;
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_start
+// Purpose:	Starts a background load.
+//---------------------------------------------------------------------------
+bool
+loader_start (LoadFunction function, void *arg)
+{
+	ASSERT_NONZERO (function,"function")
+	//----------
+
+	if (load.thread)
+		return false;
+
+	load.function = function;
+	load.arg = arg;
+	load.model = NULL;
+	load.done = false;
+	load.cancelled = false;
+	load.bytes = 0;
+	load.total = 0;
+	load.meshes = 0;
+	load.n_parts = 1;
+
+	load.thread = thread_start (loader_thread, NULL);
+	return load.thread != NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_running
+// Purpose:	Tells whether a load has been started and not yet
+//		collected by loader_finished().
+//---------------------------------------------------------------------------
+bool
+loader_running ()
+{
+	return load.thread != NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_finished
+// Purpose:	Collects the result of a load that has ended.
+//---------------------------------------------------------------------------
+bool
+loader_finished (Model **model_return)
+{
+	ASSERT_NONZERO (model_return,"model_return")
+	//----------
+
+	if (!load.thread || !load.done)
+		return false;
+
+	thread_join (load.thread);
+	load.thread = NULL;
+
+	*model_return = load.model;
+	load.model = NULL;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_cancel
+// Purpose:	Asks the running load to stop.
+//---------------------------------------------------------------------------
+void
+loader_cancel ()
+{
+	if (load.thread)
+		load.cancelled = true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_cancelled
+// Purpose:	Polled by the loading code.
+//---------------------------------------------------------------------------
+bool
+loader_cancelled ()
+{
+	return load.cancelled;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_progress
+// Purpose:	Records the number of input bytes consumed so far.
+//---------------------------------------------------------------------------
+void
+loader_progress (unsigned long bytes, unsigned long total)
+{
+	if (load.n_parts > 1) {
+		unsigned long self = thread_current ();
+		lock.lock ();
+		for (int i = 0; i < load.n_parts; i++)
+			if (load.part_thread [i] == self) {
+				load.part_total [i] = total;
+				load.part_bytes [i] = bytes;
+				lock.unlock ();
+				return;
+			}
+		lock.unlock ();
+	}
+
+	load.total = total;
+	load.bytes = bytes;
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_mesh_built
+// Purpose:	Counts a finished mesh.
+//---------------------------------------------------------------------------
+void
+loader_mesh_built ()
+{
+	lock.lock ();
+	load.meshes++;
+	lock.unlock ();
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_parts
+// Purpose:	Sets how many files are being read at once.
+//---------------------------------------------------------------------------
+void
+loader_parts (int n_parts)
+{
+	if (n_parts < 1 || n_parts > LOADER_MAX_PARTS)
+		n_parts = 1;
+
+	lock.lock ();
+	for (int i = 0; i < LOADER_MAX_PARTS; i++) {
+		load.part_thread [i] = 0;
+		load.part_bytes [i] = 0;
+		load.part_total [i] = 0;
+	}
+	load.n_parts = n_parts;
+	lock.unlock ();
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_part
+// Purpose:	Claims one of the parts for the calling thread.
+//---------------------------------------------------------------------------
+void
+loader_part (int part)
+{
+	lock.lock ();
+	if (part >= 0 && part < load.n_parts)
+		load.part_thread [part] = thread_current ();
+	lock.unlock ();
+}
+
+//---------------------------------------------------------------------------
+// Name:	loader_status
+// Purpose:	Describes the progress of the running load.
+// Returns:	False if no load is running.
+//---------------------------------------------------------------------------
+bool
+loader_status (char *buf, int size)
+{
+	ASSERT_NONZERO (buf,"buf")
+	//----------
+
+	if (!load.thread || size < 80)
+		return false;
+
+	unsigned long bytes = load.bytes;
+	unsigned long total = load.total;
+	int meshes = load.meshes;
+
+	if (load.n_parts > 1) {
+		bytes = total = 0;
+		lock.lock ();
+		for (int i = 0; i < load.n_parts; i++) {
+			bytes += load.part_bytes [i];
+			total += load.part_total [i];
+		}
+		lock.unlock ();
+	}
+
+	if (load.cancelled)
+		strcpy (buf, "Cancelling...");
+	else if (total && bytes <= total)
+		sprintf (buf, "Loading: %d%% read, %d meshes built.",
+			(int) (100.0 * bytes / total), meshes);
+	else
+		sprintf (buf, "Loading: %.1f MB read, %d meshes built.",
+			bytes / 1.0E6, meshes);
+	return true;
+}
@@ -0,0 +1,83 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _LOADER_H
+#define _LOADER_H
+
+class Model;
+
+/*===========================================================================
+ * Name:	loader_start
+ * Purpose:	Runs function(arg) on a background thread to read a
+ *		model, so that the GUI keeps running meanwhile. Only
+ *		one load may be in progress.
+ * Returns:	False if a load is already running or the thread
+ *		could not be started.
+ */
+typedef Model *(*LoadFunction) (void *arg);
+
+extern bool loader_start (LoadFunction, void *arg);
+
+/*===========================================================================
+ * Name:	loader_finished
+ * Purpose:	Called by the GUI thread to see whether the load has
+ *		ended. If it has, the thread is joined and the model,
+ *		which is complete, is handed over.
+ * Returns:	True once, when the load ends; *model_return is NULL
+ *		if the load failed or was cancelled.
+ */
+extern bool loader_finished (Model **model_return);
+
+extern bool loader_running ();
+extern bool loader_status (char *buf, int size);
+
+/*===========================================================================
+ * Name:	loader_cancel, loader_cancelled
+ * Purpose:	Asks the load to stop. The readers and parsers poll
+ *		loader_cancelled() and give up early; their caller then
+ *		discards whatever was built.
+ */
+extern void loader_cancel ();
+extern bool loader_cancelled ();
+
+/*===========================================================================
+ * Name:	loader_progress, loader_mesh_built
+ * Purpose:	Called by the readers and parsers to report how much of
+ *		the input has been consumed and how many meshes have
+ *		been built. The total size is 0 if it is not known.
+ */
+extern void loader_progress (unsigned long bytes, unsigned long total);
+extern void loader_mesh_built ();
+
+/*===========================================================================
+ * Name:	loader_parts, loader_part
+ * Purpose:	For a load that reads several files at once, each on
+ *		its own thread: loader_parts() sets the number of them,
+ *		or 1 once they are done, and each thread then calls
+ *		loader_part() with its number before reading, so that
+ *		the progress shown is the sum over the files.
+ */
+#define LOADER_MAX_PARTS (2)
+
+extern void loader_parts (int n_parts);
+extern void loader_part (int part);
+
+#endif
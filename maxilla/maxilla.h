@@ -1,2791 +1,3153 @@
-/*=============================================================================
-  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
-  Copyright (C) 2008-2011 by Zack T Smith and Ortho Cast Inc.
-
-  This program is free software; you can redistribute it and/or modify
-  it under the terms of the GNU General Public License version 2 
-  as published by the Free Software Foundation.
-
-  This program is distributed in the hope that it will be useful,
-  but WITHOUT ANY WARRANTY; without even the implied warranty of
-  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-  GNU General Public License for more details.
-
-  You should have received a copy of the GNU General Public License
-  along with this program; if not, write to the Free Software
-  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
-
-  The author may be reached at fbui@comcast.net.
- *============================================================================*/
-
-/*
- * NOTICE NOTICE NOTICE
- *
- * Please do not use multiple inheritance or templates in this program.
- * They are the leading causes of C++ code illegibility.
- *
- * Keep this program clean! Don't pollute it.
- */
-
-#ifndef _MAXILLA_H
-#define _MAXILLA_H
-
-#include <stdio.h>
-#include <math.h>
-
-#include "defs.h"
-#include "quat.h"
-
-
-#ifdef WIN32
-#include "../../zlib/zlib.h"
-#else 
-#include <zlib.h>
-#endif
-
-#include "Point.h"
-
-#include "RenderContext.h"
-
-extern int serialization_indentation_level;
-extern void indent (gzFile );
-
-typedef unsigned long RGB;
-extern RGB floats_to_rgb (float, float, float);
-extern void express_rgb (RGB);
-
-extern bool using_custom_colors;
-extern GLfloat user_fg[4];
-extern GLfloat user_bg[4];
-extern GLfloat user_shininess;
-extern GLfloat user_specularity;
-extern GLfloat user_emissivity;
-
-extern bool redrawing_for_selection;
-
-extern float field_of_view;
-extern float viewpoint_x;
-extern float viewpoint_y;
-extern float viewpoint_z;
-extern float orientation_x;
-extern float orientation_y;
-extern float orientation_z;
-
-extern void rotate_bounds_about_one_axis (double angle, char which,
-	double& xmin, double& xmax, double& ymin, double& ymax, double& zmin, double &zmax);
-
-class red_dot_info {
-public:
-	double x, y, z;
-	red_dot_info *next;
-	int name;
-
-	red_dot_info () :
-		x(0.), y(0.), z(0.), next(NULL)
-	{
-	}
-	red_dot_info (double x_, double y_, double z_, int name_) :
-		x(x_),
-		y(y_),
-		z(z_),
-		name(name_),
-		next(NULL)
-	{
-	}
-};
-
-extern red_dot_info *red_dot_stack;
-
-//-------------------------------------------
-// Camera characteristics.
-//
-class CameraCharacteristics {
-public:
-	int window;
-	int configuration;	// e.g. SHOW_MAXILLA
-	bool need_recenter;
-	double field_of_view;
-	double rotation_pitch;
-	double rotation_yaw;
-	Quat combined_rotation;
-	Quat starting_rotation;
-	double scale_factor;
-	double viewpoint_x;
-	double viewpoint_y;
-	double viewpoint_z;
-	double orientation_x;
-	double orientation_y;
-	double orientation_z;
-	double viewpoints[3];
-
-	CameraCharacteristics ();
-};
-extern CameraCharacteristics cc_main;
-
-/*===========================================================================
- * Name:	ASSERT_NONZERO
- * Purpose:	Bails if parameter is zero.
- * Note:	To be used in important functions.
- */
-#ifdef WIN32
-#define ASSERT_NONZERO(PTR,NAME) \
-	if(!(PTR)) {\
-		fatal_null_pointer(__FUNCTION__, NAME); \
-	}
-#else
-#define ASSERT_NONZERO(PTR,NAME) \
-	if(!(PTR)) {\
-		fatal_null_pointer(__FUNCTION__, NAME); \
-	}
-#endif
-
-/*===========================================================================
- * Name:	ENTRY, ENTRY2, REPORT2
- * Purpose:	Debugging code that records the order of calls to files.
- */
-#if 0
-	#define ENTRY {FILE *ff=fopen("c:/maxilla_express.txt","a");fprintf(ff,"Entered %s, type=%s, name=%s\n",__FUNCTION__,type,name);fclose(ff);}
-	#define ENTRY2 {int ii=level; FILE *ff=fopen("c:/maxilla_bounds.txt","a");while(ii>0){ii--;fprintf(ff,"  ");}fprintf(ff,"Entered %s, type=%s, name=%s\n",__FUNCTION__,type,name);fclose(ff);}
-	#define REPORT2 {int ii=level; FILE *ff=fopen("c:/maxilla_bounds.txt","a");while(ii>0){ii--;fprintf(ff,"  ");}fprintf(ff,"Reporting type=%s name=%s: %g,%g  %g,%g  %g,%g\n",type,name,minx,maxx,miny,maxy,minz,maxz);fclose(ff);}
-#else
-	#define ENTRY
-	#define ENTRY2
-	#define REPORT2
-#endif
-
-/*===========================================================================
- * Name:	WhiteLight
- * Purpose:	Holds light info w/intent that user can change it on the fly.
- */
-class WhiteLight {
-public:
-	// Values currently in use.
-	float pos[4];
-	float brightness, specularity;
-	float ambient;
-	bool positional;
-
-	// Default ortho values, copied in when orthographic mode enabled.
-	float pos_ortho[4];
-	float brightness_ortho;
-	float specularity_ortho;
-	float ambient_ortho;
-
-	// Default non-ortho values, copied in when orthographic mode disabled.
-	float pos_non_ortho[4];
-	float brightness_non_ortho;
-	float specularity_non_ortho;
-	float ambient_non_ortho;
-
-	// Default values for cross-section mode.
-	float pos_cross_section[4];
-	float brightness_cross_section;
-	float specularity_cross_section;
-	float ambient_cross_section;
-
-	WhiteLight (bool positional_) {
-		int i;
-		for (i=0; i<3; i++) {
-			pos[i] = 0.f;
-			pos_non_ortho[i] = 0.f;
-			pos_ortho[i] = 0.f;
-		}
-		pos[3] = pos_ortho[3] = pos_non_ortho[3] = positional_ ? 1.f : 0.f;
-		positional = positional_;
-		brightness = brightness_ortho = brightness_non_ortho = 0.1f;
-		specularity = specularity_ortho = specularity_non_ortho = 0.1f;
-		ambient = ambient_ortho = ambient_non_ortho = 0.1f;
-
-		total_allocated += sizeof(WhiteLight);
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Prints information about light's characteristics.
-	 */
-	void dump (int num) {
-		printf ("%s light %d: pos %g,%g,%g, brightness %g, specularity %g, ambient %g\n",
-			positional ? "Positional" : "Directional", 
-			num, pos[0], pos[1], pos[2], brightness, specularity, ambient);
-	}
-
-	/*===================================================================
-	 * Name:	reset
-	 * Purpose:	Resets light to original ortho or non-ortho values.
-	 */
-	void reset (char mode) {
-		switch (mode) {
-		case 'o':
-			pos[0] = pos_ortho[0];
-			pos[1] = pos_ortho[1];
-			pos[2] = pos_ortho[2];
-			pos[3] = pos_ortho[3];
-			brightness = brightness_ortho;
-			specularity = specularity_ortho;
-			ambient = ambient_ortho;
-			break;
-		case 'n':
-			pos[0] = pos_non_ortho[0];
-			pos[1] = pos_non_ortho[1];
-			pos[2] = pos_non_ortho[2];
-			pos[3] = pos_non_ortho[3];
-			brightness = brightness_non_ortho;
-			specularity = specularity_non_ortho;
-			ambient = ambient_non_ortho;
-		case 'c':
-			pos[0] = pos_cross_section[0];
-			pos[1] = pos_cross_section[1];
-			pos[2] = pos_cross_section[2];
-			pos[3] = pos_cross_section[3];
-			brightness = brightness_cross_section;
-			specularity = specularity_cross_section;
-			ambient = ambient_cross_section;
-		}
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses the light's characteristics as OpenGL calls.
-	 */
-	void express (int num) {
-		static int lights[4] = { 
-			GL_LIGHT0, GL_LIGHT1, GL_LIGHT2, GL_LIGHT3 
-		};
-		int which = lights[num];
-		float tmp[4];
-
-		tmp[0] = tmp[1] = tmp[2] = ambient;
-		tmp[3] = 1.f;
-		glLightfv (which, GL_AMBIENT, tmp);
-
-		tmp[0] = tmp[1] = tmp[2] = specularity;
-		tmp[3] = 1.f;
-		glLightfv (which, GL_SPECULAR, tmp);
-
-		tmp[0] = tmp[1] = tmp[2] = brightness;
-		tmp[3] = 1.f;
-		glLightfv (which, GL_DIFFUSE, tmp);
-
-		glLightfv (which, GL_POSITION, pos);
-	}
-};
-
-class Model;
-
-
-
-class OpenGLRenderContext;
-
-
-/*===========================================================================
- * Name:	Triangle
- * Purpose:	Encapsulates a triangle i.e. a face.
- */
-class Triangle 
-{
-	public:
-		Point *p1, *p2, *p3;
-		Point *normal_vector;
-		Model *model;
-		int indices [3];
-		float area;
-
-		Triangle () {
-			p1 = p2 = p3 = normal_vector = NULL;
-			model = NULL;
-			area = 0.f;
-		}
-
-		/*===================================================================
-		 * Name:	Triangle
-		 * Purpose:	Creates the object and computes normal vector.
-		 */
-		Triangle (Point *p1_, Point *p2_, Point *p3_);
-
-		/*===================================================================
-		 * Name:	serialize
-		 * Purpose:	Express the triangle as ASCII.
-		 */
-		void serialize (gzFile f) 
-		{
-			if (!f) 
-				return;
-			if (!p1 || !p2 || p3) {
-				warning ("Cannot serialize triangle, it is missing points.");
-				return;
-			}
-			gzprintf (f, "%d %d %d\n", p1->id, p2->id, p3->id);
-		}
-
-		/*===================================================================
-		 * Name:	express
-		 * Purpose:	Expresses the triangle as OpenGL calls.
-		 */
-		void express (CRenderContext* pContext);
-		void express_as_lines (CRenderContext* pContext);
-
-		/*===================================================================
-		 * Name:	get_center
-		 * Purpose:	Finds the center of a triangle.
-		 */
-		void get_center (double &x, double &y, double &z) {
-			x = (p1->x + p2->x + p3->x) / 3.f;
-			y = (p1->y + p2->y + p3->y) / 3.f;
-			z = (p1->z + p2->z + p3->z) / 3.f;
-		}
-};
-
-
-/*===========================================================================
- * Name:	PolyLine
- * Purpose:	Encapsulates a polyline as a linked list.
- */
-class PolyLine 
-{
-public:
-	Point *point;
-	PolyLine *next;
-	float color[4];
-
-	PolyLine() 
-	{
-		point = NULL;
-		next = NULL;
-	}
-
-	PolyLine (Point *p_) 
-	{
-		point = p_;
-		next = NULL;
-	}
-
-	~PolyLine() 
-	{
-		// point is allocated by someone else.
-		delete next;
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses the polyline recursively as OpenGL calls.
-	 */
-	void express (bool use_color) 
-	{
-		if (use_color)
-			return;
-		if (point)
-			Point_express (point);
-		if (next)
-			next->express (use_color);
-	}
-};
-
-
-/*===========================================================================
- * Name:	Node
- * Purpose:	Encapsulates a parsed version of information about 
- *		the objects found in the VRML file.
- */
-class Node {
-public:
-	const char *type;
-	Node *next;
-	Node *children;
-	Node *last_child;
-	Node *parent;
-	char *name;
-
-	bool dont_save_this_node;
-
-	Node () {
-		type = "Node";
-		name = NULL;
-		next = NULL;
-		children = NULL;
-		last_child = NULL;
-		parent = NULL;
-		dont_save_this_node = false;
-
-		total_allocated += sizeof(Node);
-	}
-
-	~Node() {
-		total_allocated -= sizeof(Node);
-
-		if (children)
-			delete children;
-		children = NULL;
-		last_child = NULL;
-		if (next)
-			delete next;
-		next = NULL;
-		// name is not a copy.
-		// type is a const.
-	}
-
-	/*===================================================================
-	 * Name:	find_by_name
-	 * Purpose:	Finds a node by its name.
-	 * Returns:	Node pointer or NULL if not found.
-	 */
-	Node *find_by_name (char *s) {
-		if (name && !strcmp (s, name))
-			return this;
-		Node *result = NULL;
-		if (next) 
-			result = next->find_by_name (s);
-		if (!result && children) 
-			result = children->find_by_name (s);
-		return result;
-	}
-
-	/*===================================================================
-	 * Name:	find_by_type
-	 * Purpose:	Finds the first node of the specified type.
-	 * Returns:	Node pointer or NULL if not found.
-	 */
-	Node *find_by_type (char *s) {
-		if (type && !strcmp (s, type))
-			return this;
-		Node *result = NULL;
-		if (next) 
-			result = next->find_by_type (s);
-		if (!result && children) 
-			result = children->find_by_type (s);
-		return result;
-	}
-
-	/*===================================================================
-	 * Name:	add_child
-	 * Purpose:	Appends a child to the Node's children linked list.
-	 * Returns:	The total # of children.
-	 */
-	int add_child (Node *n) 
-	{
-		ASSERT_NONZERO(n,"node")
-		//----------
-
-		if (!children)
-			children = n;
-		else
-			last_child->next = n;
-		last_child = n;
-
-		int count = 0;
-		Node *node = children;
-		while (node) {
-			count++;
-			node = node->next;
-		}
-		return count;
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses the object in terms of OpenGL calls.
-	 */
-	virtual void express(bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-		if (children)
-			children->express (true, pContext);
-		if (express_siblings && next)
-			next->express (true, pContext);
-	}
-
-	void serialize (gzFile f);
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump for testing.
-	 */
-	virtual void dump (FILE *f) 
-	{
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s\n", type, name? name : "");
-	}
-
-	/*===================================================================
-	 * Name:	smooth
-	 * Purpose:	Smooths nodes.
-	 */
-	virtual void smooth ();
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	virtual void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
-		double xmin2, xmax2, ymin2, ymax2, zmin2, zmax2;
-
-		my_xmin = my_ymin = my_zmin = xmin2 = ymin2 = zmin2 = 1E6f;
-		my_xmax = my_ymax = my_zmax = xmax2 = ymax2 = zmax2 = -1E6f;
-
-		if (children) {
-			children->report_bounds (level+1, true,
-						my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-		}
-
-		if (report_siblings && next) {
-			next->report_bounds (level, true, 
-						xmin2, xmax2, ymin2, ymax2, zmin2, zmax2);
-			if (xmin2 < my_xmin)
-				my_xmin = xmin2;
-			if (ymin2 < my_ymin)
-				my_ymin = ymin2;
-			if (zmin2 < my_zmin)
-				my_zmin = zmin2;
-			if (xmax2 > my_xmax)
-				my_xmax = xmax2;
-			if (ymax2 > my_ymax)
-				my_ymax = ymax2;
-			if (zmax2 > my_zmax)
-				my_zmax = zmax2;
-		}
-
-		minx = my_xmin;
-		maxx = my_xmax;
-		miny = my_ymin;
-		maxy = my_ymax;
-		minz = my_zmin;
-		maxz = my_zmax;
-		REPORT2
-	}
-};
-
-
-/*===========================================================================
- * Name:	NameMap
- * Purpose:	Struct for implementing a simple linked list of 
- *			name-value associations.
- * Note:	Do not replace with a templated class!
- */
-struct NameMap {
-	char *name;
-	Node *node;
-	NameMap *next;
-};
-
-
-/*===========================================================================
- * Name:	InputWord
- * Purpose:	Encapsulates a string that was read from a VRML file.
- */
-class InputWord {
-public:
-	char *str;
-	float value;
-	InputWord *next;
-	InputWord *children;
-
-	InputWord (const char*);
-	InputWord (float num) {
-		str = "#";
-		value = num;
-		next = children = NULL;
-
-		total_allocated += sizeof(InputWord);
-	}
-	~InputWord ();
-};
-
-/*===========================================================================
- * Name:	InputFile
- * Purpose:	Encapsulates information about an input file.
- */
-class InputFile {
-public:
-	bool valid;
-	char *path;
-	char *name;
-	char *extension;
-	short ungot_char;
-	gzFile gzfile;	// Used whether compressed or not.
-	InputWord *tree;
-	unsigned char buffer[INPUTFILE_BUFFERSIZE];
-	int buffer_ix;
-	int buffer_limit;
-	char *first_line;
-	bool is_dst_file;
-
-	InputFile(char*);
-
-	~InputFile() {
-		total_allocated -= path? strlen(path) + 1 : 0;
-		total_allocated -= first_line? strlen(first_line) + 1 : 0;
-
-		if (path)
-			free(path);
-		if (first_line)
-			free(first_line);
-	}
-
-	/*===================================================================
-	 * Name:	unget
-	 * Purpose:	Reverses the last read. Limit 1 character.
-	 */
-	void unget (char ch) {
-		if (ch != EOF) {
-			if (ungot_char != EOF)
-				warning ("InputFile::unget called twice.");
-			else
-				ungot_char = ch;
-		}
-	}
-
-	/*===================================================================
-	 * Name:	getchar
-	 * Purpose:	Fetches one character from the buffered file.
-	 */
-	int getchar() {
-		int ch = EOF;
-		if (ungot_char != EOF) {
-			short tmp = ungot_char;
-			ungot_char = EOF;
-			return tmp;
-		}
-		if (buffer_limit >=0 && buffer_ix >= 0)	{
-			if (buffer_ix >= buffer_limit) {
-				if (!replenish_buffer())
-					return EOF;
-			}
-			ch = buffer[buffer_ix++];
-		}
-		return ch;
-	}
-
-	/*===================================================================
-	 * Name:	open
-	 * Purpose:	Opens the file, assuming the path is already set.
-	 */
-	bool open() {
-		if (!path)
-			return false;
-		gzfile = gzopen (path, "rb");
-		if (gzfile)
-			replenish_buffer();
-		return gzfile != NULL;
-	}
-
-	/*===================================================================
-	 * Name:	close
-	 * Purpose:	Closes the file, if open.
-	 */
-	void close() {
-		if (gzfile)
-			gzclose(gzfile);
-		gzfile = NULL;
-		buffer_ix = buffer_limit = -1;
-	}
-
-private:
-	/*===================================================================
-	 * Name:	replenish_buffer
-	 * Purpose:	Loads more data from the file into the buffer.
-	 */
-	bool replenish_buffer () 
-	{
-		buffer_ix = 0;
-		buffer_limit = -1;
-
-		if (gzfile)
-			buffer_limit = gzread (gzfile, buffer, INPUTFILE_BUFFERSIZE);		
-
-		// If this is the first-ever read, let's
-		// store the 1st line.
-		//
-		if (!first_line) {
-			int i=0;
-			unsigned long chunk_size=0;
-			// Find the 1st newline. (Windows does not have strnchr().)
-			while (buffer[i] != '\n' && i<INPUTFILE_BUFFERSIZE)
-				i++;
-			chunk_size = i + 1;
-			first_line = (char*) malloc(chunk_size);
-			memset (first_line,0, chunk_size);
-			memcpy (first_line, buffer, chunk_size);
-			first_line[chunk_size-1] = 0;
-
-			total_allocated += chunk_size;
-		}
-
-		return buffer_limit > 0;
-	}
-
-};
-
-/*===========================================================================
- * Name:	Transform
- * Purpose:	Represents a VRML Transform node.
- */
-class Transform : public Node {
-public:
-	double translate_x;
-	double translate_y;
-	double translate_z;
-	double second_translate_x;
-	double second_translate_y;
-	double second_translate_z;
-	double scale_x;
-	double scale_y;
-	double scale_z;
-	double rotate_x;
-	double rotate_y;
-	double rotate_z;
-	double rotate_angle; // in radians
-	double second_rotate_x;
-	double second_rotate_y;
-	double second_rotate_z;
-	double second_rotate_angle; // in radians
-	double center_x;
-	double center_y;
-	double center_z;
-
-	// The following are used to keep track of the order of operations.
-	// RULE: In VRML's Transform construct, the order matters.
-	//
-#define TRANSFORM_MAX_OPS 4
-	enum { TRANSLATE=1, SCALE=2, ROTATE=3, ROTATE2=4, TRANSLATE2=5 };
-	char operations [TRANSFORM_MAX_OPS];
-	unsigned short op_index;
-
-	Transform() {
-		type = "Transform";
-		translate_x = 0.0f;
-		translate_y = 0.0f;
-		translate_z = 0.0f;
-		second_translate_x = 0.0f;
-		second_translate_y = 0.0f;
-		second_translate_z = 0.0f;
-		scale_x = 1.0f;
-		scale_y = 1.0f;
-		scale_z = 1.0f;
-		rotate_x = 0.0f;
-		rotate_y = 0.0f;
-		rotate_z = 0.0f;
-		second_rotate_x = 0.0f;
-		second_rotate_y = 0.0f;
-		second_rotate_z = 0.0f;
-		center_x = center_y = center_z = 0.f;
-		rotate_angle = 0.0f;
-		children = NULL;
-		next = NULL;
-		op_index = 0; // No VRML operations yet recorded.
-
-		total_allocated += sizeof(Transform);
-	}
-
-	void serialize (gzFile );
-
-
-	virtual void express(bool express_siblings, CRenderContext* pContext) 
-	{
-		int i;
-
-		ENTRY
-		pContext->PushMatrix ();
-
-		// Express translate/rotate/scale.
-		// Note that OpenGL processes any translate/rotate/scale in reverse order,
-		// whereas VRML expresses them in forward order.
-		//
-		i = op_index - 1;
-		while (i >= 0) {
-			switch (operations[i]) 
-			{
-			case ROTATE:
-				if (rotate_angle != 0.0f) 
-					pContext->Rotatef ((rotate_angle/(float)M_PI)*180.f, rotate_x, rotate_y, rotate_z);
-				break;
-
-			case ROTATE2:
-				if (second_rotate_angle != 0.0f) 
-					pContext->Rotatef ((second_rotate_angle/(float)M_PI)*180.f, 
-						second_rotate_x, second_rotate_y, second_rotate_z);
-				break;
-
-			case SCALE:
-				pContext->Scalef (scale_x, scale_y, scale_z);
-				break;
-	
-			case TRANSLATE:
-				pContext->Translatef (translate_x, translate_y, translate_z);
-				break;
-
-			case TRANSLATE2:
-				pContext->Translatef (second_translate_x, second_translate_y, second_translate_z);
-				break;
-			}
-			i--;
-		}
-
-#if 0
-		if (center_x != 0.f || center_y != 0.f || center_z != 0.f)
-			glTranslatef (-center_x, -center_y, -center_z);
-#endif
-		if (children)
-			children->express(express_siblings, pContext);
-
-		pContext->PopMatrix ();
-
-		if (express_siblings && next)
-			next->express(true, pContext);
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s: translate %g %g %g rotate %g %g %g (%g deg) scale %g %g %g\n", 
-			type, name? name : "",
-			translate_x, translate_y, translate_z,
-			rotate_x, rotate_y, rotate_z, rotate_angle,
-			scale_x, scale_y, scale_z);
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-
-		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
-		my_xmin = my_ymin = my_zmin = 1E6f;
-		my_xmax = my_ymax = my_zmax = -1E6f;
-
-		if (children) {
-			children->report_bounds (level+1, true,
-			 my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-		}
-
-		// Perform translate/rotate/scale on bounding box.
-		// Note that OpenGL processes any translate/rotate/scale in reverse order,
-		// whereas VRML expresses them in forward order.
-		//
-		if (my_xmin < 1E6f && my_ymin < 1E6f && my_zmin < 1E6f) {
-			int i = 0;
-			while (i < op_index) {
-				switch (operations[i]) {
-				case ROTATE:	
-					if (rotate_angle != 0.f) {
-						double tmp = rotate_angle - (float) M_PI;
-						if (tmp < 0)
-							tmp = -tmp;
-	
-						// At present we deal only with the case of 180 degree rotation.
-#if 0
-						if (rotate_z == 1.f && (tmp < 0.0001)) {
-							double tmp = -my_ymin;
-							double tmp2 = -my_ymax;
-							my_ymin = tmp2;
-							my_ymax = tmp;
-						}
-						else 
-#endif
-							if (rotate_x == 1.f && rotate_z == 0.f && rotate_y == 0.f) {
-							rotate_bounds_about_one_axis (rotate_angle, 'x',
-								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-						}
-						else if (rotate_y == 1.f && rotate_x == 0.f && rotate_z == 0.f) {
-							rotate_bounds_about_one_axis (rotate_angle, 'y',
-								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-						}
-						else if (rotate_z == 1.f && rotate_x == 0.f && rotate_y == 0.f) {
-							rotate_bounds_about_one_axis (rotate_angle, 'z',
-								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-						}
-						else {
-							// Rotate about an arbitrary axis not yet supported. XX
-							printf ("Encountered arbitrary rotation... ignoring.\n");
-						}
-					}
-					break;
-
-				case SCALE:
-					my_xmin *= scale_x;
-					my_xmax *= scale_x;
-					my_ymin *= scale_y;
-					my_ymax *= scale_y;
-					my_zmin *= scale_z;
-					my_zmax *= scale_z;	
-					break;
-	
-				case TRANSLATE:
-					my_xmin += translate_x;
-					my_xmax += translate_x;
-					my_ymin += translate_y;
-					my_ymax += translate_y;
-					my_zmin += translate_z;
-					my_zmax += translate_z;
-					break;
-				}
-				i++;
-			}
-		}
-
-		if (next && report_siblings) {
-			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
-			minx2 = miny2 = minz2 = 1E6f;
-			maxx2 = maxy2 = maxz2 = -1E6f;
-
-			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
-			if (minx2 < my_xmin)
-				my_xmin = minx2;
-			if (miny2 < my_ymin)
-				my_ymin = miny2;
-			if (minz2 < my_zmin)
-				my_zmin = minz2;
-
-			if (maxx2 > my_xmax)
-				my_xmax = maxx2;
-			if (maxy2 > my_ymax)
-				my_ymax = maxy2;
-			if (maxz2 > my_zmax)
-				my_zmax = maxz2;
-		}
-
-		minx = my_xmin;
-		miny = my_ymin;
-		minz = my_zmin;
-
-		maxx = my_xmax;
-		maxy = my_ymax;
-		maxz = my_zmax;
-
-		REPORT2
-	}
-};
-
-
-/*===========================================================================
- * Name:	Switch
- * Purpose:	Represents a VRML Switch node.
- */
-class Switch : public Node {
-public:
-	int which;
-#ifdef ORTHOCAST
-	bool doing_open_view;
-#endif
-	int total_choices;
-	Node *which_node;
-
-	Switch() 
-	{
-		type = "Switch";
-
-		// No node yet chosen.
-		which = -1;
-		which_node = NULL;
-
-		total_choices = 0;
-		children = NULL;
-		next = NULL;
-
-		total_allocated += sizeof(Switch);
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses Switch contents unto OpenGL.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) 
-	{
-		ENTRY
-
-		// Update just in case it was cleared.
-		if (!which_node)
-			update_which_node();
-
-		// If we have a which_node, use it and
-		// tell the node not to express siblings.
-		// 
-		if (which_node) {
-			which_node->express (false, pContext);
-			printf ("expressing which node (%s) in Switch\n", which_node->type);
-		}
-
-		// If not, we never express the next node in a Switch.
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-
-		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
-		my_xmin = my_ymin = my_zmin = 1E6f;
-		my_xmax = my_ymax = my_zmax = -1E6f;
-
-		if (!which_node)
-			update_which_node();
-
-		if (which_node)
-			which_node->report_bounds (level+1, false,
-					my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
-
-		if (next && report_siblings) {
-			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
-			minx2 = miny2 = minz2 = 1E6f;
-			maxx2 = maxy2 = maxz2 = -1E6f;
-
-			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
-			
-			if (minx2 < my_xmin)
-				my_xmin = minx2;
-			if (miny2 < my_ymin)
-				my_ymin = miny2;
-			if (minz2 < my_zmin)
-				my_zmin = minz2;
-
-			if (maxx2 > my_xmax)
-				my_xmax = maxx2;
-			if (maxy2 > my_ymax)
-				my_ymax = maxy2;
-			if (maxz2 > my_zmax)
-				my_zmax = maxz2;
-		}
-
-		minx = my_xmin;
-		miny = my_ymin;
-		minz = my_zmin;
-
-		maxx = my_xmax;
-		maxy = my_ymax;
-		maxz = my_zmax;
-
-		REPORT2
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) 
-	{
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s (which = %d)\n",
-			type, name? name : "",
-			which);
-	}
-
-	/*===================================================================
-	 * Name:	update_which_node
-	 * Purpose:	Diagnostic dump.
-	 */
-	Node *update_which_node() {
-		//----------------------------------------
-		// Find the nth node, as specified w/ VRML
-		// 'whichChoice' value.
-		//
-		Node *n = children;
-		int i = which;
-		while (i > 0 && n) {
-			i--;
-			n = n->next;
-		}
-		which_node = n;
-// printf (" which node %08lx\n", (long)n);
-		return n;
-	}
-};
-
-class Group;
-
-/*===========================================================================
- * Name:	Model
- * Purpose:	Encapsulates a 3D model, specifically a VRML model.
- */
-class Model {
-public:
-	char *title; // not strdup'd
-
-	bool smoothed;
-
-	bool background_provided; 
-	GLfloat bg[3]; // read from VRML file.
-
-	double minx, maxx, miny, maxy, minz, maxz;
-
-	InputFile *inputfile;	// file
-	InputWord *word_tree;	// data from file
-	Node *nodes;	// data parsed from data from file
-
-#ifdef ORTHOCAST
-	// Some dentistry-specific data.
-	Node *main_switch;
-	char *patient_firstname;
-	char *patient_lastname;
-	char *patient_birthdate;
-	Group *top_and_bottom_node;	
-	char *case_date;
-	char *case_number;
-	char *control_number;
-
-	bool isTopAndBottomAligned;		
-
-	bool show_occlusal2;
-	Node* occlusal2_node;
-
-#endif
-
-	// Overall translation to center the model at (0,0,0).
-	double translate_x;
-	double translate_y;
-	double translate_z;
-
-	// Map of names to Nodes for VRML "USE".
-	NameMap *names;
-	NameMap *last_name;
-
-	Model () :
-		inputfile(NULL),
-		background_provided(false),
-		title(NULL),
-		names(NULL), last_name(NULL),
-		word_tree(NULL),
-		nodes(NULL),
-#ifdef ORTHOCAST
-		main_switch(NULL),
-		patient_firstname(NULL),
-		patient_lastname(NULL),
-		patient_birthdate(NULL),
-		top_and_bottom_node(NULL),	
-		case_date(NULL),
-		case_number(NULL),
-		control_number(NULL),
-		isTopAndBottomAligned(false),
-		show_occlusal2(false),
-		occlusal2_node(NULL),
-#endif
-		smoothed(false),
-		translate_x(0.f),
-		translate_y(0.f),
-		translate_z(0.f),
-		maxx(-1E6f), maxy(-1E6f), maxz(-1E6f), 
-		minx(1E6f), miny(1E6f), minz(1E6f)
-	{
-		bg[0] = bg[1] = bg[2] = 0.f;
-
-		total_allocated += sizeof(Model);		
-	}
-
-	
-
-	/*===================================================================
-	 * Name:	register_switch
-	 * Purpose:	Tells the Model that a switch node exists.
-	 */
-	void register_switch (Switch *sw)
-	{
-		ASSERT_NONZERO(sw,"switch");
-
-		if (!main_switch)
-		{
-			double minx,maxx,miny,maxy,minz,maxz;
-
-			main_switch = sw;
-					
-			//find related model nodes in main switch node.
-			//hard coded expected order!! 
-			int i = sw->which;			
-			sw->which = 0;
-			Node* topAndbottom = sw->update_which_node();
-
-			sw->which = 1;
-			Node* bottom = sw->update_which_node();
-
-			sw->which = 2;
-			Node* top = sw->update_which_node();
-
-			sw->which = i;
-			sw->update_which_node();
-
-			
-			if(bottom && top)
-			{
-				
-				//lower jaw
-				Transform* tx = new Transform();
-
-				tx->op_index = 1;
-				tx->operations[0] = Transform::ROTATE;
-				tx->rotate_y = 1;
-				tx->rotate_angle = 180.0f * (M_PI/180.0f);	
-
-				tx->op_index = 2;
-				tx->operations[1] = Transform::ROTATE2;
-				tx->second_rotate_x = 1;
-				tx->second_rotate_angle = 90.0f * (M_PI/180.0f);
-
-				bottom->report_bounds(1, false, minx, maxx, miny,maxy, minz,maxz);
-
-				tx->op_index = 3;
-				tx->operations[2] = Transform::TRANSLATE;
-				tx->translate_x = -(maxx - minx) * 0.51;	
-
-				tx->add_child(bottom);
-
-				//top jaw
-				Transform* tx2 = new Transform();
-
-				tx2->op_index = 1;
-				tx2->operations[0] = Transform::ROTATE;
-				tx2->rotate_x = 1;
-				tx2->rotate_angle = -90.0f * (M_PI/180.0f);	
-
-				
-				top->report_bounds(1, false, minx, maxx, miny,maxy, minz,maxz);
-
-				tx2->op_index = 2;
-				tx2->operations[1] = Transform::TRANSLATE;
-				tx2->translate_x = (maxx - minx) * 0.51;			
-
-				tx2->add_child(top);			
-
-				occlusal2_node = new Node();
-				occlusal2_node->add_child(tx);
-				occlusal2_node->add_child(tx2);
-
-			}
-		}
-
-	}
-
-	/*===================================================================
-	 * Name:	translate_all
-	 * Purpose:	Permits a one-time recentering of a parsed model.
-	 */
-	bool translate_all (double x, double y, double z) {
-		translate_x = x;
-		translate_y = y;
-		translate_z = z;
-		return true;
-	}
-
-	/*===================================================================
-	 * Name:	add_name_mapping
-	 * Purpose:	Maps a name to a node, for use with "USE" construct.
-	 */
-	void add_name_mapping (char *name, Node *n) 
-	{
-		ASSERT_NONZERO(name,"name")
-		ASSERT_NONZERO(n,"node")
-		//----------
-
-		if (!name || !n)
-			fatal("Null param in add_name_mapping.");
-
-		NameMap *m = new NameMap();
-		total_allocated += sizeof(NameMap);
-
-		m->name = name;
-		m->node = n;
-		if (!names)
-			names = m;
-		else
-			last_name->next = m;
-		last_name = m;
-	}
-
-	/*===================================================================
-	 * Name:	lookup_node_by_name
-	 * Purpose:	Finds a node by its name.
-	 * Note:	It's slow but there usually aren't many names.
-	 */
-	Node* lookup_node_by_name (char *name) 
-	{
-		ASSERT_NONZERO(name,"name")
-		//----------
-
-		NameMap *m = names;
-		while(m) {
-			if (!strcmp(name,m->name))
-				return m->node;
-			m = m->next;
-		}
-		return NULL;
-	}
-
-	/*===================================================================
-	 * Name:	smooth
-	 * Purpose:	Performs smoothing.
-	 */
-	void smooth ();
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses model's objects in terms of OpenGL calls.
-	 */
-	void express (CRenderContext* pContext);
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Determines the bounding box for the model, given the
-	 *		current switch choices.
-	 */
-	void report_bounds ();
-
-	/*===================================================================
-	 * Name:	which_switch_has_triangle
-	 * Purpose:	Tells the caller which Switch contains the specified
-	 *		Triangle object.
-	 */
-	int which_switch_has_triangle (Triangle *t);
-
-#if 0
-	/*===================================================================
-	 * Name:	ensure_tiny_triangles
-	 * Purpose:	Breaks IndexedFaceSets' triangles into small ones.
-	 */
-	bool ensure_tiny_triangles (double maximum);
-	bool ensure_tiny_triangles_core (double maximum, Node *);
-#endif
-
-	/*===================================================================
-	 * Name:	~Model
-	 * Purpose:	Carefully cleans up when Model to avoid memory leaks.
-	 */
-	~Model() {
-	//	delete word_tree;  -- XX
-		delete nodes;
-
-		total_allocated -=  sizeof(Model);
-
-		NameMap *m = names;
-		while (m) {
-			NameMap *m2 = m->next;
-			delete m;
-			m = m2;
-
-			total_allocated -= sizeof(NameMap);
-		}
-	}
-
-	/*===================================================================
-	 * Name:	serialize
-	 * Purpose:	Express the entire model as ASCII.
-	 */
-	void serialize (gzFile f) 
-	{
-		if (!f) 
-			return;
-		
-		//----------------------------------------
-		// Write out the beginning VRML.
-		//
-		serialization_indentation_level = 0;
-
-		nodes->serialize (f);
-
-		//----------------------------------------
-		// Write out the lower.
-		//
-
-		//----------------------------------------
-		// Write out the upper.
-		//
-
-		//----------------------------------------
-		// Write out the upper-lower alignment.
-		//
-
-		//----------------------------------------
-		// Write out the ending VRML.
-		//
-
-		gzprintf (f, "\n\n\n");
-	}
-
-
-	void autocenter ();
-};
-
-
-/*===========================================================================
- * Name:	Group
- * Purpose:	Represents a VRML Group node.
- */
-class Group : public Node {
-public:
-	Group() {
-		type = "Group";
-		children = NULL;
-		next = NULL;
-
-		total_allocated += sizeof(Group);
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s\n",
-			type, name? name : "");
-	}
-};
-
-
-/*===========================================================================
- * Name:	Separator
- * Purpose:	Represents a VRML Separator node.
- */
-class Separator : public Node {
-public:
-	Separator() {
-		type = "Separator";
-		children = NULL;
-		next = NULL;
-
-		total_allocated += sizeof(Separator);
-	}
-
-	void express (bool express_siblings, CRenderContext* pContext) {
-		// Need to express various Separator characteristics.
-		ENTRY
-		if (children)
-			children->express (true, pContext);
-		if (express_siblings && next)
-			next->express (true, pContext);
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s\n",
-			type, name? name : "");
-	}
-
-};
-
-
-/*===========================================================================
- * Name:	Material
- * Purpose:	
- */
-class Material : public Node {
-public:	
-	GLfloat diffuseColor[4];
-	GLfloat ambientIntensity;
-	GLfloat specularColor[4];
-	GLfloat emissiveColor[4];
-	GLfloat shininess;
-	GLfloat transparency;
-
-	Material ()
-	{
-		type = "Material";
-
-		for (int i=0; i < 4; i++) {
-			diffuseColor[i] = 0.7f;
-			specularColor[i] = emissiveColor[i] = 0.f;
-		}
-		ambientIntensity = 1.f;
-		shininess = 1.f;
-		transparency = 0.f;
-	}
-
-	~Material ()
-	{
-	}
-
-	void express_colors ()
-	{
-		int i;
-		GLfloat materialColor[4];
-		GLfloat materialSpecular[4];
-		GLfloat materialEmission[4];
-		if (using_custom_colors) {
-			for (i=0; i<3; i++) {
-				materialColor[i] = user_fg[i];
-				materialSpecular[i] = user_specularity;
-				materialEmission[i] = user_emissivity;
-			}
-		} else {
-			for (i=0; i<3; i++) {
-				materialColor[i] = diffuseColor[i];
-				materialSpecular[i] = specularColor[i];
-				materialEmission[i] = emissiveColor[i];
-			}
-		}
-		materialSpecular[3] = 1.0f;
-		materialEmission[3] = 1.0f;
-		materialColor[3] = ambientIntensity;
-
-		glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
-				materialColor);
-		glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
-		glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
-
-		if (!using_custom_colors)
-			glMaterialf (GL_FRONT, GL_SHININESS, shininess);
-		else
-			glMaterialf (GL_FRONT, GL_SHININESS, 
-				user_shininess);
-	}
-};
-
-/*===========================================================================
- * Name:	Appearance
- * Purpose:	
- */
-class Appearance : public Node {
-public:
-	Material *material;
-
-	Appearance () :
-		material(NULL)
-	{	
-		type = "Appearance";
-	}
-
-	~Appearance ()
-	{
-		if (material)
-			delete material;
-	}
-};
-
-
-/*===========================================================================
- * Name:	Shape
- * Purpose:	Represents a VRML Shape node.
- * Note:	The 'children' variable points to the Shape's geometry.
- */
-class Shape : public Node {
-public:
-	Appearance *appearance;
-
-	Shape() :
-		appearance(NULL)
-	{
-		type = "Shape";
-		children = NULL;
-		next = NULL;
-
-		total_allocated += sizeof(Shape);
-	}
-
-	/*===================================================================
-	 * Name:	~Shape
-	 * Purpose:	Carefully deallocates Shape object to avoid memory leaks.
-	 */
-	~Shape() {
-		if (children)
-			delete children;
-		children = NULL;
-		last_child = NULL;
-		if (appearance)
-			delete appearance;
-		if (next)
-			delete next;
-		next = NULL;
-		// name is not a copy.
-		// type is a const.
-
-		total_allocated -= sizeof(Shape);
-	}
-
-	/*===================================================================
-	 * Name:	add_geometry
-	 * Purpose:	Sets the one geometry that a Shape is allowed.
-	 */
-	void add_geometry (Node *n) 
-	{
-		ASSERT_NONZERO(n,"node")
-		//----------
-
-		if (children != NULL)
-			warning ("Attempt to add geometry to Shape that already has one.");
-		else
-			children = n;
-	}
-
-	void express_colors ()
-	{
-		if (appearance && appearance->material)
-			appearance->material->express_colors ();
-		else {
-			int i;
-			GLfloat materialColor[4];
-			GLfloat materialSpecular[4];
-			GLfloat materialEmission[4];
-			for (i=0; i<3; i++) {
-				materialColor[i] = user_fg[i];
-				materialSpecular[i] = user_specularity;
-				materialEmission[i] = user_emissivity;
-			}
-			materialSpecular[3] = 1.0f;
-			materialEmission[3] = 1.0f;
-			materialColor[3] = 0.5f; // ambient intensity
-
-			glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
-					materialColor);
-			glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
-			glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
-			glMaterialf (GL_FRONT, GL_SHININESS, user_shininess);
-		}
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses the Shape as OpenGL if geometry set.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-
-		if (children) {
-			express_colors();
-			children->express (true, pContext);
-		}
-		if (express_siblings && next)
-			next->express (true, pContext);
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-
-		double xmin, xmax, ymin, ymax, zmin, zmax;
-		xmin = ymin = zmin = 1E6f;
-		xmax = ymax = zmax = -1E6f;
-
-		if (children) {
-			children->report_bounds (level+1, false,
-							xmin, xmax, 
-							ymin, ymax, 
-							zmin, zmax);
-		}
-
-		// Get the number for the Shape's geometry node.
-		//
-		if (report_siblings && next) {
-			double xming, xmaxg, yming, ymaxg, zming, zmaxg;
-			xming = yming = zming = 1E6f;
-			xmaxg = ymaxg = zmaxg = -1E6f;
-
-			next->report_bounds (level, true,
-					xming, xmaxg, yming, ymaxg, zming, zmaxg);
-
-			if (xming < xmin)
-				xmin = xming;
-			if (yming < ymin)
-				ymin = yming;
-			if (zming < zmin)
-				zmin = zming;
-
-			if (xmaxg > xmax)
-				xmax = xmaxg;
-			if (ymaxg > ymax)
-				ymax = ymaxg;
-			if (zmaxg > zmax)
-				zmax = zmaxg;
-		}
-		
-		minx = xmin;
-		miny = ymin;
-		minz = zmin;
-		maxx = xmax;
-		maxy = ymax;
-		maxz = zmax;
-
-		REPORT2
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump, makes sure to print children.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s: ", type, name? name : "");
-		if (!children)
-			fprintf (f, "*no geometry*");
-		fputc ('\n', f);
-	}
-
-	void serialize (gzFile f);
-};
-
-/*===========================================================================
- * Name:	IndexedFaceSet
- * Purpose:	Represents a VRML IndexedFaceSet node, i.e. list of triangles.
- */
-class IndexedFaceSet : public Node {
-public:
-	float color[4];
-	bool color_specified;
-	Point **points;
-	int n_points;
-	Triangle **triangles;
-	int n_triangles;
-	int points_size;	// # pointers allocated
-	int triangles_size;	// # pointers allocated
-
-	double minx, maxx, miny, maxy, minz, maxz;
-
-	bool force_green;	// for cross section
-	bool doing_cross_section;
-
-	/*===================================================================
-	 * Name:	ensure_tiny_triangles 
-	 * Purpose:	Enforced a maximum triangle size.
-	 */
-	void ensure_tiny_triangles (double maximum);
-
-	/*===================================================================
-	 * Name:	IndexedFaceSet
-	 * Purpose:	Sets up IndexedFaceSet, creates point & triangle arrays.
-	 */
-	IndexedFaceSet () :
-		force_green(false), doing_cross_section(false),
-		color_specified(false)
-	{
-		type = "IndexedFaceSet";
-		color[0] = 0.0f;
-		color[1] = 0.0f;
-		color[2] = 0.0f;
-		color[3] = 0.0f;
-
-#define IFS_INITIAL_NPOINTS 300
-#define IFS_INITIAL_NTRIANGLES 600
-		n_points = 0;
-		points_size = IFS_INITIAL_NPOINTS;
-		int sz = sizeof(Point*)*IFS_INITIAL_NPOINTS;
-		points = (Point**) malloc (sz);
-		memset(points, 0, sz);
-		// points = new Point*[IFS_INITIAL_NPOINTS];
-
-		n_triangles = 0;
-		triangles_size = IFS_INITIAL_NTRIANGLES;
-		sz = sizeof (Triangle*) *IFS_INITIAL_NTRIANGLES;
-		triangles = (Triangle**) malloc (sz);
-		memset(triangles, 0, sz);
-		// triangles = new Triangle*[IFS_INITIAL_NTRIANGLES];
-		
-		next = NULL;
-		children = NULL;
-		
-		minx = miny = minz = 1E6f;
-		maxx = maxy = maxz = -1E6f;
-
-		total_allocated += sizeof(IndexedFaceSet);
-		total_allocated += sizeof(Point*) * IFS_INITIAL_NPOINTS;
-		total_allocated += sizeof(Triangle*) * IFS_INITIAL_NTRIANGLES;
-	}
-
-	/*===================================================================
-	 * Name:	~IndexedFaceSet
-	 * Purpose:	Carefully deallocates object to avoid memory leaks.
-	 */
-	~IndexedFaceSet() {
-		int i;
-		for(i=0; i<n_points; i++)
-			delete points[i];
-		for(i=0; i<n_triangles; i++)
-			delete triangles[i];
-
-		total_allocated -= sizeof(Point*) * points_size;
-		total_allocated -= sizeof(Triangle*) * triangles_size;
-		total_allocated -= sizeof(IndexedFaceSet);
-
-		free (points);	// Cannot delete[] since these used w/realloc().
-		free (triangles);
-
-		if (children)
-			delete children;
-		children = NULL;
-		last_child = NULL;
-		if (next)
-			delete next;
-		next = NULL;
-		// name is not a copy.
-		// type is a const.
-	}
-
-
-	/*===================================================================
-	 * Name:	smooth_faces
-	 * Purpose:	Performs smoothing of faces of this indexed face set.
-	 */
-	void smooth_faces () 
-	{
-		int i;
-
-		// Rather than implement a mechanism to count the
-		// number of triangles and points overall do determine
-		// whether a model should be smoothed, it is better
-		// to decide on a case-by-case basis since it's not possible
-		// that an input file won't have an ICS that is detailed
-		// as well as one that needs smoothing.
-		//
-//		printf ("n_points %u, n_triangles %u\n", n_points, n_triangles);
-//		printf ("sizeof(Point) %u, sizeof(Triangle) %u\n", sizeof(Point), sizeof(Triangle));
-		if (n_triangles > 42000)
-			return;
-
-		printf ("Smoothing %d triangles...\n", n_triangles );
-
-		//----------------------------------------
-		// Clear out the triangle normals arrays.
-		//
-		for (i=0; i < n_triangles; i++) {
-			Triangle *t = triangles[i];
-			Point_init_triangle_normals_array (t->p1);
-			Point_init_triangle_normals_array (t->p2);
-			Point_init_triangle_normals_array (t->p3);
-		}
-
-		//----------------------------------------
-		// For each triangle, copy its normal to
-		// the triangle normals array of each of 
-		// its points.
-		//
-		for (i=0; i < n_triangles; i++) {
-			Triangle *t = triangles[i];
-			Point *p1 = t->p1;
-			Point *p2 = t->p2;
-			Point *p3 = t->p3;
-
-			if (p1->n_normals_added >= p1->n_normals_from_triangles)
-				Point_realloc_triangle_normals_array (p1);
-			if (p2->n_normals_added >= p2->n_normals_from_triangles)
-				Point_realloc_triangle_normals_array (p2);
-			if (p3->n_normals_added >= p3->n_normals_from_triangles)
-				Point_realloc_triangle_normals_array (p3);
-
-			// Recall that records are:
-			// 0: triangle normal x
-			// 1: triangle normal y
-			// 2: triangle normal z
-			// 3: triangle area
-			p1->normals_from_triangles [p1->n_normals_added * 4] = t->normal_vector->x;
-			p1->normals_from_triangles [p1->n_normals_added * 4 + 1] = t->normal_vector->y;
-			p1->normals_from_triangles [p1->n_normals_added * 4 + 2] = t->normal_vector->z;
-			p1->normals_from_triangles [p1->n_normals_added * 4 + 3] = t->area;
-			p1->n_normals_added++;
-
-			p2->normals_from_triangles [p2->n_normals_added * 4] = t->normal_vector->x;
-			p2->normals_from_triangles [p2->n_normals_added * 4 + 1] = t->normal_vector->y;
-			p2->normals_from_triangles [p2->n_normals_added * 4 + 2] = t->normal_vector->z;
-			p2->normals_from_triangles [p2->n_normals_added * 4 + 3] = t->area;
-			p2->n_normals_added++;
-
-			p3->normals_from_triangles [p3->n_normals_added * 4] = t->normal_vector->x;
-			p3->normals_from_triangles [p3->n_normals_added * 4 + 1] = t->normal_vector->y;
-			p3->normals_from_triangles [p3->n_normals_added * 4 + 2] = t->normal_vector->z;
-			p3->normals_from_triangles [p3->n_normals_added * 4 + 3] = t->area;
-			p3->n_normals_added++;
-		}
-
-		// Clear crease flags.
-		for (i=0; i < n_points; i++) {
-			Point *p = points[i];
-			p->along_crease = false;
-		}
-
-		//----------------------------------------
-		// Calculate weighted vertex normal from 
-		// all of each vertex's triangles' normals.
-		//
-		for (i=0; i < n_points; i++) {			
-			Point *p = points[i];
-			int j;
-			double x = 0.f;
-			double y = 0.f;
-			double z = 0.f;
-			double total_area = 0.f;
-
-			//----------------------------------------
-			// Get the total area for all triangles
-			// connected to this point.
-			//
-			for (j=0; j < p->n_normals_added; j++) {
-				int ix = j * 4;
-				total_area += p->normals_from_triangles[ix + 3];
-			}
-
-			//----------------------------------------
-			// Add the weighted normals from all 
-			// triangles. Weight is just fraction of
-			// total area of all connected triangles.
-			//
-			for (j=0; j < p->n_normals_added; j++) {
-				int ix = j * 4;
-				double weight;
-				weight = p->normals_from_triangles[ix + 3]
-					/ total_area;
-				x += weight * p->normals_from_triangles[ix];
-				y += weight * p->normals_from_triangles[ix + 1];
-				z += weight * p->normals_from_triangles[ix + 2];
-			}
-
-			//----------------------------------------
-			// Normalize & store the normal.
-			//
-			double mag = sqrt (x*x + y*y + z*z);
-			p->normal_x = x / mag;
-			p->normal_y = y / mag;
-			p->normal_z = z / mag;	
-		}
-
-		//----------------------------------------
-		// Calculate the maximal angular deviation
-		// of each vertex normal from its 
-		// triangles' normals. This will tell us
-		// which points are along a crease.
-		//
-		int total_normals_rejected = 0;
-		for (i=0; i < n_points; i++) {
-			Point *p = points[i];
-			double max_angle = 0.;
-			int j;
-				
-			for (j=0; j < p->n_normals_added; j++) {	
-				double angle, dotproduct;
-				int ix = j*4;
-				double x = p->normals_from_triangles[ix];
-				double y = p->normals_from_triangles[ix + 1];
-				double z = p->normals_from_triangles[ix + 2];
-
-				double mag = sqrt (x*x + y*y + z*z);
-				x /= mag;
-				y /= mag;
-				z /= mag;
-
-				dotproduct = p->normal_x * x 
-					+ p->normal_y * y 
-					+ p->normal_z * z;
-
-				angle = abs (acosf (dotproduct));
-// printf ("angle %g degrees, ", 180.f*angle/M_PI);
-				if (angle > max_angle) {
-					max_angle = angle;
-				}
-			}
-
-			//----------------------------------------
-			// If the maximal angular difference
-			// is over 45 degrees (pi/4) then we shan't
-			// smooth this point.
-			//
-			p->valid_vertex_normal = true;
-
-			if (max_angle > (M_PI/4.f)) {
-				p->along_crease = true;
-			}
-			else 
-				p->along_crease = false;
-		}
-
-		int total_points_along_creases = 0;
-		for (i=0; i < n_points; i++) {
-			Point *p = points[i];
-			if (p->along_crease)
-				++total_points_along_creases;
-		}
-		printf ("Smoothing found that %d points are along creases (total %d) due to large angles.\n", 
-			total_points_along_creases,
-			n_points);
-
-		//----------------------------------------
-		// For each point of each triangle, 
-		// determine whether we have enough normals
-		// for smoothing. Ideally we want 3, but
-		// points along an edge of a non-closed
-		// IndexedFaceSet may have less.
-		//
-		for (i=0; i < n_triangles; i++) {
-			Triangle *t = triangles[i];
-			Point *p1 = t->p1;
-			Point *p2 = t->p2;
-			Point *p3 = t->p3;
-
-			// Here we only invalidate point vertices.
-			if (p1->n_normals_added < 3)
-				p1->valid_vertex_normal = false;
-			if (p2->n_normals_added < 3)
-				p2->valid_vertex_normal = false;
-			if (p3->n_normals_added < 3)
-				p3->valid_vertex_normal = false;
-		}
-
-		//----------------------------------------
-		// Finally, let's clean up.
-		//
-		for (i=0; i < n_points; i++) {
-			Point *p = points[i];
-			Point_destroy_triangle_normals_array (p);
-		}
-
-//		printf ("** n_points %u, n_triangles %u\n", n_points, n_triangles);
-//		printf ("** sizeof(Point) %u, sizeof(Triangle) %u\n", sizeof(Point), sizeof(Triangle));
-	}
-
-	void serialize (gzFile f);
-
-	/*===================================================================
-	 * Name:	expand_points
-	 * Purpose:	Increases the size of the points array by 2X.
-	 */
-	void expand_points () 
-	{
-		Point** newarray;
-		int lim = points_size;
-		total_allocated -= sizeof(Point*) * points_size; // delete
-
-		points_size = 2*lim;
-		unsigned amount = points_size * sizeof(Point*);
-printf ("expand_points: new points_size: %d, amount=%u\n", points_size,amount);
-fflush (0);
-		newarray = (Point**) malloc (amount);
-		if (!newarray) {
-			fatal ("out of memory!");
-		}
-		total_allocated += sizeof(Point*) * points_size;
-
-		int i=0;
-		while(i<lim) {
-			newarray[i]=points[i];
-			i++;
-		}
-		free (points);
-		points = newarray;
-	}
-
-	/*===================================================================
-	 * Name:	expand_triangles
-	 * Purpose:	Increases the size of the triangles array by 2X.
-	 */
-	void expand_triangles () {
-		Triangle** newarray;
-		unsigned long lim = triangles_size;
-		total_allocated -= sizeof(Triangle*) * triangles_size; // delete
-
-		triangles_size = 2*lim;
-		newarray = (Triangle**) malloc (triangles_size*sizeof(void*));
-		total_allocated += sizeof(Triangle*) * triangles_size;
-
-		unsigned long i=0;
-		while(i<lim) {
-			newarray[i]=triangles[i];
-			i++;
-		}
-		free (triangles);
-		triangles = newarray;
-	}
-
-	void express_ball_at (bool cube, double x, double y, double z, double radius, unsigned long color)
-	{
-		glPushMatrix ();
-		glTranslatef (x, y, z);
-
-		GLfloat materialColor[4];
-		materialColor [0] = 255==(0xff & (color>>16)) ? 1.f : 0.f;
-		materialColor [1] = 255==(0xff & (color>>8)) ? 1.f : 0.f;
-		materialColor [2] = 255==(0xff & color) ? 1.f : 0.f;
-		materialColor [3] = 0.f; 
-		glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
-			materialColor);
-		glMaterialfv (GL_FRONT, GL_EMISSION, materialColor);
-		if (cube) 
-			glutSolidCube (radius);
-		else
-			glutSolidSphere (radius, 20, 20);
-		glPopMatrix ();
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses all of the triangles as OpenGL data.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		int i;
-		ENTRY
-
-		Shape *shape = (Shape*) parent;
-		if (shape) 
-			shape->express_colors ();
-		else 
-			force_green = true;
-
-		if (redrawing_for_selection) {
-			for (i=0; i < n_triangles; i++) {
-				Triangle *t = triangles[i];
-#if defined(WIN32) || defined(__APPLE__)
-				glLoadName ((GLuint) t);	// XX not 64 bit correct
-#endif
-				glBegin(GL_TRIANGLES);
-				t->express (pContext);
-				glEnd ();
-			}
-		} else {
-			if (force_green) {
-				GLfloat materialColor[4];
-				materialColor [0] = 0.f;
-				materialColor [1] = 1.f;
-				materialColor [2] = 0.f;
-				materialColor [3] = 0.f; // XX
-				glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
-					materialColor);
-			}
-
-			if (!doing_cross_section) {
-#define BALL_BUFFER_SIZE (1000)
-				int n_balls = 0;
-				double ball_x [BALL_BUFFER_SIZE];
-				double ball_y [BALL_BUFFER_SIZE];
-				double ball_z [BALL_BUFFER_SIZE];
-
-printf ("Rendering %d triangles in IFS\n", n_triangles);
-				glBegin(GL_TRIANGLES);
-				for (i=0; i < n_triangles; i++) {
-					Triangle *t = triangles[i];
-
-#if defined(WIN32) || defined(__APPLE__)
-					if (red_dot_stack) {
-						bool name_match = false;
-						GLuint name;
-						name = (GLuint) t;
-
-						red_dot_info *r = red_dot_stack;
-						while (r && !name_match) {
-							if (name == r->name) {
-								name_match = true;
-								break;
-							} else
-								r = r->next;
-						}
-
-						// If we encounter a specific 
-						// triangle that's been 
-						// selected, we need to place
-						// a ball in its position.
-						//
-						if (name_match) {
-							double x, y, z;
-							t->get_center (x, y, z);
-							ball_x [n_balls] = x;
-							ball_y [n_balls] = y;
-							ball_z [n_balls] = z;
-							n_balls++;
-						}
-					}
-#endif
-					t->express (pContext);
-				}
-				glEnd ();
-		
-				i = 0;
-				while (i < n_balls) {
-					//------------------------------
-					// Create a red ball where user
-					// clicked.
-					//
-					express_ball_at (false, 
-						ball_x[i], ball_y[i], 
-						ball_z[i], 0.0005f, 0xff0000);
-
-					i++;
-				}
-				if (n_balls) {
-					// Restore the triangles' color.
-					//
-					Shape *shape = (Shape*) parent;
-					shape->express_colors ();
-				}
-			}
-			else
-			{
-				// Cross section
-				//
-				GLfloat materialColor[4];
-				unsigned long color = force_green ? 0xff00 : 0xff0000;
-				materialColor [0] = 255==(0xff & (color>>16)) ? 1.f : 0.f;
-				materialColor [1] = 255==(0xff & (color>>8)) ? 1.f : 0.f;
-				materialColor [2] = 255==(0xff & color) ? 1.f : 0.f;
-				materialColor [3] = 0.f;
-				glColor3f (materialColor[0], materialColor[1], materialColor[2]);
-				
-				for (i=0; i < n_triangles; i++) {		
-					Triangle *t = triangles[i];
-
-					glDisable(GL_LIGHTING);
-					glBegin (GL_LINES);
-					double x, y, z;
-					t->get_center (x, y, z);
-		
-					// float side = 0.0005f;
-					// side /= 2.f;
-					Point_express (t->p1);
-					Point_express (t->p2);
-					Point_express (t->p3);
-					Point_express (t->p1);
-					glEnd ();
-					glBegin (GL_TRIANGLES);
-					Point_express (t->p1);
-					Point_express (t->p2);
-					Point_express (t->p3);
-					glEnd ();
-					glEnable(GL_LIGHTING);
-				}
-			}
-		}
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx_, double &maxx_,
-				double &miny_, double &maxy_,
-				double &minz_, double &maxz_) 
-	{
-		ENTRY2
-
-		minx_ = minx;
-		maxx_ = maxx;
-		miny_ = miny;
-		maxy_ = maxy;
-		minz_ = minz;
-		maxz_ = maxz;
-#if 0
-		printf ("IndexedFaceSet BOUNDS: %g %g, %g %g, %g %g\n",
-			minx,maxx,miny,maxy,minz,maxz);
-#endif
-		REPORT2
-	}
-	
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf(f, "%s (%d points, %d triangles, bounds [%g,%g] [%g,%g] [%g,%g]\n", 
-			type, n_points, n_triangles, minx,maxx, miny,maxy, minz,maxz);
-	}
-};
-
-
-/*===========================================================================
- * Name:	IndexedLineSet
- * Purpose:	Represents a VRML IndexedLineSet node, i.e. list of lines.
- * Note:	Only one color supported.
- */
-class IndexedLineSet : public Node {
-public:
-	bool color_per_vertex;
-	float color[4];
-	Point **points;
-	float *colors; // organized as r,g,b,r,g,b,...
-	int n_points;
-	int n_colors;
-	int points_size;
-	int colors_size;
-	PolyLine *polyline;
-	PolyLine *last_poly;
-	int n_segments;
-	double minx, maxx, miny, maxy, minz, maxz;
-
-	IndexedLineSet() {
-		type = "IndexedLineSet";
-		color_per_vertex = false;
-		color[0] = 0.0f;
-		color[1] = 0.0f;
-		color[2] = 0.0f;
-		color[3] = 0.0f;
-		polyline = NULL;
-		last_poly = NULL;
-		n_segments = 0;
-
-		n_colors = 0;
-#define ILS_INITIAL_NCOLORS 16
-		colors_size = ILS_INITIAL_NCOLORS;
-		colors = new float[ILS_INITIAL_NCOLORS];
-
-		children = NULL;
-		next = NULL;
-
-		minx = miny = minz = 1E6f;
-		maxx = maxy = maxz = -1E6f;
-
-		n_points = 0;
-		points_size = IFS_INITIAL_NPOINTS;
-		points = new Point*[IFS_INITIAL_NPOINTS];
-
-		total_allocated += sizeof(IndexedFaceSet);
-		total_allocated += sizeof(Point*) * IFS_INITIAL_NPOINTS;
-		total_allocated += sizeof(float) * ILS_INITIAL_NCOLORS;
-	}
-
-	void serialize (gzFile f);
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx_, double &maxx_,
-				double &miny_, double &maxy_,
-				double &minz_, double &maxz_) 
-	{
-		ENTRY2
-		minx_ = minx;
-		maxx_ = maxx;
-		miny_ = miny;
-		maxy_ = maxy;
-		minz_ = minz;
-		maxz_ = maxz;
-		REPORT2
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Express the lines in the form of OpenGL calls.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-
-#ifndef ORTHOCAST
-		if (!color_per_vertex) {
-			glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, color);
-			glBegin(GL_LINE_STRIP);
-
-			polyline->express (color_per_vertex);
-
-			glEnd ();
-		} else {
-			PolyLine *pl = polyline;
-			Point *prev = NULL;
-
-			while (pl) {
-				Point *p = pl->point;
-				if (prev) {
-					GLfloat materialColor[4];
-					GLfloat materialSpecular[4];
-					GLfloat materialEmission[4];
-					int i;
-					for (i=0; i<3; i++) {
-						materialColor[i] = using_custom_colors ? user_fg[i] : color[i];
-						materialSpecular[i] = 0 * user_specularity;
-						materialEmission[i] = 1.0f;
-					}
-					materialSpecular[3] = 1.f;
-					materialEmission[3] = 1.f;
-					materialColor[3] = 1.f;
-					glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, materialColor);
-					glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
-					glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
-					glMaterialf (GL_FRONT, GL_SHININESS, 127.f);
-
-					glBegin (GL_LINES);
-					glVertex3d (prev->x, prev->y, prev->z);
-					glVertex3d (p->x, p->y, p->z);
-					glEnd ();
-				}
-				prev = p;
-				pl = pl->next;
-			}
-		}
-#endif
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s \n", type);
-	}
-
-	/*===================================================================
-	 * Name:	expand_points
-	 * Purpose:	Increases the size of the points array by 2X.
-	 */
-	void expand_points () {
-		Point** newarray;
-		unsigned long lim = points_size;
-		total_allocated -= sizeof(Point*) * points_size;
-
-		points_size = 2*lim;
-		newarray = new Point*[points_size];
-		total_allocated += sizeof(Point*) * points_size;
-
-		unsigned long i=0;
-		while(i<lim) {
-			newarray[i]=points[i];
-			i++;
-		}
-		delete[] points;
-		points = newarray;
-	}
-
-	/*===================================================================
-	 * Name:	expand_colors
-	 * Purpose:	Increases the size of the colors array by 2X.
-	 */
-	void expand_colors () {
-		float* newarray;
-		int lim = colors_size;
-		total_allocated -= sizeof(float) * colors_size;
-
-		colors_size = 2*lim;
-		newarray = new float[colors_size];
-		total_allocated += sizeof(float) * colors_size;
-
-		int i=0;
-		while(i<lim) {
-			newarray[i]=colors[i];
-			i++;
-		}
-		delete[] colors;
-		colors = newarray;
-	}
-
-};
-
-
-/*===========================================================================
- * Name:	Cylinder
- * Purpose:	Represents a VRML Cylinder node.
- */
-class Cylinder : public Node {
-public:
-	bool bottom, top, side;
-	double radius;
-	double height;
-
-	Cylinder() {
-		type = "Cylinder";
-		bottom = top = side = true;
-		radius = 0.0f;
-		height = 0.0f;
-		next = NULL;
-		children = NULL;
-
-		total_allocated += sizeof(Cylinder);
-	}
-};
-
-/*===========================================================================
- * Name:	Box
- * Purpose:	Represents a VRML Box node.
- */
-class Box : public Node {
-public:
-	double size;
-
-	Box() {
-		type = "Box";
-		size = 0.0f;
-		next = NULL;
-		children = NULL;
-
-		total_allocated += sizeof(Box);
-	}
-};
-
-/*===========================================================================
- * Name:	Text
- * Purpose:	Represents a VRML Text node.
- */
-class Text : public Node {
-public:
-	char *text;
-
-	Text() {
-		type = "Text";
-		text = NULL;
-		next = NULL;
-		children = NULL;
-
-		total_allocated += sizeof(Text);
-	}
-
-	void serialize (gzFile );
-
-	void dump (FILE *f)
-	{
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s (%s = '%s')\n", 
-			type, 
-			name? name : "(no name)", 
-			text);
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-
-		minx = miny = minz = 1E6f;
-		maxx = maxy = maxy = -1E6f;
-	}
-};
-
-/*===========================================================================
- * Name:	Cone
- * Purpose:	Represents a VRML Cone node.
- */
-class Cone : public Node {
-public:
-	double radius;
-	double height;
-
-	Cone () :
-		radius(0.f), height(0.f)
-	{
-		type = "Cone";
-		next = NULL;
-		children = NULL;
-
-		total_allocated += sizeof(Cone);
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses Sphere using GLUT.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-		glutSolidCone (radius, height, 100, 1);
-	}
-
-};
-
-/*===========================================================================
- * Name:	Sphere
- * Purpose:	Represents a VRML Sphere node.
- */
-class Sphere : public Node {
-public:
-	double radius;
-
-	Sphere () {
-		type = "Sphere";
-		radius = 0.0f;
-		next = NULL;
-		children = NULL;
-
-		total_allocated += sizeof(Sphere);
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses Sphere using GLUT.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-		glutSolidSphere (radius, 50, 10);
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-		minx = -radius;
-		maxx = radius;
-		miny = -radius;
-		maxy = radius;
-		minz = -radius;
-		maxz = radius;
-		REPORT2
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s radius %g\n", type, name? name : "", radius);
-	}
-};
-
-/*===========================================================================
- * Name:	Replicated
- * Purpose:	Represents a replicated VRML node, i.e. result of USE command.
- */
-class Replicated : public Node {
-public:
-	Node *original; // For clarity, we don't use the 'children' datum.
-
-	/*===================================================================
-	 * Name:	Replicated
-	 * Purpose:	Creates a replication of named node.
-	 */
-	Replicated ()
-	{
-		original = NULL;
-	}
-
-	void serialize (gzFile f);
-
-	/*===================================================================
-	 * Name:	Replicated
-	 * Purpose:	Creates a replication of named node.
-	 */
-	Replicated (Model *m, char *name) {
-		ASSERT_NONZERO(m,"model")
-		ASSERT_NONZERO(name,"name")
-		//----------
-
-		type = "Replicated (USE)";
-		original = m->lookup_node_by_name (name);
-		if (!original) {
-			char tmp[250];
-			sprintf (tmp, "Unknown objected '%s' referred to in USE clause.", name);
-			warning(tmp);
-		}
-		children = NULL;
-		next = NULL;
-
-		total_allocated += sizeof(Replicated);
-	}
-
-	/*===================================================================
-	 * Name:	express
-	 * Purpose:	Expresses the object in OpenGL terms.
-	 */
-	void express (bool express_siblings, CRenderContext* pContext) {
-		ENTRY
-		if (original)
-			original->express (false, pContext);
-		if (express_siblings && next)
-			next->express (true, pContext);
-	}
-
-	/*===================================================================
-	 * Name:	report_bounds
-	 * Purpose:	Reports to caller maximum and minimum coordinates.
-	 */
-	void report_bounds (int level, bool report_siblings,
-				double &minx, double &maxx,
-				double &miny, double &maxy,
-				double &minz, double &maxz) 
-	{
-		ENTRY2
-			
-		double x0, x1, y0, y1, z0, z1;
-		x0 = y0 = z0 = 1E6f;
-		x1 = y1 = z1 = -1E6f;
-
-		if (original) {
-			original->report_bounds (level+1, false, 
-					x0, x1, y0, y1, z0, z1);
-		}
-
-		if (next && report_siblings) {
-			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
-			minx2 = miny2 = minz2 = 1E6f;
-			maxx2 = maxy2 = maxz2 = -1E6f;
-
-			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
-			if (minx2 < x0)
-				x0 = minx2;
-			if (miny2 < y0)
-				y0 = miny2;
-			if (minz2 < z0)
-				z0 = minz2;
-
-			if (maxx2 > x1)
-				x1 = maxx2;
-			if (maxy2 > y1)
-				y1 = maxy2;
-			if (maxz2 > z1)
-				z1 = maxz2;
-		}
-
-		minx = x0;
-		miny = y0;
-		minz = z0;
-		maxx = x1;
-		maxy = y1;
-		maxz = z1;
-		REPORT2
-	}
-
-	/*===================================================================
-	 * Name:	dump
-	 * Purpose:	Diagnostic dump, tells what the pointed-to object is.
-	 */
-	void dump (FILE *f) {
-		ASSERT_NONZERO(f,"file")
-		//----------
-
-		fprintf (f, "%s %s: ", type, name? name : "");
-		if (original)
-			original->dump (f);
-		else
-			fprintf (f, "NULL");
-		fputc('\n', f);
-	}
-};
-
-
-#endif /* _MAXILLA_H */
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2011 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2 
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+/*
+ * NOTICE NOTICE NOTICE
+ *
+ * Please do not use multiple inheritance or templates in this program.
+ * They are the leading causes of C++ code illegibility.
+ *
+ * Keep this program clean! Don't pollute it.
+ */
+
+#ifndef _MAXILLA_H
+#define _MAXILLA_H
+
+#include <stdio.h>
+#include <math.h>
+
+#include "defs.h"
+#include "quat.h"
+
+
+#ifdef WIN32
+#include "../../zlib/zlib.h"
+#else 
+#include <zlib.h>
+#endif
+
+#include "Point.h"
+#include "atoms.h"
+#include "mesh.h"
+#include "bvh.h"
+
+#include "RenderContext.h"
+
+class ZstdWriter;
+class GzIndex;
+
+/*===========================================================================
+ * Name:	OutputFile
+ * Purpose:	A file being saved, gzipped or as a zstd frame. The
+ *		serializers print to it, and what they print is
+ *		compressed as it is buffered, so that the model is
+ *		never written out uncompressed first. A gzipped file
+ *		is indexed as it is written.
+ */
+class OutputFile {
+public:
+	OutputFile ();
+	~OutputFile ();
+
+	bool open (const char *path, bool use_zstd);
+	void printf (const char *format, ...);
+	void write (const unsigned char *data, unsigned long size);
+	bool close ();
+
+private:
+	FILE *f;
+	z_stream stream;	// Used unless zstd is set.
+	ZstdWriter *zstd;
+	unsigned char *buffer;	// Data not yet compressed.
+	unsigned long buffer_length;
+	unsigned char *output;
+	bool failed;
+	char *path;
+	GzIndex *index;
+	unsigned long last;	// Offset of the last checkpoint.
+
+	void compress (bool finish);
+	void deflate_buffer (int flush);
+};
+
+extern int serialization_indentation_level;
+extern void indent (OutputFile *);
+
+typedef unsigned long RGB;
+extern RGB floats_to_rgb (float, float, float);
+extern void express_rgb (RGB);
+
+extern bool using_custom_colors;
+extern GLfloat user_fg[4];
+extern GLfloat user_bg[4];
+extern GLfloat user_shininess;
+extern GLfloat user_specularity;
+extern GLfloat user_emissivity;
+
+extern bool redrawing_for_selection;
+extern bool keeping_word_tree;
+extern bool saving_normals;
+
+// The level of detail drawn and saved: 0 for the full meshes,
+// n for the nth reduced one (see IndexedFaceSet::build_lods).
+extern int drawing_lod;
+extern int saving_lod;
+
+extern float field_of_view;
+extern float viewpoint_x;
+extern float viewpoint_y;
+extern float viewpoint_z;
+extern float orientation_x;
+extern float orientation_y;
+extern float orientation_z;
+
+extern void rotate_bounds_about_one_axis (double angle, char which,
+	double& xmin, double& xmax, double& ymin, double& ymax, double& zmin, double &zmax);
+
+class red_dot_info {
+public:
+	double x, y, z;
+	red_dot_info *next;
+	int name;
+
+	red_dot_info () :
+		x(0.), y(0.), z(0.), next(NULL)
+	{
+	}
+	red_dot_info (double x_, double y_, double z_, int name_) :
+		x(x_),
+		y(y_),
+		z(z_),
+		name(name_),
+		next(NULL)
+	{
+	}
+};
+
+extern red_dot_info *red_dot_stack;
+
+//-------------------------------------------
+// Camera characteristics.
+//
+class CameraCharacteristics {
+public:
+	int window;
+	int configuration;	// e.g. SHOW_MAXILLA
+	bool need_recenter;
+	double field_of_view;
+	double rotation_pitch;
+	double rotation_yaw;
+	Quat combined_rotation;
+	Quat starting_rotation;
+	double scale_factor;
+	double viewpoint_x;
+	double viewpoint_y;
+	double viewpoint_z;
+	double orientation_x;
+	double orientation_y;
+	double orientation_z;
+	double viewpoints[3];
+
+	CameraCharacteristics ();
+};
+extern CameraCharacteristics cc_main;
+
+/*===========================================================================
+ * Name:	ASSERT_NONZERO
+ * Purpose:	Bails if parameter is zero.
+ * Note:	To be used in important functions.
+ */
+#ifdef WIN32
+#define ASSERT_NONZERO(PTR,NAME) \
+	if(!(PTR)) {\
+		fatal_null_pointer(__FUNCTION__, NAME); \
+	}
+#else
+#define ASSERT_NONZERO(PTR,NAME) \
+	if(!(PTR)) {\
+		fatal_null_pointer(__FUNCTION__, NAME); \
+	}
+#endif
+
+/*===========================================================================
+ * Name:	ENTRY, ENTRY2, REPORT2
+ * Purpose:	Debugging code that records the order of calls to files.
+ */
+#if 0
+	#define ENTRY {FILE *ff=fopen("c:/maxilla_express.txt","a");fprintf(ff,"Entered %s, type=%s, name=%s\n",__FUNCTION__,type,name);fclose(ff);}
+	#define ENTRY2 {int ii=level; FILE *ff=fopen("c:/maxilla_bounds.txt","a");while(ii>0){ii--;fprintf(ff,"  ");}fprintf(ff,"Entered %s, type=%s, name=%s\n",__FUNCTION__,type,name);fclose(ff);}
+	#define REPORT2 {int ii=level; FILE *ff=fopen("c:/maxilla_bounds.txt","a");while(ii>0){ii--;fprintf(ff,"  ");}fprintf(ff,"Reporting type=%s name=%s: %g,%g  %g,%g  %g,%g\n",type,name,minx,maxx,miny,maxy,minz,maxz);fclose(ff);}
+#else
+	#define ENTRY
+	#define ENTRY2
+	#define REPORT2
+#endif
+
+/*===========================================================================
+ * Name:	WhiteLight
+ * Purpose:	Holds light info w/intent that user can change it on the fly.
+ */
+class WhiteLight {
+public:
+	// Values currently in use.
+	float pos[4];
+	float brightness, specularity;
+	float ambient;
+	bool positional;
+
+	// Default ortho values, copied in when orthographic mode enabled.
+	float pos_ortho[4];
+	float brightness_ortho;
+	float specularity_ortho;
+	float ambient_ortho;
+
+	// Default non-ortho values, copied in when orthographic mode disabled.
+	float pos_non_ortho[4];
+	float brightness_non_ortho;
+	float specularity_non_ortho;
+	float ambient_non_ortho;
+
+	// Default values for cross-section mode.
+	float pos_cross_section[4];
+	float brightness_cross_section;
+	float specularity_cross_section;
+	float ambient_cross_section;
+
+	WhiteLight (bool positional_) {
+		int i;
+		for (i=0; i<3; i++) {
+			pos[i] = 0.f;
+			pos_non_ortho[i] = 0.f;
+			pos_ortho[i] = 0.f;
+		}
+		pos[3] = pos_ortho[3] = pos_non_ortho[3] = positional_ ? 1.f : 0.f;
+		positional = positional_;
+		brightness = brightness_ortho = brightness_non_ortho = 0.1f;
+		specularity = specularity_ortho = specularity_non_ortho = 0.1f;
+		ambient = ambient_ortho = ambient_non_ortho = 0.1f;
+
+		total_allocated += sizeof(WhiteLight);
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Prints information about light's characteristics.
+	 */
+	void dump (int num) {
+		printf ("%s light %d: pos %g,%g,%g, brightness %g, specularity %g, ambient %g\n",
+			positional ? "Positional" : "Directional", 
+			num, pos[0], pos[1], pos[2], brightness, specularity, ambient);
+	}
+
+	/*===================================================================
+	 * Name:	reset
+	 * Purpose:	Resets light to original ortho or non-ortho values.
+	 */
+	void reset (char mode) {
+		switch (mode) {
+		case 'o':
+			pos[0] = pos_ortho[0];
+			pos[1] = pos_ortho[1];
+			pos[2] = pos_ortho[2];
+			pos[3] = pos_ortho[3];
+			brightness = brightness_ortho;
+			specularity = specularity_ortho;
+			ambient = ambient_ortho;
+			break;
+		case 'n':
+			pos[0] = pos_non_ortho[0];
+			pos[1] = pos_non_ortho[1];
+			pos[2] = pos_non_ortho[2];
+			pos[3] = pos_non_ortho[3];
+			brightness = brightness_non_ortho;
+			specularity = specularity_non_ortho;
+			ambient = ambient_non_ortho;
+		case 'c':
+			pos[0] = pos_cross_section[0];
+			pos[1] = pos_cross_section[1];
+			pos[2] = pos_cross_section[2];
+			pos[3] = pos_cross_section[3];
+			brightness = brightness_cross_section;
+			specularity = specularity_cross_section;
+			ambient = ambient_cross_section;
+		}
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses the light's characteristics as OpenGL calls.
+	 */
+	void express (int num) {
+		static int lights[4] = { 
+			GL_LIGHT0, GL_LIGHT1, GL_LIGHT2, GL_LIGHT3 
+		};
+		int which = lights[num];
+		float tmp[4];
+
+		tmp[0] = tmp[1] = tmp[2] = ambient;
+		tmp[3] = 1.f;
+		glLightfv (which, GL_AMBIENT, tmp);
+
+		tmp[0] = tmp[1] = tmp[2] = specularity;
+		tmp[3] = 1.f;
+		glLightfv (which, GL_SPECULAR, tmp);
+
+		tmp[0] = tmp[1] = tmp[2] = brightness;
+		tmp[3] = 1.f;
+		glLightfv (which, GL_DIFFUSE, tmp);
+
+		glLightfv (which, GL_POSITION, pos);
+	}
+};
+
+class Model;
+
+
+
+class OpenGLRenderContext;
+
+
+/*===========================================================================
+ * Name:	Triangle
+ * Purpose:	Encapsulates a triangle i.e. a face.
+ * Note:	Triangles and their normals are allocated only in the
+ *		pool of their IndexedFaceSet, which frees them all at
+ *		once; they are never deleted.
+ */
+class Triangle 
+{
+	public:
+		Point *p1, *p2, *p3;
+		Point *normal_vector;
+		int indices [3];
+		float area;
+
+		Triangle () {
+			p1 = p2 = p3 = normal_vector = NULL;
+			area = 0.f;
+		}
+
+		/*===================================================================
+		 * Name:	Triangle
+		 * Purpose:	Creates the object with its normal vector and
+		 *		area already known, as in the FlatMesh.
+		 */
+		Triangle (Point *p1_, Point *p2_, Point *p3_, const float *normal, float area_, Arena *pool) {
+			p1 = p1_;
+			p2 = p2_;
+			p3 = p3_;
+			normal_vector = Point_init ((Point*) pool->alloc (sizeof(Point)),
+				normal[0], normal[1], normal[2]);
+			area = area_;
+		}
+
+		void *operator new (size_t size, Arena *pool) {
+			return pool->alloc (size);
+		}
+		void operator delete (void *, Arena *) {
+		}
+
+		/*===================================================================
+		 * Name:	serialize
+		 * Purpose:	Express the triangle as ASCII.
+		 */
+		void serialize (OutputFile *f) 
+		{
+			if (!f) 
+				return;
+			if (!p1 || !p2 || p3) {
+				warning ("Cannot serialize triangle, it is missing points.");
+				return;
+			}
+			f->printf ("%d %d %d\n", p1->id, p2->id, p3->id);
+		}
+
+		/*===================================================================
+		 * Name:	express
+		 * Purpose:	Expresses the triangle as OpenGL calls.
+		 */
+		void express (CRenderContext* pContext);
+		void express_as_lines (CRenderContext* pContext);
+
+		/*===================================================================
+		 * Name:	get_center
+		 * Purpose:	Finds the center of a triangle.
+		 */
+		void get_center (double &x, double &y, double &z) {
+			x = (p1->x + p2->x + p3->x) / 3.f;
+			y = (p1->y + p2->y + p3->y) / 3.f;
+			z = (p1->z + p2->z + p3->z) / 3.f;
+		}
+};
+
+
+/*===========================================================================
+ * Name:	PolyLine
+ * Purpose:	Encapsulates a polyline as a linked list.
+ */
+class PolyLine 
+{
+public:
+	Point *point;
+	PolyLine *next;
+	float color[4];
+
+	PolyLine() 
+	{
+		point = NULL;
+		next = NULL;
+	}
+
+	PolyLine (Point *p_) 
+	{
+		point = p_;
+		next = NULL;
+	}
+
+	~PolyLine() 
+	{
+		// point is allocated by someone else.
+		delete next;
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses the polyline recursively as OpenGL calls.
+	 */
+	void express (bool use_color) 
+	{
+		if (use_color)
+			return;
+		if (point)
+			Point_express (point);
+		if (next)
+			next->express (use_color);
+	}
+};
+
+
+/*===========================================================================
+ * Name:	Node
+ * Purpose:	Encapsulates a parsed version of information about 
+ *		the objects found in the VRML file.
+ */
+class Node {
+public:
+	const char *type;
+	Node *next;
+	Node *children;
+	Node *last_child;
+	Node *parent;
+	char *name;
+
+	bool dont_save_this_node;
+
+	Node () {
+		type = "Node";
+		name = NULL;
+		next = NULL;
+		children = NULL;
+		last_child = NULL;
+		parent = NULL;
+		dont_save_this_node = false;
+
+		total_allocated += sizeof(Node);
+	}
+
+	virtual ~Node() {
+		total_allocated -= sizeof(Node);
+
+		if (children)
+			delete children;
+		children = NULL;
+		last_child = NULL;
+		if (next)
+			delete next;
+		next = NULL;
+		// name is not a copy.
+		// type is a const.
+	}
+
+	/*===================================================================
+	 * Name:	find_by_name
+	 * Purpose:	Finds a node by its name.
+	 * Returns:	Node pointer or NULL if not found.
+	 */
+	Node *find_by_name (char *s) {
+		if (name && !strcmp (s, name))
+			return this;
+		Node *result = NULL;
+		if (next) 
+			result = next->find_by_name (s);
+		if (!result && children) 
+			result = children->find_by_name (s);
+		return result;
+	}
+
+	/*===================================================================
+	 * Name:	find_by_type
+	 * Purpose:	Finds the first node of the specified type.
+	 * Returns:	Node pointer or NULL if not found.
+	 */
+	Node *find_by_type (char *s) {
+		if (type && !strcmp (s, type))
+			return this;
+		Node *result = NULL;
+		if (next) 
+			result = next->find_by_type (s);
+		if (!result && children) 
+			result = children->find_by_type (s);
+		return result;
+	}
+
+	/*===================================================================
+	 * Name:	add_child
+	 * Purpose:	Appends a child to the Node's children linked list.
+	 * Returns:	The total # of children.
+	 */
+	int add_child (Node *n) 
+	{
+		ASSERT_NONZERO(n,"node")
+		//----------
+
+		if (!children)
+			children = n;
+		else
+			last_child->next = n;
+		last_child = n;
+
+		int count = 0;
+		Node *node = children;
+		while (node) {
+			count++;
+			node = node->next;
+		}
+		return count;
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses the object in terms of OpenGL calls.
+	 */
+	virtual void express(bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+		if (children)
+			children->express (true, pContext);
+		if (express_siblings && next)
+			next->express (true, pContext);
+	}
+
+	void serialize (OutputFile *f);
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump for testing.
+	 */
+	virtual void dump (FILE *f) 
+	{
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s\n", type, name? name : "");
+	}
+
+	/*===================================================================
+	 * Name:	smooth
+	 * Purpose:	Smooths nodes.
+	 */
+	virtual void smooth ();
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	virtual void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
+		double xmin2, xmax2, ymin2, ymax2, zmin2, zmax2;
+
+		my_xmin = my_ymin = my_zmin = xmin2 = ymin2 = zmin2 = 1E6f;
+		my_xmax = my_ymax = my_zmax = xmax2 = ymax2 = zmax2 = -1E6f;
+
+		if (children) {
+			children->report_bounds (level+1, true,
+						my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+		}
+
+		if (report_siblings && next) {
+			next->report_bounds (level, true, 
+						xmin2, xmax2, ymin2, ymax2, zmin2, zmax2);
+			if (xmin2 < my_xmin)
+				my_xmin = xmin2;
+			if (ymin2 < my_ymin)
+				my_ymin = ymin2;
+			if (zmin2 < my_zmin)
+				my_zmin = zmin2;
+			if (xmax2 > my_xmax)
+				my_xmax = xmax2;
+			if (ymax2 > my_ymax)
+				my_ymax = ymax2;
+			if (zmax2 > my_zmax)
+				my_zmax = zmax2;
+		}
+
+		minx = my_xmin;
+		maxx = my_xmax;
+		miny = my_ymin;
+		maxy = my_ymax;
+		minz = my_zmin;
+		maxz = my_zmax;
+		REPORT2
+	}
+};
+
+
+/*===========================================================================
+ * Name:	NameMap
+ * Purpose:	Struct for implementing a simple linked list of 
+ *			name-value associations.
+ * Note:	Do not replace with a templated class!
+ */
+struct NameMap {
+	char *name;
+	unsigned int hash;
+	Node *node;
+	NameMap *next;
+};
+
+
+/*===========================================================================
+ * Name:	InputWord
+ * Purpose:	Encapsulates a string that was read from a VRML file.
+ * Note:	InputWords are allocated only in an Arena, which frees
+ *		the whole tree at once; they are never deleted.
+ */
+class InputWord {
+public:
+	char *str;	// Interned, or "#" for a number.
+	int atom;	// ATOM_NONE for a number.
+	float value;
+	InputWord *next;
+	InputWord *children;
+
+	// For the [ of a point or coordIndex list, the numbers are
+	// stored here by the streaming reader, instead of as children.
+	// The arrays are owned by the tree's Arena.
+	float *floats;
+	int n_floats;
+	int *ints;
+	int n_ints;
+
+	InputWord (AtomTable *, const char*, int len);
+	InputWord (float num) {
+		str = "#";
+		atom = ATOM_NONE;
+		value = num;
+		next = children = NULL;
+		floats = NULL;
+		ints = NULL;
+		n_floats = n_ints = 0;
+	}
+
+	void *operator new (size_t size, Arena *arena) {
+		return arena->alloc (size);
+	}
+	void operator delete (void *, Arena *) {
+	}
+};
+
+class InflateRing;
+class ZstdReader;
+class GzIndex;
+class GzIndexReader;
+class GzIndexBuilder;
+
+/*===========================================================================
+ * Name:	InputFile
+ * Purpose:	Encapsulates information about an input file.
+ */
+class InputFile {
+public:
+	bool valid;
+	char *path;
+	char *name;
+	char *extension;
+	short ungot_char;
+	gzFile gzfile;	// Used whether compressed or not.
+	InputWord *tree;
+	unsigned char buffer[INPUTFILE_BUFFERSIZE];
+	int buffer_ix;
+	int buffer_limit;
+	char *first_line;
+	bool is_dst_file;
+
+	// If the file is not compressed, it is memory-mapped
+	// for use by the Tokenizer instead of being read via zlib.
+	unsigned char *mapped;
+	unsigned long mapped_size;
+	void *map_file_handle;	// Win32 only.
+	void *map_handle;	// Win32 only.
+
+	// A DST file may be zstd-compressed instead of gzipped,
+	// in which case it is read via zstd rather than gzfile.
+	ZstdReader *zstd;
+
+	// A file in a ZIP archive is instead inflated into memory,
+	// in place of the mapping, and path is only nominal.
+	char *archive;		// The ZIP file, else NULL.
+	char *member;		// The file's name within it.
+
+	// Size of the file's (decompressed) data, if known, else 0.
+	unsigned long data_size;
+
+	// Otherwise a separate thread inflates the file ahead
+	// of the reader into a ring of buffers.
+	InflateRing *ring;
+
+	// Random access to a compressed file is via its
+	// index, which records where inflating can resume.
+	GzIndex *index;
+	GzIndexReader *index_reader;
+
+	// A gzipped file with no index yet is inflated via
+	// this, which builds and saves the index as it goes.
+	GzIndexBuilder *builder;
+
+	// Words read from the file; passed on to its Model.
+	Arena *words;		// Holds the InputWord tree.
+	AtomTable *atoms;	// Holds the words' strings.
+
+	InputFile(char*);
+
+	~InputFile() {
+		stop_inflating ();
+		stop_building ();
+		close_zstd ();
+		unmap ();
+		drop_index ();
+		delete words;
+		delete atoms;
+
+		set_archive (NULL, NULL);
+
+		total_allocated -= path? strlen(path) + 1 : 0;
+		total_allocated -= first_line? strlen(first_line) + 1 : 0;
+
+		if (path)
+			free(path);
+		if (first_line)
+			free(first_line);
+	}
+
+	/*===================================================================
+	 * Name:	unget
+	 * Purpose:	Reverses the last read. Limit 1 character.
+	 */
+	void unget (char ch) {
+		if (ch != EOF) {
+			if (ungot_char != EOF)
+				warning ("InputFile::unget called twice.");
+			else
+				ungot_char = ch;
+		}
+	}
+
+	/*===================================================================
+	 * Name:	getchar
+	 * Purpose:	Fetches one character from the buffered file.
+	 */
+	int getchar() {
+		int ch = EOF;
+		if (ungot_char != EOF) {
+			short tmp = ungot_char;
+			ungot_char = EOF;
+			return tmp;
+		}
+		if (buffer_limit >=0 && buffer_ix >= 0)	{
+			if (buffer_ix >= buffer_limit) {
+				if (!replenish_buffer())
+					return EOF;
+			}
+			ch = buffer[buffer_ix++];
+		}
+		return ch;
+	}
+
+	/*===================================================================
+	 * Name:	open
+	 * Purpose:	Opens the file, assuming the path is already set.
+	 */
+	bool open() {
+		if (!path)
+			return false;
+		if (!open_zstd ())
+			gzfile = gzopen (path, "rb");
+		if (gzfile || zstd) {
+			start_inflating ();
+			replenish_buffer();
+		}
+		return gzfile != NULL || zstd != NULL;
+	}
+
+	/*===================================================================
+	 * Name:	close
+	 * Purpose:	Closes the file, if open.
+	 */
+	void close() {
+		stop_inflating ();
+		stop_building ();
+		end_seek ();
+		if (gzfile)
+			gzclose(gzfile);
+		gzfile = NULL;
+		close_zstd ();
+		buffer_ix = buffer_limit = -1;
+		unmap ();
+	}
+
+	bool open_mapped ();
+	bool open_archived ();
+	void set_archive (const char *zip_path, const char *member_name);
+	bool open_zstd ();
+	void close_zstd ();
+	void unmap ();
+	int read_block (unsigned char *dest, int size);
+	void capture_first_line (const unsigned char *data, int size);
+	void start_inflating ();
+	void stop_inflating ();
+	void start_building ();
+	void stop_building ();
+	bool seek (unsigned long offset);
+	void end_seek ();
+	void drop_index ();
+
+private:
+	/*===================================================================
+	 * Name:	replenish_buffer
+	 * Purpose:	Loads more data from the file into the buffer.
+	 */
+	bool replenish_buffer () 
+	{
+		buffer_ix = 0;
+		buffer_limit = read_block (buffer, INPUTFILE_BUFFERSIZE);
+		return buffer_limit > 0;
+	}
+
+};
+
+extern unsigned long gzip_data_size (const char *path);
+extern const unsigned char *map_whole_file (const char *path, unsigned long *size_return);
+extern void unmap_whole_file (const unsigned char *data, unsigned long size);
+
+/*===========================================================================
+ * Name:	Transform
+ * Purpose:	Represents a VRML Transform node.
+ */
+class Transform : public Node {
+public:
+	double translate_x;
+	double translate_y;
+	double translate_z;
+	double second_translate_x;
+	double second_translate_y;
+	double second_translate_z;
+	double scale_x;
+	double scale_y;
+	double scale_z;
+	double rotate_x;
+	double rotate_y;
+	double rotate_z;
+	double rotate_angle; // in radians
+	double second_rotate_x;
+	double second_rotate_y;
+	double second_rotate_z;
+	double second_rotate_angle; // in radians
+	double center_x;
+	double center_y;
+	double center_z;
+
+	// The following are used to keep track of the order of operations.
+	// RULE: In VRML's Transform construct, the order matters.
+	//
+#define TRANSFORM_MAX_OPS 4
+	enum { TRANSLATE=1, SCALE=2, ROTATE=3, ROTATE2=4, TRANSLATE2=5 };
+	char operations [TRANSFORM_MAX_OPS];
+	unsigned short op_index;
+
+	Transform() {
+		type = "Transform";
+		translate_x = 0.0f;
+		translate_y = 0.0f;
+		translate_z = 0.0f;
+		second_translate_x = 0.0f;
+		second_translate_y = 0.0f;
+		second_translate_z = 0.0f;
+		scale_x = 1.0f;
+		scale_y = 1.0f;
+		scale_z = 1.0f;
+		rotate_x = 0.0f;
+		rotate_y = 0.0f;
+		rotate_z = 0.0f;
+		second_rotate_x = 0.0f;
+		second_rotate_y = 0.0f;
+		second_rotate_z = 0.0f;
+		center_x = center_y = center_z = 0.f;
+		rotate_angle = 0.0f;
+		children = NULL;
+		next = NULL;
+		op_index = 0; // No VRML operations yet recorded.
+
+		total_allocated += sizeof(Transform);
+	}
+
+	~Transform () {
+		total_allocated -= sizeof(Transform);
+	}
+
+	void serialize (OutputFile *);
+
+	/*===================================================================
+	 * Name:	get_matrix
+	 * Purpose:	Gives the transform as 3 rows of 4, in the order
+	 *		that express gives its operations to OpenGL.
+	 */
+	void get_matrix (double *matrix);
+
+	virtual void express(bool express_siblings, CRenderContext* pContext) 
+	{
+		int i;
+
+		ENTRY
+		pContext->PushMatrix ();
+
+		// Express translate/rotate/scale.
+		// Note that OpenGL processes any translate/rotate/scale in reverse order,
+		// whereas VRML expresses them in forward order.
+		//
+		i = op_index - 1;
+		while (i >= 0) {
+			switch (operations[i]) 
+			{
+			case ROTATE:
+				if (rotate_angle != 0.0f) 
+					pContext->Rotatef ((rotate_angle/(float)M_PI)*180.f, rotate_x, rotate_y, rotate_z);
+				break;
+
+			case ROTATE2:
+				if (second_rotate_angle != 0.0f) 
+					pContext->Rotatef ((second_rotate_angle/(float)M_PI)*180.f, 
+						second_rotate_x, second_rotate_y, second_rotate_z);
+				break;
+
+			case SCALE:
+				pContext->Scalef (scale_x, scale_y, scale_z);
+				break;
+	
+			case TRANSLATE:
+				pContext->Translatef (translate_x, translate_y, translate_z);
+				break;
+
+			case TRANSLATE2:
+				pContext->Translatef (second_translate_x, second_translate_y, second_translate_z);
+				break;
+			}
+			i--;
+		}
+
+#if 0
+		if (center_x != 0.f || center_y != 0.f || center_z != 0.f)
+			glTranslatef (-center_x, -center_y, -center_z);
+#endif
+		if (children)
+			children->express(express_siblings, pContext);
+
+		pContext->PopMatrix ();
+
+		if (express_siblings && next)
+			next->express(true, pContext);
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s: translate %g %g %g rotate %g %g %g (%g deg) scale %g %g %g\n", 
+			type, name? name : "",
+			translate_x, translate_y, translate_z,
+			rotate_x, rotate_y, rotate_z, rotate_angle,
+			scale_x, scale_y, scale_z);
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+
+		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
+		my_xmin = my_ymin = my_zmin = 1E6f;
+		my_xmax = my_ymax = my_zmax = -1E6f;
+
+		if (children) {
+			children->report_bounds (level+1, true,
+			 my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+		}
+
+		// Perform translate/rotate/scale on bounding box.
+		// Note that OpenGL processes any translate/rotate/scale in reverse order,
+		// whereas VRML expresses them in forward order.
+		//
+		if (my_xmin < 1E6f && my_ymin < 1E6f && my_zmin < 1E6f) {
+			int i = 0;
+			while (i < op_index) {
+				switch (operations[i]) {
+				case ROTATE:	
+					if (rotate_angle != 0.f) {
+						double tmp = rotate_angle - (float) M_PI;
+						if (tmp < 0)
+							tmp = -tmp;
+	
+						// At present we deal only with the case of 180 degree rotation.
+#if 0
+						if (rotate_z == 1.f && (tmp < 0.0001)) {
+							double tmp = -my_ymin;
+							double tmp2 = -my_ymax;
+							my_ymin = tmp2;
+							my_ymax = tmp;
+						}
+						else 
+#endif
+							if (rotate_x == 1.f && rotate_z == 0.f && rotate_y == 0.f) {
+							rotate_bounds_about_one_axis (rotate_angle, 'x',
+								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+						}
+						else if (rotate_y == 1.f && rotate_x == 0.f && rotate_z == 0.f) {
+							rotate_bounds_about_one_axis (rotate_angle, 'y',
+								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+						}
+						else if (rotate_z == 1.f && rotate_x == 0.f && rotate_y == 0.f) {
+							rotate_bounds_about_one_axis (rotate_angle, 'z',
+								my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+						}
+						else {
+							// Rotate about an arbitrary axis not yet supported. XX
+							printf ("Encountered arbitrary rotation... ignoring.\n");
+						}
+					}
+					break;
+
+				case SCALE:
+					my_xmin *= scale_x;
+					my_xmax *= scale_x;
+					my_ymin *= scale_y;
+					my_ymax *= scale_y;
+					my_zmin *= scale_z;
+					my_zmax *= scale_z;	
+					break;
+	
+				case TRANSLATE:
+					my_xmin += translate_x;
+					my_xmax += translate_x;
+					my_ymin += translate_y;
+					my_ymax += translate_y;
+					my_zmin += translate_z;
+					my_zmax += translate_z;
+					break;
+				}
+				i++;
+			}
+		}
+
+		if (next && report_siblings) {
+			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
+			minx2 = miny2 = minz2 = 1E6f;
+			maxx2 = maxy2 = maxz2 = -1E6f;
+
+			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
+			if (minx2 < my_xmin)
+				my_xmin = minx2;
+			if (miny2 < my_ymin)
+				my_ymin = miny2;
+			if (minz2 < my_zmin)
+				my_zmin = minz2;
+
+			if (maxx2 > my_xmax)
+				my_xmax = maxx2;
+			if (maxy2 > my_ymax)
+				my_ymax = maxy2;
+			if (maxz2 > my_zmax)
+				my_zmax = maxz2;
+		}
+
+		minx = my_xmin;
+		miny = my_ymin;
+		minz = my_zmin;
+
+		maxx = my_xmax;
+		maxy = my_ymax;
+		maxz = my_zmax;
+
+		REPORT2
+	}
+};
+
+
+/*===========================================================================
+ * Name:	Deferred
+ * Purpose:	Stands in for a Switch choice that has not been built
+ *		yet. It keeps the choice's words, which the Model holds
+ *		on to until no choice is left unbuilt, and it is replaced
+ *		by the real node on first use (see model_parse_deferred).
+ */
+class Deferred : public Node {
+public:
+	Model *model;
+	const InputWord *word;	// The node's keyword, e.g. Transform.
+	char *def_name;		// From DEF, or NULL.
+	bool building;
+	Deferred *next_pending;
+
+	Deferred () {
+		type = "Deferred";
+		model = NULL;
+		word = NULL;
+		def_name = NULL;
+		building = false;
+		next_pending = NULL;
+
+		total_allocated += sizeof(Deferred);
+	}
+
+	~Deferred () {
+		total_allocated -= sizeof(Deferred);
+	}
+};
+
+extern Node *model_parse_deferred (Deferred *);
+
+
+/*===========================================================================
+ * Name:	Switch
+ * Purpose:	Represents a VRML Switch node.
+ */
+class Switch : public Node {
+public:
+	int which;
+#ifdef ORTHOCAST
+	bool doing_open_view;
+#endif
+	int total_choices;
+	Node *which_node;
+	int file_which;		// whichChoice as read, which the mesh cache keeps.
+
+	Switch() 
+	{
+		type = "Switch";
+
+		// No node yet chosen.
+		which = -1;
+		which_node = NULL;
+		file_which = -1;
+
+		total_choices = 0;
+		children = NULL;
+		next = NULL;
+
+		total_allocated += sizeof(Switch);
+	}
+
+	~Switch () {
+		total_allocated -= sizeof(Switch);
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses Switch contents unto OpenGL.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) 
+	{
+		ENTRY
+
+		// Update just in case it was cleared.
+		if (!which_node)
+			update_which_node();
+
+		// If we have a which_node, use it and
+		// tell the node not to express siblings.
+		// 
+		if (which_node) {
+			which_node->express (false, pContext);
+			printf ("expressing which node (%s) in Switch\n", which_node->type);
+		}
+
+		// If not, we never express the next node in a Switch.
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+
+		double my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax;
+		my_xmin = my_ymin = my_zmin = 1E6f;
+		my_xmax = my_ymax = my_zmax = -1E6f;
+
+		if (!which_node)
+			update_which_node();
+
+		if (which_node)
+			which_node->report_bounds (level+1, false,
+					my_xmin, my_xmax, my_ymin, my_ymax, my_zmin, my_zmax);
+
+		if (next && report_siblings) {
+			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
+			minx2 = miny2 = minz2 = 1E6f;
+			maxx2 = maxy2 = maxz2 = -1E6f;
+
+			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
+			
+			if (minx2 < my_xmin)
+				my_xmin = minx2;
+			if (miny2 < my_ymin)
+				my_ymin = miny2;
+			if (minz2 < my_zmin)
+				my_zmin = minz2;
+
+			if (maxx2 > my_xmax)
+				my_xmax = maxx2;
+			if (maxy2 > my_ymax)
+				my_ymax = maxy2;
+			if (maxz2 > my_zmax)
+				my_zmax = maxz2;
+		}
+
+		minx = my_xmin;
+		miny = my_ymin;
+		minz = my_zmin;
+
+		maxx = my_xmax;
+		maxy = my_ymax;
+		maxz = my_zmax;
+
+		REPORT2
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) 
+	{
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s (which = %d)\n",
+			type, name? name : "",
+			which);
+	}
+
+	/*===================================================================
+	 * Name:	update_which_node
+	 * Purpose:	Diagnostic dump.
+	 */
+	Node *update_which_node() {
+		//----------------------------------------
+		// Find the nth node, as specified w/ VRML
+		// 'whichChoice' value.
+		//
+		Node *n = children;
+		int i = which;
+		while (i > 0 && n) {
+			i--;
+			n = n->next;
+		}
+		if (n && !strcmp (n->type, "Deferred"))
+			n = model_parse_deferred ((Deferred*) n);
+		which_node = n;
+// printf (" which node %08lx\n", (long)n);
+		return n;
+	}
+};
+
+class Group;
+class IndexedFaceSet;
+
+/*===========================================================================
+ * Name:	MeshBuild
+ * Purpose:	An IndexedFaceSet whose points and triangles are still
+ *		to be made from the lists streamed by the reader. Those
+ *		met by vrml_parser are built at its end, in parallel.
+ */
+struct MeshBuild {
+	IndexedFaceSet *ifs;
+	const float *coords;	// Owned by the InputWords.
+	int n_coords;
+	const int *indices;	// Likewise.
+	int n_indices;
+	float *normals;		// Owned by the MeshBuild.
+	int n_normals;
+	int *normal_index;
+	int n_normal_index;
+	bool normals_ignored;
+};
+
+/*===========================================================================
+ * Name:	Model
+ * Purpose:	Encapsulates a 3D model, specifically a VRML model.
+ */
+class Model {
+public:
+	char *title; // not strdup'd
+
+	bool smoothed;
+
+	bool background_provided; 
+	GLfloat bg[3]; // read from VRML file.
+
+	// The file's Viewpoint, which load_file copies to cc_main,
+	// and which of its fields the file set.
+#define VIEWPOINT_POSITION (1)
+#define VIEWPOINT_ORIENTATION (2)
+#define VIEWPOINT_FIELD_OF_VIEW (4)
+	int viewpoint_fields;
+	double viewpoint_x, viewpoint_y, viewpoint_z;
+	double orientation_x, orientation_y, orientation_z;
+	double field_of_view;
+
+	double minx, maxx, miny, maxy, minz, maxz;
+
+	InputFile *inputfile;	// file
+	InputWord *word_tree;	// data from file, if kept (see keeping_word_tree)
+	Arena *words;		// Holds word_tree.
+	Node *nodes;	// data parsed from data from file
+
+#ifdef ORTHOCAST
+	// Some dentistry-specific data.
+	Node *main_switch;
+	char *patient_firstname;
+	char *patient_lastname;
+	char *patient_birthdate;
+	Group *top_and_bottom_node;	
+	char *case_date;
+	char *case_number;
+	char *control_number;
+
+	bool isTopAndBottomAligned;		
+
+	bool show_occlusal2;
+	Node* occlusal2_node;
+
+#endif
+
+	// Overall translation to center the model at (0,0,0).
+	double translate_x;
+	double translate_y;
+	double translate_z;
+
+	// Map of names to Nodes for VRML "USE".
+	// The list is also indexed by an open-addressed hash table.
+	NameMap *names;
+	NameMap *last_name;
+	NameMap **name_table;
+	int name_table_size;	// Always a power of 2.
+	int n_names;
+
+	// Owns the strings of word_tree, which node names point to.
+	AtomTable *atoms;
+
+	// Switch choices not yet built, and the one being built.
+	Deferred *pending;
+	Deferred *building;
+	bool parsing;		// vrml_parser is running.
+	bool caching;		// Save the mesh cache once all is built.
+
+	// The thread that saves the mesh cache, if need be, and
+	// then makes the meshes' levels of detail.
+	void *lod_thread;
+	IndexedFaceSet **lod_sets;
+	int n_lod_sets;
+	volatile bool lod_cancel;
+	bool lods_started;
+
+	// Meshes that vrml_parser is to build once it has read all.
+	MeshBuild *mesh_builds;
+	int n_mesh_builds;
+	int mesh_builds_size;
+
+	Model () :
+		inputfile(NULL),
+		background_provided(false),
+		viewpoint_fields(0),
+		viewpoint_x(0.), viewpoint_y(0.), viewpoint_z(0.),
+		orientation_x(0.), orientation_y(0.), orientation_z(0.),
+		field_of_view(0.),
+		title(NULL),
+		names(NULL), last_name(NULL),
+		name_table(NULL), name_table_size(0), n_names(0),
+		words(NULL), atoms(NULL),
+		pending(NULL), building(NULL),
+		parsing(false), caching(false),
+		lod_thread(NULL), lod_sets(NULL), n_lod_sets(0),
+		lod_cancel(false), lods_started(false),
+		mesh_builds(NULL), n_mesh_builds(0), mesh_builds_size(0),
+		word_tree(NULL),
+		nodes(NULL),
+#ifdef ORTHOCAST
+		main_switch(NULL),
+		patient_firstname(NULL),
+		patient_lastname(NULL),
+		patient_birthdate(NULL),
+		top_and_bottom_node(NULL),	
+		case_date(NULL),
+		case_number(NULL),
+		control_number(NULL),
+		isTopAndBottomAligned(false),
+		show_occlusal2(false),
+		occlusal2_node(NULL),
+#endif
+		smoothed(false),
+		translate_x(0.f),
+		translate_y(0.f),
+		translate_z(0.f),
+		maxx(-1E6f), maxy(-1E6f), maxz(-1E6f), 
+		minx(1E6f), miny(1E6f), minz(1E6f)
+	{
+		bg[0] = bg[1] = bg[2] = 0.f;
+
+		total_allocated += sizeof(Model);		
+	}
+
+	
+
+	/*===================================================================
+	 * Name:	register_switch
+	 * Purpose:	Tells the Model that a switch node exists.
+	 */
+	void register_switch (Switch *sw)
+	{
+		ASSERT_NONZERO(sw,"switch");
+
+		if (!main_switch)
+		{
+			double minx,maxx,miny,maxy,minz,maxz;
+
+			main_switch = sw;
+					
+			//find related model nodes in main switch node.
+			//hard coded expected order!! 
+			int i = sw->which;			
+			sw->which = 0;
+			Node* topAndbottom = sw->update_which_node();
+
+			sw->which = 1;
+			Node* bottom = sw->update_which_node();
+
+			sw->which = 2;
+			Node* top = sw->update_which_node();
+
+			sw->which = i;
+			sw->update_which_node();
+
+			
+			if(bottom && top)
+			{
+				
+				//lower jaw
+				Transform* tx = new Transform();
+
+				tx->op_index = 1;
+				tx->operations[0] = Transform::ROTATE;
+				tx->rotate_y = 1;
+				tx->rotate_angle = 180.0f * (M_PI/180.0f);	
+
+				tx->op_index = 2;
+				tx->operations[1] = Transform::ROTATE2;
+				tx->second_rotate_x = 1;
+				tx->second_rotate_angle = 90.0f * (M_PI/180.0f);
+
+				bottom->report_bounds(1, false, minx, maxx, miny,maxy, minz,maxz);
+
+				tx->op_index = 3;
+				tx->operations[2] = Transform::TRANSLATE;
+				tx->translate_x = -(maxx - minx) * 0.51;	
+
+				tx->add_child(bottom);
+
+				//top jaw
+				Transform* tx2 = new Transform();
+
+				tx2->op_index = 1;
+				tx2->operations[0] = Transform::ROTATE;
+				tx2->rotate_x = 1;
+				tx2->rotate_angle = -90.0f * (M_PI/180.0f);	
+
+				
+				top->report_bounds(1, false, minx, maxx, miny,maxy, minz,maxz);
+
+				tx2->op_index = 2;
+				tx2->operations[1] = Transform::TRANSLATE;
+				tx2->translate_x = (maxx - minx) * 0.51;			
+
+				tx2->add_child(top);			
+
+				occlusal2_node = new Node();
+				occlusal2_node->add_child(tx);
+				occlusal2_node->add_child(tx2);
+
+			}
+		}
+
+	}
+
+	/*===================================================================
+	 * Name:	translate_all
+	 * Purpose:	Permits a one-time recentering of a parsed model.
+	 */
+	bool translate_all (double x, double y, double z) {
+		translate_x = x;
+		translate_y = y;
+		translate_z = z;
+		return true;
+	}
+
+	/*===================================================================
+	 * Name:	add_name_mapping
+	 * Purpose:	Maps a name to a node, for use with "USE" construct.
+	 */
+	void add_name_mapping (char *name, Node *n) 
+	{
+		ASSERT_NONZERO(name,"name")
+		ASSERT_NONZERO(n,"node")
+		//----------
+
+		if (!name || !n)
+			fatal("Null param in add_name_mapping.");
+
+		//----------------------------------------
+		// A choice being built takes over the
+		// names that were reserved for it, so that
+		// they keep their place in the list.
+		//
+		if (building) {
+			NameMap *r = names;
+			while (r && (r->node != building || strcmp (r->name, name)))
+				r = r->next;
+			if (r) {
+				r->node = n;
+				return;
+			}
+		}
+
+		NameMap *m = new NameMap();
+		total_allocated += sizeof(NameMap);
+
+		m->name = name;
+		m->hash = atom_hash (name, strlen (name));
+		m->node = n;
+		if (!names)
+			names = m;
+		else
+			last_name->next = m;
+		last_name = m;
+
+		//----------------------------------------
+		// As with the list, the first definition
+		// of a name is the one that is found.
+		//
+		if (2 * (n_names + 1) > name_table_size)
+			grow_name_table ();
+		NameMap **slot = find_name_slot (name, m->hash);
+		if (!*slot) {
+			*slot = m;
+			n_names++;
+		}
+	}
+
+	/*===================================================================
+	 * Name:	find_name_slot
+	 * Purpose:	Locates a name in the hash table.
+	 * Returns:	Its slot, or the empty slot where it would go.
+	 */
+	NameMap** find_name_slot (char *name, unsigned int hash)
+	{
+		unsigned int mask = name_table_size - 1;
+		unsigned int i = hash & mask;
+		NameMap *m;
+		while ((m = name_table[i])) {
+			// Names from the reader are interned, so
+			// are usually the very same string.
+			if (m->hash == hash && 
+			    (m->name == name || !strcmp (name, m->name)))
+				break;
+			i = (i + 1) & mask;
+		}
+		return name_table + i;
+	}
+
+	/*===================================================================
+	 * Name:	grow_name_table
+	 * Purpose:	Doubles the name hash table and reinserts the names.
+	 */
+	void grow_name_table ()
+	{
+		NameMap **old_table = name_table;
+		int old_size = name_table_size;
+		int i;
+
+		name_table_size = old_size ? old_size * 2 : 64;
+		name_table = (NameMap**) calloc (name_table_size, sizeof(NameMap*));
+		if (!name_table)
+			fatal ("Out of memory!");
+		total_allocated += (name_table_size - old_size) * sizeof(NameMap*);
+
+		for (i = 0; i < old_size; i++) {
+			NameMap *m = old_table[i];
+			if (m)
+				find_name_slot (m->name, m->hash)[0] = m;
+		}
+		if (old_table)
+			free (old_table);
+	}
+
+	/*===================================================================
+	 * Name:	drop_reserved_names
+	 * Purpose:	Forgets the names reserved for a Deferred node that
+	 *		its choice, once built, did not define after all.
+	 */
+	void drop_reserved_names (Node *placeholder)
+	{
+		NameMap **link = &names;
+		bool dropped = false;
+
+		last_name = NULL;
+		while (*link) {
+			NameMap *m = *link;
+			if (m->node == placeholder) {
+				*link = m->next;
+				delete m;
+				total_allocated -= sizeof(NameMap);
+				dropped = true;
+			} else {
+				last_name = m;
+				link = &m->next;
+			}
+		}
+		if (!dropped || !name_table)
+			return;
+
+		memset (name_table, 0, name_table_size * sizeof(NameMap*));
+		n_names = 0;
+		for (NameMap *m = names; m; m = m->next) {
+			NameMap **slot = find_name_slot (m->name, m->hash);
+			if (!*slot) {
+				*slot = m;
+				n_names++;
+			}
+		}
+	}
+
+	/*===================================================================
+	 * Name:	lookup_node_by_name
+	 * Purpose:	Finds a node by its name, building the Switch choice
+	 *		that defines it if need be.
+	 */
+	Node* lookup_node_by_name (char *name) 
+	{
+		ASSERT_NONZERO(name,"name")
+		//----------
+
+		if (!name_table)
+			return NULL;
+
+		NameMap *m = find_name_slot (name, atom_hash (name, strlen (name)))[0];
+		if (m && !strcmp (m->node->type, "Deferred")) {
+			Deferred *d = (Deferred*) m->node;
+			if (d->building)
+				return NULL;
+			model_parse_deferred (d);
+			return lookup_node_by_name (name);
+		}
+		return m ? m->node : NULL;
+	}
+
+	/*===================================================================
+	 * Name:	build_all
+	 * Purpose:	Builds every Switch choice that is still deferred.
+	 */
+	void build_all ()
+	{
+		while (pending)
+			model_parse_deferred (pending);
+	}
+
+	/*===================================================================
+	 * Name:	smooth
+	 * Purpose:	Performs smoothing.
+	 */
+	void smooth ();
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses model's objects in terms of OpenGL calls.
+	 */
+	void express (CRenderContext* pContext);
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Determines the bounding box for the model, given the
+	 *		current switch choices.
+	 */
+	void report_bounds ();
+
+	/*===================================================================
+	 * Name:	which_switch_has_triangle
+	 * Purpose:	Tells the caller which Switch contains the specified
+	 *		Triangle object.
+	 */
+	int which_switch_has_triangle (Triangle *t);
+
+#if 0
+	/*===================================================================
+	 * Name:	ensure_tiny_triangles
+	 * Purpose:	Breaks IndexedFaceSets' triangles into small ones.
+	 */
+	bool ensure_tiny_triangles (double maximum);
+	bool ensure_tiny_triangles_core (double maximum, Node *);
+#endif
+
+	/*===================================================================
+	 * Name:	start_lods, stop_lods
+	 * Purpose:	Starts making the levels of detail of all of the
+	 *		meshes on a thread of their own, once; stops it.
+	 */
+	void start_lods ();
+	void stop_lods ();
+
+	/*===================================================================
+	 * Name:	lod_error
+	 * Purpose:	Tells how far the meshes at a level of detail are
+	 *		from the full ones, at most, as sampled.
+	 * Returns:	The sampled Hausdorff distance, or -1 if the level
+	 *		is not ready for every mesh.
+	 */
+	double lod_error (int level);
+
+	/*===================================================================
+	 * Name:	face_set_matrix
+	 * Purpose:	Gives the product of the Transforms above a face
+	 *		set, 3 rows of 4, which moves it to model space.
+	 * Returns:	False if the face set is not in this Model.
+	 */
+	bool face_set_matrix (IndexedFaceSet *, double *matrix);
+	bool face_set_matrix_core (Node *, IndexedFaceSet *, double *matrix);
+
+	/*===================================================================
+	 * Name:	~Model
+	 * Purpose:	Carefully cleans up when Model to avoid memory leaks.
+	 */
+	~Model() {
+		stop_lods ();
+		free (lod_sets);
+		delete words;	// i.e. word_tree, all at once.
+		delete nodes;
+
+		total_allocated -=  sizeof(Model);
+
+		NameMap *m = names;
+		while (m) {
+			NameMap *m2 = m->next;
+			delete m;
+			m = m2;
+
+			total_allocated -= sizeof(NameMap);
+		}
+		if (name_table) {
+			free (name_table);
+			total_allocated -= name_table_size * sizeof(NameMap*);
+		}
+		delete atoms;
+	}
+
+	/*===================================================================
+	 * Name:	serialize
+	 * Purpose:	Express the entire model as ASCII.
+	 */
+	void serialize (OutputFile *f) 
+	{
+		if (!f) 
+			return;
+		
+		build_all ();
+
+		// The vertex normals are saved with the meshes.
+		if (saving_normals && !smoothed)
+			smooth ();
+
+		//----------------------------------------
+		// Write out the beginning VRML.
+		//
+		serialization_indentation_level = 0;
+
+		nodes->serialize (f);
+
+		//----------------------------------------
+		// Write out the lower.
+		//
+
+		//----------------------------------------
+		// Write out the upper.
+		//
+
+		//----------------------------------------
+		// Write out the upper-lower alignment.
+		//
+
+		//----------------------------------------
+		// Write out the ending VRML.
+		//
+
+		f->printf ("\n\n\n");
+	}
+
+
+	void autocenter ();
+};
+
+
+/*===========================================================================
+ * Name:	Group
+ * Purpose:	Represents a VRML Group node.
+ */
+class Group : public Node {
+public:
+	Group() {
+		type = "Group";
+		children = NULL;
+		next = NULL;
+
+		total_allocated += sizeof(Group);
+	}
+
+	~Group () {
+		total_allocated -= sizeof(Group);
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s\n",
+			type, name? name : "");
+	}
+};
+
+
+/*===========================================================================
+ * Name:	Separator
+ * Purpose:	Represents a VRML Separator node.
+ */
+class Separator : public Node {
+public:
+	Separator() {
+		type = "Separator";
+		children = NULL;
+		next = NULL;
+
+		total_allocated += sizeof(Separator);
+	}
+
+	~Separator () {
+		total_allocated -= sizeof(Separator);
+	}
+
+	void express (bool express_siblings, CRenderContext* pContext) {
+		// Need to express various Separator characteristics.
+		ENTRY
+		if (children)
+			children->express (true, pContext);
+		if (express_siblings && next)
+			next->express (true, pContext);
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s\n",
+			type, name? name : "");
+	}
+
+};
+
+
+/*===========================================================================
+ * Name:	Material
+ * Purpose:	
+ */
+class Material : public Node {
+public:	
+	GLfloat diffuseColor[4];
+	GLfloat ambientIntensity;
+	GLfloat specularColor[4];
+	GLfloat emissiveColor[4];
+	GLfloat shininess;
+	GLfloat transparency;
+
+	Material ()
+	{
+		type = "Material";
+
+		for (int i=0; i < 4; i++) {
+			diffuseColor[i] = 0.7f;
+			specularColor[i] = emissiveColor[i] = 0.f;
+		}
+		ambientIntensity = 1.f;
+		shininess = 1.f;
+		transparency = 0.f;
+	}
+
+	~Material ()
+	{
+	}
+
+	void express_colors ()
+	{
+		int i;
+		GLfloat materialColor[4];
+		GLfloat materialSpecular[4];
+		GLfloat materialEmission[4];
+		if (using_custom_colors) {
+			for (i=0; i<3; i++) {
+				materialColor[i] = user_fg[i];
+				materialSpecular[i] = user_specularity;
+				materialEmission[i] = user_emissivity;
+			}
+		} else {
+			for (i=0; i<3; i++) {
+				materialColor[i] = diffuseColor[i];
+				materialSpecular[i] = specularColor[i];
+				materialEmission[i] = emissiveColor[i];
+			}
+		}
+		materialSpecular[3] = 1.0f;
+		materialEmission[3] = 1.0f;
+		materialColor[3] = ambientIntensity;
+
+		glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
+				materialColor);
+		glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
+		glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
+
+		if (!using_custom_colors)
+			glMaterialf (GL_FRONT, GL_SHININESS, shininess);
+		else
+			glMaterialf (GL_FRONT, GL_SHININESS, 
+				user_shininess);
+	}
+};
+
+/*===========================================================================
+ * Name:	Appearance
+ * Purpose:	
+ */
+class Appearance : public Node {
+public:
+	Material *material;
+
+	Appearance () :
+		material(NULL)
+	{	
+		type = "Appearance";
+	}
+
+	~Appearance ()
+	{
+		if (material)
+			delete material;
+	}
+};
+
+
+/*===========================================================================
+ * Name:	Shape
+ * Purpose:	Represents a VRML Shape node.
+ * Note:	The 'children' variable points to the Shape's geometry.
+ */
+class Shape : public Node {
+public:
+	Appearance *appearance;
+	bool owns_appearance;	// False if the Appearance is USE'd.
+
+	Shape() :
+		appearance(NULL),
+		owns_appearance(false)
+	{
+		type = "Shape";
+		children = NULL;
+		next = NULL;
+
+		total_allocated += sizeof(Shape);
+	}
+
+	/*===================================================================
+	 * Name:	~Shape
+	 * Purpose:	Carefully deallocates Shape object to avoid memory leaks.
+	 */
+	~Shape() {
+		if (children)
+			delete children;
+		children = NULL;
+		last_child = NULL;
+		if (appearance && owns_appearance)
+			delete appearance;
+		if (next)
+			delete next;
+		next = NULL;
+		// name is not a copy.
+		// type is a const.
+
+		total_allocated -= sizeof(Shape);
+	}
+
+	/*===================================================================
+	 * Name:	add_geometry
+	 * Purpose:	Sets the one geometry that a Shape is allowed.
+	 */
+	void add_geometry (Node *n) 
+	{
+		ASSERT_NONZERO(n,"node")
+		//----------
+
+		if (children != NULL)
+			warning ("Attempt to add geometry to Shape that already has one.");
+		else
+			children = n;
+	}
+
+	void express_colors ()
+	{
+		if (appearance && appearance->material)
+			appearance->material->express_colors ();
+		else {
+			int i;
+			GLfloat materialColor[4];
+			GLfloat materialSpecular[4];
+			GLfloat materialEmission[4];
+			for (i=0; i<3; i++) {
+				materialColor[i] = user_fg[i];
+				materialSpecular[i] = user_specularity;
+				materialEmission[i] = user_emissivity;
+			}
+			materialSpecular[3] = 1.0f;
+			materialEmission[3] = 1.0f;
+			materialColor[3] = 0.5f; // ambient intensity
+
+			glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
+					materialColor);
+			glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
+			glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
+			glMaterialf (GL_FRONT, GL_SHININESS, user_shininess);
+		}
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses the Shape as OpenGL if geometry set.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+
+		if (children) {
+			express_colors();
+			children->express (true, pContext);
+		}
+		if (express_siblings && next)
+			next->express (true, pContext);
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+
+		double xmin, xmax, ymin, ymax, zmin, zmax;
+		xmin = ymin = zmin = 1E6f;
+		xmax = ymax = zmax = -1E6f;
+
+		if (children) {
+			children->report_bounds (level+1, false,
+							xmin, xmax, 
+							ymin, ymax, 
+							zmin, zmax);
+		}
+
+		// Get the number for the Shape's geometry node.
+		//
+		if (report_siblings && next) {
+			double xming, xmaxg, yming, ymaxg, zming, zmaxg;
+			xming = yming = zming = 1E6f;
+			xmaxg = ymaxg = zmaxg = -1E6f;
+
+			next->report_bounds (level, true,
+					xming, xmaxg, yming, ymaxg, zming, zmaxg);
+
+			if (xming < xmin)
+				xmin = xming;
+			if (yming < ymin)
+				ymin = yming;
+			if (zming < zmin)
+				zmin = zming;
+
+			if (xmaxg > xmax)
+				xmax = xmaxg;
+			if (ymaxg > ymax)
+				ymax = ymaxg;
+			if (zmaxg > zmax)
+				zmax = zmaxg;
+		}
+		
+		minx = xmin;
+		miny = ymin;
+		minz = zmin;
+		maxx = xmax;
+		maxy = ymax;
+		maxz = zmax;
+
+		REPORT2
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump, makes sure to print children.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s: ", type, name? name : "");
+		if (!children)
+			fprintf (f, "*no geometry*");
+		fputc ('\n', f);
+	}
+
+	void serialize (OutputFile *f);
+};
+
+// Unless the file gives a creaseAngle, a vertex whose normal
+// deviates more than this from one of its triangles' is on a crease.
+#define IFS_DEFAULT_CREASE_ANGLE (M_PI/4.f)	// 45 degrees
+
+// Chunk size of the pool of an IndexedFaceSet's Points and Triangles.
+#define IFS_POOL_CHUNK_SIZE (64*1024)
+
+// The room a FlatMesh is first given when its size is not known
+// beforehand (see reserve).
+#define IFS_INITIAL_NPOINTS 300
+#define IFS_INITIAL_NTRIANGLES 600
+
+/*===========================================================================
+ * Name:	IndexedFaceSet
+ * Purpose:	Represents a VRML IndexedFaceSet node, i.e. list of triangles.
+ */
+class IndexedFaceSet : public Node {
+public:
+	float color[4];
+	bool color_specified;
+
+	// The mesh, which the parsers and the mesh cache fill in
+	// place; n_points and n_triangles are its numbers of
+	// vertices and faces.
+	FlatMesh *flat;
+	int n_points;
+	int n_triangles;
+
+	double minx, maxx, miny, maxy, minz, maxz;
+
+	bool force_green;	// for cross section
+	bool doing_cross_section;
+
+	// Vertex normals given by the file (see Normal), which
+	// smooth_faces() then leaves alone.
+	bool normals_given;
+	double crease_angle;	// Radians; VRML creaseAngle.
+
+	// A Point per vertex and a Triangle per face, in the same
+	// order as the FlatMesh's, for picking and the cross
+	// section. They are made by make_objects(), carved with
+	// the triangles' normals from pool, and NULL until then.
+	Point **points;
+	Triangle **triangles;
+	Arena *pool;
+
+	/*===================================================================
+	 * Name:	add_point
+	 * Purpose:	Appends a vertex, with no normal, to the mesh,
+	 *		growing it by 2X if it is full.
+	 * Returns:	Its position.
+	 */
+	float *add_point (double x, double y, double z) {
+		if (n_points == flat->vertices_size)
+			reserve (n_points ? 2 * n_points : IFS_INITIAL_NPOINTS, 0);
+		float *position = flat_position (flat, n_points);
+		float *normal = flat_normal (flat, n_points);
+		position [0] = x;
+		position [1] = y;
+		position [2] = z;
+		normal [0] = normal [1] = normal [2] = 0.f;
+		flat->smooth [n_points] = 0;
+		n_points = ++flat->n_vertices;
+		return position;
+	}
+
+	/*===================================================================
+	 * Name:	add_triangle
+	 * Purpose:	Appends a face of three existing vertices to the
+	 *		mesh, growing it by 2X if it is full, and computes
+	 *		its normal and area, unless they are given.
+	 */
+	void add_triangle (int a, int b, int c) {
+		if (n_triangles == flat->faces_size)
+			reserve (0, n_triangles ? 2 * n_triangles : IFS_INITIAL_NTRIANGLES);
+		flatmesh_set_face (flat, n_triangles, a, b, c);
+		n_triangles = ++flat->n_faces;
+	}
+	void add_triangle (int a, int b, int c, const float *normal, float area) {
+		if (n_triangles == flat->faces_size)
+			reserve (0, n_triangles ? 2 * n_triangles : IFS_INITIAL_NTRIANGLES);
+		uint32 *v = flat_face (flat, n_triangles);
+		float *n = flat_face_normal (flat, n_triangles);
+		v [0] = a;
+		v [1] = b;
+		v [2] = c;
+		n [0] = normal [0];
+		n [1] = normal [1];
+		n [2] = normal [2];
+		flat->face_areas [n_triangles] = area;
+		n_triangles = ++flat->n_faces;
+	}
+
+	/*===================================================================
+	 * Name:	reserve
+	 * Purpose:	Grows the mesh to a known final size in one step,
+	 *		rather than by repeated doubling.
+	 */
+	void reserve (int npoints, int ntriangles) {
+		if (npoints > flat->vertices_size || ntriangles > flat->faces_size)
+			flat = flatmesh_grow (flat,
+				npoints > flat->vertices_size ? npoints : flat->vertices_size,
+				ntriangles > flat->faces_size ? ntriangles : flat->faces_size);
+	}
+
+	// Reduced copies of the flat mesh, each about a quarter
+	// the size of the one before, made by build_lods() on the
+	// Model's LOD thread. n_lods counts those ready to use.
+#define IFS_MAX_LODS (3)
+	FlatMesh *lods [IFS_MAX_LODS];
+	float lod_errors [IFS_MAX_LODS];	// Sampled Hausdorff distance from flat.
+	volatile int n_lods;
+
+	/*===================================================================
+	 * Name:	lod
+	 * Purpose:	Returns the mesh to draw or save at a level of
+	 *		detail: the flat mesh for 0, else the reduced one
+	 *		nearest to that level that is ready.
+	 */
+	FlatMesh *lod (int level);
+
+	/*===================================================================
+	 * Name:	build_lods
+	 * Purpose:	Makes up to n_levels reduced meshes, each with the
+	 *		given ratio of the triangles of the one before, or
+	 *		fewer if that is within max_error, if not 0. Stops
+	 *		early, keeping those made, when *cancel is set.
+	 */
+	void build_lods (int n_levels, double ratio, double max_error, volatile bool *cancel);
+	void drop_lods ();
+
+	/*===================================================================
+	 * Name:	make_objects
+	 * Purpose:	Makes the Points and Triangles from the mesh, if
+	 *		not yet made. Point ids are vertex indices.
+	 */
+	void make_objects ();
+	void drop_objects ();
+
+	/*===================================================================
+	 * Name:	adjacency
+	 * Purpose:	Returns the connectivity of the FlatMesh, making
+	 *		it first if need be. It goes with the FlatMesh.
+	 */
+	MeshAdjacency *adjacency () {
+		return flatmesh_adjacency (flat);
+	}
+
+	/*===================================================================
+	 * Name:	bvh
+	 * Purpose:	Returns the bounding volume hierarchy of the
+	 *		FlatMesh, making it first if need be. It goes
+	 *		with the FlatMesh, and is in this face set's own
+	 *		coordinates until refitted.
+	 */
+	Bvh *bvh () {
+		return flatmesh_bvh (flat);
+	}
+
+	/*===================================================================
+	 * Name:	ensure_tiny_triangles 
+	 * Purpose:	Enforces a maximum triangle size, splitting the
+	 *		large triangles without leaving T-junctions.
+	 */
+	void ensure_tiny_triangles (double maximum);
+
+	/*===================================================================
+	 * Name:	IndexedFaceSet
+	 * Purpose:	Sets up IndexedFaceSet, with an empty mesh.
+	 */
+	IndexedFaceSet () :
+		force_green(false), doing_cross_section(false),
+		color_specified(false)
+	{
+		type = "IndexedFaceSet";
+		normals_given = false;
+		crease_angle = IFS_DEFAULT_CREASE_ANGLE;
+		flat = flatmesh_new (0, 0);
+		n_points = 0;
+		n_triangles = 0;
+		n_lods = 0;
+		points = NULL;
+		triangles = NULL;
+		pool = NULL;
+		color[0] = 0.0f;
+		color[1] = 0.0f;
+		color[2] = 0.0f;
+		color[3] = 0.0f;
+
+		next = NULL;
+		children = NULL;
+		
+		minx = miny = minz = 1E6f;
+		maxx = maxy = maxz = -1E6f;
+
+		total_allocated += sizeof(IndexedFaceSet);
+	}
+
+	/*===================================================================
+	 * Name:	~IndexedFaceSet
+	 * Purpose:	Carefully deallocates object to avoid memory leaks.
+	 */
+	~IndexedFaceSet() {
+		drop_lods ();
+		drop_objects ();
+		flatmesh_free (flat);
+
+		total_allocated -= sizeof(IndexedFaceSet);
+
+		if (children)
+			delete children;
+		children = NULL;
+		last_child = NULL;
+		if (next)
+			delete next;
+		next = NULL;
+		// name is not a copy.
+		// type is a const.
+	}
+
+
+	/*===================================================================
+	 * Name:	smooth_faces
+	 * Purpose:	Performs smoothing of faces of this indexed face set.
+	 */
+	void smooth_faces ();
+
+	void serialize (OutputFile *f);
+	void serialize_normals (OutputFile *f);
+
+	void express_ball_at (bool cube, double x, double y, double z, double radius, unsigned long color)
+	{
+		glPushMatrix ();
+		glTranslatef (x, y, z);
+
+		GLfloat materialColor[4];
+		materialColor [0] = 255==(0xff & (color>>16)) ? 1.f : 0.f;
+		materialColor [1] = 255==(0xff & (color>>8)) ? 1.f : 0.f;
+		materialColor [2] = 255==(0xff & color) ? 1.f : 0.f;
+		materialColor [3] = 0.f; 
+		glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
+			materialColor);
+		glMaterialfv (GL_FRONT, GL_EMISSION, materialColor);
+		if (cube) 
+			glutSolidCube (radius);
+		else
+			glutSolidSphere (radius, 20, 20);
+		glPopMatrix ();
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses all of the triangles as OpenGL data.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		int i;
+		ENTRY
+
+		Shape *shape = (Shape*) parent;
+		if (shape) 
+			shape->express_colors ();
+		else 
+			force_green = true;
+
+		if (redrawing_for_selection) {
+			make_objects ();
+			for (i=0; i < n_triangles; i++) {
+				Triangle *t = triangles[i];
+#if defined(WIN32) || defined(__APPLE__)
+				glLoadName ((GLuint) t);	// XX not 64 bit correct
+#endif
+				glBegin(GL_TRIANGLES);
+				t->express (pContext);
+				glEnd ();
+			}
+		} else {
+			if (force_green) {
+				GLfloat materialColor[4];
+				materialColor [0] = 0.f;
+				materialColor [1] = 1.f;
+				materialColor [2] = 0.f;
+				materialColor [3] = 0.f; // XX
+				glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, 
+					materialColor);
+			}
+
+			if (!doing_cross_section) {
+#define BALL_BUFFER_SIZE (1000)
+				int n_balls = 0;
+				double ball_x [BALL_BUFFER_SIZE];
+				double ball_y [BALL_BUFFER_SIZE];
+				double ball_z [BALL_BUFFER_SIZE];
+
+printf ("Rendering %d triangles in IFS\n", n_triangles);
+
+				// Red dots are matched by Triangle pointer,
+				// so only then are the Triangles walked.
+				FlatMesh *mesh = NULL;
+#if defined(WIN32) || defined(__APPLE__)
+				if (red_dot_stack)
+					make_objects ();
+				else
+#endif
+					mesh = lod (pContext->LevelOfDetail ());
+
+				glBegin(GL_TRIANGLES);
+				if (mesh)
+					flatmesh_express (mesh, pContext);
+				else for (i=0; i < n_triangles; i++) {
+					Triangle *t = triangles[i];
+
+#if defined(WIN32) || defined(__APPLE__)
+					if (red_dot_stack) {
+						bool name_match = false;
+						GLuint name;
+						name = (GLuint) t;
+
+						red_dot_info *r = red_dot_stack;
+						while (r && !name_match) {
+							if (name == r->name) {
+								name_match = true;
+								break;
+							} else
+								r = r->next;
+						}
+
+						// If we encounter a specific 
+						// triangle that's been 
+						// selected, we need to place
+						// a ball in its position.
+						//
+						if (name_match) {
+							double x, y, z;
+							t->get_center (x, y, z);
+							ball_x [n_balls] = x;
+							ball_y [n_balls] = y;
+							ball_z [n_balls] = z;
+							n_balls++;
+						}
+					}
+#endif
+					t->express (pContext);
+				}
+				glEnd ();
+		
+				i = 0;
+				while (i < n_balls) {
+					//------------------------------
+					// Create a red ball where user
+					// clicked.
+					//
+					express_ball_at (false, 
+						ball_x[i], ball_y[i], 
+						ball_z[i], 0.0005f, 0xff0000);
+
+					i++;
+				}
+				if (n_balls) {
+					// Restore the triangles' color.
+					//
+					Shape *shape = (Shape*) parent;
+					shape->express_colors ();
+				}
+			}
+			else
+			{
+				// Cross section
+				//
+				GLfloat materialColor[4];
+				unsigned long color = force_green ? 0xff00 : 0xff0000;
+				materialColor [0] = 255==(0xff & (color>>16)) ? 1.f : 0.f;
+				materialColor [1] = 255==(0xff & (color>>8)) ? 1.f : 0.f;
+				materialColor [2] = 255==(0xff & color) ? 1.f : 0.f;
+				materialColor [3] = 0.f;
+				glColor3f (materialColor[0], materialColor[1], materialColor[2]);
+				
+				make_objects ();
+				for (i=0; i < n_triangles; i++) {		
+					Triangle *t = triangles[i];
+
+					glDisable(GL_LIGHTING);
+					glBegin (GL_LINES);
+					double x, y, z;
+					t->get_center (x, y, z);
+		
+					// float side = 0.0005f;
+					// side /= 2.f;
+					Point_express (t->p1);
+					Point_express (t->p2);
+					Point_express (t->p3);
+					Point_express (t->p1);
+					glEnd ();
+					glBegin (GL_TRIANGLES);
+					Point_express (t->p1);
+					Point_express (t->p2);
+					Point_express (t->p3);
+					glEnd ();
+					glEnable(GL_LIGHTING);
+				}
+			}
+		}
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx_, double &maxx_,
+				double &miny_, double &maxy_,
+				double &minz_, double &maxz_) 
+	{
+		ENTRY2
+
+		minx_ = minx;
+		maxx_ = maxx;
+		miny_ = miny;
+		maxy_ = maxy;
+		minz_ = minz;
+		maxz_ = maxz;
+#if 0
+		printf ("IndexedFaceSet BOUNDS: %g %g, %g %g, %g %g\n",
+			minx,maxx,miny,maxy,minz,maxz);
+#endif
+		REPORT2
+	}
+	
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf(f, "%s (%d points, %d triangles, bounds [%g,%g] [%g,%g] [%g,%g]\n", 
+			type, n_points, n_triangles, minx,maxx, miny,maxy, minz,maxz);
+	}
+};
+
+
+/*===========================================================================
+ * Name:	IndexedLineSet
+ * Purpose:	Represents a VRML IndexedLineSet node, i.e. list of lines.
+ * Note:	Only one color supported.
+ */
+class IndexedLineSet : public Node {
+public:
+	bool color_per_vertex;
+	float color[4];
+	Point **points;
+	float *colors; // organized as r,g,b,r,g,b,...
+	int n_points;
+	int n_colors;
+	int points_size;
+	int colors_size;
+	PolyLine *polyline;
+	PolyLine *last_poly;
+	int n_segments;
+	double minx, maxx, miny, maxy, minz, maxz;
+
+	IndexedLineSet() {
+		type = "IndexedLineSet";
+		color_per_vertex = false;
+		color[0] = 0.0f;
+		color[1] = 0.0f;
+		color[2] = 0.0f;
+		color[3] = 0.0f;
+		polyline = NULL;
+		last_poly = NULL;
+		n_segments = 0;
+
+		n_colors = 0;
+#define ILS_INITIAL_NCOLORS 16
+		colors_size = ILS_INITIAL_NCOLORS;
+		colors = new float[ILS_INITIAL_NCOLORS];
+
+		children = NULL;
+		next = NULL;
+
+		minx = miny = minz = 1E6f;
+		maxx = maxy = maxz = -1E6f;
+
+		n_points = 0;
+		points_size = IFS_INITIAL_NPOINTS;
+		points = new Point*[IFS_INITIAL_NPOINTS];
+
+		total_allocated += sizeof(IndexedLineSet);
+		total_allocated += sizeof(Point*) * IFS_INITIAL_NPOINTS;
+		total_allocated += sizeof(float) * ILS_INITIAL_NCOLORS;
+	}
+
+	/*===================================================================
+	 * Name:	~IndexedLineSet
+	 * Purpose:	Frees the points, the polyline and the colors.
+	 */
+	~IndexedLineSet() {
+		for (int i = 0; i < n_points; i++)
+			Point_free (points[i]);
+		delete[] points;
+		delete[] colors;
+
+		// One segment at a time, since a long
+		// polyline would be deep recursion.
+		//
+		while (polyline) {
+			PolyLine *pl = polyline->next;
+			polyline->next = NULL;
+			delete polyline;
+			polyline = pl;
+		}
+
+		total_allocated -= sizeof(Point*) * points_size;
+		total_allocated -= sizeof(float) * colors_size;
+		total_allocated -= sizeof(IndexedLineSet);
+	}
+
+	void serialize (OutputFile *f);
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx_, double &maxx_,
+				double &miny_, double &maxy_,
+				double &minz_, double &maxz_) 
+	{
+		ENTRY2
+		minx_ = minx;
+		maxx_ = maxx;
+		miny_ = miny;
+		maxy_ = maxy;
+		minz_ = minz;
+		maxz_ = maxz;
+		REPORT2
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Express the lines in the form of OpenGL calls.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+
+#ifndef ORTHOCAST
+		if (!color_per_vertex) {
+			glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, color);
+			glBegin(GL_LINE_STRIP);
+
+			polyline->express (color_per_vertex);
+
+			glEnd ();
+		} else {
+			PolyLine *pl = polyline;
+			Point *prev = NULL;
+
+			while (pl) {
+				Point *p = pl->point;
+				if (prev) {
+					GLfloat materialColor[4];
+					GLfloat materialSpecular[4];
+					GLfloat materialEmission[4];
+					int i;
+					for (i=0; i<3; i++) {
+						materialColor[i] = using_custom_colors ? user_fg[i] : color[i];
+						materialSpecular[i] = 0 * user_specularity;
+						materialEmission[i] = 1.0f;
+					}
+					materialSpecular[3] = 1.f;
+					materialEmission[3] = 1.f;
+					materialColor[3] = 1.f;
+					glMaterialfv (GL_FRONT, GL_AMBIENT_AND_DIFFUSE, materialColor);
+					glMaterialfv (GL_FRONT, GL_SPECULAR, materialSpecular);
+					glMaterialfv (GL_FRONT, GL_EMISSION, materialEmission);
+					glMaterialf (GL_FRONT, GL_SHININESS, 127.f);
+
+					glBegin (GL_LINES);
+					glVertex3d (prev->x, prev->y, prev->z);
+					glVertex3d (p->x, p->y, p->z);
+					glEnd ();
+				}
+				prev = p;
+				pl = pl->next;
+			}
+		}
+#endif
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s \n", type);
+	}
+
+	/*===================================================================
+	 * Name:	expand_points
+	 * Purpose:	Increases the size of the points array by 2X.
+	 */
+	void expand_points () {
+		Point** newarray;
+		unsigned long lim = points_size;
+		total_allocated -= sizeof(Point*) * points_size;
+
+		points_size = 2*lim;
+		newarray = new Point*[points_size];
+		total_allocated += sizeof(Point*) * points_size;
+
+		unsigned long i=0;
+		while(i<lim) {
+			newarray[i]=points[i];
+			i++;
+		}
+		delete[] points;
+		points = newarray;
+	}
+
+	/*===================================================================
+	 * Name:	expand_colors
+	 * Purpose:	Increases the size of the colors array by 2X.
+	 */
+	void expand_colors () {
+		float* newarray;
+		int lim = colors_size;
+		total_allocated -= sizeof(float) * colors_size;
+
+		colors_size = 2*lim;
+		newarray = new float[colors_size];
+		total_allocated += sizeof(float) * colors_size;
+
+		int i=0;
+		while(i<lim) {
+			newarray[i]=colors[i];
+			i++;
+		}
+		delete[] colors;
+		colors = newarray;
+	}
+
+};
+
+
+/*===========================================================================
+ * Name:	Cylinder
+ * Purpose:	Represents a VRML Cylinder node.
+ */
+class Cylinder : public Node {
+public:
+	bool bottom, top, side;
+	double radius;
+	double height;
+
+	Cylinder() {
+		type = "Cylinder";
+		bottom = top = side = true;
+		radius = 0.0f;
+		height = 0.0f;
+		next = NULL;
+		children = NULL;
+
+		total_allocated += sizeof(Cylinder);
+	}
+
+	~Cylinder () {
+		total_allocated -= sizeof(Cylinder);
+	}
+};
+
+/*===========================================================================
+ * Name:	Box
+ * Purpose:	Represents a VRML Box node.
+ */
+class Box : public Node {
+public:
+	double size;
+
+	Box() {
+		type = "Box";
+		size = 0.0f;
+		next = NULL;
+		children = NULL;
+
+		total_allocated += sizeof(Box);
+	}
+
+	~Box () {
+		total_allocated -= sizeof(Box);
+	}
+};
+
+/*===========================================================================
+ * Name:	Text
+ * Purpose:	Represents a VRML Text node.
+ */
+class Text : public Node {
+public:
+	char *text;
+
+	Text() {
+		type = "Text";
+		text = NULL;
+		next = NULL;
+		children = NULL;
+
+		total_allocated += sizeof(Text);
+	}
+
+	~Text () {
+		// text is not a copy.
+		total_allocated -= sizeof(Text);
+	}
+
+	void serialize (OutputFile *);
+
+	void dump (FILE *f)
+	{
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s (%s = '%s')\n", 
+			type, 
+			name? name : "(no name)", 
+			text);
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+
+		minx = miny = minz = 1E6f;
+		maxx = maxy = maxy = -1E6f;
+	}
+};
+
+/*===========================================================================
+ * Name:	Cone
+ * Purpose:	Represents a VRML Cone node.
+ */
+class Cone : public Node {
+public:
+	double radius;
+	double height;
+
+	Cone () :
+		radius(0.f), height(0.f)
+	{
+		type = "Cone";
+		next = NULL;
+		children = NULL;
+
+		total_allocated += sizeof(Cone);
+	}
+
+	~Cone () {
+		total_allocated -= sizeof(Cone);
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses Sphere using GLUT.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+		glutSolidCone (radius, height, 100, 1);
+	}
+
+};
+
+/*===========================================================================
+ * Name:	Sphere
+ * Purpose:	Represents a VRML Sphere node.
+ */
+class Sphere : public Node {
+public:
+	double radius;
+
+	Sphere () {
+		type = "Sphere";
+		radius = 0.0f;
+		next = NULL;
+		children = NULL;
+
+		total_allocated += sizeof(Sphere);
+	}
+
+	~Sphere () {
+		total_allocated -= sizeof(Sphere);
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses Sphere using GLUT.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+		glutSolidSphere (radius, 50, 10);
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+		minx = -radius;
+		maxx = radius;
+		miny = -radius;
+		maxy = radius;
+		minz = -radius;
+		maxz = radius;
+		REPORT2
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s radius %g\n", type, name? name : "", radius);
+	}
+};
+
+/*===========================================================================
+ * Name:	Replicated
+ * Purpose:	Represents a replicated VRML node, i.e. result of USE command.
+ */
+class Replicated : public Node {
+public:
+	Node *original; // For clarity, we don't use the 'children' datum.
+
+	/*===================================================================
+	 * Name:	Replicated
+	 * Purpose:	Creates a replication of named node.
+	 */
+	Replicated ()
+	{
+		original = NULL;
+	}
+
+	void serialize (OutputFile *f);
+
+	/*===================================================================
+	 * Name:	Replicated
+	 * Purpose:	Creates a replication of named node.
+	 */
+	Replicated (Model *m, char *name) {
+		ASSERT_NONZERO(m,"model")
+		ASSERT_NONZERO(name,"name")
+		//----------
+
+		type = "Replicated (USE)";
+		original = m->lookup_node_by_name (name);
+		if (!original) {
+			char tmp[250];
+			sprintf (tmp, "Unknown objected '%s' referred to in USE clause.", name);
+			warning(tmp);
+		}
+		children = NULL;
+		next = NULL;
+
+		total_allocated += sizeof(Replicated);
+	}
+
+	~Replicated () {
+		// original belongs to the tree it was USE'd from.
+		total_allocated -= sizeof(Replicated);
+	}
+
+	/*===================================================================
+	 * Name:	express
+	 * Purpose:	Expresses the object in OpenGL terms.
+	 */
+	void express (bool express_siblings, CRenderContext* pContext) {
+		ENTRY
+		if (original)
+			original->express (false, pContext);
+		if (express_siblings && next)
+			next->express (true, pContext);
+	}
+
+	/*===================================================================
+	 * Name:	report_bounds
+	 * Purpose:	Reports to caller maximum and minimum coordinates.
+	 */
+	void report_bounds (int level, bool report_siblings,
+				double &minx, double &maxx,
+				double &miny, double &maxy,
+				double &minz, double &maxz) 
+	{
+		ENTRY2
+			
+		double x0, x1, y0, y1, z0, z1;
+		x0 = y0 = z0 = 1E6f;
+		x1 = y1 = z1 = -1E6f;
+
+		if (original) {
+			original->report_bounds (level+1, false, 
+					x0, x1, y0, y1, z0, z1);
+		}
+
+		if (next && report_siblings) {
+			double minx2, maxx2, miny2, maxy2, minz2, maxz2;
+			minx2 = miny2 = minz2 = 1E6f;
+			maxx2 = maxy2 = maxz2 = -1E6f;
+
+			next->report_bounds (level, true, minx2, maxx2, miny2, maxy2, minz2, maxz2);
+			if (minx2 < x0)
+				x0 = minx2;
+			if (miny2 < y0)
+				y0 = miny2;
+			if (minz2 < z0)
+				z0 = minz2;
+
+			if (maxx2 > x1)
+				x1 = maxx2;
+			if (maxy2 > y1)
+				y1 = maxy2;
+			if (maxz2 > z1)
+				z1 = maxz2;
+		}
+
+		minx = x0;
+		miny = y0;
+		minz = z0;
+		maxx = x1;
+		maxy = y1;
+		maxz = z1;
+		REPORT2
+	}
+
+	/*===================================================================
+	 * Name:	dump
+	 * Purpose:	Diagnostic dump, tells what the pointed-to object is.
+	 */
+	void dump (FILE *f) {
+		ASSERT_NONZERO(f,"file")
+		//----------
+
+		fprintf (f, "%s %s: ", type, name? name : "");
+		if (original)
+			original->dump (f);
+		else
+			fprintf (f, "NULL");
+		fputc('\n', f);
+	}
+};
+
+
+#endif /* _MAXILLA_H */
@@ -0,0 +1,1358 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+//----------------------------------------------------------------------------
+// A face set was once built as one malloc'd Point per vertex and one
+// Triangle, plus a Point for its normal, per face. Walking such a mesh
+// means chasing three pointers per corner to blocks scattered over the
+// heap, and every block carries the allocator's own overhead.
+//
+// The FlatMesh is the mesh as a handful of contiguous arrays, and is
+// what a face set keeps. The parsers and the mesh cache fill it in
+// place; drawing, smoothing, splitting, saving and exporting walk it in
+// order. Points and Triangles are made from it only for picking and
+// the cross section, which name and draw single triangles.
+//
+// Its MeshAdjacency gives the twin of each half-edge, the corners
+// around each vertex and the boundary edges. It is made in linear time:
+// a counting sort of the corners by vertex, then one pass over the
+// half-edges through an open-addressed hash table of edges. Smoothing
+// uses it to sum each vertex's face normals and to find creases edge by
+// edge, with no allocation per vertex and no limit on the mesh size.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <limits.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "mesh.h"
+#include "threads.h"
+
+extern bool doing_smooth_shading;
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_alloc
+// Purpose:	Allocates an empty FlatMesh with room for the given
+//		numbers of vertices and faces, all as one block.
+//---------------------------------------------------------------------------
+static FlatMesh *
+flatmesh_alloc (int vertices_size, int faces_size)
+{
+	unsigned long nv = vertices_size;
+	unsigned long nf = faces_size;
+
+	// The 4-byte arrays come first, so that all are aligned.
+	unsigned long size = sizeof (FlatMesh)
+		+ nv * 6 * sizeof(float)
+		+ nf * 3 * sizeof(uint32)
+		+ nf * 4 * sizeof(float)
+		+ nv;
+
+	char *block = (char*) malloc (size);
+	if (!block)
+		fatal ("Out of memory!");
+
+	FlatMesh *m = (FlatMesh*) block;
+	block += sizeof (FlatMesh);
+	m->n_vertices = 0;
+	m->n_faces = 0;
+	m->vertices_size = vertices_size;
+	m->faces_size = faces_size;
+	m->positions = (float*) block;
+	m->normals = m->positions + 3 * nv;
+	m->indices = (uint32*) (m->normals + 3 * nv);
+	m->face_normals = (float*) (m->indices + 3 * nf);
+	m->face_areas = m->face_normals + 3 * nf;
+	m->smooth = (unsigned char*) (m->face_areas + nf);
+	m->size = size;
+	m->adjacency = NULL;
+	m->bvh = NULL;
+
+	total_allocated += size;
+	return m;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_new
+// Purpose:	Allocates a FlatMesh of the given size as one block.
+//---------------------------------------------------------------------------
+FlatMesh *
+flatmesh_new (int n_vertices, int n_faces)
+{
+	FlatMesh *m = flatmesh_alloc (n_vertices, n_faces);
+	m->n_vertices = n_vertices;
+	m->n_faces = n_faces;
+	return m;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_copy
+// Purpose:	Copies a FlatMesh, if any, into a new one with room for
+//		the given numbers of vertices and faces, which must be
+//		no fewer than it has. The adjacency and the BVH are not
+//		copied.
+//---------------------------------------------------------------------------
+static FlatMesh *
+flatmesh_copy (const FlatMesh *m, int vertices_size, int faces_size)
+{
+	FlatMesh *copy = flatmesh_alloc (vertices_size, faces_size);
+	if (!m)
+		return copy;
+
+	unsigned long nv = m->n_vertices;
+	unsigned long nf = m->n_faces;
+	memcpy (copy->positions, m->positions, nv * 3 * sizeof(float));
+	memcpy (copy->normals, m->normals, nv * 3 * sizeof(float));
+	memcpy (copy->smooth, m->smooth, nv);
+	memcpy (copy->indices, m->indices, nf * 3 * sizeof(uint32));
+	memcpy (copy->face_normals, m->face_normals, nf * 3 * sizeof(float));
+	memcpy (copy->face_areas, m->face_areas, nf * sizeof(float));
+	copy->n_vertices = m->n_vertices;
+	copy->n_faces = m->n_faces;
+	return copy;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_grow
+// Purpose:	Moves a FlatMesh, which may be NULL, to a new block with
+//		room for the given numbers of vertices and faces, or
+//		more if it has them. Its adjacency and BVH are dropped.
+// Returns:	The new FlatMesh.
+//---------------------------------------------------------------------------
+FlatMesh *
+flatmesh_grow (FlatMesh *m, int vertices_size, int faces_size)
+{
+	if (m && vertices_size < m->n_vertices)
+		vertices_size = m->n_vertices;
+	if (m && faces_size < m->n_faces)
+		faces_size = m->n_faces;
+
+	FlatMesh *grown = flatmesh_copy (m, vertices_size, faces_size);
+	flatmesh_free (m);
+	return grown;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flat_distance
+// Purpose:	Finds the distance between two positions, in single
+//		precision as Point_distance does.
+//---------------------------------------------------------------------------
+static inline float
+flat_distance (const float *p, const float *p2)
+{
+	float a = p[0] - p2[0];
+	float b = p[1] - p2[1];
+	float c = p[2] - p2[2];
+	return sqrt (a*a + b*b + c*c);
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_set_face
+// Purpose:	Sets the vertices of a face and computes its normal and
+//		its area, as a Triangle's were computed.
+//---------------------------------------------------------------------------
+void
+flatmesh_set_face (FlatMesh *m, int face, uint32 a, uint32 b, uint32 c)
+{
+	double d1x, d1y, d1z, d2x, d2y, d2z;
+	double cross_x, cross_y, cross_z;
+
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	uint32 *v = flat_face (m, face);
+	v [0] = a;
+	v [1] = b;
+	v [2] = c;
+
+	const float *p1 = flat_position (m, a);
+	const float *p2 = flat_position (m, b);
+	const float *p3 = flat_position (m, c);
+
+	d1x = p2[0] - p1[0];
+	d1y = p2[1] - p1[1];
+	d1z = p2[2] - p1[2];
+	d2x = p3[0] - p2[0];
+	d2y = p3[1] - p2[1];
+	d2z = p3[2] - p2[2];
+	cross_x = d2y*d1z - d2z*d1y;
+	cross_y = d2z*d1x - d2x*d1z;
+	cross_z = d2x*d1y - d2y*d1x;
+
+	float mag = 
+		sqrt (cross_x*cross_x + cross_y*cross_y + cross_z*cross_z);
+
+	float *normal = flat_face_normal (m, face);
+	normal [0] = cross_x / mag;
+	normal [1] = cross_y / mag;
+	normal [2] = cross_z / mag;
+
+	m->face_areas [face] = flat_distance (p1, p2) * flat_distance (p1, p3) / 2.0f;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_free
+//---------------------------------------------------------------------------
+void
+flatmesh_free (FlatMesh *m)
+{
+	if (!m)
+		return;
+	flatmesh_drop_adjacency (m);
+	flatmesh_drop_bvh (m);
+	total_allocated -= m->size;
+	free (m);
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_drop_adjacency
+//---------------------------------------------------------------------------
+void
+flatmesh_drop_adjacency (FlatMesh *m)
+{
+	if (m->adjacency) {
+		total_allocated -= m->adjacency->size;
+		free (m->adjacency);
+		m->adjacency = NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_express
+// Purpose:	Gives every face to the render context, within a
+//		glBegin (GL_TRIANGLES) made by the caller. Faces whose
+//		three vertices are all smoothed get the vertex normals.
+//---------------------------------------------------------------------------
+void
+flatmesh_express (FlatMesh *m, CRenderContext *pContext)
+{
+	ASSERT_NONZERO (m,"mesh")
+	ASSERT_NONZERO (pContext,"context")
+	//----------
+
+	int i;
+	for (i = 0; i < m->n_faces; i++) {
+		const uint32 *v = flat_face (m, i);
+		if (doing_smooth_shading && flat_face_smooth (m, i))
+			pContext->MeshTriangleSmooth (
+				flat_position (m, v[0]), flat_normal (m, v[0]),
+				flat_position (m, v[1]), flat_normal (m, v[1]),
+				flat_position (m, v[2]), flat_normal (m, v[2]));
+		else
+			pContext->MeshTriangle (flat_face_normal (m, i),
+				flat_position (m, v[0]),
+				flat_position (m, v[1]),
+				flat_position (m, v[2]));
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	edge_hash
+// Purpose:	Hashes the edge between two vertices, lo < hi.
+//---------------------------------------------------------------------------
+static inline unsigned int
+edge_hash (unsigned int lo, unsigned int hi)
+{
+	unsigned int h = lo * 2654435761U ^ hi * 2246822519U;
+	return h ^ (h >> 15);
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_adjacency
+// Purpose:	Makes the MeshAdjacency of a FlatMesh, once.
+//---------------------------------------------------------------------------
+MeshAdjacency *
+flatmesh_adjacency (FlatMesh *m)
+{
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	if (m->adjacency)
+		return m->adjacency;
+
+	int nv = m->n_vertices;
+	int nh = 3 * m->n_faces;
+	int h, v;
+
+	unsigned long size = sizeof (MeshAdjacency)
+		+ (2 * (unsigned long) nh + nv + 1) * sizeof(int)
+		+ nh;
+	char *block = (char*) malloc (size);
+	if (!block)
+		fatal ("Out of memory!");
+
+	MeshAdjacency *a = (MeshAdjacency*) block;
+	a->n_halfedges = nh;
+	a->twin = (int*) (block + sizeof (MeshAdjacency));
+	a->ring_start = a->twin + nh;
+	a->ring = a->ring_start + nv + 1;
+	a->on_boundary = (unsigned char*) (a->ring + nh);
+	a->n_boundary_edges = 0;
+	a->n_nonmanifold_edges = 0;
+	a->size = size;
+
+	//----------------------------------------
+	// Scratch: the edge table, with at least
+	// twice as many slots as half-edges, the
+	// fill position of each vertex's ring and
+	// which edges are known to be non-manifold.
+	//
+	unsigned int n_slots = 16;
+	while (n_slots < 2 * (unsigned int) nh)
+		n_slots *= 2;
+	unsigned int mask = n_slots - 1;
+	unsigned long scratch_size = (n_slots + nv) * sizeof(int) + nh;
+	int *slots = (int*) malloc (scratch_size);
+	if (!slots)
+		fatal ("Out of memory!");
+	int *fill = slots + n_slots;
+	unsigned char *counted = (unsigned char*) (fill + nv);
+	memset (slots, 0xff, n_slots * sizeof(int));
+	memset (counted, 0, nh);
+
+	//----------------------------------------
+	// Sort the corners by vertex, counting
+	// them first.
+	//
+	memset (a->ring_start, 0, (nv + 1) * sizeof(int));
+	for (h = 0; h < nh; h++)
+		a->ring_start [m->indices [h] + 1]++;
+	for (v = 0; v < nv; v++) {
+		a->ring_start [v + 1] += a->ring_start [v];
+		fill [v] = a->ring_start [v];
+	}
+	for (h = 0; h < nh; h++)
+		a->ring [fill [m->indices [h]]++] = h;
+
+	//----------------------------------------
+	// Pair each half-edge with the first one
+	// seen on the same edge, if that is not
+	// already paired. A half-edge from a
+	// vertex to itself is on no edge.
+	//
+	for (h = 0; h < nh; h++) {
+		unsigned int v1 = m->indices [h];
+		unsigned int v2 = m->indices [halfedge_next (h)];
+		a->twin [h] = -1;
+		a->on_boundary [h] = 0;
+		if (v1 == v2)
+			continue;
+		unsigned int lo = v1 < v2 ? v1 : v2;
+		unsigned int hi = v1 < v2 ? v2 : v1;
+
+		unsigned int i = edge_hash (lo, hi) & mask;
+		int g;
+		while ((g = slots [i]) != -1) {
+			unsigned int w1 = m->indices [g];
+			unsigned int w2 = m->indices [halfedge_next (g)];
+			if ((w1 == lo && w2 == hi) || (w1 == hi && w2 == lo))
+				break;
+			i = (i + 1) & mask;
+		}
+
+		if (g == -1) {
+			slots [i] = h;
+			a->on_boundary [h] = 1;
+		} else if (a->on_boundary [g]) {
+			a->twin [g] = h;
+			a->twin [h] = g;
+			a->on_boundary [g] = 0;
+		} else if (!counted [g]) {
+			counted [g] = 1;
+			a->n_nonmanifold_edges++;
+		}
+	}
+
+	for (h = 0; h < nh; h++)
+		a->n_boundary_edges += a->on_boundary [h];
+
+	free (slots);
+
+	total_allocated += size;
+	m->adjacency = a;
+	return a;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_edges
+// Purpose:	Numbers the edges through an open-addressed hash table,
+//		giving every half-edge on the same edge the same number,
+//		however many faces share it, and -1 to a half-edge from
+//		a vertex to itself. edge_of must have room for one int
+//		per half-edge, and edge_ends for two per half-edge; it
+//		gets the lower and then the higher vertex of each edge.
+// Returns:	The number of edges.
+//---------------------------------------------------------------------------
+int
+flatmesh_edges (const FlatMesh *m, int *edge_of, uint32 *edge_ends)
+{
+	ASSERT_NONZERO (m,"mesh")
+	ASSERT_NONZERO (edge_of,"edge_of")
+	ASSERT_NONZERO (edge_ends,"edge_ends")
+	//----------
+
+	int nh = 3 * m->n_faces;
+
+	unsigned int n_slots = 16;
+	while (n_slots < 2 * (unsigned int) nh)
+		n_slots *= 2;
+	unsigned int mask = n_slots - 1;
+	int *slots = (int*) malloc (n_slots * sizeof(int));
+	if (!slots)
+		fatal ("Out of memory!");
+	memset (slots, 0xff, n_slots * sizeof(int));
+
+	int n = 0;
+	int h;
+	for (h = 0; h < nh; h++) {
+		unsigned int v1 = m->indices [h];
+		unsigned int v2 = m->indices [halfedge_next (h)];
+		if (v1 == v2) {
+			edge_of [h] = -1;
+			continue;
+		}
+		unsigned int lo = v1 < v2 ? v1 : v2;
+		unsigned int hi = v1 < v2 ? v2 : v1;
+
+		unsigned int i = edge_hash (lo, hi) & mask;
+		int e;
+		while ((e = slots [i]) != -1 &&
+		       (edge_ends [2*e] != lo || edge_ends [2*e+1] != hi))
+			i = (i + 1) & mask;
+		if (e == -1) {
+			e = n++;
+			slots [i] = e;
+			edge_ends [2*e] = lo;
+			edge_ends [2*e+1] = hi;
+		}
+		edge_of [h] = e;
+	}
+
+	free (slots);
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_one_ring
+// Purpose:	Finds the vertices that share an edge with a vertex.
+// Returns:	How many were stored in neighbors, at most max.
+//---------------------------------------------------------------------------
+int
+mesh_one_ring (const FlatMesh *m, const MeshAdjacency *a, int vertex,
+	int *neighbors, int max)
+{
+	ASSERT_NONZERO (m,"mesh")
+	ASSERT_NONZERO (a,"adjacency")
+	ASSERT_NONZERO (neighbors,"neighbors")
+	//----------
+
+	int n = 0;
+	int i, j, k;
+	for (i = a->ring_start [vertex]; i < a->ring_start [vertex + 1]; i++) {
+		int c = a->ring [i];
+		int candidates [2];
+		candidates [0] = m->indices [halfedge_next (c)];
+		candidates [1] = m->indices [halfedge_prev (c)];
+		for (j = 0; j < 2; j++) {
+			int w = candidates [j];
+			if (w == vertex)
+				continue;
+			for (k = 0; k < n && neighbors [k] != w; k++)
+				;
+			if (k == n) {
+				if (n == max)
+					return n;
+				neighbors [n++] = w;
+			}
+		}
+	}
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_boundary_loops
+// Purpose:	Chains the boundary half-edges into loops, each one
+//		from a half-edge to the one leaving its end vertex.
+//		edges must have room for 2 * n_boundary_edges; each
+//		loop is stored as its half-edges followed by -1.
+//		Where a vertex has more than one boundary half-edge
+//		leaving it, the first not yet taken is followed.
+// Returns:	The number of loops. A chain that does not close,
+//		as at a non-manifold vertex, counts as one.
+//---------------------------------------------------------------------------
+int
+mesh_boundary_loops (const FlatMesh *m, const MeshAdjacency *a, int *edges)
+{
+	ASSERT_NONZERO (m,"mesh")
+	ASSERT_NONZERO (a,"adjacency")
+	ASSERT_NONZERO (edges,"edges")
+	//----------
+
+	int nh = a->n_halfedges;
+	unsigned char *taken = (unsigned char*) malloc (nh ? nh : 1);
+	if (!taken)
+		fatal ("Out of memory!");
+	memset (taken, 0, nh);
+
+	int n_loops = 0;
+	int n = 0;
+	int h, i;
+	for (h = 0; h < nh; h++) {
+		if (!a->on_boundary [h] || taken [h])
+			continue;
+
+		int e = h;
+		while (e != -1) {
+			taken [e] = 1;
+			edges [n++] = e;
+
+			int v = m->indices [halfedge_next (e)];
+			e = -1;
+			for (i = a->ring_start [v]; i < a->ring_start [v + 1]; i++) {
+				int c = a->ring [i];
+				if (a->on_boundary [c] && !taken [c]) {
+					e = c;
+					break;
+				}
+			}
+		}
+		edges [n++] = -1;
+		n_loops++;
+	}
+
+	free (taken);
+	return n_loops;
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::make_objects
+// Purpose:	Makes a Point for each vertex and a Triangle for each
+//		face of the FlatMesh, once, in a pool of their own.
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::make_objects ()
+{
+	int i;
+
+	if (points)
+		return;
+
+	FlatMesh *m = flat;
+	pool = new Arena (IFS_POOL_CHUNK_SIZE);
+	pool->reserve ((unsigned long) n_points * ARENA_ALIGNED (sizeof(Point)) +
+		(unsigned long) n_triangles *
+			(ARENA_ALIGNED (sizeof(Triangle)) + ARENA_ALIGNED (sizeof(Point))));
+
+	unsigned long points_bytes = sizeof(Point*) * (n_points ? n_points : 1);
+	unsigned long triangles_bytes = sizeof(Triangle*) * (n_triangles ? n_triangles : 1);
+	points = (Point**) malloc (points_bytes);
+	triangles = (Triangle**) malloc (triangles_bytes);
+	if (!points || !triangles)
+		fatal ("Out of memory!");
+	total_allocated += points_bytes + triangles_bytes;
+
+	for (i = 0; i < n_points; i++) {
+		const float *position = flat_position (m, i);
+		const float *normal = flat_normal (m, i);
+		Point *p = Point_init ((Point*) pool->alloc (sizeof(Point)),
+			position[0], position[1], position[2]);
+		p->id = i;
+		p->normal_x = normal [0];
+		p->normal_y = normal [1];
+		p->normal_z = normal [2];
+		p->valid_vertex_normal = m->smooth [i];
+		points [i] = p;
+	}
+
+	for (i = 0; i < n_triangles; i++) {
+		const uint32 *v = flat_face (m, i);
+		Triangle *t = new (pool) Triangle (points [v[0]], points [v[1]],
+			points [v[2]], flat_face_normal (m, i), m->face_areas [i], pool);
+		t->indices [0] = v [0];
+		t->indices [1] = v [1];
+		t->indices [2] = v [2];
+		triangles [i] = t;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::drop_objects
+// Purpose:	Frees the Points and Triangles, if made.
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::drop_objects ()
+{
+	if (!points)
+		return;
+
+	total_allocated -= sizeof(Point*) * (n_points ? n_points : 1);
+	total_allocated -= sizeof(Triangle*) * (n_triangles ? n_triangles : 1);
+	free (points);
+	free (triangles);
+	delete pool;
+	points = NULL;
+	triangles = NULL;
+	pool = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Smoothing works on blocks of vertices in parallel. Each vertex sums
+// the normals of its faces, which the adjacency lists in face order,
+// so that the result is the same however many threads there are and
+// no thread writes what another one reads.
+//---------------------------------------------------------------------------
+
+#define SMOOTH_BLOCK_SIZE (4096)	// Vertices per parallel_for call.
+
+typedef struct {
+	FlatMesh *mesh;
+	MeshAdjacency *adjacency;
+	double cos_crease;
+	int *n_creases;			// Per block, if wanted: the points on creases.
+} SmoothJob;
+
+//---------------------------------------------------------------------------
+// Name:	is_crease
+// Purpose:	Tells whether the faces on either side of a half-edge
+//		meet at more than the crease angle. An edge of three or
+//		more faces is taken to be one; a boundary is not.
+//---------------------------------------------------------------------------
+static inline bool
+is_crease (const SmoothJob *job, int h)
+{
+	int t = job->adjacency->twin [h];
+	if (t < 0)
+		return !job->adjacency->on_boundary [h] &&
+			job->mesh->indices [h] != job->mesh->indices [halfedge_next (h)];
+
+	const float *n1 = flat_face_normal (job->mesh, h / 3);
+	const float *n2 = flat_face_normal (job->mesh, t / 3);
+	double dot = (double) n1[0] * n2[0] + (double) n1[1] * n2[1] + (double) n1[2] * n2[2];
+	return dot < job->cos_crease;
+}
+
+//---------------------------------------------------------------------------
+// Name:	smooth_block
+// Purpose:	Smooths one block of vertices for parallel_for.
+//---------------------------------------------------------------------------
+static void
+smooth_block (void *arg, int block)
+{
+	SmoothJob *job = (SmoothJob*) arg;
+	FlatMesh *m = job->mesh;
+	MeshAdjacency *a = job->adjacency;
+	int first = block * SMOOTH_BLOCK_SIZE;
+	int last = first + SMOOTH_BLOCK_SIZE;
+	if (last > m->n_vertices)
+		last = m->n_vertices;
+
+	int v, i;
+	int n_creases = 0;
+	for (v = first; v < last; v++) {
+		int start = a->ring_start [v];
+		int end = a->ring_start [v + 1];
+
+		//----------------------------------------
+		// The normal is the average of those of
+		// the vertex's faces, weighted by their
+		// share of the faces' total area, or
+		// equally if all have zero area.
+		//
+		double total_area = 0.;
+		for (i = start; i < end; i++)
+			total_area += m->face_areas [a->ring [i] / 3];
+
+		double x = 0., y = 0., z = 0.;
+		bool crease = false;
+		for (i = start; i < end; i++) {
+			int c = a->ring [i];
+			const float *n = flat_face_normal (m, c / 3);
+			double weight = total_area > 0. ?
+				m->face_areas [c / 3] / total_area :
+				1. / (end - start);
+			x += weight * n [0];
+			y += weight * n [1];
+			z += weight * n [2];
+
+			// Each edge at v leaves or enters it
+			// in one of its faces.
+			if (!crease)
+				crease = is_crease (job, c) ||
+					is_crease (job, halfedge_prev (c));
+		}
+
+		//----------------------------------------
+		// If the normals cancel out, or there are
+		// no faces, there is no average; the point
+		// takes the normal of its first face, if
+		// any, and is not smoothed.
+		//
+		double mag = sqrt (x*x + y*y + z*z);
+		bool averaged = mag > 0.;
+		float *normal = flat_normal (m, v);
+		if (averaged) {
+			normal [0] = x / mag;
+			normal [1] = y / mag;
+			normal [2] = z / mag;
+		} else if (end > start) {
+			const float *n = flat_face_normal (m, a->ring [start] / 3);
+			normal [0] = n [0];
+			normal [1] = n [1];
+			normal [2] = n [2];
+		} else
+			normal [0] = normal [1] = normal [2] = 0.f;
+
+		//----------------------------------------
+		// Points along an edge of a non-closed
+		// face set may have less than the 3
+		// triangles needed for smoothing.
+		//
+		bool valid = averaged && end - start >= 3;
+		m->smooth [v] = valid && !crease;
+		n_creases += crease;
+	}
+
+	if (job->n_creases)
+		job->n_creases [block] = n_creases;
+}
+
+//---------------------------------------------------------------------------
+// Name:	flatmesh_smooth
+// Purpose:	Smooths a FlatMesh that belongs to no IndexedFaceSet,
+//		such as a reduced one, as smooth_faces does. Its face
+//		normals must be set. The adjacency is dropped after.
+//---------------------------------------------------------------------------
+void
+flatmesh_smooth (FlatMesh *m, double crease_angle)
+{
+	ASSERT_NONZERO (m,"mesh")
+	//----------
+
+	SmoothJob job;
+	job.mesh = m;
+	job.adjacency = flatmesh_adjacency (m);
+	job.cos_crease = cos (crease_angle);
+	job.n_creases = NULL;
+
+	int n_blocks = (m->n_vertices + SMOOTH_BLOCK_SIZE - 1) / SMOOTH_BLOCK_SIZE;
+	parallel_for (n_blocks, smooth_block, &job);
+
+	flatmesh_drop_adjacency (m);
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::smooth_faces
+// Purpose:	Gives each vertex the average of the normals of its
+//		faces, weighted by their areas, and marks as being on
+//		a crease each vertex with an edge whose two faces meet
+//		at more than the crease angle, as VRML defines it.
+//		Points, if made, get the result as well.
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::smooth_faces ()
+{
+	int i;
+
+	if (normals_given)
+		return;
+
+	printf ("Smoothing %d triangles...\n", n_triangles );
+
+	SmoothJob job;
+	job.mesh = flat;
+	job.adjacency = flatmesh_adjacency (job.mesh);
+	job.cos_crease = cos (crease_angle);
+
+	int n_blocks = (job.mesh->n_vertices + SMOOTH_BLOCK_SIZE - 1) / SMOOTH_BLOCK_SIZE;
+	job.n_creases = (int*) malloc ((n_blocks ? n_blocks : 1) * sizeof(int));
+	if (!job.n_creases)
+		fatal ("Out of memory!");
+	parallel_for (n_blocks, smooth_block, &job);
+
+	int total_points_along_creases = 0;
+	for (i = 0; i < n_blocks; i++)
+		total_points_along_creases += job.n_creases [i];
+	free (job.n_creases);
+
+	if (points)
+		for (i = 0; i < n_points; i++) {
+			const float *normal = flat_normal (flat, i);
+			Point *p = points [i];
+			p->normal_x = normal [0];
+			p->normal_y = normal [1];
+			p->normal_z = normal [2];
+			p->valid_vertex_normal = flat->smooth [i];
+		}
+	printf ("Smoothing found that %d points are along creases (total %d) due to large angles.\n", 
+		total_points_along_creases,
+		n_points);
+}
+
+//---------------------------------------------------------------------------
+// Splitting large triangles. Each face gets a level, the number of times
+// it must be split 1->4 for its pieces to be small enough, and the levels
+// are raised where need be so that faces sharing an edge differ by at
+// most one. Each edge is cut into 2^level pieces for the higher level of
+// its faces, and its points are made once, through the edge table, for
+// all of its faces. A face is split regularly ("red") at its own level;
+// the pieces along an edge that has the extra points of a finer
+// neighbor are split once more ("green"), so that no point of one face
+// lies in the middle of another's edge. The final numbers of points and
+// triangles are known before any is made, and edges and faces are then
+// made in parallel batches.
+//---------------------------------------------------------------------------
+
+#define TINY_BATCH_SIZE (4096)	// Faces or edges per parallel_for call.
+#define TINY_MAX_LEVEL (12)
+#define TINY_KEEP (0xff)	// The level of a face with a repeated vertex.
+
+typedef struct {
+	FlatMesh *mesh;
+	FlatMesh *out;			// The mesh with the pieces, old points first.
+	bool normals_given;
+	double maximum_squared_4;
+	int n_edges;
+	unsigned char *level;		// Per face.
+	unsigned char *edge_level;	// Per edge.
+	int *edge_of;			// Per half-edge, or -1.
+	uint32 *edge_ends;		// Lower and higher vertex of each edge.
+	int *edge_first;		// The first point of each edge.
+	int *face_first;		// The first inner point of each face,
+	int *triangle_first;		// and its first piece.
+} TinyJob;
+
+//---------------------------------------------------------------------------
+// Name:	blend_normal
+// Purpose:	Gives a point made by splitting an edge or a face the
+//		weighted average of the corners' given normals. If any
+//		corner is drawn flat, so is the new point.
+//---------------------------------------------------------------------------
+static void
+blend_normal (FlatMesh *m, int p, const int *corners, const double *weights, int n)
+{
+	double x = 0., y = 0., z = 0.;
+	int i;
+	for (i = 0; i < n; i++) {
+		if (!m->smooth [corners [i]])
+			return;
+		const float *normal = flat_normal (m, corners [i]);
+		x += weights [i] * normal [0];
+		y += weights [i] * normal [1];
+		z += weights [i] * normal [2];
+	}
+
+	double mag = sqrt (x*x + y*y + z*z);
+	if (mag <= 0.)
+		return;
+
+	float *normal = flat_normal (m, p);
+	normal [0] = x / mag;
+	normal [1] = y / mag;
+	normal [2] = z / mag;
+	m->smooth [p] = 1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_point
+// Purpose:	Sets the position of a new point, with no normal yet.
+//---------------------------------------------------------------------------
+static inline void
+tiny_point (FlatMesh *m, int p, double x, double y, double z)
+{
+	float *position = flat_position (m, p);
+	float *normal = flat_normal (m, p);
+	position [0] = x;
+	position [1] = y;
+	position [2] = z;
+	normal [0] = normal [1] = normal [2] = 0.f;
+	m->smooth [p] = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_level_batch
+// Purpose:	Finds the level of one batch of faces for parallel_for.
+//---------------------------------------------------------------------------
+static void
+tiny_level_batch (void *arg, int batch)
+{
+	TinyJob *job = (TinyJob*) arg;
+	FlatMesh *m = job->mesh;
+	int first = batch * TINY_BATCH_SIZE;
+	int last = first + TINY_BATCH_SIZE;
+	if (last > m->n_faces)
+		last = m->n_faces;
+
+	int f;
+	for (f = first; f < last; f++) {
+		const uint32 *v = flat_face (m, f);
+		if (v[0] == v[1] || v[1] == v[2] || v[2] == v[0]) {
+			job->level [f] = TINY_KEEP;
+			continue;
+		}
+
+		const float *p1 = flat_position (m, v[0]);
+		const float *p2 = flat_position (m, v[1]);
+		const float *p3 = flat_position (m, v[2]);
+
+		double v1x = p2[0] - p1[0];
+		double v1y = p2[1] - p1[1];
+		double v1z = p2[2] - p1[2];
+		double v2x = p3[0] - p1[0];
+		double v2y = p3[1] - p1[1];
+		double v2z = p3[2] - p1[2];
+
+		double v3x = v1y * v2z - v1z * v2y;
+		double v3y = v1z * v2x - v1x * v2z;
+		double v3z = v1x * v2y - v1y * v2x;
+
+		// if (0.5 * sqrt(...) >= maximum) as for the
+		// area, where each split quarters the area.
+		//
+		double area = v3x*v3x + v3y*v3y + v3z*v3z;
+		int level = 0;
+		while (area >= job->maximum_squared_4 && level < TINY_MAX_LEVEL) {
+			area /= 16.;
+			level++;
+		}
+		job->level [f] = level;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_edge_batch
+// Purpose:	Makes the points of one batch of edges for parallel_for.
+//---------------------------------------------------------------------------
+static void
+tiny_edge_batch (void *arg, int batch)
+{
+	TinyJob *job = (TinyJob*) arg;
+	FlatMesh *out = job->out;
+	int first = batch * TINY_BATCH_SIZE;
+	int last = first + TINY_BATCH_SIZE;
+	if (last > job->n_edges)
+		last = job->n_edges;
+
+	int e, k;
+	for (e = first; e < last; e++) {
+		int n = 1 << job->edge_level [e];
+		int ends [2];
+		ends [0] = job->edge_ends [2*e];
+		ends [1] = job->edge_ends [2*e+1];
+		const float *p1 = flat_position (out, ends [0]);
+		const float *p2 = flat_position (out, ends [1]);
+
+		for (k = 1; k < n; k++) {
+			double t = (double) k / n;
+			int index = job->edge_first [e] + k - 1;
+			tiny_point (out, index,
+				p1[0] + t * (p2[0] - p1[0]),
+				p1[1] + t * (p2[1] - p1[1]),
+				p1[2] + t * (p2[2] - p1[2]));
+			if (job->normals_given) {
+				double weights [2];
+				weights [0] = 1. - t;
+				weights [1] = t;
+				blend_normal (out, index, ends, weights, 2);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_edge_point
+// Purpose:	Finds the point k/n of the way along half-edge h from
+//		its vertex, where n is a power of two no larger than the
+//		number of pieces of the edge, and 0 < k < n.
+//---------------------------------------------------------------------------
+static inline int
+tiny_edge_point (const TinyJob *job, int h, int k, int n)
+{
+	int e = job->edge_of [h];
+	int n_edge = 1 << job->edge_level [e];
+	k *= n_edge / n;
+	if (job->mesh->indices [h] != job->edge_ends [2*e])
+		k = n_edge - k;
+	return job->edge_first [e] + k - 1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_lattice_point
+// Purpose:	Finds the point of face f split n ways along each edge
+//		that is b steps toward its second vertex and c steps
+//		toward its third from its first.
+//---------------------------------------------------------------------------
+static int
+tiny_lattice_point (const TinyJob *job, int f, int n, int b, int c)
+{
+	const uint32 *v = flat_face (job->mesh, f);
+	int a = n - b - c;
+
+	if (a == n)
+		return v[0];
+	if (b == n)
+		return v[1];
+	if (c == n)
+		return v[2];
+	if (c == 0)
+		return tiny_edge_point (job, 3*f, b, n);
+	if (a == 0)
+		return tiny_edge_point (job, 3*f + 1, c, n);
+	if (b == 0)
+		return tiny_edge_point (job, 3*f + 2, n - c, n);
+
+	// Inner points go by rows b = 1 .. n-2,
+	// each with c = 1 .. n-1-b.
+	int row = (b - 1) * (n - 1) - (b - 1) * b / 2;
+	return job->face_first [f] + row + c - 1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_triangle
+// Purpose:	Makes piece *i of face f.
+//---------------------------------------------------------------------------
+static inline void
+tiny_triangle (TinyJob *job, int f, int *i, int p1, int p2, int p3)
+{
+	flatmesh_set_face (job->out, job->triangle_first [f] + *i, p1, p2, p3);
+	(*i)++;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_piece
+// Purpose:	Makes the pieces of the triangle q, where mid [j], if
+//		not -1, is a point in the middle of the edge from
+//		q [j] to q [j+1]: one piece if there is none, two if
+//		there is one, three if there are two, across the
+//		shorter diagonal, and four if there are three.
+//---------------------------------------------------------------------------
+static void
+tiny_piece (TinyJob *job, int f, int *i, const int *q, const int *mid)
+{
+	int n = (mid[0] != -1) + (mid[1] != -1) + (mid[2] != -1);
+	int j;
+
+	switch (n) {
+	case 0:
+		tiny_triangle (job, f, i, q[0], q[1], q[2]);
+		break;
+
+	case 1:
+		for (j = 0; mid [j] == -1; j++)
+			;
+		tiny_triangle (job, f, i, q[j], mid[j], q[(j+2)%3]);
+		tiny_triangle (job, f, i, mid[j], q[(j+1)%3], q[(j+2)%3]);
+		break;
+
+	case 2: {
+		for (j = 0; mid [(j+2)%3] != -1; j++)
+			;
+		int a = q[j];
+		int b = mid[j];
+		int c = q[(j+1)%3];
+		int d = mid[(j+1)%3];
+		int e = q[(j+2)%3];
+		FlatMesh *out = job->out;
+		tiny_triangle (job, f, i, b, c, d);
+		if (flat_distance (flat_position (out, a), flat_position (out, d)) <=
+		    flat_distance (flat_position (out, b), flat_position (out, e))) {
+			tiny_triangle (job, f, i, a, b, d);
+			tiny_triangle (job, f, i, a, d, e);
+		} else {
+			tiny_triangle (job, f, i, b, d, e);
+			tiny_triangle (job, f, i, a, b, e);
+		}
+		break;
+	}
+
+	default:
+		tiny_triangle (job, f, i, q[0], mid[0], mid[2]);
+		tiny_triangle (job, f, i, mid[0], q[1], mid[1]);
+		tiny_triangle (job, f, i, mid[2], mid[1], q[2]);
+		tiny_triangle (job, f, i, mid[0], mid[1], mid[2]);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	tiny_face_batch
+// Purpose:	Makes the inner points and the pieces of one batch of
+//		faces for parallel_for.
+//---------------------------------------------------------------------------
+static void
+tiny_face_batch (void *arg, int batch)
+{
+	TinyJob *job = (TinyJob*) arg;
+	FlatMesh *m = job->mesh;
+	FlatMesh *out = job->out;
+	int first = batch * TINY_BATCH_SIZE;
+	int last = first + TINY_BATCH_SIZE;
+	if (last > m->n_faces)
+		last = m->n_faces;
+
+	int f, j, b, c;
+	for (f = first; f < last; f++) {
+		int level = job->level [f];
+		if (level == TINY_KEEP)
+			continue;
+
+		bool split [3];
+		for (j = 0; j < 3; j++)
+			split [j] = job->edge_level [job->edge_of [3*f + j]] > level;
+		if (!level && !split[0] && !split[1] && !split[2])
+			continue;
+
+		int n = 1 << level;
+		const uint32 *v = flat_face (m, f);
+		int corners [3];
+		corners [0] = v[0];
+		corners [1] = v[1];
+		corners [2] = v[2];
+		const float *p1 = flat_position (out, v[0]);
+		const float *p2 = flat_position (out, v[1]);
+		const float *p3 = flat_position (out, v[2]);
+
+		//----------------------------------------
+		// Inner points, row by row.
+		//
+		int index = job->face_first [f];
+		for (b = 1; b < n - 1; b++) {
+			for (c = 1; b + c < n; c++) {
+				double weights [3];
+				weights [0] = (double) (n - b - c) / n;
+				weights [1] = (double) b / n;
+				weights [2] = (double) c / n;
+				tiny_point (out, index,
+					weights[0] * p1[0] + weights[1] * p2[0] + weights[2] * p3[0],
+					weights[0] * p1[1] + weights[1] * p2[1] + weights[2] * p3[1],
+					weights[0] * p1[2] + weights[1] * p2[2] + weights[2] * p3[2]);
+				if (job->normals_given)
+					blend_normal (out, index, corners, weights, 3);
+				index++;
+			}
+		}
+
+		//----------------------------------------
+		// Each step (b,c) has an upward piece,
+		// which may lie along an edge of the face,
+		// and but for the last one in its row a
+		// downward piece, which cannot.
+		//
+		int i = 0;
+		for (b = 0; b < n; b++) {
+			for (c = 0; b + c < n; c++) {
+				int q [3], mid [3];
+				q [0] = tiny_lattice_point (job, f, n, b, c);
+				q [1] = tiny_lattice_point (job, f, n, b + 1, c);
+				q [2] = tiny_lattice_point (job, f, n, b, c + 1);
+				mid [0] = c == 0 && split [0] ?
+					tiny_edge_point (job, 3*f, 2*b + 1, 2*n) : -1;
+				mid [1] = b + c == n - 1 && split [1] ?
+					tiny_edge_point (job, 3*f + 1, 2*c + 1, 2*n) : -1;
+				mid [2] = b == 0 && split [2] ?
+					tiny_edge_point (job, 3*f + 2, 2*(n - c - 1) + 1, 2*n) : -1;
+				tiny_piece (job, f, &i, q, mid);
+
+				if (b + c < n - 1)
+					tiny_triangle (job, f, &i,
+						q [1],
+						tiny_lattice_point (job, f, n, b + 1, c + 1),
+						q [2]);
+			}
+		}
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	IndexedFaceSet::ensure_tiny_triangles
+// Purpose:	Splits the triangles larger than maximum, and those
+//		around them as need be to leave no T-junctions, into
+//		pieces that are not.
+//---------------------------------------------------------------------------
+void
+IndexedFaceSet::ensure_tiny_triangles (double maximum)
+{
+	int f, h, e;
+
+	TinyJob job;
+	job.mesh = flat;
+	job.normals_given = normals_given;
+	job.maximum_squared_4 = 4. * maximum * maximum; // to avoid sqrt().
+
+	int nf = job.mesh->n_faces;
+	int nh = 3 * nf;
+	int n_batches = (nf + TINY_BATCH_SIZE - 1) / TINY_BATCH_SIZE;
+
+	//----------------------------------------
+	// Most meshes have no triangle that is
+	// too large, which the levels show.
+	//
+	job.level = (unsigned char*) malloc (nf ? nf : 1);
+	if (!job.level)
+		fatal ("Out of memory!");
+	parallel_for (n_batches, tiny_level_batch, &job);
+
+	for (f = 0; f < nf; f++)
+		if (job.level [f] && job.level [f] != TINY_KEEP)
+			break;
+	if (f == nf) {
+		free (job.level);
+		return;
+	}
+
+	//----------------------------------------
+	// Scratch: per half-edge, at most as many
+	// edges; per face, plus one.
+	//
+	unsigned long scratch_size = (unsigned long) nh * (2 * sizeof(int) + 2 * sizeof(uint32) + 1)
+		+ 2 * (nf + 1) * sizeof(int);
+	char *scratch = (char*) malloc (scratch_size);
+	if (!scratch)
+		fatal ("Out of memory!");
+	job.edge_of = (int*) scratch;
+	job.edge_first = job.edge_of + nh;
+	job.face_first = job.edge_first + nh;
+	job.triangle_first = job.face_first + nf + 1;
+	job.edge_ends = (uint32*) (job.triangle_first + nf + 1);
+	job.edge_level = (unsigned char*) (job.edge_ends + 2 * nh);
+
+	job.n_edges = flatmesh_edges (job.mesh, job.edge_of, job.edge_ends);
+
+	//----------------------------------------
+	// An edge takes the higher level of its
+	// faces. A face more than one level below
+	// one of its edges is raised, until none
+	// is.
+	//
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		memset (job.edge_level, 0, job.n_edges);
+		for (h = 0; h < nh; h++) {
+			int level = job.level [h / 3];
+			e = job.edge_of [h];
+			if (e >= 0 && level != TINY_KEEP && level > job.edge_level [e])
+				job.edge_level [e] = level;
+		}
+		for (h = 0; h < nh; h++) {
+			int level = job.level [h / 3];
+			e = job.edge_of [h];
+			if (e >= 0 && level != TINY_KEEP && job.edge_level [e] > level + 1) {
+				job.level [h / 3] = job.edge_level [e] - 1;
+				changed = true;
+			}
+		}
+	}
+
+	//----------------------------------------
+	// Number the new points and the pieces,
+	// so that each batch knows where to put
+	// its own.
+	//
+	unsigned long total_points = n_points;
+	for (e = 0; e < job.n_edges; e++) {
+		job.edge_first [e] = total_points;
+		total_points += (1UL << job.edge_level [e]) - 1;
+	}
+
+	unsigned long total_triangles = 0;
+	unsigned long n_pieces = 0;
+	int n_split = 0;
+	for (f = 0; f < nf; f++) {
+		int level = job.level [f];
+		job.face_first [f] = total_points;
+		job.triangle_first [f] = total_triangles;
+		if (level == TINY_KEEP) {
+			total_triangles++;
+			continue;
+		}
+
+		unsigned long n = 1UL << level;
+		int n_mid = 0;
+		for (h = 3 * f; h < 3 * f + 3; h++)
+			n_mid += job.edge_level [job.edge_of [h]] > level;
+		if (!level && !n_mid) {
+			total_triangles++;
+			continue;
+		}
+
+		n_split++;
+		total_points += (n - 1) * (n - 2) / 2;
+		total_triangles += n * n + n * n_mid;
+		n_pieces += n * n + n * n_mid;
+	}
+	job.triangle_first [nf] = total_triangles;
+
+	if (total_points > INT_MAX || total_triangles > INT_MAX) {
+		warning ("Triangles are too large to be split.");
+		free (scratch);
+		free (job.level);
+		return;
+	}
+
+	//----------------------------------------
+	// The new mesh starts with the old points.
+	// A face that is kept, which alone has one
+	// piece, moves to its new place.
+	//
+	job.out = flatmesh_copy (job.mesh, total_points, total_triangles);
+	job.out->n_vertices = total_points;
+	job.out->n_faces = total_triangles;
+
+	for (f = 0; f < nf; f++) {
+		int t = job.triangle_first [f];
+		if (job.triangle_first [f + 1] != t + 1)
+			continue;
+		memcpy (flat_face (job.out, t), flat_face (job.mesh, f), 3 * sizeof(uint32));
+		memcpy (flat_face_normal (job.out, t), flat_face_normal (job.mesh, f), 3 * sizeof(float));
+		job.out->face_areas [t] = job.mesh->face_areas [f];
+	}
+
+	//----------------------------------------
+	// Edge points first, since the faces
+	// share them.
+	//
+	parallel_for ((job.n_edges + TINY_BATCH_SIZE - 1) / TINY_BATCH_SIZE, tiny_edge_batch, &job);
+	parallel_for (n_batches, tiny_face_batch, &job);
+
+	printf ("Split %d large triangles into %lu, with %lu new points.\n",
+		n_split, n_pieces, total_points - n_points);
+
+	drop_objects ();
+	flatmesh_free (flat);
+	flat = job.out;
+	n_points = total_points;
+	n_triangles = total_triangles;
+
+	free (scratch);
+	free (job.level);
+}
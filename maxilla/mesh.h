@@ -0,0 +1,137 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _MESH_H
+#define _MESH_H
+
+class CRenderContext;
+struct Bvh;
+
+/*===========================================================================
+ * Name:	MeshAdjacency
+ * Purpose:	The connectivity of a FlatMesh. Half-edge h of face
+ *		h/3 runs from the vertex of corner h to that of the
+ *		next corner of the face, so that half-edges are
+ *		numbered as the corners in indices are.
+ *		An edge shared by two faces pairs their half-edges as
+ *		twins. An edge of only one face is on a boundary. An
+ *		edge of three or more faces pairs the first two and
+ *		leaves the rest on no boundary and with no twin.
+ */
+typedef struct {
+	int n_halfedges;
+	int *twin;		// Per half-edge, or -1.
+	int *ring_start;	// Per vertex, plus one more.
+	int *ring;		// The corners of each vertex, from ring_start.
+	unsigned char *on_boundary;	// Per half-edge.
+	int n_boundary_edges;
+	int n_nonmanifold_edges;
+	unsigned long size;
+} MeshAdjacency;
+
+/*===========================================================================
+ * Name:	FlatMesh
+ * Purpose:	The mesh of an IndexedFaceSet, laid out as contiguous
+ *		arrays rather than as one Point and one Triangle per
+ *		allocation. All of the arrays live in one block of size
+ *		bytes, with room for vertices_size vertices and
+ *		faces_size faces, so that a parser can add to it.
+ */
+typedef struct {
+	int n_vertices;
+	int n_faces;
+	int vertices_size;
+	int faces_size;
+	float *positions;	// x, y, z per vertex.
+	float *normals;		// Smoothed x, y, z per vertex.
+	uint32 *indices;	// Three vertices per face.
+	float *face_normals;	// x, y, z per face.
+	float *face_areas;
+	unsigned char *smooth;	// Per vertex: normal is valid, not on a crease.
+	unsigned long size;
+	MeshAdjacency *adjacency;	// Made on demand, freed with the mesh.
+	struct Bvh *bvh;		// Likewise.
+} FlatMesh;
+
+extern FlatMesh *flatmesh_new (int n_vertices, int n_faces);
+extern FlatMesh *flatmesh_grow (FlatMesh *, int vertices_size, int faces_size);
+extern void flatmesh_set_face (FlatMesh *, int face, uint32 a, uint32 b, uint32 c);
+extern void flatmesh_free (FlatMesh *);
+extern void flatmesh_express (FlatMesh *, CRenderContext *);
+
+extern MeshAdjacency *flatmesh_adjacency (FlatMesh *);
+extern void flatmesh_drop_adjacency (FlatMesh *);
+extern int mesh_one_ring (const FlatMesh *, const MeshAdjacency *, int vertex,
+	int *neighbors, int max);
+extern int mesh_boundary_loops (const FlatMesh *, const MeshAdjacency *, int *edges);
+extern int flatmesh_edges (const FlatMesh *, int *edge_of, uint32 *edge_ends);
+extern void flatmesh_smooth (FlatMesh *, double crease_angle);
+
+static inline float *
+flat_position (const FlatMesh *m, int vertex)
+{
+	return m->positions + 3 * vertex;
+}
+
+static inline float *
+flat_normal (const FlatMesh *m, int vertex)
+{
+	return m->normals + 3 * vertex;
+}
+
+static inline uint32 *
+flat_face (const FlatMesh *m, int face)
+{
+	return m->indices + 3 * face;
+}
+
+static inline float *
+flat_face_normal (const FlatMesh *m, int face)
+{
+	return m->face_normals + 3 * face;
+}
+
+static inline bool
+flat_face_smooth (const FlatMesh *m, int face)
+{
+	const uint32 *v = m->indices + 3 * face;
+	return m->smooth [v[0]] && m->smooth [v[1]] && m->smooth [v[2]];
+}
+
+static inline int
+halfedge_next (int h)
+{
+	return h % 3 == 2 ? h - 2 : h + 1;
+}
+
+static inline int
+halfedge_prev (int h)
+{
+	return h % 3 == 0 ? h + 2 : h - 1;
+}
+
+// The vertex that half-edge h leaves; halfedge_next gives the other.
+static inline int
+halfedge_vertex (const FlatMesh *m, int h)
+{
+	return m->indices [h];
+}
+
+#endif
@@ -0,0 +1,288 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <locale.h>
+#include <ctype.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "numbers.h"
+
+
+// Powers of ten that a double holds exactly.
+static const double exact_powers_of_ten [23] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define MAX_MANTISSA_DIGITS (19)	// Always fits in 64 bits.
+#define MAX_EXACT_MANTISSA (((uint64) 1) << 53)
+
+//---------------------------------------------------------------------------
+// Name:	slow_parse_double
+// Purpose:	Converts a number that the fast path cannot round exactly,
+//		using strtod() on a copy whose decimal point is that of
+//		the current locale.
+//---------------------------------------------------------------------------
+static double
+slow_parse_double (const char *s, int len)
+{
+	char small [64];
+	char *buf = small;
+	if (len >= (int) sizeof (small)) {
+		buf = (char*) malloc (len + 1);
+		if (!buf)
+			fatal ("Out of memory!");
+	}
+
+	char point = '.';
+	struct lconv *lc = localeconv ();
+	if (lc && lc->decimal_point && lc->decimal_point[0])
+		point = lc->decimal_point[0];
+
+	for (int i = 0; i < len; i++)
+		buf[i] = s[i] == '.' ? point : s[i];
+	buf[len] = 0;
+
+	double value = strtod (buf, NULL);
+
+	if (buf != small)
+		free (buf);
+	return value;
+}
+
+//---------------------------------------------------------------------------
+// Name:	vrml_parse_double
+// Purpose:	Parses [+-]digits[.digits][(e|E)[+-]digits]. Up to 19
+//		significant digits are gathered into a 64-bit integer;
+//		when that is at most 2^53 and the decimal exponent is
+//		at most 22 in magnitude, one multiply or divide by an
+//		exact power of ten gives the correctly rounded result.
+//		Anything else goes to strtod().
+// Returns:	Number of characters used, 0 if there is no number.
+//---------------------------------------------------------------------------
+int
+vrml_parse_double (const char *s, int len, double *value_return)
+{
+	if (!s || len <= 0 || !value_return)
+		return 0;
+
+	const char *p = s;
+	const char *end = s + len;
+
+	bool negative = false;
+	if (*p == '-' || *p == '+')
+		negative = *p++ == '-';
+
+	uint64 mantissa = 0;
+	int n_digits = 0;
+	int exponent = 0;
+	bool any_digits = false;
+	bool inexact = false;
+
+	while (p < end && *p >= '0' && *p <= '9') {
+		int digit = *p++ - '0';
+		any_digits = true;
+		if (!mantissa && !digit)
+			continue;
+		if (n_digits < MAX_MANTISSA_DIGITS) {
+			mantissa = 10 * mantissa + digit;
+			n_digits++;
+		} else {
+			exponent++;
+			if (digit)
+				inexact = true;
+		}
+	}
+
+	if (p < end && *p == '.') {
+		p++;
+		while (p < end && *p >= '0' && *p <= '9') {
+			int digit = *p++ - '0';
+			any_digits = true;
+			if (!mantissa && !digit) {
+				exponent--;
+				continue;
+			}
+			if (n_digits < MAX_MANTISSA_DIGITS) {
+				mantissa = 10 * mantissa + digit;
+				n_digits++;
+				exponent--;
+			} else if (digit)
+				inexact = true;
+		}
+	}
+
+	if (!any_digits)
+		return 0;
+
+	//----------------------------------------
+	// The exponent is only used if it has
+	// digits, as with strtod().
+	//
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char *q = p + 1;
+		bool negative_exponent = false;
+		if (q < end && (*q == '-' || *q == '+'))
+			negative_exponent = *q++ == '-';
+		if (q < end && *q >= '0' && *q <= '9') {
+			int e = 0;
+			while (q < end && *q >= '0' && *q <= '9') {
+				if (e < 100000)
+					e = 10 * e + (*q - '0');
+				q++;
+			}
+			exponent += negative_exponent ? -e : e;
+			p = q;
+		}
+	}
+
+	int used = p - s;
+
+	if (!mantissa)
+		*value_return = negative ? -0.0 : 0.0;
+	else if (!inexact && mantissa <= MAX_EXACT_MANTISSA &&
+		 exponent >= -22 && exponent <= 22) {
+		double value = (double) (int64) mantissa;
+		if (exponent < 0)
+			value /= exact_powers_of_ten [-exponent];
+		else
+			value *= exact_powers_of_ten [exponent];
+		*value_return = negative ? -value : value;
+	}
+	else
+		*value_return = slow_parse_double (s, used);
+
+	return used;
+}
+
+//---------------------------------------------------------------------------
+// Name:	vrml_parse_int
+// Purpose:	Parses [+-]digits, saturating at the limits of an int.
+// Returns:	Number of characters used, 0 if there is no number.
+//---------------------------------------------------------------------------
+int
+vrml_parse_int (const char *s, int len, int *value_return)
+{
+	if (!s || len <= 0 || !value_return)
+		return 0;
+
+	const char *p = s;
+	const char *end = s + len;
+
+	bool negative = false;
+	if (*p == '-' || *p == '+')
+		negative = *p++ == '-';
+
+	const char *digits = p;
+	int64 value = 0;
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (value <= 0x80000000LL)
+			value = 10 * value + (*p - '0');
+		p++;
+	}
+
+	if (p == digits)
+		return 0;
+
+	if (negative)
+		value = -value;
+	if (value > 0x7fffffffLL)
+		value = 0x7fffffffLL;
+	else if (value < -0x80000000LL)
+		value = -0x80000000LL;
+
+	*value_return = (int) value;
+	return p - s;
+}
+
+//---------------------------------------------------------------------------
+// Name:	vrml_atof
+//---------------------------------------------------------------------------
+double
+vrml_atof (const char *s, int len)
+{
+	double value = 0.0;
+	if (!vrml_parse_double (s, len, &value))
+		return 0.0;
+	return value;
+}
+
+//---------------------------------------------------------------------------
+// Name:	vrml_atoi
+//---------------------------------------------------------------------------
+int
+vrml_atoi (const char *s, int len)
+{
+	int value = 0;
+	if (!vrml_parse_int (s, len, &value))
+		return 0;
+	return value;
+}
+
+//---------------------------------------------------------------------------
+// Name:	vrml_list_value
+//---------------------------------------------------------------------------
+int
+vrml_list_value (const char *word, int len, bool is_number, bool integer,
+	double *value_return)
+{
+	char ch = *word;
+	if (ch == ',')
+		return 0;
+
+	if (!is_number && ch != '-' && !isdigit (ch)) {
+		printf ("Problematic array datum %.*s\n", len, word);
+		return 0;
+	}
+
+	//----------------------------------------
+	// Indices are parsed as integers unless
+	// they are written e.g. as "3.0".
+	//
+	if (integer) {
+		int value;
+		int used = vrml_parse_int (word, len, &value);
+		if (!is_number || VRML_NUMBER_IS_WHOLE_WORD (word, len, used))
+			*value_return = used ? value : 0;
+		else
+			*value_return = (float) vrml_atof (word, len);
+	}
+	else if (is_number)
+		*value_return = (float) vrml_atof (word, len);
+	else
+		*value_return = vrml_atof (word, len);
+	return 1;
+}
@@ -0,0 +1,58 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _NUMBERS_H
+#define _NUMBERS_H
+
+/*===========================================================================
+ * Name:	vrml_parse_double, vrml_parse_int
+ * Purpose:	Convert the number at the start of a VRML word without
+ *		regard to the C locale, which atof() and sscanf() obey.
+ *		Doubles are correctly rounded, so that a value written
+ *		with %.17g reads back exactly.
+ * Returns:	Number of characters used, 0 if there is no number.
+ */
+extern int vrml_parse_double (const char *s, int len, double *value_return);
+extern int vrml_parse_int (const char *s, int len, int *value_return);
+
+/*===========================================================================
+ * Name:	vrml_atof, vrml_atoi
+ * Purpose:	Drop-in replacements for atof() and atoi(): any text
+ *		after the number, such as a trailing comma, is ignored.
+ */
+extern double vrml_atof (const char *s, int len);
+extern int vrml_atoi (const char *s, int len);
+
+/*===========================================================================
+ * Name:	vrml_list_value
+ * Purpose:	Converts one word of a point or coordIndex list, given
+ *		whether the tokenizer considers it a number. Commas and
+ *		words that are not numbers are skipped.
+ * Returns:	1 for a value, 0 for a skipped word.
+ */
+extern int vrml_list_value (const char *word, int len, bool is_number,
+	bool integer, double *value_return);
+
+// True if the word is exactly a number, optionally followed by one comma.
+#define VRML_NUMBER_IS_WHOLE_WORD(S,LEN,USED) \
+	((USED) > 0 && ((USED) == (LEN) || ((USED) == (LEN)-1 && (S)[USED] == ',')))
+
+#endif
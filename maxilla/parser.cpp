@@ -1,1517 +1,2269 @@
-/*=============================================================================
-// Maxilla, an OpenGL-based program for viewing dentistry-related VRML & STL.
-// Copyright (C) 2008-2010 by Zack T Smith and Ortho Cast Inc.
-//
-// This program is free software; you can redistribute it and/or modify
-// it under the terms of the GNU General Public License version 2 
-// as published by the Free Software Foundation.
-//
-// This program is distributed in the hope that it will be useful,
-// but WITHOUT ANY WARRANTY; without even the implied warranty of
-// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-// GNU General Public License for more details.
-//
-// You should have received a copy of the GNU General Public License
-// along with this program; if not, write to the Free Software
-// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
-//
-// The author may be reached at fbui@comcast.net.
-//============================================================================*/
-
-#ifdef WIN32
-	#include <windows.h>
-	#define _USE_MATH_DEFINES
-#endif
-
-#include <string.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <math.h>
-
-#include "defs.h"
-
-// zlib.h is read in maxilla.h 
-
-#ifdef WIN32
-#include "stdafx.h"
-#endif
-
-#include "quat.h"
-#include "maxilla.h"
-
-extern "C" {
-#include "BMP.h"
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_worldinfo
-// Purpose:	Parser for WorldInfo construct.
-//---------------------------------------------------------------------------
-void
-model_parse_worldinfo (Model *m, const InputWord *w)
-{
-	w = w->next;
-	w = w->children;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("title", s)) {
-			w = w->next;
-			m->title = w->str;
-		}
-		else if (!strcmp("info", s)) {
-			w = w->next;
-		}
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_material
-// Purpose:	Parser for material construct, that stores these data
-//		in the Shape object.
-// Returns:	# of words for caller to skip.
-//---------------------------------------------------------------------------
-int
-model_parse_material (Model *m, Appearance *appearance, const InputWord *w)
-{
-	int nwords = 3; // material Material {
-	char *s;
-	char *name=NULL;
-	Material *material = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	s = w->str;
-
-	if (!strcmp(s, "DEF")) {
-		w = w->next;
-		name = w->str;
-		material = new Material ();
-		m->add_name_mapping (name, material);
-		appearance->material = material;
-		w = w->next;
-		s = w->str;
-		nwords += 2;
-	}
-
-	if (strcmp(s, "Material")) {
-		warning ("VRML material construct lacks Material{ }.");
-	}
-	w = w->next;
-	w = w->children;
-
-	if (!material) {
-		material = new Material ();
-		appearance->material = material;
-	}
-
-	while (w) {
-		s = w->str;
-		if (!strcmp("shininess", s)) {
-			float tmp;
-			w = w->next;
-			tmp = w->value;
-			if (tmp < 0.0f)
-				tmp = 0.0f;
-			if (tmp > 100.0f)
-				tmp = 100.0f;
-			material->shininess = tmp;
-		}
-		else if (!strcmp("diffuseColor", s)) {
-			w = w->next;
-			material->diffuseColor[0] = (GLfloat) w->value; 
-			w = w->next;
-			material->diffuseColor[1] = (GLfloat) w->value; 
-			w = w->next;
-			material->diffuseColor[2] = (GLfloat) w->value;
-		} 
-		else if (!strcmp("ambientIntensity", s)) {
-			w = w->next;
-			material->ambientIntensity = w->value; 
-		}
-		else if (!strcmp("specularColor", s)) {
-			w = w->next;
-			material->specularColor[0] = (GLfloat) w->value; 
-			w = w->next;
-			material->specularColor[1] = (GLfloat) w->value; 
-			w = w->next;
-			material->specularColor[2] = (GLfloat) w->value;
-		}
-		else if (!strcmp("emissiveColor", s)) {
-			w = w->next;
-			material->emissiveColor[0] = (GLfloat) w->value; 
-			w = w->next;
-			material->emissiveColor[1] = (GLfloat) w->value; 
-			w = w->next;
-			material->emissiveColor[2] = (GLfloat) w->value;
-		}
-		w = w->next;
-	}
-
-	return nwords;
-}
-
-void model_parse_use (Model *m, Node *parent, const InputWord *w, char *name);
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_appearance
-// Purpose:	Parser for appearance construct.
-//---------------------------------------------------------------------------
-void
-model_parse_appearance (Model *m, Shape *parent, const InputWord *w)
-{
-	char *name = NULL;
-	char *s;
-	Appearance *appearance = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	s = w->str;
-	if (!strcmp (s, "DEF")) {
-		w = w->next;
-		name = w->str;
-		appearance = new Appearance ();
-		m->add_name_mapping (name, appearance);
-		w = w->next;
-		s = w->str;
-	}
-	if (!strcmp(s, "USE")) { // e.g. appearance USE Felt
-		w = w->next;
-		s = w->str;
-		Node *n = m->lookup_node_by_name (s);
-		if (!strcmp (n->type, "Appearance"))
-			parent->appearance = (Appearance*) n;
-		else {
-			char tmp[1000];
-#ifdef WIN32
-			sprintf_s (tmp,999, "Name %s was expected to refer to Appearance, but is %s.",
-				s, n->type);
-#else
-			sprintf (tmp,"Name %s was expected to refer to Appearance, but is %s.",
-				s, n->type);
-#endif
-			warning (tmp);
-		}
-		return;
-	}
-	if (strcmp (s, "Appearance")) {
-		warning ("VRML appearance construct missing Appearance{ }.");
-		warning (s);
-		return;
-	}
-
-	// If we're not creating a named Appearance,
-	// create an unnamed one.
-	//
-	if (!appearance) {
-		appearance = new Appearance ();
-	}
-	if (!parent->appearance)
-		parent->appearance = appearance;
-	
-	w = w->next;
-	w = w->children;
-
-	while (w) {
-		s = w->str;
-		if (!strcmp (s, "material")) {
-			if (model_parse_material (m, appearance, w) > 3) {
-				w = w->next;
-				w = w->next;
-			}
-			w = w->next;
-			w = w->next;
-		} else 
-		if (!strcmp (s, "texture")) {
-			printf ("Ignoring texture.\n");
-			w = w->next;
-			w = w->next;
-		} else 
-		if (!strcmp (s, "textureTransform")) {
-			printf ("Ignoring textureTransform.\n");
-			w = w->next;
-			w = w->next;
-		} else {
-			warning ("Unknown node type in Appearance.");
-			warning(s);
-		}
-		w = w->next;
-
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_use
-// Purpose:	Parser for the USE construct.
-//---------------------------------------------------------------------------
-void
-model_parse_use (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Replicated *r;
-	char *use_name;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	use_name = w->str;
-	r = new Replicated (m, use_name);
-	r->parent = parent;
-	parent->add_child(r);
-	if (name)
-		m->add_name_mapping (name, r->original);
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_sphere
-// Purpose:	Parser for Sphere construct (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_sphere (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Sphere *sphere;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	sphere = new Sphere ();
-	sphere->parent = parent;
-	if (!strcmp (parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (sphere);
-
-	if (name)
-		m->add_name_mapping (name, sphere);
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "radius")) {
-			w = w->next;
-			sphere->radius = w->value;
-		}
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_cylinder
-// Purpose:	Parser for Cylinder construct (child of Shape, Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_cylinder (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Cylinder *cylinder;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	cylinder = new Cylinder();
-	cylinder->parent = parent;
-	if (!strcmp (parent->type, "Cylinder"))
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (cylinder);
-
-	if (name)
-		m->add_name_mapping (name, cylinder);
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "radius")) {
-			w = w->next;
-			cylinder->radius = w->value;
-		}
-		else if (!strcmp(s, "height")) {
-			w = w->next;
-			cylinder->height = w->value;
-		}
-		else if (!strcmp(s, "top")) {
-			w = w->next;
-			cylinder->top = tolower(w->str[0]) == 't';
-		}
-		else if (!strcmp(s, "bottom")) {
-			w = w->next;
-			cylinder->top = tolower(w->str[0]) == 't';
-		}
-		else if (!strcmp(s, "side")) {
-			w = w->next;
-			cylinder->top = tolower(w->str[0]) == 't';
-		}
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_box
-// Purpose:	Parser for Box construct (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_box (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Box *box;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	box = new Box();
-	box->parent = parent;
-	if (!strcmp (parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (box);
-
-	if (name)
-		m->add_name_mapping (name, box);
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "size")) {
-			w = w->next;
-			box->size = w->value;
-		}
-		w = w->next;
-	}
-}
-
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_text
-// Purpose:	Parser for Text construct (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_text (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Text *text;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	text = new Text ();
-	text->parent = parent;
-	if (!strcmp (parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (text);
-
-	if (name)
-		m->add_name_mapping (name, text);
-
-	text->name = name;
-	text->text = "";
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "string")) {
-
-			w = w->next;
-			if (!w)	// Sometimes string is followed by nothing.
-				break;
-
-			text->text = w->str;
-
-			// Dentistry-specific strings.
-			if (name) {
-				if (!strncmp (name, "PatientFirstName", 16))
-					m->patient_firstname = w->str;
-				else if (!strncmp (name, "PatientLastName", 15))
-					m->patient_lastname = w->str;
-				else if (!strncmp (name, "Age", 3))
-					m->patient_birthdate = w->str;
-				else if (!strncmp (name, "CaseNumber", 10))
-					m->case_number = w->str;
-				else if (!strncmp (name, "CaseDate", 8))
-					m->case_date = w->str;
-				else if (!strncmp (name, "ControlNumber", 13))
-					m->control_number = w->str;
-				else if (!strncmp (name, "TopAndBottomAligned", 19))
-				{
-					m->isTopAndBottomAligned = !strncmp (w->str, "true", 4);
-				}				
-			}
-		}
-		w = w->next;
-	}
-}
-
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_cone
-// Purpose:	Parser for Cone construct (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_cone (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Cone *cone;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	cone = new Cone ();
-	cone->parent = parent;
-	if (!strcmp (parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (cone);
-
-	if (name)
-		m->add_name_mapping (name, cone);
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp (s, "bottomRadius")) {
-			w = w->next; 
-			if (w->str[0] == '#')
-				cone->radius = w->value;
-			else
-				; // XX
-		}
-		else if (!strcmp (s, "height")) {
-			w = w->next; 
-			if (w->str[0] == '#')
-				cone->height = w->value;
-			else 
-				; // XX
-		}
-		w = w->next;
-	}
-}
-
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_indexedlineset
-// Purpose:	Parser for IndexedLineSet (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_indexedlineset (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	IndexedLineSet *ils = new IndexedLineSet ();
-	char *name2 = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("color", s)) {
-			w = w->next; 		
-			if (strcmp(w->str, "Color")) {
-				warning ("VRML IndexedLineSet construct has problematic Color section.");
-				delete ils;
-				return;
-			}
-			w = w->next;
-			if (w && w->children) {
-				InputWord *w2 = w->children;
-				if (strcmp (w2->str, "color")) {
-					warning ("VRML IndexedLineSet construct has problematic color section.");
-					delete ils;
-					return;
-				}
-				w2 = w2->next;
-				w2 = w2->children;
-				ils->n_colors = 0;
-				while (w2) {
-					if (w2->str[0] == '#')
-						ils->colors [ils->n_colors++] = 
-							w2->value;
-					if (ils->n_colors >= ils->colors_size)
-						ils->expand_colors ();
-					w2 = w2->next;
-				}
-				printf ("IndexedLineSet: read %d color values\n", ils->n_colors);
-			}
-		}
-		else if (!strcmp("colorPerVertex", s)) {
-			w = w->next; 
-			if (tolower(w->str[0]) == 't')
-				ils->color_per_vertex = true;
-		}
-		else if (!strcmp ("coord", s)) {
-			w = w->next;
-			if (!strcmp(w->str, "DEF")) {
-				w = w->next;
-				name2 = w->str;
-				w = w->next;
-			}
-			if (strcmp(w->str, "Coordinate")) {
-				warning ("VRML IndexedLineSet construct has problematic coord section.");
-				delete ils;
-				return;
-			}
-			w = w->next;
-
-			// Let's read the data here rather than in another function.
-			InputWord *w2 = w->children;
-			s = w2->str;
-			if (strcmp("point", s)) {
-				warning ("VRML IndexedLineSet has problematic point list.");
-				delete ils;
-				return;
-			}
-			w2 = w2->next;
-			w2 = w2->children;
-
-			// Fetch point coordinates in sets of 3 floats.
-			float values[3];
-			int total = 0;
-			while (w2) {
-				char ch = *w2->str;
-				if (ch == ',') {
-					w2 = w2->next;
-					continue;
-				}
-				if (ch == '#' || ch=='-' || isdigit (ch)) {
-					values[total++] = ch=='#' ? w2->value
-						: (float) atof (w2->str);
-					w2 = w2->next;
-
-					if (total >= 3) {
-						Point *p = Point_new (values[0],
-							values[1], values[2]);
-						total = 0;
-
-						if (ils->n_points >= 
-						    ils->points_size)
-							ils->expand_points();
-						ils->points[ils->n_points++]=p;
-					}
-				} else {
-					printf ("Problematic IndexedLineSet datum %s\n", w2->str);
-					w2 = w2->next;
-				}
-
-			}
-//			printf ("Got %d points\n", ils->n_points);
-		}
-		else if (!strcmp ("coordIndex", s)) {
-			w = w->next;
-
-			// Each datum that we read is an index into 
-			// the points array.
-			//
-			InputWord *w2 = w->children;
-			int value;
-			int total_read = 0;
-			ils->polyline = NULL;
-			ils->last_poly = NULL;
-			while (w2) {
-				char ch = *w2->str;
-				if (ch == ',') {
-					w2 = w2->next;
-					continue;
-				}
-				else
-				if (ch == '#' || ch=='-' || isdigit (ch)) {
-					value = ch=='#' ? ((int) w2->value) 
-							: atoi(w2->str);
-					w2 = w2->next;
-
-					if (value<0 || value >= ils->n_points) {
-						warning("VRML IndexedLineSet has invalid coordIndex index value (s).");
-						delete ils;
-						return;
-					}
-
-					// The value is just an index into the
-					// array of points. So now we obtain the
-					// point and make a polyline segment 
-					// out of it.
-					//
-					Point *p = ils->points[value];
-					PolyLine *pl = new PolyLine (p);
-
-					if (p->x < ils->minx)
-						ils->minx = p->x;
-					if (p->x > ils->maxx)
-						ils->maxx = p->x;
-					if (p->y < ils->miny)
-						ils->miny = p->y;
-					if (p->y > ils->maxy)
-						ils->maxy = p->y;
-					if (p->z < ils->minz)
-						ils->minz = p->z;
-					if (p->z > ils->maxz)
-						ils->maxz = p->z;
-
-					if (!ils->polyline)
-						ils->polyline = pl;
-					else 
-						ils->last_poly->next = pl;
-					ils->last_poly = pl;
-
-					if (ils->color_per_vertex) {
-						int i;
-						for (i=0; i<3; i++) 
-							pl->color[i] = ils->colors[total_read*3+i];
-						pl->color[3] = 1.0f;
-					}
-					total_read++;
-
-				} else {
-					printf ("Problematic IndexedLineSet array value: '%s'\n", w2->str);
-					w2=w2->next;
-				}
-			}
-//			printf ("Got %d triangles\n", ils->n_triangles);
-		} else {
-			printf ("Artifact in IndexedLinesSet: %s\n", w->str);
-		}
-		w = w->next;
-	}
-
-	// If parent is a shape we set our node as its geometry.
-	ils->parent = parent;
-	if (!strcmp(parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (ils);
-	if (name)
-		m->add_name_mapping(name,ils);
-}
-
-
-class IndexedFaceSet;
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_indexedfaceset
-// Purpose:	Parser for IndexedFaceSet (child of Shape or Separator).
-//---------------------------------------------------------------------------
-void
-model_parse_indexedfaceset (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	IndexedFaceSet *ifs = new IndexedFaceSet ();
-	char *name2 = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-
-	ifs->maxx = ifs->maxy = ifs->maxz = -999999;
-	ifs->minx = ifs->miny = ifs->minz = 999999;
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("solid", s)) {
-			w = w->next;
-		}
-		else if (!strcmp ("coord", s)) {
-			w = w->next;
-			if (!strcmp(w->str, "DEF")) {
-				w = w->next;
-				name2 = w->str;
-				w = w->next;
-			}
-			if (strcmp(w->str, "Coordinate")) {
-				warning ("VRML IndexedFaceSet construct has problematic coord section.");
-				delete ifs;
-				return;
-			}
-			w = w->next;
-
-			// Let's read the data here rather than in another function.
-			InputWord *w2 = w->children;
-			s = w2->str;
-			if (strcmp("point", s)) {
-				warning ("VRML IndexedFaceSet has problematic point list.");
-				delete ifs;
-				return;
-			}
-			w2 = w2->next;
-			w2 = w2->children;
-
-			// Fetch point coordinates in sets of 3 floats.
-			double values[3];
-			int total = 0;
-			while (w2) {
-				char ch = *w2->str;
-				if (ch == ',') {
-					w2 = w2->next;
-					continue;
-				}
-				if (ch == '#' || ch=='-' || isdigit (ch)) {
-					values[total++] = ch=='#' ? w2->value : (double) atof (w2->str);
-					w2 = w2->next;
-
-					if (total >= 3) {
-						Point *p = Point_new (values[0], values[1], values[2]);
-						total = 0;
-
-						if (ifs->n_points >= ifs->points_size)
-							ifs->expand_points();
-						ifs->points[ifs->n_points++] = p;
-					}
-				} else {
-					printf ("Problematic IndexedFaceSet datum %s\n", w2->str);
-					w2 = w2->next;
-				}
-
-			}
-//			printf ("Got %d points\n", ifs->n_points);
-		}
-		else if (!strcmp ("coordIndex", s)) {
-			w = w->next;
-
-			// Each four data that we read will represent one triangle.
-			InputWord *w2 = w->children;
-			int values[4];
-			int total_read = 0;
-			while (w2) {
-				char ch = *w2->str;
-				if (ch == ',') {
-					w2 = w2->next;
-					continue;
-				}
-				else
-				if (ch == '#' || ch=='-' || isdigit (ch)) {
-					values[total_read++] = ch=='#' ? ((int) w2->value) : atoi(w2->str);
-					w2 = w2->next;
-					if (total_read >= 4) {
-						total_read = 0;
-
-						if (values[3] != -1) {
-							warning("VRML IndexedFaceSet has invalid coordIndex data.");
-							delete ifs;
-							return;
-						}
-						if (values[0] < 0 || values[0] >= ifs->n_points ||
-						    values[1] < 0 || values[1] >= ifs->n_points ||
-						    values[2] < 0 || values[2] >= ifs->n_points) {
-								warning("VRML IndexedFaceSet has invalid coordIndex index value (s).");
-								delete ifs;
-								return;
-						}
-						Point *p1 = ifs->points[values[0]];
-						Point *p2 = ifs->points[values[1]];
-						Point *p3 = ifs->points[values[2]];
-
-						Triangle *t = new Triangle (p1, p2, p3);
-						t->model = m;
-
-						t->indices [0] = values [0];
-						t->indices [1] = values [1];
-						t->indices [2] = values [2];
-
-						if (p1->x < ifs->minx)
-							ifs->minx = p1->x;
-						if (p1->x > ifs->maxx)
-							ifs->maxx = p1->x;
-						if (p1->y < ifs->miny)
-							ifs->miny = p1->y;
-						if (p1->y > ifs->maxy)
-							ifs->maxy = p1->y;
-						if (p1->z < ifs->minz)
-							ifs->minz = p1->z;
-						if (p1->z > ifs->maxz)
-							ifs->maxz = p1->z;
-
-						if (p2->x < ifs->minx)
-							ifs->minx = p2->x;
-						if (p2->x > ifs->maxx)
-							ifs->maxx = p2->x;
-						if (p2->y < ifs->miny)
-							ifs->miny = p2->y;
-						if (p2->y > ifs->maxy)
-							ifs->maxy = p2->y;
-						if (p2->z < ifs->minz)
-							ifs->minz = p2->z;
-						if (p2->z > ifs->maxz)
-							ifs->maxz = p2->z;
-
-						if (p3->x < ifs->minx)
-							ifs->minx = p3->x;
-						if (p3->x > ifs->maxx)
-							ifs->maxx = p3->x;
-						if (p3->y < ifs->miny)
-							ifs->miny = p3->y;
-						if (p3->y > ifs->maxy)
-							ifs->maxy = p3->y;
-						if (p3->z < ifs->minz)
-							ifs->minz = p3->z;
-						if (p3->z > ifs->maxz)
-							ifs->maxz = p3->z;
-
-						if (ifs->n_triangles >= ifs->triangles_size)
-							ifs->expand_triangles();
-						ifs->triangles[ifs->n_triangles++] = t;
-					}
-				} else {
-					printf ("Problematic array value: '%s'\n", w2->str);
-					w2=w2->next;
-				}
-			}
-//			printf ("Got %d triangles\n", ifs->n_triangles);
-		}
-		w = w->next;
-	}	
-
-	// If parent is a shape we set our node as its geometry.
-	ifs->parent = parent;
-	if (!strcmp(parent->type, "Shape") && parent->children)
-		warning ("Shape already has geometry but additional defined.");
-	parent->add_child (ifs);
-	if (name)
-		m->add_name_mapping(name,ifs);
-
-	ifs->ensure_tiny_triangles (0.0000010f); // formerly 6
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_geometry
-// Purpose:	Parser for geometry construct.
-//---------------------------------------------------------------------------
-void
-model_parse_geometry (Model *m, Shape *parent, const InputWord *w, char *name)
-{
-	char *s;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	s = w->str;
-	if (!strcmp(s, "DEF")) {
-		w = w->next;
-		w = w->next;
-		s = w->str;
-	}
-
-	if (!strcmp(s, "USE")) {
-		Replicated *r;
-		w = w->next;
-		s = w->str;
-		r = new Replicated(m, s);
-		parent->add_geometry (r);
-		return;
-	}
-
-	if (!strcmp(s, "IndexedFaceSet")) {
-		model_parse_indexedfaceset (m, parent, w, name);
-	}
-	else if (!strcmp(s, "IndexedLineSet")) {
-		model_parse_indexedlineset (m, parent, w, name);
-	}
-	else if (!strcmp(s, "Sphere")) {
-		model_parse_sphere (m, parent, w, name);
-	}
-	else if (!strcmp(s, "Cone")) {
-		model_parse_cone (m, parent, w, name);
-	}
-	else if (!strcmp(s, "Cylinder")) {
-		model_parse_cylinder (m, parent, w, name);
-	}
-	else if (!strcmp(s, "Box")) {
-		model_parse_box (m, parent, w, name);
-	}
-	else if (!strcmp(s, "Text")) {
-		model_parse_text (m, parent, w, name);
-	}
-	else
-		printf ("Geometry of type %s ignored.\n", s);
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_shape
-// Purpose:	Parser for shape construct.
-//---------------------------------------------------------------------------
-void
-model_parse_shape (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	Shape *shape;
-	char *name2 = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	shape = new Shape ();
-	shape->parent = parent;
-	parent->add_child(shape);
-	if (name)
-		m->add_name_mapping (name, shape);
-
-	// Move to children.
-	w = w->next;
-	w = w->children;
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("geometry", s)) {
-			InputWord *w2 = w->next;
-			if (w2 && !strcmp("DEF", w2->str)) {
-				w2 = w2->next;
-				name2 = w2->str;
-				w2 = w2->next;
-				w2 = w2->next;
-			}
-			model_parse_geometry (m, shape, w, name2);
-			name2 = NULL;
-			w = w2;
-		}
-		else if (!strcmp("appearance", s)) {
-			model_parse_appearance (m, shape, w);
-			w = w->next;
-		}
-		w = w->next;
-	}
-}
-
-void model_parse_group (Model *m, Node *parent, const InputWord *w, char *name);
-void model_parse_transform (Model *m, Node *parent, const InputWord *w, char *name);
-void model_parse_switch (Model *m, Node *parent, const InputWord *w, char *name);
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_children
-// Purpose:	Parser for Transform's and Group's children array.
-// Returns:	Number of InputWords that the caller should skip.
-//---------------------------------------------------------------------------
-int
-model_parse_children (Model *m, Node *parent, const InputWord *w)
-{
-	char *name = NULL;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	// Locates the children.
-	// This can be an array inside brackets or it can a single node.
-	//
-	w = w->next;
-	if (!strcmp(w->str, "DEF")) {
-		w = w->next;
-		name = w->str;
-#if 0
-printf ("In parse_children, found name %s\n", name);
-#endif
-		w = w->next;
-	}	
-	//
-	if (!strcmp(w->str, "Shape")) {
-		model_parse_shape (m, parent, w, name);
-		return 2;
-	}	
-	else if (!strcmp(w->str, "Group")) {
-		model_parse_group (m, parent, w, name);
-		return 2;
-	}
-	else if (!strcmp(w->str, "Transform")) {
-		model_parse_transform (m, parent, w, name);
-		return 2;
-	}
-	else if (!strcmp(w->str, "Switch")) {
-		model_parse_switch (m, parent, w, name);
-		return 2;
-	}
-	else if (!strcmp(w->str, "Inline")) {
-		warning("VRML Inline construct not supported.");
-		return 2;
-	}
-
-	if ('[' != *w->str) {
-		printf ("In parse_children, next node != array: %s\n", w->str);
-	}
-
-	w = w->children;
-
-	while (w) {
-		char *s = w->str;
-// printf ("In parse_children, string is %s, parent = %s, name = %s\n", parent->type, s,name);
-		if (!strcmp("DEF", s)) {
-			w = w->next;
-			name = w->str;
-			w = w->next;
-			continue;
-		}
-		else if (!strcmp("Shape", s)) {
-			model_parse_shape (m, parent, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("USE", s)) {
-			model_parse_use (m, parent, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Inline", s)) {
-			warning ("VRML Inline construct found: not supported.");
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Transform", s)) {
-			model_parse_transform (m, parent, w, name);
-			name = NULL;
-			w = w->next;
-		}		
-		else if (!strcmp("Switch", s)) {
-			model_parse_switch (m, parent, w, name);
-			name = NULL;
-			w = w->next;
-		}	
-		else if (!strcmp("Group", s)) {
-			model_parse_group (m, parent, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		w = w->next;
-	}
-	return 1;
-}
-
-
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_switch
-// Purpose:	Parser for Switch.
-//---------------------------------------------------------------------------
-void
-model_parse_switch (Model *m, Node *parent, const InputWord *w, char* name)
-{
-	Switch *swtch;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	swtch = new Switch();
-	swtch->name = name;
-	if (name)
-		m->add_name_mapping (name, swtch);
-	swtch->parent = parent;
-	parent->add_child(swtch);
-
-	
-
-	w = w->next;
-	w = w->children;
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "choice")) {
-			if (2 == model_parse_children (m, swtch, w))
-				w = w->next;
-			w = w->next;
-
-			// Count the total choices.
-			int count = 0;
-			Node *n = swtch->children;
-			while (n) {
-				count++;
-				n = n->next;
-			}
-			swtch->total_choices = count;
-		}
-		else if (!strcmp(s, "whichChoice")) {
-			int choice;
-			w = w->next;
-			choice = (int) w->value;
-			swtch->which = choice;
-		}
-		w = w->next;
-	}
-
-	if (name && !strncmp(name, "switchNode", 10))
-		m->register_switch (swtch);
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_transform
-// Purpose:	Parser for transform construct.
-//---------------------------------------------------------------------------
-void
-model_parse_transform (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	// char *name2 = NULL;
-	Transform *transform;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	transform = new Transform();
-	transform->name = name;
-	if (name)
-		m->add_name_mapping (name, transform);
-	transform->parent = parent;
-	parent->add_child(transform);
-
-	w = w->next;
-	w = w->children;
-
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("rotation", s)) {	
-			w = w->next;
-			transform->rotate_x = w->value; w = w->next;
-			transform->rotate_y = w->value; w = w->next;
-			transform->rotate_z = w->value; w = w->next;
-			transform->rotate_angle = w->value;
-			if (transform->op_index >= TRANSFORM_MAX_OPS)
-				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
-			else
-				transform->operations[transform->op_index++] = 
-					Transform::ROTATE;
-		}
-		else if (!strcmp("translation", s)) {	
-			w = w->next;
-			transform->translate_x = w->value; w = w->next;
-			transform->translate_y = w->value; w = w->next;
-			transform->translate_z = w->value; 
-// printf ("Found translation in %s: %g %g %g\n", name, transform->translate_x, transform->translate_y, transform->translate_z);
-			if (transform->op_index >= TRANSFORM_MAX_OPS)
-				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
-			else
-				transform->operations[transform->op_index++] = 
-						Transform::TRANSLATE;
-		}
-		else if (!strcmp("scale", s)) {
-			w = w->next;
-			transform->scale_x = w->value; w = w->next;
-			transform->scale_y = w->value; w = w->next;
-			transform->scale_z = w->value; 
-			if (transform->op_index >= TRANSFORM_MAX_OPS)
-				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
-			else
-				transform->operations[transform->op_index++] = 
-					Transform::SCALE;
-		}
-		else if (!strcmp("center", s)) {
-			w = w->next;
-			transform->center_x = w->value; 
-			w = w->next;
-			transform->center_y = w->value; 
-			w = w->next;
-			transform->center_z = w->value; 
-
-			// Not used.
-		}
-		else if (!strcmp("children", s)) {
-			if (2 == model_parse_children (m, transform, w))
-				w = w->next;
-			w = w->next;
-		}
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_separator
-// Purpose:	Parser for Separator construct.
-//---------------------------------------------------------------------------
-void
-model_parse_separator (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	char *name2 = NULL;
-	Separator *sep;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	sep = new Separator();
-	sep->name = name;
-	if (name)
-		m->add_name_mapping (name, sep);
-	sep->parent = parent;
-	parent->add_child(sep);
-
-	w = w->next;
-	w = w->children;
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("DEF", s)) {
-			w = w->next;
-			name2 = w->str;
-			w = w->next;
-			continue;
-		}
-		else if (!strcmp("Material", s)) {	
-			w = w->next;
-		}
-		else if (!strcmp("Sphere", s)) {	
-			model_parse_sphere (m, sep, w, name2);
-			w = w->next;
-		}
-		else if (!strcmp("IndexedFaceSet", s)) {
-			model_parse_indexedfaceset (m, sep, w, name2);
-			w = w->next;
-		}
-#if 0
-		else if (!strcmp("center", s)) {
-			w = w->next;
-			sep->center_x = w->value; w = w->next;
-			sep->center_y = w->value; w = w->next;
-			sep->center_z = w->value; 
-		}
-		else if (!strcmp("children", s)) {
-			if (2 == model_parse_children (m, sep, w))
-				w = w->next;
-			w = w->next;
-		}
-#endif
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_group
-// Purpose:	Parser for group construct.
-//---------------------------------------------------------------------------
-void
-model_parse_group (Model *m, Node *parent, const InputWord *w, char *name)
-{
-	char *name2 = NULL;
-	Group *group;
-
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(parent,"parent-node")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	group = new Group();
-	group->name = name;
-	if (name)
-		m->add_name_mapping (name, group);
-	group->parent = parent;
-	parent->add_child(group);
-
-#ifdef ORTHOCAST
-	// This is part of a kludge that's required because
-	// the DST input files lack a fourth Switch choice
-	// for an "open" or occlusal view of dentistry files.
-	//
-	if (name && !strncmp (name, "TopAndBottom", 12)) {
-		m->top_and_bottom_node = group;
-	}
-#endif
-
-	w = w->next;
-	w = w->children;
-	while (w) {
-		char *s = w->str;
-		if (!strcmp(s, "children")) {
-			if (2 == model_parse_children (m, group, w))
-				w = w->next;
-			w = w->next;
-		}
-		else if (!strcmp(s, "bboxCenter")) {
-			float x = w->value; w = w->next;
-			float y = w->value; w = w->next;
-			float z = w->value;
-		}
-		else if (!strcmp(s, "bboxSize")) {
-			float wid = w->value; w = w->next;
-			float h = w->value; w = w->next;
-			float depth = w->value;
-		}
-		w = w->next;
-	}
-}
-
-//---------------------------------------------------------------------------
-// Name:	model_parse_viewpoint
-// Purpose:	Parser for viewpoint construct.
-// Note:	This program supports only one viewpoint at this time.
-//---------------------------------------------------------------------------
-void
-model_parse_viewpoint (Model *m, const InputWord *w)
-{
-	ASSERT_NONZERO(m,"model")
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	w = w->next;
-	w = w->children;
-	while (w) {
-		char *s = w->str;
-		if (!strcmp("position", s)) {
-			w = w->next;
-			cc_main.viewpoint_x = w->value; w = w->next;
-			cc_main.viewpoint_y = w->value; w = w->next;
-			cc_main.viewpoint_z = w->value;
-		}
-		else if (!strcmp("orientation", s)) {
-			w = w->next;
-			cc_main.orientation_x = w->value; w = w->next;
-			cc_main.orientation_y = w->value; w = w->next;
-			cc_main.orientation_z = w->value; w = w->next;
-			float foo = w->value;
-		}
-		else if (!strcmp("fieldOfView", s)) {
-			float tmp;
-			w = w->next;
-			tmp = w->value;
-			if (tmp > 0.1f) {
-				cc_main.field_of_view = 360.0f * tmp / (float) M_PI;
-			}
-		}
-		else if (!strcmp("jump", s) ||
-				!strcmp("description", s) ||
-				!strcmp("isBound", s) ||
-				!strcmp("set_bind", s) ||
-				!strcmp("bindTime", s)) {
-			w = w->next;  // skip param
-		}
-		w = w->next;
-	}
-}
-
-
-//---------------------------------------------------------------------------
-// Name:	model_parser
-// Purpose:	Parser for VRML files.
-//---------------------------------------------------------------------------
-Model *
-vrml_parser (const InputWord *w)
-{
-	Model *m;
-	Node *node;
-	char *name = NULL; // used with DEF.
-
-	ASSERT_NONZERO(w,"inputword")
-	//----------
-
-	m = new Model();
-	node = new Node ();
-	m->nodes = node;
-
-	while (w) {
-		char *str = w->str;
-// printf ("Word is %s\n", str);
-		if (!strcmp("Viewpoint", str)) {
-			model_parse_viewpoint (m, w);
-			w = w->next; 
-		}
-		else if (!strcmp("Shape", str)) {
-			model_parse_shape (m, node, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Transform", str)) {			
-// printf ("Got transform %s\n", name);
-			model_parse_transform (m, node, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Group", str)) {
-			model_parse_group (m, node, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Separator", str)) {
-			model_parse_separator (m, node, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Switch", str)) {
-			model_parse_switch (m, node, w, name);
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("USE", str)) {
-			model_parse_use (m, node, w, name); // [DEF foo] USE bar
-			name = NULL;
-			w = w->next;
-		}
-		else if (!strcmp("Background", str)) {
-			w = w->next;
-			InputWord *c = w->children->next;
-			m->background_provided = true;
-			m->bg[0] = c->value; c = c->next;
-			m->bg[1] = c->value; c = c->next;
-			m->bg[2] = c->value;
-		}
-		else if (!strcmp("PROTO", str)) {
-			warning ("VRML contains a PROTO construct, which is not supported.");
-			w = w->next;
-			w = w->next;
-			w = w->next;
-		}
-		else if (!strcmp("ROUTE", str) ||
-				!strcmp("field", str)) {
-			w = w->next;	// Skip 3.
-			w = w->next;
-			w = w->next;
-		}
-		else if (!strcmp("EXTERNPROTO", str) ||
-				!strcmp("eventIn", str) ||
-				!strcmp("eventOut", str)) {
-			w = w->next;	// Skip 2
-			w = w->next;
-		}
-		else if (!strcmp("WorldInfo", str)) {
-			model_parse_worldinfo (m, w);
-			w = w->next;
-		}
-		else if (!strcmp("DirectionalLight", str)) {
-			printf ("Found VRML DirectionalLight\n");
-			w = w->next;
-		}
-		else if (!strcmp("DEF", str)) {
-			w = w->next;
-			name = w->str;
-			w = w->next;
-			continue;
-		}
-		else if (!strcmp("TimeSensor", str) || 
-				!strcmp("CoordinateInterpolator", str) || 
-				!strcmp("PositionInterpolator", str) ||
-				!strcmp("NavigationInfo", str)) {
-			w = w->next;
-		} else
-			printf ("Found VRML '%s'\n", str);
-		
-		w = w->next;
-	}
-	return m;
-}
-
+/*=============================================================================
+// Maxilla, an OpenGL-based program for viewing dentistry-related VRML & STL.
+// Copyright (C) 2008-2010 by Zack T Smith and Ortho Cast Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 
+// as published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// The author may be reached at fbui@comcast.net.
+//============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "defs.h"
+
+// zlib.h is read in maxilla.h 
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "quat.h"
+#include "maxilla.h"
+#include "numbers.h"
+#include "loader.h"
+#include "threads.h"
+
+extern "C" {
+#include "BMP.h"
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_worldinfo
+// Purpose:	Parser for WorldInfo construct.
+//---------------------------------------------------------------------------
+void
+model_parse_worldinfo (Model *m, const InputWord *w)
+{
+	w = w->next;
+	w = w->children;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_title:
+			w = w->next;
+			m->title = w->str;
+			break;
+		case ATOM_info:
+			w = w->next;
+			break;
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_material
+// Purpose:	Parser for material construct, that stores these data
+//		in the Shape object.
+// Returns:	# of words for caller to skip.
+//---------------------------------------------------------------------------
+int
+model_parse_material (Model *m, Appearance *appearance, const InputWord *w)
+{
+	int nwords = 3; // material Material {
+	char *name=NULL;
+	Material *material = NULL;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+
+	if (w->atom == ATOM_DEF) {
+		w = w->next;
+		name = w->str;
+		material = new Material ();
+		m->add_name_mapping (name, material);
+		appearance->material = material;
+		w = w->next;
+		nwords += 2;
+	}
+
+	if (w->atom != ATOM_Material) {
+		warning ("VRML material construct lacks Material{ }.");
+	}
+	w = w->next;
+	w = w->children;
+
+	if (!material) {
+		material = new Material ();
+		appearance->material = material;
+	}
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_shininess: {
+			float tmp;
+			w = w->next;
+			tmp = w->value;
+			if (tmp < 0.0f)
+				tmp = 0.0f;
+			if (tmp > 100.0f)
+				tmp = 100.0f;
+			material->shininess = tmp;
+			break;
+		}
+		case ATOM_diffuseColor:
+			w = w->next;
+			material->diffuseColor[0] = (GLfloat) w->value; 
+			w = w->next;
+			material->diffuseColor[1] = (GLfloat) w->value; 
+			w = w->next;
+			material->diffuseColor[2] = (GLfloat) w->value;
+			break;
+		case ATOM_ambientIntensity:
+			w = w->next;
+			material->ambientIntensity = w->value; 
+			break;
+		case ATOM_specularColor:
+			w = w->next;
+			material->specularColor[0] = (GLfloat) w->value; 
+			w = w->next;
+			material->specularColor[1] = (GLfloat) w->value; 
+			w = w->next;
+			material->specularColor[2] = (GLfloat) w->value;
+			break;
+		case ATOM_emissiveColor:
+			w = w->next;
+			material->emissiveColor[0] = (GLfloat) w->value; 
+			w = w->next;
+			material->emissiveColor[1] = (GLfloat) w->value; 
+			w = w->next;
+			material->emissiveColor[2] = (GLfloat) w->value;
+			break;
+		}
+		w = w->next;
+	}
+
+	return nwords;
+}
+
+void model_parse_use (Model *m, Node *parent, const InputWord *w, char *name);
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_appearance
+// Purpose:	Parser for appearance construct.
+//---------------------------------------------------------------------------
+void
+model_parse_appearance (Model *m, Shape *parent, const InputWord *w)
+{
+	char *name = NULL;
+	char *s;
+	Appearance *appearance = NULL;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	s = w->str;
+	if (w->atom == ATOM_DEF) {
+		w = w->next;
+		name = w->str;
+		appearance = new Appearance ();
+		m->add_name_mapping (name, appearance);
+		w = w->next;
+		s = w->str;
+	}
+	if (w->atom == ATOM_USE) { // e.g. appearance USE Felt
+		w = w->next;
+		s = w->str;
+		Node *n = m->lookup_node_by_name (s);
+		if (!strcmp (n->type, "Appearance"))
+			parent->appearance = (Appearance*) n;
+		else {
+			char tmp[1000];
+#ifdef WIN32
+			sprintf_s (tmp,999, "Name %s was expected to refer to Appearance, but is %s.",
+				s, n->type);
+#else
+			sprintf (tmp,"Name %s was expected to refer to Appearance, but is %s.",
+				s, n->type);
+#endif
+			warning (tmp);
+		}
+		return;
+	}
+	if (w->atom != ATOM_Appearance) {
+		warning ("VRML appearance construct missing Appearance{ }.");
+		warning (s);
+		return;
+	}
+
+	// If we're not creating a named Appearance,
+	// create an unnamed one.
+	//
+	if (!appearance) {
+		appearance = new Appearance ();
+	}
+	if (!parent->appearance) {
+		parent->appearance = appearance;
+		parent->owns_appearance = true;
+	}
+	
+	w = w->next;
+	w = w->children;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_material:
+			if (model_parse_material (m, appearance, w) > 3) {
+				w = w->next;
+				w = w->next;
+			}
+			w = w->next;
+			w = w->next;
+			break;
+		case ATOM_texture:
+			printf ("Ignoring texture.\n");
+			w = w->next;
+			w = w->next;
+			break;
+		case ATOM_textureTransform:
+			printf ("Ignoring textureTransform.\n");
+			w = w->next;
+			w = w->next;
+			break;
+		default:
+			warning ("Unknown node type in Appearance.");
+			warning(w->str);
+		}
+		w = w->next;
+
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_use
+// Purpose:	Parser for the USE construct.
+//---------------------------------------------------------------------------
+void
+model_parse_use (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Replicated *r;
+	char *use_name;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	use_name = w->str;
+	r = new Replicated (m, use_name);
+	r->parent = parent;
+	parent->add_child(r);
+	if (name)
+		m->add_name_mapping (name, r->original);
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_sphere
+// Purpose:	Parser for Sphere construct (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_sphere (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Sphere *sphere;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	sphere = new Sphere ();
+	sphere->parent = parent;
+	if (!strcmp (parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (sphere);
+
+	if (name)
+		m->add_name_mapping (name, sphere);
+
+	while (w) {
+		if (w->atom == ATOM_radius) {
+			w = w->next;
+			sphere->radius = w->value;
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_cylinder
+// Purpose:	Parser for Cylinder construct (child of Shape, Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_cylinder (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Cylinder *cylinder;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	cylinder = new Cylinder();
+	cylinder->parent = parent;
+	if (!strcmp (parent->type, "Cylinder"))
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (cylinder);
+
+	if (name)
+		m->add_name_mapping (name, cylinder);
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_radius:
+			w = w->next;
+			cylinder->radius = w->value;
+			break;
+		case ATOM_height:
+			w = w->next;
+			cylinder->height = w->value;
+			break;
+		case ATOM_top:
+			w = w->next;
+			cylinder->top = tolower(w->str[0]) == 't';
+			break;
+		case ATOM_bottom:
+			w = w->next;
+			cylinder->top = tolower(w->str[0]) == 't';
+			break;
+		case ATOM_side:
+			w = w->next;
+			cylinder->top = tolower(w->str[0]) == 't';
+			break;
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_box
+// Purpose:	Parser for Box construct (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_box (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Box *box;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	box = new Box();
+	box->parent = parent;
+	if (!strcmp (parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (box);
+
+	if (name)
+		m->add_name_mapping (name, box);
+
+	while (w) {
+		if (w->atom == ATOM_size) {
+			w = w->next;
+			box->size = w->value;
+		}
+		w = w->next;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_text
+// Purpose:	Parser for Text construct (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_text (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Text *text;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	text = new Text ();
+	text->parent = parent;
+	if (!strcmp (parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (text);
+
+	if (name)
+		m->add_name_mapping (name, text);
+
+	text->name = name;
+	text->text = "";
+
+	while (w) {
+		if (w->atom == ATOM_string) {
+
+			w = w->next;
+			if (!w)	// Sometimes string is followed by nothing.
+				break;
+
+			text->text = w->str;
+
+			// Dentistry-specific strings.
+			if (name) {
+				if (!strncmp (name, "PatientFirstName", 16))
+					m->patient_firstname = w->str;
+				else if (!strncmp (name, "PatientLastName", 15))
+					m->patient_lastname = w->str;
+				else if (!strncmp (name, "Age", 3))
+					m->patient_birthdate = w->str;
+				else if (!strncmp (name, "CaseNumber", 10))
+					m->case_number = w->str;
+				else if (!strncmp (name, "CaseDate", 8))
+					m->case_date = w->str;
+				else if (!strncmp (name, "ControlNumber", 13))
+					m->control_number = w->str;
+				else if (!strncmp (name, "TopAndBottomAligned", 19))
+				{
+					m->isTopAndBottomAligned = !strncmp (w->str, "true", 4);
+				}				
+			}
+		}
+		w = w->next;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_cone
+// Purpose:	Parser for Cone construct (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_cone (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Cone *cone;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	cone = new Cone ();
+	cone->parent = parent;
+	if (!strcmp (parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (cone);
+
+	if (name)
+		m->add_name_mapping (name, cone);
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_bottomRadius:
+			w = w->next; 
+			if (w->str[0] == '#')
+				cone->radius = w->value;
+			else
+				; // XX
+			break;
+		case ATOM_height:
+			w = w->next; 
+			if (w->str[0] == '#')
+				cone->height = w->value;
+			else 
+				; // XX
+			break;
+		}
+		w = w->next;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+// Name:	ils_add_index
+// Purpose:	Adds a polyline segment for one coordIndex entry.
+// Returns:	False if the index is invalid.
+//---------------------------------------------------------------------------
+static bool
+ils_add_index (IndexedLineSet *ils, int value, int total_read)
+{
+	if (value<0 || value >= ils->n_points) {
+		warning("VRML IndexedLineSet has invalid coordIndex index value (s).");
+		return false;
+	}
+
+	// The value is just an index into the
+	// array of points. So now we obtain the
+	// point and make a polyline segment 
+	// out of it.
+	//
+	Point *p = ils->points[value];
+	PolyLine *pl = new PolyLine (p);
+
+	if (p->x < ils->minx)
+		ils->minx = p->x;
+	if (p->x > ils->maxx)
+		ils->maxx = p->x;
+	if (p->y < ils->miny)
+		ils->miny = p->y;
+	if (p->y > ils->maxy)
+		ils->maxy = p->y;
+	if (p->z < ils->minz)
+		ils->minz = p->z;
+	if (p->z > ils->maxz)
+		ils->maxz = p->z;
+
+	if (!ils->polyline)
+		ils->polyline = pl;
+	else 
+		ils->last_poly->next = pl;
+	ils->last_poly = pl;
+
+	if (ils->color_per_vertex) {
+		int i;
+		for (i=0; i<3; i++) 
+			pl->color[i] = ils->colors[total_read*3+i];
+		pl->color[3] = 1.0f;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_indexedlineset
+// Purpose:	Parser for IndexedLineSet (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_indexedlineset (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	IndexedLineSet *ils = new IndexedLineSet ();
+	char *name2 = NULL;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_color:
+			w = w->next; 		
+			if (w->atom != ATOM_Color) {
+				warning ("VRML IndexedLineSet construct has problematic Color section.");
+				delete ils;
+				return;
+			}
+			w = w->next;
+			if (w && w->children) {
+				InputWord *w2 = w->children;
+				if (w2->atom != ATOM_color) {
+					warning ("VRML IndexedLineSet construct has problematic color section.");
+					delete ils;
+					return;
+				}
+				w2 = w2->next;
+				w2 = w2->children;
+				ils->n_colors = 0;
+				while (w2) {
+					if (w2->str[0] == '#')
+						ils->colors [ils->n_colors++] = 
+							w2->value;
+					if (ils->n_colors >= ils->colors_size)
+						ils->expand_colors ();
+					w2 = w2->next;
+				}
+				printf ("IndexedLineSet: read %d color values\n", ils->n_colors);
+			}
+			break;
+		case ATOM_colorPerVertex:
+			w = w->next; 
+			if (tolower(w->str[0]) == 't')
+				ils->color_per_vertex = true;
+			break;
+		case ATOM_coord: {
+			w = w->next;
+			if (w->atom == ATOM_DEF) {
+				w = w->next;
+				name2 = w->str;
+				w = w->next;
+			}
+			if (w->atom != ATOM_Coordinate) {
+				warning ("VRML IndexedLineSet construct has problematic coord section.");
+				delete ils;
+				return;
+			}
+			w = w->next;
+
+			// Let's read the data here rather than in another function.
+			InputWord *w2 = w->children;
+			if (w2->atom != ATOM_point) {
+				warning ("VRML IndexedLineSet has problematic point list.");
+				delete ils;
+				return;
+			}
+			w2 = w2->next;
+
+			//----------------------------------------
+			// Points streamed by the reader.
+			//
+			if (w2 && w2->floats) {
+				int i;
+				float *f = w2->floats;
+				for (i = 0; i + 2 < w2->n_floats; i += 3) {
+					if (ils->n_points >= ils->points_size)
+						ils->expand_points();
+					ils->points[ils->n_points++] = Point_new (f[i], f[i+1], f[i+2]);
+				}
+				w2 = NULL;
+			}
+			else
+				w2 = w2->children;
+
+			// Fetch point coordinates in sets of 3 floats.
+			float values[3];
+			int total = 0;
+			while (w2) {
+				char ch = *w2->str;
+				if (ch == ',') {
+					w2 = w2->next;
+					continue;
+				}
+				if (ch == '#' || ch=='-' || isdigit (ch)) {
+					values[total++] = ch=='#' ? w2->value
+						: (float) vrml_atof (w2->str, strlen (w2->str));
+					w2 = w2->next;
+
+					if (total >= 3) {
+						Point *p = Point_new (values[0],
+							values[1], values[2]);
+						total = 0;
+
+						if (ils->n_points >= 
+						    ils->points_size)
+							ils->expand_points();
+						ils->points[ils->n_points++]=p;
+					}
+				} else {
+					printf ("Problematic IndexedLineSet datum %s\n", w2->str);
+					w2 = w2->next;
+				}
+
+			}
+//			printf ("Got %d points\n", ils->n_points);
+			break;
+		}
+		case ATOM_coordIndex: {
+			w = w->next;
+
+			// Each datum that we read is an index into 
+			// the points array.
+			//
+			InputWord *w2 = w->children;
+			int value;
+			int total_read = 0;
+			ils->polyline = NULL;
+			ils->last_poly = NULL;
+
+			//----------------------------------------
+			// Indices streamed by the reader.
+			//
+			if (w->ints) {
+				int i;
+				for (i = 0; i < w->n_ints; i++) {
+					if (!ils_add_index (ils, w->ints[i], total_read++)) {
+						delete ils;
+						return;
+					}
+				}
+				w2 = NULL;
+			}
+
+			while (w2) {
+				char ch = *w2->str;
+				if (ch == ',') {
+					w2 = w2->next;
+					continue;
+				}
+				else
+				if (ch == '#' || ch=='-' || isdigit (ch)) {
+					value = ch=='#' ? ((int) w2->value) 
+							: vrml_atoi (w2->str, strlen (w2->str));
+					w2 = w2->next;
+
+					if (!ils_add_index (ils, value, total_read++)) {
+						delete ils;
+						return;
+					}
+
+				} else {
+					printf ("Problematic IndexedLineSet array value: '%s'\n", w2->str);
+					w2=w2->next;
+				}
+			}
+//			printf ("Got %d triangles\n", ils->n_triangles);
+			break;
+		}
+		default:
+			printf ("Artifact in IndexedLinesSet: %s\n", w->str);
+		}
+		w = w->next;
+	}
+
+	// If parent is a shape we set our node as its geometry.
+	ils->parent = parent;
+	if (!strcmp(parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (ils);
+	if (name)
+		m->add_name_mapping(name,ils);
+}
+
+
+class IndexedFaceSet;
+
+//---------------------------------------------------------------------------
+// Name:	ifs_check_indices
+// Purpose:	Checks coordIndex groups of four against the number of
+//		points. A final incomplete group is ignored.
+// Returns:	False if any group is invalid.
+//---------------------------------------------------------------------------
+static bool
+ifs_check_indices (const int *indices, int n_indices, int n_points)
+{
+	int i;
+	for (i = 0; i + 3 < n_indices; i += 4) {
+		const int *values = indices + i;
+		if (values[3] != -1) {
+			warning("VRML IndexedFaceSet has invalid coordIndex data.");
+			return false;
+		}
+		if (values[0] < 0 || values[0] >= n_points ||
+		    values[1] < 0 || values[1] >= n_points ||
+		    values[2] < 0 || values[2] >= n_points) {
+			warning("VRML IndexedFaceSet has invalid coordIndex index value (s).");
+			return false;
+		}
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_make_triangle
+// Purpose:	Creates a triangle from one checked coordIndex group.
+//---------------------------------------------------------------------------
+static void
+ifs_make_triangle (IndexedFaceSet *ifs, const int *values)
+{
+	int j;
+	for (j = 0; j < 3; j++) {
+		const float *p = flat_position (ifs->flat, values [j]);
+
+		if (p[0] < ifs->minx)
+			ifs->minx = p[0];
+		if (p[0] > ifs->maxx)
+			ifs->maxx = p[0];
+		if (p[1] < ifs->miny)
+			ifs->miny = p[1];
+		if (p[1] > ifs->maxy)
+			ifs->maxy = p[1];
+		if (p[2] < ifs->minz)
+			ifs->minz = p[2];
+		if (p[2] > ifs->maxz)
+			ifs->maxz = p[2];
+	}
+
+	ifs->add_triangle (values[0], values[1], values[2]);
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_add_triangle
+// Purpose:	Creates a triangle from one coordIndex group of four.
+// Returns:	False if the group is invalid.
+//---------------------------------------------------------------------------
+static bool
+ifs_add_triangle (IndexedFaceSet *ifs, const int *values)
+{
+	if (!ifs_check_indices (values, 4, ifs->n_points))
+		return false;
+	ifs_make_triangle (ifs, values);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_list_floats, ifs_list_ints
+// Purpose:	Copy out the numbers of a [ ] list, whether streamed by
+//		the reader or read as words (-per-character-reader).
+// Returns:	An array for the caller to free, or NULL if empty.
+//---------------------------------------------------------------------------
+static float *
+ifs_list_floats (const InputWord *w, int *n_return)
+{
+	*n_return = 0;
+	if (!w)
+		return NULL;
+
+	int n = w->floats ? w->n_floats : 0;
+	const InputWord *w2;
+	if (!w->floats)
+		for (w2 = w->children; w2; w2 = w2->next)
+			if (*w2->str == '#' || *w2->str == '-' || isdigit (*w2->str))
+				n++;
+	if (!n)
+		return NULL;
+
+	float *values = (float*) malloc (n * sizeof(float));
+	if (!values)
+		fatal ("Out of memory!");
+
+	if (w->floats)
+		memcpy (values, w->floats, n * sizeof(float));
+	else {
+		int i = 0;
+		for (w2 = w->children; w2; w2 = w2->next) {
+			char ch = *w2->str;
+			if (ch == '#' || ch == '-' || isdigit (ch))
+				values[i++] = ch=='#' ? w2->value : vrml_atof (w2->str, strlen (w2->str));
+		}
+	}
+	*n_return = n;
+	return values;
+}
+
+static int *
+ifs_list_ints (const InputWord *w, int *n_return)
+{
+	*n_return = 0;
+	if (!w)
+		return NULL;
+
+	int n = w->ints ? w->n_ints : 0;
+	const InputWord *w2;
+	if (!w->ints)
+		for (w2 = w->children; w2; w2 = w2->next)
+			if (*w2->str == '#' || *w2->str == '-' || isdigit (*w2->str))
+				n++;
+	if (!n)
+		return NULL;
+
+	int *values = (int*) malloc (n * sizeof(int));
+	if (!values)
+		fatal ("Out of memory!");
+
+	if (w->ints)
+		memcpy (values, w->ints, n * sizeof(int));
+	else {
+		int i = 0;
+		for (w2 = w->children; w2; w2 = w2->next) {
+			char ch = *w2->str;
+			if (ch == '#' || ch == '-' || isdigit (ch))
+				values[i++] = ch=='#' ? ((int) w2->value) : vrml_atoi (w2->str, strlen (w2->str));
+		}
+	}
+	*n_return = n;
+	return values;
+}
+
+// Cosine below which two normals given for a point differ.
+#define IFS_SAME_NORMAL (0.9999)
+
+//---------------------------------------------------------------------------
+// Name:	ifs_apply_normals
+// Purpose:	Gives each point the vertex normal that the file gives
+//		for it, indexed by normalIndex if present, else by
+//		coordIndex. A point that is given differing normals by
+//		different triangles is on a crease and is drawn flat,
+//		as is one in fewer than three triangles, just as when
+//		smooth_faces() computes the normals.
+// Returns:	False if the normals do not match the triangles.
+//---------------------------------------------------------------------------
+static bool
+ifs_apply_normals (IndexedFaceSet *ifs, const float *normals, int n_normals,
+		const int *normal_index, int n_index)
+{
+	int i, j;
+
+	n_normals /= 3;
+	if (!normals || !n_normals)
+		return false;
+
+	//----------------------------------------
+	// Check all indices before changing any
+	// point.
+	//
+	if (normal_index) {
+		if (n_index < 4 * ifs->n_triangles - 1)
+			return false;
+		for (i = 0; i < ifs->n_triangles; i++)
+			for (j = 0; j < 3; j++) {
+				int k = normal_index [4 * i + j];
+				if (k < 0 || k >= n_normals)
+					return false;
+			}
+	}
+	else if (n_normals < ifs->n_points)
+		return false;
+
+	//----------------------------------------
+	// Scratch, per point: how many normals it
+	// was given, up to 3, whether it has one
+	// and whether it is on a crease.
+	//
+	FlatMesh *mesh = ifs->flat;
+	int n_points = ifs->n_points;
+	unsigned char *n_added = (unsigned char*) malloc (n_points ? 3 * n_points : 1);
+	if (!n_added)
+		fatal ("Out of memory!");
+	unsigned char *valid = n_added + n_points;
+	unsigned char *crease = valid + n_points;
+	memset (n_added, 0, 3 * n_points);
+
+	for (i = 0; i < ifs->n_triangles; i++) {
+		const uint32 *v = flat_face (mesh, i);
+
+		for (j = 0; j < 3; j++) {
+			int p = v [j];
+			int k = normal_index ? normal_index [4 * i + j] : p;
+			if (n_added [p] < 3)
+				n_added [p]++;
+
+			double x = normals [3 * k];
+			double y = normals [3 * k + 1];
+			double z = normals [3 * k + 2];
+			double mag = sqrt (x*x + y*y + z*z);
+			if (mag <= 0.) {
+				crease [p] = true;
+				continue;
+			}
+			x /= mag;
+			y /= mag;
+			z /= mag;
+
+			float *normal = flat_normal (mesh, p);
+			if (!valid [p]) {
+				normal [0] = x;
+				normal [1] = y;
+				normal [2] = z;
+				valid [p] = true;
+			}
+			else if (normal [0] * x + normal [1] * y + normal [2] * z < IFS_SAME_NORMAL)
+				crease [p] = true;
+		}
+	}
+
+	for (i = 0; i < n_points; i++)
+		mesh->smooth [i] = n_added [i] >= 3 && valid [i] && !crease [i];
+	free (n_added);
+
+	ifs->normals_given = true;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_make_pending
+// Purpose:	Makes the points and triangles from the lists that a
+//		MeshBuild holds, which must have been checked.
+//---------------------------------------------------------------------------
+static void
+ifs_make_pending (MeshBuild *b)
+{
+	IndexedFaceSet *ifs = b->ifs;
+	int i;
+
+	if (b->coords) {
+		const float *f = b->coords;
+		ifs->reserve (ifs->n_points + b->n_coords / 3, 0);
+		for (i = 0; i + 2 < b->n_coords; i += 3)
+			ifs->add_point (f[i], f[i+1], f[i+2]);
+		b->coords = NULL;
+		b->n_coords = 0;
+	}
+
+	if (b->indices) {
+		ifs->reserve (0, ifs->n_triangles + b->n_indices / 4);
+		for (i = 0; i + 3 < b->n_indices; i += 4)
+			ifs_make_triangle (ifs, b->indices + i);
+		b->indices = NULL;
+		b->n_indices = 0;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_make_pending_now
+// Purpose:	Checks and makes the pending points and triangles, so
+//		that more can be added to them directly.
+// Returns:	False if the pending coordIndex groups are invalid.
+//---------------------------------------------------------------------------
+static bool
+ifs_make_pending_now (MeshBuild *b)
+{
+	if (!ifs_check_indices (b->indices, b->n_indices, b->ifs->n_points + b->n_coords / 3))
+		return false;
+	ifs_make_pending (b);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_build
+// Purpose:	Finishes an IndexedFaceSet: makes its pending points
+//		and triangles, applies the normals given for it, and
+//		splits large triangles. It touches nothing but the
+//		IndexedFaceSet, so meshes can be built in parallel.
+//---------------------------------------------------------------------------
+static void
+ifs_build (MeshBuild *b)
+{
+	IndexedFaceSet *ifs = b->ifs;
+
+	ifs_make_pending (b);
+
+	//----------------------------------------
+	// Normals that the file gives for the
+	// vertices save smoothing them later.
+	//
+	if (b->normals &&
+	    !ifs_apply_normals (ifs, b->normals, b->n_normals, b->normal_index, b->n_normal_index))
+		b->normals_ignored = true;
+
+	ifs->ensure_tiny_triangles (0.0000010f); // formerly 6
+}
+
+//---------------------------------------------------------------------------
+// Name:	ifs_build_done
+// Purpose:	Reports on and releases a MeshBuild after ifs_build.
+//---------------------------------------------------------------------------
+static void
+ifs_build_done (MeshBuild *b)
+{
+	if (b->normals_ignored)
+		warning ("VRML IndexedFaceSet normals do not match its faces, ignoring them.");
+	free (b->normals);
+	free (b->normal_index);
+	b->normals = NULL;
+	b->normal_index = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_add_mesh_build
+// Purpose:	Queues an IndexedFaceSet to be built at the end of
+//		vrml_parser.
+//---------------------------------------------------------------------------
+static void
+model_add_mesh_build (Model *m, const MeshBuild *b)
+{
+	if (m->n_mesh_builds >= m->mesh_builds_size) {
+		int size = m->mesh_builds_size ? 2 * m->mesh_builds_size : 16;
+		MeshBuild *tmp = (MeshBuild*) realloc (m->mesh_builds, size * sizeof(MeshBuild));
+		if (!tmp)
+			fatal ("Out of memory!");
+		total_allocated += (size - m->mesh_builds_size) * sizeof(MeshBuild);
+		m->mesh_builds = tmp;
+		m->mesh_builds_size = size;
+	}
+	m->mesh_builds [m->n_mesh_builds++] = *b;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_build_run
+// Purpose:	Builds one queued mesh. Called in parallel.
+//---------------------------------------------------------------------------
+static void
+mesh_build_run (void *arg, int index)
+{
+	Model *m = (Model*) arg;
+
+	// A cancelled load builds no more meshes.
+	if (!loader_cancelled ())
+		ifs_build (m->mesh_builds + index);
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_build_meshes
+// Purpose:	Builds the meshes queued while parsing, such as the
+//		upper and lower arches, on the worker threads at once.
+//		Their nodes are already in place in the Model.
+//---------------------------------------------------------------------------
+static void
+model_build_meshes (Model *m)
+{
+	int i;
+
+	parallel_for (m->n_mesh_builds, mesh_build_run, m);
+
+	for (i = 0; i < m->n_mesh_builds; i++) {
+		ifs_build_done (m->mesh_builds + i);
+		loader_mesh_built ();
+	}
+
+	free (m->mesh_builds);
+	total_allocated -= m->mesh_builds_size * sizeof(MeshBuild);
+	m->mesh_builds = NULL;
+	m->n_mesh_builds = 0;
+	m->mesh_builds_size = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_indexedfaceset
+// Purpose:	Parser for IndexedFaceSet (child of Shape or Separator).
+//---------------------------------------------------------------------------
+void
+model_parse_indexedfaceset (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	IndexedFaceSet *ifs = new IndexedFaceSet ();
+	char *name2 = NULL;
+	float *normals = NULL;
+	int n_normals = 0;
+	int *normal_index = NULL;
+	int n_normal_index = 0;
+	bool normal_per_vertex = true;
+	MeshBuild build;
+
+	memset (&build, 0, sizeof (build));
+	build.ifs = ifs;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	// A cancelled load builds no more meshes. A choice built
+	// later belongs to no load.
+	if (m->parsing && loader_cancelled ()) {
+		delete ifs;
+		return;
+	}
+
+	w = w->next;
+	w = w->children;
+
+	ifs->maxx = ifs->maxy = ifs->maxz = -999999;
+	ifs->minx = ifs->miny = ifs->minz = 999999;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_solid:
+			w = w->next;
+			break;
+		case ATOM_creaseAngle:
+			w = w->next;
+			if (*w->str == '#' || isdigit (*w->str))
+				ifs->crease_angle = *w->str == '#' ? w->value : vrml_atof (w->str, strlen (w->str));
+			break;
+		case ATOM_normalPerVertex:
+			w = w->next;
+			normal_per_vertex = strcmp (w->str, "FALSE") != 0;
+			break;
+		case ATOM_normalIndex:
+			w = w->next;
+			free (normal_index);
+			normal_index = ifs_list_ints (w, &n_normal_index);
+			break;
+		case ATOM_normal: {
+			w = w->next;
+			if (w->atom == ATOM_DEF) {
+				w = w->next;
+				w = w->next;
+			}
+			if (w->atom == ATOM_USE) {
+				w = w->next;	// Not supported; smoothing is used instead.
+				break;
+			}
+			if (w->atom != ATOM_Normal) {
+				warning ("VRML IndexedFaceSet has problematic normal section.");
+				break;
+			}
+			w = w->next;
+
+			InputWord *w2 = w->children;
+			while (w2) {
+				if (w2->atom == ATOM_vector && w2->next) {
+					w2 = w2->next;
+					free (normals);
+					normals = ifs_list_floats (w2, &n_normals);
+				}
+				w2 = w2->next;
+			}
+			break;
+		}
+		case ATOM_coord: {
+			w = w->next;
+			if (w->atom == ATOM_DEF) {
+				w = w->next;
+				name2 = w->str;
+				w = w->next;
+			}
+			if (w->atom != ATOM_Coordinate) {
+				warning ("VRML IndexedFaceSet construct has problematic coord section.");
+				free (normals);
+				free (normal_index);
+				delete ifs;
+				return;
+			}
+			w = w->next;
+
+			// Let's read the data here rather than in another function.
+			InputWord *w2 = w->children;
+			if (w2->atom != ATOM_point) {
+				warning ("VRML IndexedFaceSet has problematic point list.");
+				free (normals);
+				free (normal_index);
+				delete ifs;
+				return;
+			}
+			w2 = w2->next;
+
+			//----------------------------------------
+			// Points streamed by the reader are made
+			// later, by ifs_build.
+			//
+			if (w2 && w2->floats) {
+				if (build.coords && !ifs_make_pending_now (&build)) {
+					free (normals);
+					free (normal_index);
+					delete ifs;
+					return;
+				}
+				build.coords = w2->floats;
+				build.n_coords = w2->n_floats;
+				w2 = NULL;
+			}
+			else {
+				if (!ifs_make_pending_now (&build)) {
+					free (normals);
+					free (normal_index);
+					delete ifs;
+					return;
+				}
+				w2 = w2->children;
+			}
+
+			// Fetch point coordinates in sets of 3 floats.
+			double values[3];
+			int total = 0;
+			while (w2) {
+				char ch = *w2->str;
+				if (ch == ',') {
+					w2 = w2->next;
+					continue;
+				}
+				if (ch == '#' || ch=='-' || isdigit (ch)) {
+					values[total++] = ch=='#' ? w2->value : vrml_atof (w2->str, strlen (w2->str));
+					w2 = w2->next;
+
+					if (total >= 3) {
+						ifs->add_point (values[0], values[1], values[2]);
+						total = 0;
+					}
+				} else {
+					printf ("Problematic IndexedFaceSet datum %s\n", w2->str);
+					w2 = w2->next;
+				}
+
+			}
+//			printf ("Got %d points\n", ifs->n_points);
+			break;
+		}
+		case ATOM_coordIndex: {
+			w = w->next;
+
+			// Each four data that we read will represent one triangle.
+			InputWord *w2 = w->children;
+			int values[4];
+			int total_read = 0;
+
+			//----------------------------------------
+			// Indices streamed by the reader are
+			// checked and made into triangles later.
+			//
+			if (w->ints) {
+				if (build.indices && !ifs_make_pending_now (&build)) {
+					free (normals);
+					free (normal_index);
+					delete ifs;
+					return;
+				}
+				build.indices = w->ints;
+				build.n_indices = w->n_ints;
+				w2 = NULL;
+			}
+			else if (!ifs_make_pending_now (&build)) {
+				free (normals);
+				free (normal_index);
+				delete ifs;
+				return;
+			}
+
+			while (w2) {
+				char ch = *w2->str;
+				if (ch == ',') {
+					w2 = w2->next;
+					continue;
+				}
+				else
+				if (ch == '#' || ch=='-' || isdigit (ch)) {
+					values[total_read++] = ch=='#' ? ((int) w2->value) : vrml_atoi (w2->str, strlen (w2->str));
+					w2 = w2->next;
+					if (total_read >= 4) {
+						total_read = 0;
+
+						if (!ifs_add_triangle (ifs, values)) {
+							free (normals);
+							free (normal_index);
+							delete ifs;
+							return;
+						}
+					}
+				} else {
+					printf ("Problematic array value: '%s'\n", w2->str);
+					w2=w2->next;
+				}
+			}
+//			printf ("Got %d triangles\n", ifs->n_triangles);
+			break;
+		}
+		}
+		w = w->next;
+	}	
+
+	if (!ifs_check_indices (build.indices, build.n_indices, ifs->n_points + build.n_coords / 3)) {
+		free (normals);
+		free (normal_index);
+		delete ifs;
+		return;
+	}
+
+	if (normal_per_vertex) {
+		build.normals = normals;
+		build.n_normals = n_normals;
+		build.normal_index = normal_index;
+		build.n_normal_index = n_normal_index;
+	} else {
+		free (normals);
+		free (normal_index);
+	}
+
+	// If parent is a shape we set our node as its geometry.
+	ifs->parent = parent;
+	if (!strcmp(parent->type, "Shape") && parent->children)
+		warning ("Shape already has geometry but additional defined.");
+	parent->add_child (ifs);
+	if (name)
+		m->add_name_mapping(name,ifs);
+
+	//----------------------------------------
+	// While a file is being parsed, its meshes
+	// are built together at the end.
+	//
+	if (m->parsing) {
+		model_add_mesh_build (m, &build);
+		return;
+	}
+	ifs_build (&build);
+	ifs_build_done (&build);
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_geometry
+// Purpose:	Parser for geometry construct.
+//---------------------------------------------------------------------------
+void
+model_parse_geometry (Model *m, Shape *parent, const InputWord *w, char *name)
+{
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	if (w->atom == ATOM_DEF) {
+		w = w->next;
+		w = w->next;
+	}
+
+	switch (w->atom) {
+	case ATOM_USE: {
+		Replicated *r;
+		w = w->next;
+		r = new Replicated(m, w->str);
+		parent->add_geometry (r);
+		break;
+	}
+	case ATOM_IndexedFaceSet:
+		model_parse_indexedfaceset (m, parent, w, name);
+		break;
+	case ATOM_IndexedLineSet:
+		model_parse_indexedlineset (m, parent, w, name);
+		break;
+	case ATOM_Sphere:
+		model_parse_sphere (m, parent, w, name);
+		break;
+	case ATOM_Cone:
+		model_parse_cone (m, parent, w, name);
+		break;
+	case ATOM_Cylinder:
+		model_parse_cylinder (m, parent, w, name);
+		break;
+	case ATOM_Box:
+		model_parse_box (m, parent, w, name);
+		break;
+	case ATOM_Text:
+		model_parse_text (m, parent, w, name);
+		break;
+	default:
+		printf ("Geometry of type %s ignored.\n", w->str);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_shape
+// Purpose:	Parser for shape construct.
+//---------------------------------------------------------------------------
+void
+model_parse_shape (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	Shape *shape;
+	char *name2 = NULL;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	shape = new Shape ();
+	shape->parent = parent;
+	parent->add_child(shape);
+	if (name)
+		m->add_name_mapping (name, shape);
+
+	// Move to children.
+	w = w->next;
+	w = w->children;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_geometry: {
+			InputWord *w2 = w->next;
+			if (w2 && w2->atom == ATOM_DEF) {
+				w2 = w2->next;
+				name2 = w2->str;
+				w2 = w2->next;
+				w2 = w2->next;
+			}
+			model_parse_geometry (m, shape, w, name2);
+			name2 = NULL;
+			w = w2;
+			break;
+		}
+		case ATOM_appearance:
+			model_parse_appearance (m, shape, w);
+			w = w->next;
+			break;
+		}
+		w = w->next;
+	}
+}
+
+void model_parse_group (Model *m, Node *parent, const InputWord *w, char *name);
+void model_parse_transform (Model *m, Node *parent, const InputWord *w, char *name);
+void model_parse_switch (Model *m, Node *parent, const InputWord *w, char *name);
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_child
+// Purpose:	Parser for one node of a children or choice array.
+//---------------------------------------------------------------------------
+static void
+model_parse_child (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	switch (w->atom) {
+	case ATOM_Shape:
+		model_parse_shape (m, parent, w, name);
+		break;
+	case ATOM_USE:
+		model_parse_use (m, parent, w, name);
+		break;
+	case ATOM_Inline:
+		warning ("VRML Inline construct found: not supported.");
+		break;
+	case ATOM_Transform:
+		model_parse_transform (m, parent, w, name);
+		break;
+	case ATOM_Switch:
+		model_parse_switch (m, parent, w, name);
+		break;
+	case ATOM_Group:
+		model_parse_group (m, parent, w, name);
+		break;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_children
+// Purpose:	Parser for Transform's and Group's children array.
+// Returns:	Number of InputWords that the caller should skip.
+//---------------------------------------------------------------------------
+int
+model_parse_children (Model *m, Node *parent, const InputWord *w)
+{
+	char *name = NULL;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	// Locates the children.
+	// This can be an array inside brackets or it can a single node.
+	//
+	w = w->next;
+	if (w->atom == ATOM_DEF) {
+		w = w->next;
+		name = w->str;
+#if 0
+printf ("In parse_children, found name %s\n", name);
+#endif
+		w = w->next;
+	}	
+	//
+	switch (w->atom) {
+	case ATOM_Shape:
+		model_parse_shape (m, parent, w, name);
+		return 2;
+	case ATOM_Group:
+		model_parse_group (m, parent, w, name);
+		return 2;
+	case ATOM_Transform:
+		model_parse_transform (m, parent, w, name);
+		return 2;
+	case ATOM_Switch:
+		model_parse_switch (m, parent, w, name);
+		return 2;
+	case ATOM_Inline:
+		warning("VRML Inline construct not supported.");
+		return 2;
+	case ATOM_OPEN_BRACKET:
+		break;
+	default:
+		printf ("In parse_children, next node != array: %s\n", w->str);
+	}
+
+	w = w->children;
+
+	while (w) {
+// printf ("In parse_children, string is %s, parent = %s, name = %s\n", parent->type, w->str,name);
+		switch (w->atom) {
+		case ATOM_DEF:
+			w = w->next;
+			name = w->str;
+			w = w->next;
+			continue;
+		case ATOM_Shape:
+		case ATOM_USE:
+		case ATOM_Inline:
+		case ATOM_Transform:
+		case ATOM_Switch:
+		case ATOM_Group:
+			model_parse_child (m, parent, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		}
+		w = w->next;
+	}
+	return 1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_name_is_special
+// Purpose:	Tells whether the program looks for a DEF name as soon
+//		as a file is loaded, in which case the node that it
+//		names cannot be left unbuilt.
+//---------------------------------------------------------------------------
+static bool
+model_name_is_special (const char *name)
+{
+	static const char *prefixes[] = {
+		"switchNode", "TopAndBottom", "PatientFirstName",
+		"PatientLastName", "Age", "CaseNumber", "CaseDate",
+		"ControlNumber", "manual_spacing", "node_position", NULL
+	};
+	int i;
+
+	for (i = 0; prefixes[i]; i++)
+		if (!strncmp (name, prefixes[i], strlen (prefixes[i])))
+			return true;
+	return false;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_reserve_names
+// Purpose:	Walks the words of a choice for the names that it DEFs.
+//		Without a Deferred node, only checks them; with one,
+//		maps them to it, so that a USE of any of them builds
+//		the choice.
+// Returns:	False if the choice defines a special name.
+//---------------------------------------------------------------------------
+static bool
+model_reserve_names (Model *m, const InputWord *w, Deferred *d)
+{
+	while (w) {
+		if (w->atom == ATOM_DEF && w->next) {
+			if (!d && model_name_is_special (w->next->str))
+				return false;
+			if (d)
+				m->add_name_mapping (w->next->str, d);
+		}
+		if (w->children && !model_reserve_names (m, w->children, d))
+			return false;
+		w = w->next;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_defer_choice
+// Purpose:	Leaves a Switch choice unbuilt, adding a Deferred node
+//		in its place.
+// Returns:	False if the choice must be built now.
+//---------------------------------------------------------------------------
+static bool
+model_defer_choice (Model *m, Switch *swtch, const InputWord *w, char *name)
+{
+	Deferred *d;
+
+	if (!w->next || !w->next->children)
+		return false;
+	if (name && model_name_is_special (name))
+		return false;
+	if (!model_reserve_names (m, w->next->children, NULL))
+		return false;
+
+	d = new Deferred ();
+	d->model = m;
+	d->word = w;
+	d->def_name = name;
+	d->parent = swtch;
+	swtch->add_child (d);
+
+	d->next_pending = m->pending;
+	m->pending = d;
+
+	if (name)
+		m->add_name_mapping (name, d);
+	model_reserve_names (m, w->next->children, d);
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_choices
+// Purpose:	Parser for Switch's choice array. Only the choice that
+//		whichChoice selects is built now; the others are built
+//		when first selected or USEd, or when the program is idle.
+// Returns:	Number of InputWords that the caller should skip.
+//---------------------------------------------------------------------------
+static int
+model_parse_choices (Model *m, Switch *swtch, const InputWord *w, int selected)
+{
+	char *name = NULL;
+	int index = 0;
+
+	if (w->next->atom != ATOM_OPEN_BRACKET)
+		return model_parse_children (m, swtch, w);
+
+	w = w->next->children;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_DEF:
+			w = w->next;
+			name = w->str;
+			w = w->next;
+			continue;
+		case ATOM_Shape:
+		case ATOM_Transform:
+		case ATOM_Switch:
+		case ATOM_Group:
+			if (index == selected || !model_defer_choice (m, swtch, w, name))
+				model_parse_child (m, swtch, w, name);
+			index++;
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_USE:
+			model_parse_child (m, swtch, w, name);
+			index++;
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Inline:
+			model_parse_child (m, swtch, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		}
+		w = w->next;
+	}
+	return 1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_deferred
+// Purpose:	Builds a Switch choice that model_parse_choices left
+//		unbuilt, and puts it in the place of its Deferred node.
+// Returns:	The node built.
+//---------------------------------------------------------------------------
+Node *
+model_parse_deferred (Deferred *d)
+{
+	Model *m;
+	Node *parent, *n, **link;
+	Deferred **p;
+	Deferred *outer;
+	Node holder;
+
+	ASSERT_NONZERO(d,"deferred")
+	//----------
+
+	if (d->building)
+		return d;
+
+	m = d->model;
+	parent = d->parent;
+
+	//----------------------------------------
+	// Building a choice can need another one
+	// built, for a USE, so this one leaves the
+	// pending list first.
+	//
+	p = &m->pending;
+	while (*p && *p != d)
+		p = &(*p)->next_pending;
+	if (*p)
+		*p = d->next_pending;
+
+	outer = m->building;
+	m->building = d;
+	d->building = true;
+	model_parse_child (m, &holder, d->word, d->def_name);
+	m->building = outer;
+	m->drop_reserved_names (d);
+
+	n = holder.children;
+	holder.children = NULL;
+	holder.last_child = NULL;
+	if (!n)
+		n = new Group ();
+	n->parent = parent;
+
+	link = &parent->children;
+	while (*link != d)
+		link = &(*link)->next;
+	*link = n;
+	n->next = d->next;
+	if (parent->last_child == d)
+		parent->last_child = n;
+	d->next = NULL;
+	delete d;
+
+	if (m->smoothed) {
+		Node *after = n->next;
+		n->next = NULL;
+		n->smooth ();
+		n->next = after;
+	}
+
+	//----------------------------------------
+	// The words were kept only for the choices.
+	//
+	if (!m->pending && !keeping_word_tree && m->words) {
+		delete m->words;
+		m->words = NULL;
+		m->word_tree = NULL;
+	}
+	return n;
+}
+
+
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_switch
+// Purpose:	Parser for Switch.
+//---------------------------------------------------------------------------
+void
+model_parse_switch (Model *m, Node *parent, const InputWord *w, char* name)
+{
+	Switch *swtch;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	swtch = new Switch();
+	swtch->name = name;
+	if (name)
+		m->add_name_mapping (name, swtch);
+	swtch->parent = parent;
+	parent->add_child(swtch);
+
+	
+
+	w = w->next;
+	w = w->children;
+
+	//----------------------------------------
+	// whichChoice may follow the choices, so
+	// look for it first.
+	//
+	int selected = 0;
+	const InputWord *w2 = w;
+	while (w2) {
+		if (w2->atom == ATOM_whichChoice && w2->next) {
+			selected = (int) w2->next->value;
+			break;
+		}
+		w2 = w2->next;
+	}
+	if (selected < 0)
+		selected = 0;	// See update_which_node.
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_choice: {
+			if (2 == model_parse_choices (m, swtch, w, selected))
+				w = w->next;
+			w = w->next;
+
+			// Count the total choices.
+			int count = 0;
+			Node *n = swtch->children;
+			while (n) {
+				count++;
+				n = n->next;
+			}
+			swtch->total_choices = count;
+			break;
+		}
+		case ATOM_whichChoice: {
+			int choice;
+			w = w->next;
+			choice = (int) w->value;
+			swtch->which = choice;
+			swtch->file_which = choice;
+			break;
+		}
+		}
+		w = w->next;
+	}
+
+	if (name && !strncmp(name, "switchNode", 10))
+		m->register_switch (swtch);
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_transform
+// Purpose:	Parser for transform construct.
+//---------------------------------------------------------------------------
+void
+model_parse_transform (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	// char *name2 = NULL;
+	Transform *transform;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	transform = new Transform();
+	transform->name = name;
+	if (name)
+		m->add_name_mapping (name, transform);
+	transform->parent = parent;
+	parent->add_child(transform);
+
+	w = w->next;
+	w = w->children;
+
+	while (w) {
+		switch (w->atom) {
+		case ATOM_rotation:
+			w = w->next;
+			transform->rotate_x = w->value; w = w->next;
+			transform->rotate_y = w->value; w = w->next;
+			transform->rotate_z = w->value; w = w->next;
+			transform->rotate_angle = w->value;
+			if (transform->op_index >= TRANSFORM_MAX_OPS)
+				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
+			else
+				transform->operations[transform->op_index++] = 
+					Transform::ROTATE;
+			break;
+		case ATOM_translation:
+			w = w->next;
+			transform->translate_x = w->value; w = w->next;
+			transform->translate_y = w->value; w = w->next;
+			transform->translate_z = w->value; 
+// printf ("Found translation in %s: %g %g %g\n", name, transform->translate_x, transform->translate_y, transform->translate_z);
+			if (transform->op_index >= TRANSFORM_MAX_OPS)
+				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
+			else
+				transform->operations[transform->op_index++] = 
+						Transform::TRANSLATE;
+			break;
+		case ATOM_scale:
+			w = w->next;
+			transform->scale_x = w->value; w = w->next;
+			transform->scale_y = w->value; w = w->next;
+			transform->scale_z = w->value; 
+			if (transform->op_index >= TRANSFORM_MAX_OPS)
+				warning ("Too many translate, rotate, or scale operations inside Transform construct.");
+			else
+				transform->operations[transform->op_index++] = 
+					Transform::SCALE;
+			break;
+		case ATOM_center:
+			w = w->next;
+			transform->center_x = w->value; 
+			w = w->next;
+			transform->center_y = w->value; 
+			w = w->next;
+			transform->center_z = w->value; 
+
+			// Not used.
+			break;
+		case ATOM_children:
+			if (2 == model_parse_children (m, transform, w))
+				w = w->next;
+			w = w->next;
+			break;
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_separator
+// Purpose:	Parser for Separator construct.
+//---------------------------------------------------------------------------
+void
+model_parse_separator (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	char *name2 = NULL;
+	Separator *sep;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	sep = new Separator();
+	sep->name = name;
+	if (name)
+		m->add_name_mapping (name, sep);
+	sep->parent = parent;
+	parent->add_child(sep);
+
+	w = w->next;
+	w = w->children;
+	while (w) {
+		switch (w->atom) {
+		case ATOM_DEF:
+			w = w->next;
+			name2 = w->str;
+			w = w->next;
+			continue;
+		case ATOM_Material:
+			w = w->next;
+			break;
+		case ATOM_Sphere:
+			model_parse_sphere (m, sep, w, name2);
+			w = w->next;
+			break;
+		case ATOM_IndexedFaceSet:
+			model_parse_indexedfaceset (m, sep, w, name2);
+			w = w->next;
+			break;
+#if 0
+		case ATOM_center:
+			w = w->next;
+			sep->center_x = w->value; w = w->next;
+			sep->center_y = w->value; w = w->next;
+			sep->center_z = w->value; 
+			break;
+		case ATOM_children:
+			if (2 == model_parse_children (m, sep, w))
+				w = w->next;
+			w = w->next;
+			break;
+#endif
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_group
+// Purpose:	Parser for group construct.
+//---------------------------------------------------------------------------
+void
+model_parse_group (Model *m, Node *parent, const InputWord *w, char *name)
+{
+	char *name2 = NULL;
+	Group *group;
+
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(parent,"parent-node")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	group = new Group();
+	group->name = name;
+	if (name)
+		m->add_name_mapping (name, group);
+	group->parent = parent;
+	parent->add_child(group);
+
+#ifdef ORTHOCAST
+	// This is part of a kludge that's required because
+	// the DST input files lack a fourth Switch choice
+	// for an "open" or occlusal view of dentistry files.
+	//
+	if (name && !strncmp (name, "TopAndBottom", 12)) {
+		m->top_and_bottom_node = group;
+	}
+#endif
+
+	w = w->next;
+	w = w->children;
+	while (w) {
+		switch (w->atom) {
+		case ATOM_children:
+			if (2 == model_parse_children (m, group, w))
+				w = w->next;
+			w = w->next;
+			break;
+		case ATOM_bboxCenter: {
+			float x = w->value; w = w->next;
+			float y = w->value; w = w->next;
+			float z = w->value;
+			break;
+		}
+		case ATOM_bboxSize: {
+			float wid = w->value; w = w->next;
+			float h = w->value; w = w->next;
+			float depth = w->value;
+			break;
+		}
+		}
+		w = w->next;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	model_parse_viewpoint
+// Purpose:	Parser for viewpoint construct.
+// Note:	This program supports only one viewpoint at this time.
+//---------------------------------------------------------------------------
+void
+model_parse_viewpoint (Model *m, const InputWord *w)
+{
+	ASSERT_NONZERO(m,"model")
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	w = w->next;
+	w = w->children;
+	while (w) {
+		switch (w->atom) {
+		case ATOM_position:
+			w = w->next;
+			m->viewpoint_x = w->value; w = w->next;
+			m->viewpoint_y = w->value; w = w->next;
+			m->viewpoint_z = w->value;
+			m->viewpoint_fields |= VIEWPOINT_POSITION;
+			break;
+		case ATOM_orientation: {
+			w = w->next;
+			m->orientation_x = w->value; w = w->next;
+			m->orientation_y = w->value; w = w->next;
+			m->orientation_z = w->value; w = w->next;
+			float foo = w->value;
+			m->viewpoint_fields |= VIEWPOINT_ORIENTATION;
+			break;
+		}
+		case ATOM_fieldOfView: {
+			float tmp;
+			w = w->next;
+			tmp = w->value;
+			if (tmp > 0.1f) {
+				m->field_of_view = 360.0f * tmp / (float) M_PI;
+				m->viewpoint_fields |= VIEWPOINT_FIELD_OF_VIEW;
+			}
+			break;
+		}
+		case ATOM_jump:
+		case ATOM_description:
+		case ATOM_isBound:
+		case ATOM_set_bind:
+		case ATOM_bindTime:
+			w = w->next;  // skip param
+			break;
+		}
+		w = w->next;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+// Name:	model_parser
+// Purpose:	Parser for VRML files.
+//---------------------------------------------------------------------------
+Model *
+vrml_parser (const InputWord *w)
+{
+	Model *m;
+	Node *node;
+	char *name = NULL; // used with DEF.
+
+	ASSERT_NONZERO(w,"inputword")
+	//----------
+
+	m = new Model();
+	node = new Node ();
+	m->nodes = node;
+	m->parsing = true;
+
+	while (w) {
+// printf ("Word is %s\n", w->str);
+		switch (w->atom) {
+		case ATOM_Viewpoint:
+			model_parse_viewpoint (m, w);
+			w = w->next; 
+			break;
+		case ATOM_Shape:
+			model_parse_shape (m, node, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Transform:
+// printf ("Got transform %s\n", name);
+			model_parse_transform (m, node, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Group:
+			model_parse_group (m, node, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Separator:
+			model_parse_separator (m, node, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Switch:
+			model_parse_switch (m, node, w, name);
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_USE:
+			model_parse_use (m, node, w, name); // [DEF foo] USE bar
+			name = NULL;
+			w = w->next;
+			break;
+		case ATOM_Background: {
+			w = w->next;
+			InputWord *c = w->children->next;
+			m->background_provided = true;
+			m->bg[0] = c->value; c = c->next;
+			m->bg[1] = c->value; c = c->next;
+			m->bg[2] = c->value;
+			break;
+		}
+		case ATOM_PROTO:
+			warning ("VRML contains a PROTO construct, which is not supported.");
+			w = w->next;
+			w = w->next;
+			w = w->next;
+			break;
+		case ATOM_ROUTE:
+		case ATOM_field:
+			w = w->next;	// Skip 3.
+			w = w->next;
+			w = w->next;
+			break;
+		case ATOM_EXTERNPROTO:
+		case ATOM_eventIn:
+		case ATOM_eventOut:
+			w = w->next;	// Skip 2
+			w = w->next;
+			break;
+		case ATOM_WorldInfo:
+			model_parse_worldinfo (m, w);
+			w = w->next;
+			break;
+		case ATOM_DirectionalLight:
+			printf ("Found VRML DirectionalLight\n");
+			w = w->next;
+			break;
+		case ATOM_DEF:
+			w = w->next;
+			name = w->str;
+			w = w->next;
+			continue;
+		case ATOM_TimeSensor:
+		case ATOM_CoordinateInterpolator:
+		case ATOM_PositionInterpolator:
+		case ATOM_NavigationInfo:
+			w = w->next;
+			break;
+		default:
+			printf ("Found VRML '%s'\n", w->str);
+		}
+		
+		w = w->next;
+	}
+	model_build_meshes (m);
+	m->parsing = false;
+	return m;
+}
+
@@ -0,0 +1,696 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "loader.h"
+#include "ply.h"
+
+// The header must end within this many bytes.
+#define PLY_MAX_HEADER (65536)
+
+#define PLY_MAX_ELEMENTS (16)
+#define PLY_MAX_PROPERTIES (32)
+#define PLY_MAX_NAME (32)
+
+// Records read between checks for cancellation.
+#define PLY_BLOCK_RECORDS (65536)
+
+// Property types; the value is the size in bytes
+// plus a tag to tell the kinds of the same size apart.
+enum {
+	PLY_NONE = 0,
+	PLY_INT8 = 0x01,
+	PLY_UINT8 = 0x11,
+	PLY_INT16 = 0x02,
+	PLY_UINT16 = 0x12,
+	PLY_INT32 = 0x04,
+	PLY_UINT32 = 0x14,
+	PLY_FLOAT32 = 0x24,
+	PLY_FLOAT64 = 0x28,
+};
+
+#define PLY_SIZE(TYPE) ((TYPE) & 0xf)
+
+/*===========================================================================
+ * Name:	PLYProperty, PLYElement
+ * Purpose:	An element as described by the header. An element with
+ *		no list properties has records of one size, so that a
+ *		property is simply at a fixed offset in each record.
+ */
+typedef struct {
+	char name [PLY_MAX_NAME];
+	int type;		// Type of the value or of a list's items.
+	int count_type;		// Type of a list's count, else PLY_NONE.
+	int offset;		// In a fixed-size record, else -1.
+} PLYProperty;
+
+typedef struct {
+	char name [PLY_MAX_NAME];
+	unsigned long count;
+	PLYProperty properties [PLY_MAX_PROPERTIES];
+	int n_properties;
+	int record_size;	// 0 if records vary in size.
+} PLYElement;
+
+//---------------------------------------------------------------------------
+// Name:	is_ply_path
+// Purpose:	Tells whether a path names a PLY file.
+//---------------------------------------------------------------------------
+bool
+is_ply_path (const char *path)
+{
+	int len = strlen (path);
+	return len >= 4 && path [len-4] == '.' &&
+		tolower (path [len-3]) == 'p' &&
+		tolower (path [len-2]) == 'l' &&
+		tolower (path [len-1]) == 'y';
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_type
+// Purpose:	Converts a header type name to a type.
+// Returns:	The type, or PLY_NONE if the name is unknown.
+//---------------------------------------------------------------------------
+static int
+ply_type (const char *name)
+{
+	if (!strcmp (name, "char") || !strcmp (name, "int8"))
+		return PLY_INT8;
+	if (!strcmp (name, "uchar") || !strcmp (name, "uint8"))
+		return PLY_UINT8;
+	if (!strcmp (name, "short") || !strcmp (name, "int16"))
+		return PLY_INT16;
+	if (!strcmp (name, "ushort") || !strcmp (name, "uint16"))
+		return PLY_UINT16;
+	if (!strcmp (name, "int") || !strcmp (name, "int32"))
+		return PLY_INT32;
+	if (!strcmp (name, "uint") || !strcmp (name, "uint32"))
+		return PLY_UINT32;
+	if (!strcmp (name, "float") || !strcmp (name, "float32"))
+		return PLY_FLOAT32;
+	if (!strcmp (name, "double") || !strcmp (name, "float64"))
+		return PLY_FLOAT64;
+	return PLY_NONE;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_value
+// Purpose:	Reads one little-endian value of the given type.
+//---------------------------------------------------------------------------
+static inline double
+ply_value (const unsigned char *p, int type)
+{
+	switch (type) {
+	case PLY_INT8:	return (double) (signed char) p[0];
+	case PLY_UINT8:	return (double) p[0];
+	case PLY_INT16:	return (double) (short) (p[0] | (p[1] << 8));
+	case PLY_UINT16: return (double) (p[0] | (p[1] << 8));
+	case PLY_INT32:	return (double) (int) (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24));
+	case PLY_UINT32: return (double) (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24));
+	case PLY_FLOAT32: {
+		float f;
+		memcpy (&f, p, 4);
+		return f;
+	 }
+	case PLY_FLOAT64: {
+		double d;
+		memcpy (&d, p, 8);
+		return d;
+	 }
+	}
+	return 0.;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_index
+// Purpose:	Reads one little-endian list count or vertex index.
+// Returns:	The value, or -1 if it is negative or not an integer type.
+//---------------------------------------------------------------------------
+static inline int64
+ply_index (const unsigned char *p, int type)
+{
+	switch (type) {
+	case PLY_INT8:	return (signed char) p[0];
+	case PLY_UINT8:	return p[0];
+	case PLY_INT16:	return (short) (p[0] | (p[1] << 8));
+	case PLY_UINT16: return p[0] | (p[1] << 8);
+	case PLY_INT32:	return (int) (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24));
+	case PLY_UINT32: return (int64) (p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int) p[3] << 24));
+	}
+	return -1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_record_end
+// Purpose:	Finds the end of a record of an element that has list
+//		properties, and where the given list property is in it.
+// Returns:	The end, or NULL if the record would pass the limit.
+//---------------------------------------------------------------------------
+static const unsigned char *
+ply_record_end (const PLYElement *e, const unsigned char *p, const unsigned char *limit,
+		int list_property, const unsigned char **list_return)
+{
+	int i;
+	for (i = 0; i < e->n_properties; i++) {
+		const PLYProperty *prop = e->properties + i;
+		if (prop->count_type == PLY_NONE) {
+			p += PLY_SIZE(prop->type);
+			if (p > limit)
+				return NULL;
+			continue;
+		}
+
+		if (p + PLY_SIZE(prop->count_type) > limit)
+			return NULL;
+		int64 count = ply_index (p, prop->count_type);
+		if (count < 0)
+			return NULL;
+		if (i == list_property)
+			*list_return = p;
+		p += PLY_SIZE(prop->count_type);
+		if ((uint64) count * PLY_SIZE(prop->type) > (uint64) (limit - p))
+			return NULL;
+		p += count * PLY_SIZE(prop->type);
+	}
+	return p;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_parse_header
+// Purpose:	Reads the header's element & property descriptions.
+// Returns:	The length of the header, or 0 if it is unusable.
+//---------------------------------------------------------------------------
+static unsigned long
+ply_parse_header (const unsigned char *data, unsigned long size,
+		PLYElement *elements, int *n_elements_return)
+{
+	if (size < 4 || memcmp (data, "ply", 3) || (data[3] != '\n' && data[3] != '\r')) {
+		warning ("File is not PLY.");
+		return 0;
+	}
+
+	unsigned long limit = size < PLY_MAX_HEADER ? size : PLY_MAX_HEADER;
+	unsigned long ix = 0;
+	int n_elements = 0;
+	bool have_format = false;
+
+	while (ix < limit) {
+		char line [256];
+		int len = 0;
+		while (ix < limit && data[ix] != '\n') {
+			if (len < (int) sizeof(line) - 1 && data[ix] != '\r')
+				line [len++] = data[ix];
+			ix++;
+		}
+		if (ix >= limit)
+			break;
+		ix++;
+		line [len] = 0;
+
+		char word1 [PLY_MAX_NAME], word2 [PLY_MAX_NAME];
+		char word3 [PLY_MAX_NAME], word4 [PLY_MAX_NAME];
+		word1[0] = word2[0] = word3[0] = word4[0] = 0;
+		sscanf (line, "%31s %31s %31s %31s", word1, word2, word3, word4);
+
+		if (!strcmp (word1, "end_header")) {
+			if (!have_format) {
+				warning ("PLY header has no format.");
+				return 0;
+			}
+			*n_elements_return = n_elements;
+			return ix;
+		}
+		else if (!strcmp (word1, "format")) {
+			if (strcmp (word2, "binary_little_endian")) {
+				warning ("Only binary little-endian PLY files can be read.");
+				return 0;
+			}
+			have_format = true;
+		}
+		else if (!strcmp (word1, "element")) {
+			if (n_elements == PLY_MAX_ELEMENTS) {
+				warning ("PLY file has too many elements.");
+				return 0;
+			}
+			PLYElement *e = elements + n_elements++;
+			memset (e, 0, sizeof(PLYElement));
+			strcpy (e->name, word2);
+			e->count = strtoul (word3, NULL, 10);
+		}
+		else if (!strcmp (word1, "property")) {
+			if (!n_elements) {
+				warning ("PLY property precedes any element.");
+				return 0;
+			}
+			PLYElement *e = elements + n_elements - 1;
+			if (e->n_properties == PLY_MAX_PROPERTIES) {
+				warning ("PLY element has too many properties.");
+				return 0;
+			}
+			PLYProperty *prop = e->properties + e->n_properties++;
+			if (!strcmp (word2, "list")) {
+				prop->count_type = ply_type (word3);
+				prop->type = ply_type (word4);
+				if (sscanf (line, "%*s %*s %*s %*s %31s", prop->name) != 1 ||
+				    prop->count_type == PLY_NONE || prop->count_type == PLY_FLOAT32 ||
+				    prop->count_type == PLY_FLOAT64 || prop->type == PLY_NONE) {
+					warning ("PLY list property is malformed.");
+					return 0;
+				}
+			} else {
+				prop->type = ply_type (word2);
+				strcpy (prop->name, word3);
+				if (prop->type == PLY_NONE) {
+					warning ("PLY property has an unknown type.");
+					return 0;
+				}
+			}
+		}
+		// Comments and obj_info are ignored.
+	}
+
+	warning ("PLY header has no end.");
+	return 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_layout
+// Purpose:	Works out the offsets of properties in fixed-size
+//		records, and the size of those records.
+//---------------------------------------------------------------------------
+static void
+ply_layout (PLYElement *e)
+{
+	int i, offset = 0;
+	for (i = 0; i < e->n_properties; i++) {
+		PLYProperty *prop = e->properties + i;
+		if (prop->count_type != PLY_NONE)
+			break;
+		prop->offset = offset;
+		offset += PLY_SIZE(prop->type);
+	}
+	for ( ; i < e->n_properties; i++)
+		e->properties [i].offset = -1;
+
+	e->record_size = 0;
+	for (i = 0; i < e->n_properties; i++)
+		if (e->properties [i].count_type != PLY_NONE)
+			return;
+	e->record_size = offset;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_find_property
+// Returns:	The index of the named property, or -1.
+//---------------------------------------------------------------------------
+static int
+ply_find_property (const PLYElement *e, const char *name)
+{
+	int i;
+	for (i = 0; i < e->n_properties; i++)
+		if (!strcmp (e->properties [i].name, name))
+			return i;
+	return -1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_parser_data
+// Purpose:	Reads a binary PLY file held in memory. The vertex
+//		records are read in place into a reserved
+//		IndexedFaceSet; the face records are walked once to
+//		count the triangles and check the indices, then again
+//		to make the triangles.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+IndexedFaceSet *
+ply_parser_data (const unsigned char *data, unsigned long size, Model *m)
+{
+	ASSERT_NONZERO (data,"data")
+	//----------
+
+	PLYElement elements [PLY_MAX_ELEMENTS];
+	int n_elements = 0;
+	unsigned long header_size = ply_parse_header (data, size, elements, &n_elements);
+	if (!header_size) {
+		return NULL;
+	}
+
+	//----------------------------------------
+	// Find where each element's records
+	// start. Elements other than vertex and
+	// face are skipped.
+	//
+	const unsigned char *limit = data + size;
+	const unsigned char *p = data + header_size;
+	const unsigned char *vertex_data = NULL;
+	const unsigned char *face_data = NULL;
+	const unsigned char *face_end = NULL;
+	PLYElement *vertex = NULL;
+	PLYElement *face = NULL;
+	int face_list = -1;
+	int i;
+
+	for (i = 0; i < n_elements; i++) {
+		PLYElement *e = elements + i;
+		ply_layout (e);
+
+		if (!strcmp (e->name, "vertex")) {
+			vertex = e;
+			vertex_data = p;
+		}
+		else if (!strcmp (e->name, "face")) {
+			face = e;
+			face_data = p;
+			face_list = ply_find_property (e, "vertex_indices");
+			if (face_list < 0)
+				face_list = ply_find_property (e, "vertex_index");
+		}
+
+		if (e->record_size) {
+			if ((uint64) e->count * e->record_size > (uint64) (limit - p))
+				p = NULL;
+			else
+				p += e->count * e->record_size;
+		} else {
+			//----------------------------------------
+			// Records vary in size, so this is the
+			// first pass over the face records.
+			//
+			unsigned long j;
+			for (j = 0; p && j < e->count; j++) {
+				if (!(j % PLY_BLOCK_RECORDS)) {
+					if (loader_cancelled ()) {
+						return NULL;
+					}
+					loader_progress (p - data, size);
+				}
+				const unsigned char *list;
+				p = ply_record_end (e, p, limit, -1, &list);
+			}
+		}
+
+		if (!p) {
+			warning ("PLY file is shorter than its header says.");
+			return NULL;
+		}
+		if (e == face)
+			face_end = p;
+	}
+
+	if (!vertex || !face || face_list < 0 ||
+	    face->properties [face_list].count_type == PLY_NONE) {
+		warning ("PLY file has no vertex and face lists.");
+		return NULL;
+	}
+
+	int vx = ply_find_property (vertex, "x");
+	int vy = ply_find_property (vertex, "y");
+	int vz = ply_find_property (vertex, "z");
+	int vnx = ply_find_property (vertex, "nx");
+	int vny = ply_find_property (vertex, "ny");
+	int vnz = ply_find_property (vertex, "nz");
+	if (vx < 0 || vy < 0 || vz < 0 || !vertex->record_size) {
+		warning ("PLY vertices have no x, y and z.");
+		return NULL;
+	}
+	if (vertex->count > 0x7fffffff / 4 || face->count > 0x7fffffff / 4) {
+		warning ("PLY file is too big.");
+		return NULL;
+	}
+
+	int n_vertices = (int) vertex->count;
+	int x_type = vertex->properties [vx].type;
+	int y_type = vertex->properties [vy].type;
+	int z_type = vertex->properties [vz].type;
+	int x_offset = vertex->properties [vx].offset;
+	int y_offset = vertex->properties [vy].offset;
+	int z_offset = vertex->properties [vz].offset;
+	int stride = vertex->record_size;
+	bool all_float = x_type == PLY_FLOAT32 && y_type == PLY_FLOAT32 && z_type == PLY_FLOAT32;
+
+	//----------------------------------------
+	// Count the triangles that the polygons
+	// will be split into, and check that
+	// every index names a vertex.
+	//
+	const PLYProperty *list_prop = face->properties + face_list;
+	int count_type = list_prop->count_type;
+	int index_type = list_prop->type;
+	int index_size = PLY_SIZE(index_type);
+	int64 n_triangles = 0;
+	int n_degenerate = 0;
+	unsigned long j;
+
+	p = face_data;
+	for (j = 0; j < face->count; j++) {
+		if (!(j % PLY_BLOCK_RECORDS)) {
+			if (loader_cancelled ()) {
+				return NULL;
+			}
+			loader_progress (p - data, size);
+		}
+
+		const unsigned char *list = NULL;
+		p = ply_record_end (face, p, face_end, face_list, &list);
+		int64 count = ply_index (list, count_type);
+		list += PLY_SIZE(count_type);
+
+		int64 k;
+		for (k = 0; k < count; k++) {
+			int64 index = ply_index (list + k * index_size, index_type);
+			if (index < 0 || index >= n_vertices) {
+				warning ("PLY face refers to a nonexistent vertex.");
+				return NULL;
+			}
+		}
+		if (count >= 3)
+			n_triangles += count - 2;
+		else
+			n_degenerate++;
+	}
+
+	if (n_triangles > 0x7fffffff / 4) {
+		warning ("PLY file is too big.");
+		return NULL;
+	}
+	if (!n_triangles) {
+		warning ("PLY file has no triangles.");
+		return NULL;
+	}
+
+	printf ("PLY has %d vertices and %d faces, making up to %d triangles.\n",
+		n_vertices, (int) face->count, (int) n_triangles);
+
+	//----------------------------------------
+	// Find the bounds, to center the mesh.
+	//
+	float min[3] = { 1e30f, 1e30f, 1e30f };
+	float max[3] = { -1e30f, -1e30f, -1e30f };
+	for (i = 0; i < n_vertices; i++) {
+		const unsigned char *record = vertex_data + (unsigned long) i * stride;
+		float v[3];
+		if (all_float) {
+			memcpy (v, record + x_offset, 4);
+			memcpy (v + 1, record + y_offset, 4);
+			memcpy (v + 2, record + z_offset, 4);
+		} else {
+			v[0] = ply_value (record + x_offset, x_type);
+			v[1] = ply_value (record + y_offset, y_type);
+			v[2] = ply_value (record + z_offset, z_type);
+		}
+		int k;
+		for (k = 0; k < 3; k++) {
+			if (v[k] < min[k])
+				min[k] = v[k];
+			if (v[k] > max[k])
+				max[k] = v[k];
+		}
+	}
+
+	IndexedFaceSet *ifs = new IndexedFaceSet ();
+	ifs->reserve (n_vertices, (int) n_triangles);
+
+	float x_center = (max[0] + min[0]) / -2.f;
+	float y_center = (max[1] + min[1]) / -2.f;
+	float z_center = (max[2] + min[2]) / -2.f;
+
+	ifs->maxx = -1e6f;
+	ifs->minx = 1e6f;
+	ifs->maxy = -1e6f;
+	ifs->miny = 1e6f;
+	ifs->maxz = -1e6f;
+	ifs->minz = 1e6f;
+
+	for (i = 0; i < n_vertices; i++) {
+		const unsigned char *record = vertex_data + (unsigned long) i * stride;
+		float v[3];
+		if (all_float) {
+			memcpy (v, record + x_offset, 4);
+			memcpy (v + 1, record + y_offset, 4);
+			memcpy (v + 2, record + z_offset, 4);
+		} else {
+			v[0] = ply_value (record + x_offset, x_type);
+			v[1] = ply_value (record + y_offset, y_type);
+			v[2] = ply_value (record + z_offset, z_type);
+		}
+
+		float *pt = ifs->add_point (v[0]+x_center, v[1]+y_center, v[2]+z_center);
+		pt[0] /= 1000.f;
+		pt[1] /= 1000.f;
+		pt[2] /= 1000.f;
+
+		if (pt[0] < ifs->minx)
+			ifs->minx = pt[0];
+		if (pt[0] > ifs->maxx)
+			ifs->maxx = pt[0];
+		if (pt[1] < ifs->miny)
+			ifs->miny = pt[1];
+		if (pt[1] > ifs->maxy)
+			ifs->maxy = pt[1];
+		if (pt[2] < ifs->minz)
+			ifs->minz = pt[2];
+		if (pt[2] > ifs->maxz)
+			ifs->maxz = pt[2];
+	}
+
+	//----------------------------------------
+	// Make the triangles, splitting each
+	// polygon into a fan around its first
+	// vertex. Triangles that repeat a vertex
+	// have no area and are dropped.
+	//
+	p = face_data;
+	for (j = 0; j < face->count; j++) {
+		if (!(j % PLY_BLOCK_RECORDS)) {
+			if (loader_cancelled ()) {
+				delete ifs;
+				return NULL;
+			}
+			loader_progress (p - data, size);
+		}
+
+		const unsigned char *list = NULL;
+		p = ply_record_end (face, p, face_end, face_list, &list);
+		int count = (int) ply_index (list, count_type);
+		list += PLY_SIZE(count_type);
+
+		int k;
+		int i0 = (int) ply_index (list, index_type);
+		for (k = 1; k + 1 < count; k++) {
+			int i1 = (int) ply_index (list + k * index_size, index_type);
+			int i2 = (int) ply_index (list + (k + 1) * index_size, index_type);
+			if (i0 == i1 || i1 == i2 || i0 == i2) {
+				n_degenerate++;
+				continue;
+			}
+
+			ifs->add_triangle (i0, i1, i2);
+		}
+	}
+
+	if (n_degenerate)
+		printf ("Dropped %d PLY faces or triangles with no area.\n", n_degenerate);
+
+	//----------------------------------------
+	// Vertex normals, if present, are used as
+	// given, except that like smooth_faces()
+	// a point in fewer than three triangles
+	// is drawn flat.
+	//
+	if (vnx >= 0 && vny >= 0 && vnz >= 0) {
+		unsigned char *n_added = (unsigned char*) malloc (n_vertices ? n_vertices : 1);
+		if (!n_added)
+			fatal ("Out of memory!");
+		memset (n_added, 0, n_vertices);
+		for (i = 0; i < 3 * ifs->n_triangles; i++) {
+			uint32 v = ifs->flat->indices [i];
+			if (n_added [v] < 3)
+				n_added [v]++;
+		}
+
+		const PLYProperty *nx = vertex->properties + vnx;
+		const PLYProperty *ny = vertex->properties + vny;
+		const PLYProperty *nz = vertex->properties + vnz;
+		for (i = 0; i < n_vertices; i++) {
+			const unsigned char *record = vertex_data + (unsigned long) i * stride;
+			double x = ply_value (record + nx->offset, nx->type);
+			double y = ply_value (record + ny->offset, ny->type);
+			double z = ply_value (record + nz->offset, nz->type);
+			double mag = sqrt (x*x + y*y + z*z);
+			if (mag > 0. && n_added [i] >= 3) {
+				float *normal = flat_normal (ifs->flat, i);
+				normal [0] = x / mag;
+				normal [1] = y / mag;
+				normal [2] = z / mag;
+				ifs->flat->smooth [i] = 1;
+			}
+		}
+		free (n_added);
+		ifs->normals_given = true;
+	}
+
+	loader_mesh_built ();
+	puts ("Done reading binary PLY file.");
+
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ply_parser
+// Purpose:	Reads a binary PLY file, mapped into memory.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+IndexedFaceSet *
+ply_parser (char *path, Model *m)
+{
+	if (!path)
+		return NULL;
+	//----------
+
+	unsigned long size = 0;
+	const unsigned char *data = map_whole_file (path, &size);
+	if (!data) {
+		perror ("mmap");
+		warning ("Cannot open PLY file.");
+		return NULL;
+	}
+
+	IndexedFaceSet *ifs = ply_parser_data (data, size, m);
+	unmap_whole_file (data, size);
+	return ifs;
+}
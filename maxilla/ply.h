@@ -0,0 +1,38 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _PLY_H
+#define _PLY_H
+
+/*===========================================================================
+ * Name:	ply_parser
+ * Purpose:	Reads a binary little-endian PLY file's vertex and face
+ *		elements into an IndexedFaceSet, which like an STL mesh
+ *		is centered and converted from millimeters to meters.
+ *		Polygons are split into fans of triangles.
+ * Returns:	The IndexedFaceSet, or NULL.
+ */
+extern IndexedFaceSet *ply_parser (char *path, Model *m);
+extern IndexedFaceSet *ply_parser_data (const unsigned char *data, unsigned long size, Model *m);
+
+extern bool is_ply_path (const char *path);
+
+#endif
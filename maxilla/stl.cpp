@@ -1,497 +1,877 @@
-
-/*=============================================================================
-  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
-  Copyright (C) 2008-2010 by Zack T Smith and Ortho Cast Inc.
-
-  This program is free software; you can redistribute it and/or modify
-  it under the terms of the GNU General Public License version 2 
-  as published by the Free Software Foundation.
-
-  This program is distributed in the hope that it will be useful,
-  but WITHOUT ANY WARRANTY; without even the implied warranty of
-  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-  GNU General Public License for more details.
-
-  You should have received a copy of the GNU General Public License
-  along with this program; if not, write to the Free Software
-  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
-
-  The author may be reached at fbui@comcast.net.
- *============================================================================*/
-
-#ifdef WIN32
-	#include <windows.h>
-	#define _USE_MATH_DEFINES
-#else
-	#include <sys/time.h> 	// gettimeofday
-#endif
-
-#include <stdio.h>
-#include <string.h>
-
-#include <math.h>
-
-#include "defs.h"
-
-#ifdef WIN32
-#include "stdafx.h"
-#endif
-
-#include "maxilla.h"
-
-//---------------------------------------------------------------------------
-// Name:	stl_parser
-// Purpose:	Parser for binary STL files.
-//---------------------------------------------------------------------------
-IndexedFaceSet *
-stl_parser (char *path, Model *m)
-{
-	if (!path)
-		return NULL;
-	//----------
-
-	FILE *f = fopen (path, "rb");
-	if (!f) {
-		perror("fopen");
-		return NULL;
-	}
-
-	unsigned char header[80];
-	if (80 != fread ((char*) header, 1, 80, f)) {
-		perror("fread");
-		fclose (f);
-		return NULL;
-	}
-
-	if (!strncmp ((char*) header, "solid", 5)) {
-#ifdef WIN32
-		MessageBox (0, _T("It's an ASCII STL file. That type is unsupported."), 0, 0);
-#else
-		warning ("Selected STL file is the ASCII type, which is unsupported.");
-#endif
-		fclose (f);
-		return NULL;
-	}
-
-	int n_triangles;
-	if (4 != fread ((char*) &n_triangles, 1, 4, f)) {
-		perror("fread");
-		fclose (f);
-		return NULL;
-	}
-	
-	unsigned long amount = (12 * 4 + 2) * n_triangles;
-	unsigned char *buffer = (unsigned char*) malloc (amount);
-	if (!buffer) {
-#ifdef WIN32
-		MessageBoxA (0, "Unable to allocate memory.", 0, 0);
-#else
-		warning ("Out of memory.");
-#endif
-		return NULL;
-	}
-
-	memset(buffer,0,amount);
-
-	if (amount != fread ((void*) buffer, 1, amount, f)) {
-		perror("fread");
-		fclose (f);
-		return NULL;
-	}
-
-	fclose (f);
-
-	IndexedFaceSet *ifs = new IndexedFaceSet ();
-
-	printf ("Binary STL has %d triangles.\n", n_triangles);
-
-	int i;
-	float v[12];
-	int index = 0;
-	float max=-1E6f, min=1E6f;
-
-	ifs->maxx = -1e6f;
-	ifs->minx = 1e6f;
-	ifs->maxy = -1e6f;
-	ifs->miny = 1e6f;
-	ifs->maxz = -1e6f;
-	ifs->minz = 1e6f;
-
-	for (i = 0; i < n_triangles; i++) {
-		unsigned short attr_byte_count;
-
-		memcpy (v, &buffer[index], 12 * 4);
-		index += 12 * 4;
-		memcpy (&attr_byte_count, &buffer[index], 2);
-		index += 2;
-
-		if (attr_byte_count != 0) {
-			puts ("Nonzero attr_byte_count.");
-			delete ifs;
-			return NULL;
-		}
-
-		Point *p1 = Point_new (v[3], v[4], v[5]);
-		Point *p2 = Point_new (v[6], v[7], v[8]);
-		Point *p3 = Point_new (v[9], v[10], v[11]);
-		
-		if (p1->x < ifs->minx)
-			ifs->minx = p1->x;
-		if (p1->x > ifs->maxx)
-			ifs->maxx = p1->x;
-		if (p1->y < ifs->miny)
-			ifs->miny = p1->y;
-		if (p1->y > ifs->maxy)
-			ifs->maxy = p1->y;
-		if (p1->z < ifs->minz)
-			ifs->minz = p1->z;
-		if (p1->z > ifs->maxz)
-			ifs->maxz = p1->z;
-
-		if (p2->x < ifs->minx)
-			ifs->minx = p2->x;
-		if (p2->x > ifs->maxx)
-			ifs->maxx = p2->x;
-		if (p2->y < ifs->miny)
-			ifs->miny = p2->y;
-		if (p2->y > ifs->maxy)
-			ifs->maxy = p2->y;
-		if (p2->z < ifs->minz)
-			ifs->minz = p2->z;
-		if (p2->z > ifs->maxz)
-			ifs->maxz = p2->z;
-
-		if (p3->x < ifs->minx)
-			ifs->minx = p3->x;
-		if (p3->x > ifs->maxx)
-			ifs->maxx = p3->x;
-		if (p3->y < ifs->miny)
-			ifs->miny = p3->y;
-		if (p3->y > ifs->maxy)
-			ifs->maxy = p3->y;
-		if (p3->z < ifs->minz)
-			ifs->minz = p3->z;
-		if (p3->z > ifs->maxz)
-			ifs->maxz = p3->z;
-
-		Point_free (p1);
-		Point_free (p2);
-		Point_free (p3);
-	}
-
-	float x_offset = (ifs->maxx + ifs->minx) / -2.f;
-	float y_offset = (ifs->maxy + ifs->miny) / -2.f;
-	float z_offset = (ifs->maxz + ifs->minz) / -2.f;
-#if 0
-	printf ("x min,max = %g %g\n", ifs->minx, ifs->maxx);
-	printf ("y min,max = %g %g\n", ifs->miny, ifs->maxy);
-	printf ("z min,max = %g %g\n", ifs->minz, ifs->maxz);
-#endif
-	ifs->maxx = -1e6f;
-	ifs->minx = 1e6f;
-	ifs->maxy = -1e6f;
-	ifs->miny = 1e6f;
-	ifs->maxz = -1e6f;
-	ifs->minz = 1e6f;
-
-	index = 0;
-	for (i = 0; i < n_triangles; i++) {
-		unsigned short attr_byte_count;
-
-		memcpy (v, &buffer[index], 12 * 4);
-		index += 12 * 4;
-		memcpy (&attr_byte_count, &buffer[index], 2);
-		index += 2;
-
-		if (attr_byte_count != 0) {
-			puts ("Nonzero attr_byte_count.");
-			delete ifs;
-			return NULL;
-		}
-#if 0
-		printf ("Triangle %d:\n", i);
-		printf ("\tNormal %g %g %g\n", v[0], v[1], v[2]);
-		printf ("\tPoint A %g %g %g\n", v[3], v[4], v[5]);
-		printf ("\tPoint B %g %g %g\n", v[6], v[7], v[8]);
-		printf ("\tPoint C %g %g %g\n", v[9], v[10], v[11]);
-#endif
-		if (ifs->n_points+3 >= ifs->points_size)
-			ifs->expand_points();
-
-		Point *p1 = Point_new (v[3]+x_offset, v[4]+y_offset, v[5]+z_offset);
-		Point *p2 = Point_new (v[6]+x_offset, v[7]+y_offset, v[8]+z_offset);
-		Point *p3 = Point_new (v[9]+x_offset, v[10]+y_offset, v[11]+z_offset);
-		
-		if (p1->x < ifs->minx)
-			ifs->minx = p1->x;
-		if (p1->x > ifs->maxx)
-			ifs->maxx = p1->x;
-		if (p1->y < ifs->miny)
-			ifs->miny = p1->y;
-		if (p1->y > ifs->maxy)
-			ifs->maxy = p1->y;
-		if (p1->z < ifs->minz)
-			ifs->minz = p1->z;
-		if (p1->z > ifs->maxz)
-			ifs->maxz = p1->z;
-
-		if (p2->x < ifs->minx)
-			ifs->minx = p2->x;
-		if (p2->x > ifs->maxx)
-			ifs->maxx = p2->x;
-		if (p2->y < ifs->miny)
-			ifs->miny = p2->y;
-		if (p2->y > ifs->maxy)
-			ifs->maxy = p2->y;
-		if (p2->z < ifs->minz)
-			ifs->minz = p2->z;
-		if (p2->z > ifs->maxz)
-			ifs->maxz = p2->z;
-
-		if (p3->x < ifs->minx)
-			ifs->minx = p3->x;
-		if (p3->x > ifs->maxx)
-			ifs->maxx = p3->x;
-		if (p3->y < ifs->miny)
-			ifs->miny = p3->y;
-		if (p3->y > ifs->maxy)
-			ifs->maxy = p3->y;
-		if (p3->z < ifs->minz)
-			ifs->minz = p3->z;
-		if (p3->z > ifs->maxz)
-			ifs->maxz = p3->z;
-
-		ifs->points[ifs->n_points++] = p1;
-		ifs->points[ifs->n_points++] = p2;
-		ifs->points[ifs->n_points++] = p3;
-	}
-
-	for (i = 0; i < ifs->n_points; i++) {
-		ifs->points[i]->x /= 1000.f;
-		ifs->points[i]->y /= 1000.f;
-		ifs->points[i]->z /= 1000.f;
-	}
-
-	#if 0
-	printf ("x min,max = %g %g\n", ifs->minx, ifs->maxx);
-	printf ("y min,max = %g %g\n", ifs->miny, ifs->maxy);
-	printf ("z min,max = %g %g\n", ifs->minz, ifs->maxz);
-#endif
-
-	ifs->maxx = -1e6f;
-	ifs->minx = 1e6f;
-	ifs->maxy = -1e6f;
-	ifs->miny = 1e6f;
-	ifs->maxz = -1e6f;
-	ifs->minz = 1e6f;
-
-	for (i = 0; i < ifs->n_points; i += 3) {
-		Point *p1 = ifs->points [i];
-		Point *p2 = ifs->points [i+1];
-		Point *p3 = ifs->points [i+2];
-		
-		Triangle *t = new Triangle (p1, p2, p3);
-		t->model = m;
-
-		if (p1->x < ifs->minx)
-			ifs->minx = p1->x;
-		if (p1->x > ifs->maxx)
-			ifs->maxx = p1->x;
-		if (p1->y < ifs->miny)
-			ifs->miny = p1->y;
-		if (p1->y > ifs->maxy)
-			ifs->maxy = p1->y;
-		if (p1->z < ifs->minz)
-			ifs->minz = p1->z;
-		if (p1->z > ifs->maxz)
-			ifs->maxz = p1->z;
-
-		if (p2->x < ifs->minx)
-			ifs->minx = p2->x;
-		if (p2->x > ifs->maxx)
-			ifs->maxx = p2->x;
-		if (p2->y < ifs->miny)
-			ifs->miny = p2->y;
-		if (p2->y > ifs->maxy)
-			ifs->maxy = p2->y;
-		if (p2->z < ifs->minz)
-			ifs->minz = p2->z;
-		if (p2->z > ifs->maxz)
-			ifs->maxz = p2->z;
-
-		if (p3->x < ifs->minx)
-			ifs->minx = p3->x;
-		if (p3->x > ifs->maxx)
-			ifs->maxx = p3->x;
-		if (p3->y < ifs->miny)
-			ifs->miny = p3->y;
-		if (p3->y > ifs->maxy)
-			ifs->maxy = p3->y;
-		if (p3->z < ifs->minz)
-			ifs->minz = p3->z;
-		if (p3->z > ifs->maxz)
-			ifs->maxz = p3->z;
-
-		if (ifs->n_triangles+1 >= ifs->triangles_size)
-			ifs->expand_triangles();
-		ifs->triangles[ifs->n_triangles++] = t;
-	}
-
-#if 0
-	// Test triangle
-	Point *p1 = new Point (0.f,0.f,0.f);
-	Point *p2 = new Point (1.f,0.f,0.f);
-	Point *p3 = new Point (0.f,1.f,0.f);
-		Triangle *t = new Triangle (p1, p2, p3);
-		ifs->triangles[ifs->n_triangles++] = t;
-#endif
-
-	puts ("Done reading binary STL file.");
-
-	free (buffer);
-
-	return ifs;
-}
-
-Model *
-stl_parser_one_file (char *path)
-{
-	Model *m;
-	m = new Model();
-
-	IndexedFaceSet *ifs = stl_parser (path, m);
-	if (!ifs)
-		return NULL;
-
-	Node *node;
-	node = new Node ();
-	m->nodes = node;
-
-	Shape *shape = new Shape ();
-	Appearance *appearance = new Appearance ();
-	Material *material = new Material ();
-	appearance->add_child (material);
-	shape->appearance = appearance;
-
-	node->add_child (shape);
-
-	shape->add_geometry (ifs);
-	return m;
-}
-
-Model *
-stl_parser_two_files (char *path1, char *path2)
-{
-	Model *m;
-	m = new Model();\
-	puts (path1);
-	puts (path2);
-	IndexedFaceSet *ifs1 = stl_parser (path1, m);
-	if (!ifs1)
-		return NULL;
-
-	IndexedFaceSet *ifs2 = stl_parser (path2, m);
-	if (!ifs2) {
-		delete ifs1;
-		return NULL;
-	}
-
-	Node *node;
-	node = new Node ();
-	m->nodes = node;
-
-	Transform *transform1 = new Transform ();
-	Shape *shape1 = new Shape ();
-	Appearance *appearance1 = new Appearance ();
-	Material *material1 = new Material ();
-	appearance1->add_child (material1);
-	shape1->appearance = appearance1;
-	appearance1->parent = shape1;
-	transform1->add_child (shape1);
-	node->add_child (transform1);
-	shape1->add_geometry (ifs1);
-	transform1->translate_y = -0.5f * (ifs1->maxy - ifs1->miny);
-	transform1->operations [0] = Transform::TRANSLATE;
-	transform1->op_index = 1;
-	ifs1->parent = shape1;
-
-	Transform *transform2 = new Transform ();
-	Shape *shape2 = new Shape ();
-	Appearance *appearance2 = new Appearance ();
-	Material *material2 = new Material ();
-	appearance2->add_child (material2);
-	shape2->appearance = appearance2;
-	appearance2->parent = shape2;
-	transform2->add_child (shape2);
-	node->add_child (transform2);
-	shape2->add_geometry (ifs2);
-	transform2->translate_y = 0.5f * (ifs2->maxy - ifs2->miny);
-	transform2->operations [0] = Transform::TRANSLATE;
-	transform2->op_index = 1;
-	ifs2->parent = shape2;
-
-	return m;
-}
-
-
-
-typedef struct {
-	float nx,ny,nz;
-	float x1,y1,z1;
-	float x2,y2,z2;
-	float x3,y3,z3;
-} STLTRI;
-
-void stl_export (IndexedFaceSet *ifs, char *path)
-{
-
-	float scale = 1000.f;
-
-	FILE *fp = NULL;
-
-	fp = fopen(path, "wb");
-
-	if(!fp)
-	{
-		return;
-	}
-
-	if(!ifs)
-		return;
-
-	//write header
-	char* header[80];
-	memset(&header, 0xFF, sizeof(char) * 80);
-	fwrite(header, sizeof(char), 80, fp);
-
-	//tri count
-	fwrite(&ifs->n_triangles, sizeof(unsigned int), 1, fp);
-	
-	//write triangles
-	for(int i=0;i<ifs->n_triangles;i++) 
-	{
-		STLTRI t;
-		memset(&t,0,sizeof(STLTRI));
-
-		//each tri
-		Triangle* tri = ifs->triangles[i];
-		if(tri->normal_vector)
-			t.nx = tri->normal_vector->x; t.ny = tri->normal_vector->y; t.nz = tri->normal_vector->z;
-
-		t.x1 = tri->p1->x * scale; t.y1 = tri->p1->y * scale; t.z1 = tri->p1->z * scale;
-		t.x2 = tri->p2->x * scale; t.y2 = tri->p2->y * scale; t.z2 = tri->p2->z * scale;
-		t.x3 = tri->p3->x * scale; t.y3 = tri->p3->y * scale; t.z3 = tri->p3->z * scale;
-
-		fwrite(&t, sizeof(STLTRI), 1, fp);
-
-		//atrributes
-		char attr[2];
-		attr[0] = 0;
-		attr[1] = 0;
-		fwrite(attr, sizeof(char), 2, fp);
-	}
-	
-	fclose(fp);
-
-}
-
+
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2010 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2 
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#else
+	#include <sys/time.h> 	// gettimeofday
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "numbers.h"
+#include "loader.h"
+#include "threads.h"
+#include "ply.h"
+#include "zipfile.h"
+
+// Vertices of different triangles closer than this, in millimeters,
+// in each coordinate are taken to be the same vertex.
+#define STL_WELD_EPSILON (0.0001f)
+
+// Binary STL triangles welded between checks for cancellation.
+#define STL_BLOCK_TRIANGLES (4096)
+
+/*===========================================================================
+ * Name:	STLWelder
+ * Purpose:	Gathers STL triangles into an indexed mesh, merging
+ *		corners that are the same vertex. Vertices are found
+ *		through a spatial hash: each is chained into the bucket
+ *		of the grid cell it lies in, with cells twice the weld
+ *		epsilon wide, so a match can only be in the up to 8
+ *		cells that the epsilon box around a corner touches.
+ */
+typedef struct {
+	float *vertices;	// 3 floats per vertex, in millimeters.
+	int *next;		// Next vertex in the same bucket.
+	int n_vertices;
+	int vertices_size;
+
+	int *buckets;		// First vertex of each bucket, or -1.
+	unsigned long n_buckets;	// Power of 2.
+
+	int *indices;		// 3 vertex indices per triangle.
+	int n_triangles;
+	int triangles_size;
+	int n_degenerate;
+
+	float min[3], max[3];
+} STLWelder;
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_cell
+// Purpose:	Computes the grid cell of a coordinate.
+//---------------------------------------------------------------------------
+static inline int64
+stl_weld_cell (float value)
+{
+	return (int64) floor (value * (0.5 / STL_WELD_EPSILON));
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_bucket
+// Purpose:	Hashes a grid cell to a bucket.
+//---------------------------------------------------------------------------
+static inline unsigned long
+stl_weld_bucket (STLWelder *w, int64 cx, int64 cy, int64 cz)
+{
+	uint64 h = (uint64) cx * ((((uint64) 0x9e3779b9) << 32) | 0x7f4a7c15);
+	h ^= (uint64) cy * ((((uint64) 0xc2b2ae3d) << 32) | 0x27d4eb4f);
+	h ^= (uint64) cz * ((((uint64) 0x165667b1) << 32) | 0x9e3779f9);
+	h ^= h >> 29;
+	return (unsigned long) h & (w->n_buckets - 1);
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_rehash
+// Purpose:	Doubles the number of buckets.
+//---------------------------------------------------------------------------
+static void
+stl_weld_rehash (STLWelder *w)
+{
+	free (w->buckets);
+	w->n_buckets *= 2;
+	w->buckets = (int*) malloc (w->n_buckets * sizeof(int));
+	if (!w->buckets)
+		fatal ("Out of memory!");
+	memset (w->buckets, 0xff, w->n_buckets * sizeof(int));
+
+	int i;
+	for (i = 0; i < w->n_vertices; i++) {
+		float *v = w->vertices + 3 * i;
+		unsigned long b = stl_weld_bucket (w, stl_weld_cell (v[0]), stl_weld_cell (v[1]), stl_weld_cell (v[2]));
+		w->next [i] = w->buckets [b];
+		w->buckets [b] = i;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_init
+// Purpose:	Prepares a welder for about n_triangles triangles.
+//---------------------------------------------------------------------------
+static void
+stl_weld_init (STLWelder *w, int n_triangles)
+{
+	if (n_triangles < 64)
+		n_triangles = 64;
+
+	// A closed mesh has about half as many vertices as triangles.
+	w->vertices_size = n_triangles / 2 + 16;
+	w->vertices = (float*) malloc (w->vertices_size * 3 * sizeof(float));
+	w->next = (int*) malloc (w->vertices_size * sizeof(int));
+	w->n_vertices = 0;
+
+	w->n_buckets = 64;
+	while (w->n_buckets < (unsigned long) w->vertices_size)
+		w->n_buckets *= 2;
+	w->buckets = (int*) malloc (w->n_buckets * sizeof(int));
+
+	w->triangles_size = n_triangles;
+	w->indices = (int*) malloc (w->triangles_size * 3 * sizeof(int));
+	w->n_triangles = 0;
+	w->n_degenerate = 0;
+
+	if (!w->vertices || !w->next || !w->buckets || !w->indices)
+		fatal ("Out of memory!");
+	memset (w->buckets, 0xff, w->n_buckets * sizeof(int));
+
+	w->min[0] = w->min[1] = w->min[2] = 1e6f;
+	w->max[0] = w->max[1] = w->max[2] = -1e6f;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_free
+// Purpose:	Releases a welder's arrays.
+//---------------------------------------------------------------------------
+static void
+stl_weld_free (STLWelder *w)
+{
+	free (w->vertices);
+	free (w->next);
+	free (w->buckets);
+	free (w->indices);
+	w->vertices = NULL;
+	w->next = NULL;
+	w->buckets = NULL;
+	w->indices = NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_search
+// Purpose:	Looks in one grid cell for a vertex within the weld
+//		epsilon of v.
+// Returns:	Index of the vertex, or -1.
+//---------------------------------------------------------------------------
+static inline int
+stl_weld_search (STLWelder *w, const float *v, int64 cx, int64 cy, int64 cz)
+{
+	int i = w->buckets [stl_weld_bucket (w, cx, cy, cz)];
+	while (i >= 0) {
+		const float *u = w->vertices + 3 * i;
+		if (fabsf (u[0] - v[0]) <= STL_WELD_EPSILON &&
+		    fabsf (u[1] - v[1]) <= STL_WELD_EPSILON &&
+		    fabsf (u[2] - v[2]) <= STL_WELD_EPSILON)
+			return i;
+		i = w->next [i];
+	}
+	return -1;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_vertex
+// Purpose:	Finds the vertex at v, adding it if it is new.
+// Returns:	Index of the vertex.
+//---------------------------------------------------------------------------
+static int
+stl_weld_vertex (STLWelder *w, const float *v)
+{
+	int64 cx = stl_weld_cell (v[0]);
+	int64 cy = stl_weld_cell (v[1]);
+	int64 cz = stl_weld_cell (v[2]);
+
+	//----------------------------------------
+	// Look in the corner's own cell first,
+	// since exact duplicates are the rule,
+	// then in any neighbors within epsilon.
+	//
+	int ix = stl_weld_search (w, v, cx, cy, cz);
+	if (ix >= 0)
+		return ix;
+
+	int64 lo[3], hi[3];
+	int j;
+	for (j = 0; j < 3; j++) {
+		lo[j] = stl_weld_cell (v[j] - STL_WELD_EPSILON);
+		hi[j] = stl_weld_cell (v[j] + STL_WELD_EPSILON);
+	}
+	int64 x, y, z;
+	for (x = lo[0]; x <= hi[0]; x++)
+	for (y = lo[1]; y <= hi[1]; y++)
+	for (z = lo[2]; z <= hi[2]; z++) {
+		if (x == cx && y == cy && z == cz)
+			continue;
+		ix = stl_weld_search (w, v, x, y, z);
+		if (ix >= 0)
+			return ix;
+	}
+
+	//----------------------------------------
+	// It's a new vertex.
+	//
+	if (w->n_vertices >= w->vertices_size) {
+		w->vertices_size *= 2;
+		float *tmp = (float*) realloc (w->vertices, w->vertices_size * 3 * sizeof(float));
+		if (!tmp)
+			fatal ("Out of memory!");
+		w->vertices = tmp;
+		int *tmp2 = (int*) realloc (w->next, w->vertices_size * sizeof(int));
+		if (!tmp2)
+			fatal ("Out of memory!");
+		w->next = tmp2;
+	}
+
+	ix = w->n_vertices++;
+	memcpy (w->vertices + 3 * ix, v, 3 * sizeof(float));
+
+	for (j = 0; j < 3; j++) {
+		if (v[j] < w->min[j])
+			w->min[j] = v[j];
+		if (v[j] > w->max[j])
+			w->max[j] = v[j];
+	}
+
+	if ((unsigned long) w->n_vertices > w->n_buckets)
+		stl_weld_rehash (w);
+	else {
+		unsigned long b = stl_weld_bucket (w, cx, cy, cz);
+		w->next [ix] = w->buckets [b];
+		w->buckets [b] = ix;
+	}
+	return ix;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_triangle
+// Purpose:	Adds a triangle given as 9 floats. A triangle whose
+//		corners weld together has no area and is dropped.
+//---------------------------------------------------------------------------
+static void
+stl_weld_triangle (STLWelder *w, const float *corners)
+{
+	int a = stl_weld_vertex (w, corners);
+	int b = stl_weld_vertex (w, corners + 3);
+	int c = stl_weld_vertex (w, corners + 6);
+
+	if (a == b || b == c || a == c) {
+		w->n_degenerate++;
+		return;
+	}
+
+	if (w->n_triangles >= w->triangles_size) {
+		w->triangles_size *= 2;
+		int *tmp = (int*) realloc (w->indices, w->triangles_size * 3 * sizeof(int));
+		if (!tmp)
+			fatal ("Out of memory!");
+		w->indices = tmp;
+	}
+
+	int *ix = w->indices + 3 * w->n_triangles++;
+	ix[0] = a;
+	ix[1] = b;
+	ix[2] = c;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_weld_finish
+// Purpose:	Makes an IndexedFaceSet from the welded mesh, centered
+//		and converted from millimeters to meters, and frees the
+//		welder.
+//---------------------------------------------------------------------------
+static IndexedFaceSet *
+stl_weld_finish (STLWelder *w)
+{
+	if (w->n_degenerate)
+		printf ("Dropped %d STL triangles with no area.\n", w->n_degenerate);
+	printf ("Welded STL corners into %d vertices.\n", w->n_vertices);
+
+	if (!w->n_triangles) {
+		warning ("STL file has no triangles.");
+		stl_weld_free (w);
+		return NULL;
+	}
+
+	IndexedFaceSet *ifs = new IndexedFaceSet ();
+	ifs->reserve (w->n_vertices, w->n_triangles);
+
+	float x_offset = (w->max[0] + w->min[0]) / -2.f;
+	float y_offset = (w->max[1] + w->min[1]) / -2.f;
+	float z_offset = (w->max[2] + w->min[2]) / -2.f;
+
+	ifs->maxx = -1e6f;
+	ifs->minx = 1e6f;
+	ifs->maxy = -1e6f;
+	ifs->miny = 1e6f;
+	ifs->maxz = -1e6f;
+	ifs->minz = 1e6f;
+
+	int i;
+	for (i = 0; i < w->n_vertices; i++) {
+		const float *v = w->vertices + 3 * i;
+		float *p = ifs->add_point (v[0]+x_offset, v[1]+y_offset, v[2]+z_offset);
+		p[0] /= 1000.f;
+		p[1] /= 1000.f;
+		p[2] /= 1000.f;
+
+		if (p[0] < ifs->minx)
+			ifs->minx = p[0];
+		if (p[0] > ifs->maxx)
+			ifs->maxx = p[0];
+		if (p[1] < ifs->miny)
+			ifs->miny = p[1];
+		if (p[1] > ifs->maxy)
+			ifs->maxy = p[1];
+		if (p[2] < ifs->minz)
+			ifs->minz = p[2];
+		if (p[2] > ifs->maxz)
+			ifs->maxz = p[2];
+	}
+
+	for (i = 0; i < w->n_triangles; i++) {
+		const int *ix = w->indices + 3 * i;
+		ifs->add_triangle (ix[0], ix[1], ix[2]);
+	}
+
+	stl_weld_free (w);
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_word_is
+// Purpose:	Checks whether the word of length len is the keyword.
+//---------------------------------------------------------------------------
+static inline bool
+stl_word_is (const char *word, int len, const char *keyword)
+{
+	return len == (int) strlen (keyword) && !memcmp (word, keyword, len);
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser_ascii
+// Purpose:	Parser for ASCII STL files, i.e.
+//			solid name
+//			facet normal nx ny nz
+//			  outer loop
+//			    vertex x y z
+//			    ...
+//			  endloop
+//			endfacet
+//			...
+//			endsolid name
+//		The whole file is scanned in place in memory. Facet
+//		normals are recomputed, and a loop of more than 3
+//		vertices is divided into a fan of triangles.
+//---------------------------------------------------------------------------
+static IndexedFaceSet *
+stl_parser_ascii (const char *text, unsigned long size, Model *m)
+{
+	// An ASCII facet takes roughly 250 bytes.
+	STLWelder welder;
+	stl_weld_init (&welder, (int) (size / 250));
+	int n_triangles = 0;
+
+	float loop[9];		// First, previous and current vertex.
+	int n_loop = 0;
+	bool ok = true;
+	unsigned long i = 0;
+
+	while (ok) {
+		while (i < size && isspace ((unsigned char) text[i]))
+			i++;
+		if (i >= size)
+			break;
+
+		const char *word = text + i;
+		unsigned long start = i;
+		while (i < size && !isspace ((unsigned char) text[i]))
+			i++;
+		int len = (int) (i - start);
+
+		if (stl_word_is (word, len, "vertex")) {
+			float *v = loop + 3 * (n_loop < 2 ? n_loop : 2);
+			for (int j = 0; j < 3; j++) {
+				while (i < size && isspace ((unsigned char) text[i]))
+					i++;
+				double value;
+				int used = vrml_parse_double (text + i, (int) (size - i < 64 ? size - i : 64), &value);
+				if (!used) {
+					ok = false;
+					break;
+				}
+				v[j] = (float) value;
+				i += used;
+			}
+			if (!ok)
+				break;
+
+			//----------------------------------------
+			// From the third vertex on, each one
+			// completes a triangle of the fan.
+			//
+			if (++n_loop >= 3) {
+				stl_weld_triangle (&welder, loop);
+				if (!(++n_triangles & 4095)) {
+					if (loader_cancelled ())
+						ok = false;
+					loader_progress (i, size);
+				}
+				memcpy (loop + 3, loop + 6, 3 * sizeof(float));
+			}
+		}
+		else if (stl_word_is (word, len, "endloop") || stl_word_is (word, len, "endfacet"))
+			n_loop = 0;
+		else if (stl_word_is (word, len, "solid") || stl_word_is (word, len, "endsolid")) {
+			// Skip the name, which may contain anything.
+			while (i < size && text[i] != '\n' && text[i] != '\r')
+				i++;
+		}
+		// Other words, and facet normals, are ignored.
+	}
+
+	if (!ok) {
+		if (!loader_cancelled ())
+			warning ("ASCII STL file has a malformed vertex.");
+		stl_weld_free (&welder);
+		return NULL;
+	}
+
+	printf ("ASCII STL has %d triangles.\n", n_triangles);
+
+	IndexedFaceSet *ifs = stl_weld_finish (&welder);
+	if (!ifs)
+		return NULL;
+
+	loader_mesh_built ();
+	puts ("Done reading ASCII STL file.");
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser_data
+// Purpose:	Parser for binary and ASCII STL files held in memory.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+IndexedFaceSet *
+stl_parser_data (const unsigned char *data, unsigned long size, Model *m)
+{
+	ASSERT_NONZERO (data,"data")
+	//----------
+
+	if (size < 84) {
+		//----------------------------------------
+		// Too short to be binary.
+		//
+		if (size >= 5 && !strncmp ((const char*) data, "solid", 5))
+			return stl_parser_ascii ((const char*) data, size, m);
+		warning ("File is too short to be STL.");
+		return NULL;
+	}
+
+	const unsigned char *header = data;
+	unsigned int n_triangles = header[80] | (header[81] << 8) | (header[82] << 16) | ((unsigned int) header[83] << 24);
+
+	//----------------------------------------
+	// An ASCII file starts with "solid", but
+	// some binary files' headers do as well;
+	// the latter have exactly the length that
+	// their triangle count implies.
+	//
+	if (!strncmp ((const char*) header, "solid", 5) &&
+	    (n_triangles > (size - 84) / 50 ||
+	     84 + 50 * (unsigned long) n_triangles != size))
+		return stl_parser_ascii ((const char*) data, size, m);
+
+	if (n_triangles > (size - 84) / 50) {
+		warning ("Binary STL file is shorter than its triangle count.");
+		return NULL;
+	}
+	
+	printf ("Binary STL has %u triangles.\n", n_triangles);
+
+	//----------------------------------------
+	// Each record is a normal, 3 corners and
+	// an attribute byte count. The records
+	// are welded a block at a time, checking
+	// for cancellation between blocks.
+	//
+	STLWelder welder;
+	stl_weld_init (&welder, n_triangles);
+
+	const unsigned char *records = data + 84;
+	unsigned int done = 0;
+	while (done < n_triangles) {
+		if (loader_cancelled ()) {
+			stl_weld_free (&welder);
+			return NULL;
+		}
+		loader_progress (84 + 50 * (unsigned long) done, size);
+
+		unsigned int count = n_triangles - done;
+		if (count > STL_BLOCK_TRIANGLES)
+			count = STL_BLOCK_TRIANGLES;
+
+		unsigned int i;
+		for (i = 0; i < count; i++) {
+			const unsigned char *record = records + 50 * (unsigned long) (done + i);
+			unsigned short attr_byte_count;
+			memcpy (&attr_byte_count, record + 12 * 4, 2);
+			if (attr_byte_count != 0) {
+				puts ("Nonzero attr_byte_count.");
+				stl_weld_free (&welder);
+				return NULL;
+			}
+
+			float corners[9];
+			memcpy (corners, record + 3 * 4, 9 * 4);
+			stl_weld_triangle (&welder, corners);
+		}
+		done += count;
+	}
+
+	IndexedFaceSet *ifs = stl_weld_finish (&welder);
+	if (!ifs)
+		return NULL;
+
+	loader_mesh_built ();
+	puts ("Done reading binary STL file.");
+
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser
+// Purpose:	Parser for binary and ASCII STL files, mapped into
+//		memory.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+IndexedFaceSet *
+stl_parser (char *path, Model *m)
+{
+	if (!path)
+		return NULL;
+	//----------
+
+	unsigned long size = 0;
+	const unsigned char *data = map_whole_file (path, &size);
+	if (!data) {
+		perror ("mmap");
+		warning ("Cannot open STL file.");
+		return NULL;
+	}
+
+	IndexedFaceSet *ifs = stl_parser_data (data, size, m);
+	unmap_whole_file (data, size);
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_parser
+// Purpose:	Reads a PLY or STL file, according to its name.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+static IndexedFaceSet *
+mesh_parser (char *path, Model *m)
+{
+	if (path && is_ply_path (path))
+		return ply_parser (path, m);
+	return stl_parser (path, m);
+}
+
+//---------------------------------------------------------------------------
+// Name:	mesh_parser_zip
+// Purpose:	Reads a PLY or STL file from a ZIP archive, inflating
+//		it into memory.
+// Returns:	The IndexedFaceSet, or NULL.
+//---------------------------------------------------------------------------
+static IndexedFaceSet *
+mesh_parser_zip (const char *zip_path, const char *member, Model *m)
+{
+	unsigned long size = 0;
+	unsigned char *data = zip_read_member (zip_path, member, &size);
+	if (!data)
+		return NULL;
+
+	IndexedFaceSet *ifs = is_ply_path (member) ?
+		ply_parser_data (data, size, m) : stl_parser_data (data, size, m);
+
+	free (data);
+	total_allocated -= size;
+	return ifs;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser_one
+// Purpose:	Reads one mesh, from a file or from a ZIP archive if
+//		zip_path is set.
+// Returns:	The Model, or NULL.
+//---------------------------------------------------------------------------
+static Model *
+stl_parser_one (const char *zip_path, char *path)
+{
+	Model *m;
+	m = new Model();
+
+	IndexedFaceSet *ifs = zip_path ? mesh_parser_zip (zip_path, path, m) : mesh_parser (path, m);
+	if (!ifs) {
+		delete m;
+		return NULL;
+	}
+
+	Node *node;
+	node = new Node ();
+	m->nodes = node;
+
+	Shape *shape = new Shape ();
+	Appearance *appearance = new Appearance ();
+	Material *material = new Material ();
+	appearance->add_child (material);
+	shape->appearance = appearance;
+	shape->owns_appearance = true;
+
+	node->add_child (shape);
+
+	shape->add_geometry (ifs);
+	return m;
+}
+
+Model *
+stl_parser_one_file (char *path)
+{
+	return stl_parser_one (NULL, path);
+}
+
+/*===========================================================================
+ * Name:	MeshLoad
+ * Purpose:	One of the two files read by stl_parser_pair.
+ */
+typedef struct {
+	const char *zip_path;	// Archive holding path, or NULL.
+	char *path;
+	Model *m;
+	int part;		// For loader_part.
+	IndexedFaceSet *ifs;	// The result, or NULL.
+} MeshLoad;
+
+//---------------------------------------------------------------------------
+// Name:	mesh_load_thread
+// Purpose:	Reads one of two files, on its own thread or not.
+//---------------------------------------------------------------------------
+static void *
+mesh_load_thread (void *arg)
+{
+	MeshLoad *load = (MeshLoad*) arg;
+	loader_part (load->part);
+	if (load->zip_path)
+		load->ifs = mesh_parser_zip (load->zip_path, load->path, load->m);
+	else
+		load->ifs = mesh_parser (load->path, load->m);
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser_pair
+// Purpose:	Reads the lower and upper arches from two files, or two
+//		members of a ZIP archive if zip_path is set, and places
+//		them one above the other. On a multiprocessor the second
+//		is read on another thread while the first is read on
+//		this one.
+// Returns:	The Model, or NULL if either file could not be read.
+//---------------------------------------------------------------------------
+static Model *
+stl_parser_pair (const char *zip_path, char *path1, char *path2)
+{
+	Model *m;
+	m = new Model();
+	puts (path1);
+	puts (path2);
+
+	MeshLoad loads [2];
+	loads[0].path = path1;
+	loads[1].path = path2;
+	for (int i = 0; i < 2; i++) {
+		loads[i].zip_path = zip_path;
+		loads[i].m = m;
+		loads[i].part = i;
+		loads[i].ifs = NULL;
+	}
+
+	void *thread = NULL;
+	if (processor_count () > 1) {
+		loader_parts (2);
+		thread = thread_start (mesh_load_thread, &loads[1]);
+		if (!thread)
+			loader_parts (1);
+	}
+
+	mesh_load_thread (&loads[0]);
+	if (thread)
+		thread_join (thread);
+	else if (loads[0].ifs)
+		mesh_load_thread (&loads[1]);
+	loader_parts (1);
+
+	IndexedFaceSet *ifs1 = loads[0].ifs;
+	IndexedFaceSet *ifs2 = loads[1].ifs;
+	if (!ifs1 || !ifs2) {
+		delete ifs1;
+		delete ifs2;
+		delete m;
+		return NULL;
+	}
+
+	Node *node;
+	node = new Node ();
+	m->nodes = node;
+
+	Transform *transform1 = new Transform ();
+	Shape *shape1 = new Shape ();
+	Appearance *appearance1 = new Appearance ();
+	Material *material1 = new Material ();
+	appearance1->add_child (material1);
+	shape1->appearance = appearance1;
+	shape1->owns_appearance = true;
+	appearance1->parent = shape1;
+	transform1->add_child (shape1);
+	node->add_child (transform1);
+	shape1->add_geometry (ifs1);
+	transform1->translate_y = -0.5f * (ifs1->maxy - ifs1->miny);
+	transform1->operations [0] = Transform::TRANSLATE;
+	transform1->op_index = 1;
+	ifs1->parent = shape1;
+
+	Transform *transform2 = new Transform ();
+	Shape *shape2 = new Shape ();
+	Appearance *appearance2 = new Appearance ();
+	Material *material2 = new Material ();
+	appearance2->add_child (material2);
+	shape2->appearance = appearance2;
+	shape2->owns_appearance = true;
+	appearance2->parent = shape2;
+	transform2->add_child (shape2);
+	node->add_child (transform2);
+	shape2->add_geometry (ifs2);
+	transform2->translate_y = 0.5f * (ifs2->maxy - ifs2->miny);
+	transform2->operations [0] = Transform::TRANSLATE;
+	transform2->op_index = 1;
+	ifs2->parent = shape2;
+
+	return m;
+}
+
+Model *
+stl_parser_two_files (char *path1, char *path2)
+{
+	return stl_parser_pair (NULL, path1, path2);
+}
+
+//---------------------------------------------------------------------------
+// Name:	stl_parser_zip
+// Purpose:	Reads a pair of arches, or a single mesh if member2 is
+//		NULL, from a ZIP archive without extracting them.
+// Returns:	The Model, or NULL.
+//---------------------------------------------------------------------------
+Model *
+stl_parser_zip (char *zip_path, char *member1, char *member2)
+{
+	if (!member2)
+		return stl_parser_one (zip_path, member1);
+	return stl_parser_pair (zip_path, member1, member2);
+}
+
+
+
+typedef struct {
+	float nx,ny,nz;
+	float x1,y1,z1;
+	float x2,y2,z2;
+	float x3,y3,z3;
+} STLTRI;
+
+bool stl_export (IndexedFaceSet *ifs, char *path)
+{
+
+	float scale = 1000.f;
+
+	FILE *fp = NULL;
+
+	if(!ifs)
+		return false;
+
+	fp = fopen(path, "wb");
+
+	if(!fp)
+	{
+		return false;
+	}
+
+	//write header
+	char* header[80];
+	memset(&header, 0xFF, sizeof(char) * 80);
+	fwrite(header, sizeof(char), 80, fp);
+
+	//tri count
+	FlatMesh *m = ifs->lod(saving_lod);
+	fwrite(&m->n_faces, sizeof(unsigned int), 1, fp);
+	
+	//write triangles
+	for(int i=0;i<m->n_faces;i++) 
+	{
+		STLTRI t;
+
+		//each tri
+		const uint32 *v = flat_face(m, i);
+		const float *n = flat_face_normal(m, i);
+		const float *p1 = flat_position(m, v[0]);
+		const float *p2 = flat_position(m, v[1]);
+		const float *p3 = flat_position(m, v[2]);
+		t.nx = n[0]; t.ny = n[1]; t.nz = n[2];
+
+		t.x1 = p1[0] * scale; t.y1 = p1[1] * scale; t.z1 = p1[2] * scale;
+		t.x2 = p2[0] * scale; t.y2 = p2[1] * scale; t.z2 = p2[2] * scale;
+		t.x3 = p3[0] * scale; t.y3 = p3[1] * scale; t.z3 = p3[2] * scale;
+
+		fwrite(&t, sizeof(STLTRI), 1, fp);
+
+		//atrributes
+		char attr[2];
+		attr[0] = 0;
+		attr[1] = 0;
+		fwrite(attr, sizeof(char), 2, fp);
+	}
+	
+	bool ok = !ferror(fp);
+	if(fclose(fp))
+		ok = false;
+	return ok;
+}
+
@@ -0,0 +1,347 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#else
+	#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "threads.h"
+
+#ifdef WIN32
+struct ThreadStart {
+	ThreadFunction function;
+	void *arg;
+};
+
+static DWORD WINAPI
+thread_trampoline (LPVOID param)
+{
+	ThreadStart start = *(ThreadStart*) param;
+	free (param);
+	start.function (start.arg);
+	return 0;
+}
+#endif
+
+//---------------------------------------------------------------------------
+// Name:	thread_start
+// Purpose:	Runs function(arg) in a new thread.
+// Returns:	Handle to pass to thread_join, or NULL on failure.
+//---------------------------------------------------------------------------
+void *
+thread_start (ThreadFunction function, void *arg)
+{
+#ifdef WIN32
+	ThreadStart *start = (ThreadStart*) malloc (sizeof (ThreadStart));
+	if (!start)
+		return NULL;
+	start->function = function;
+	start->arg = arg;
+
+	HANDLE h = CreateThread (0, 0, thread_trampoline, start, 0, 0);
+	if (!h) {
+		free (start);
+		return NULL;
+	}
+	return (void*) h;
+#else
+	pthread_t *thread = (pthread_t*) malloc (sizeof (pthread_t));
+	if (!thread)
+		return NULL;
+	if (pthread_create (thread, NULL, function, arg)) {
+		free (thread);
+		return NULL;
+	}
+	return (void*) thread;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	thread_join
+// Purpose:	Waits for a thread to finish and releases its handle.
+//---------------------------------------------------------------------------
+void
+thread_join (void *thread)
+{
+	if (!thread)
+		return;
+#ifdef WIN32
+	WaitForSingleObject ((HANDLE) thread, INFINITE);
+	CloseHandle ((HANDLE) thread);
+#else
+	pthread_join (*(pthread_t*) thread, NULL);
+	free (thread);
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	thread_current
+// Returns:	An identifier of the calling thread, unique among the
+//		threads now running.
+//---------------------------------------------------------------------------
+unsigned long
+thread_current ()
+{
+#ifdef WIN32
+	return (unsigned long) GetCurrentThreadId ();
+#else
+	return (unsigned long) pthread_self ();
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	processor_count
+// Returns:	Number of CPUs available, at least 1.
+//---------------------------------------------------------------------------
+int
+processor_count ()
+{
+	static int count = 0;
+	if (count)
+		return count;
+
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo (&info);
+	count = info.dwNumberOfProcessors;
+#else
+	count = (int) sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+	if (count < 1)
+		count = 1;
+	return count;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Mutex::Mutex
+//---------------------------------------------------------------------------
+Mutex::Mutex ()
+{
+#ifdef WIN32
+	CRITICAL_SECTION *cs = new CRITICAL_SECTION;
+	InitializeCriticalSection (cs);
+	handle = (void*) cs;
+#else
+	pthread_mutex_init (&mutex, NULL);
+#endif
+}
+
+Mutex::~Mutex ()
+{
+#ifdef WIN32
+	DeleteCriticalSection ((CRITICAL_SECTION*) handle);
+	delete (CRITICAL_SECTION*) handle;
+#else
+	pthread_mutex_destroy (&mutex);
+#endif
+}
+
+void
+Mutex::lock ()
+{
+#ifdef WIN32
+	EnterCriticalSection ((CRITICAL_SECTION*) handle);
+#else
+	pthread_mutex_lock (&mutex);
+#endif
+}
+
+void
+Mutex::unlock ()
+{
+#ifdef WIN32
+	LeaveCriticalSection ((CRITICAL_SECTION*) handle);
+#else
+	pthread_mutex_unlock (&mutex);
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	Semaphore::Semaphore
+//---------------------------------------------------------------------------
+Semaphore::Semaphore (int initial_count)
+{
+#ifdef WIN32
+	handle = (void*) CreateSemaphore (NULL, initial_count, 0x7fffffff, NULL);
+	if (!handle)
+		fatal ("Unable to create semaphore.");
+#else
+	pthread_mutex_init (&mutex, NULL);
+	pthread_cond_init (&condition, NULL);
+	count = initial_count;
+#endif
+}
+
+Semaphore::~Semaphore ()
+{
+#ifdef WIN32
+	CloseHandle ((HANDLE) handle);
+#else
+	pthread_cond_destroy (&condition);
+	pthread_mutex_destroy (&mutex);
+#endif
+}
+
+void
+Semaphore::wait ()
+{
+#ifdef WIN32
+	WaitForSingleObject ((HANDLE) handle, INFINITE);
+#else
+	pthread_mutex_lock (&mutex);
+	while (count <= 0)
+		pthread_cond_wait (&condition, &mutex);
+	count--;
+	pthread_mutex_unlock (&mutex);
+#endif
+}
+
+void
+Semaphore::post ()
+{
+#ifdef WIN32
+	ReleaseSemaphore ((HANDLE) handle, 1, NULL);
+#else
+	pthread_mutex_lock (&mutex);
+	count++;
+	pthread_cond_signal (&condition);
+	pthread_mutex_unlock (&mutex);
+#endif
+}
+
+//----------------------------------------
+// The worker pool used by parallel_for.
+// Workers are started on first use and
+// live until the program exits, so the
+// objects they wait on are never deleted.
+//
+static Mutex *pool_mutex = new Mutex;
+static Semaphore *pool_start = new Semaphore (0);
+static Semaphore *pool_done = new Semaphore (0);
+static int pool_size = 0;
+static bool pool_busy = false;
+
+static ParallelFunction job_function = NULL;
+static void *job_arg = NULL;
+static int job_count = 0;
+static int job_next = 0;
+
+//---------------------------------------------------------------------------
+// Name:	run_jobs
+// Purpose:	Takes loop indices until there are none left.
+//---------------------------------------------------------------------------
+static void
+run_jobs ()
+{
+	while (true) {
+		pool_mutex->lock ();
+		int index = job_next++;
+		pool_mutex->unlock ();
+
+		if (index >= job_count)
+			break;
+		job_function (job_arg, index);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	pool_worker
+//---------------------------------------------------------------------------
+static void *
+pool_worker (void *arg)
+{
+	while (true) {
+		pool_start->wait ();
+		run_jobs ();
+		pool_done->post ();
+	}
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+// Name:	parallel_for
+//---------------------------------------------------------------------------
+void
+parallel_for (int count, ParallelFunction function, void *arg)
+{
+	if (!function || count <= 0)
+		return;
+
+	bool serial = count == 1 || processor_count () < 2;
+
+	if (!serial) {
+		pool_mutex->lock ();
+		if (pool_busy)
+			serial = true;
+		else {
+			while (pool_size < processor_count () - 1) {
+				void *thread = thread_start (pool_worker, NULL);
+				if (!thread)
+					break;
+				pool_size++;
+			}
+			if (!pool_size)
+				serial = true;
+			else {
+				pool_busy = true;
+				job_function = function;
+				job_arg = arg;
+				job_count = count;
+				job_next = 0;
+			}
+		}
+		pool_mutex->unlock ();
+	}
+
+	if (serial) {
+		for (int i = 0; i < count; i++)
+			function (arg, i);
+		return;
+	}
+
+	int helpers = count - 1 < pool_size ? count - 1 : pool_size;
+	for (int i = 0; i < helpers; i++)
+		pool_start->post ();
+
+	run_jobs ();
+
+	for (int i = 0; i < helpers; i++)
+		pool_done->wait ();
+
+	pool_mutex->lock ();
+	pool_busy = false;
+	pool_mutex->unlock ();
+}
@@ -0,0 +1,97 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+
+#ifndef _THREADS_H
+#define _THREADS_H
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
+
+/*===========================================================================
+ * Name:	thread_start, thread_join
+ * Purpose:	Minimal portable threads: Win32 threads on Windows,
+ *		POSIX threads elsewhere.
+ */
+typedef void *(*ThreadFunction) (void *);
+
+extern void *thread_start (ThreadFunction, void *arg);
+extern void thread_join (void *thread);
+extern unsigned long thread_current ();
+extern int processor_count ();
+
+/*===========================================================================
+ * Name:	Mutex
+ * Purpose:	Mutual exclusion lock.
+ */
+class Mutex {
+public:
+	Mutex ();
+	~Mutex ();
+
+	void lock ();
+	void unlock ();
+
+private:
+#ifdef WIN32
+	void *handle;		// CRITICAL_SECTION*
+#else
+	pthread_mutex_t mutex;
+#endif
+};
+
+/*===========================================================================
+ * Name:	Semaphore
+ * Purpose:	Counting semaphore. Mac OS X has no unnamed POSIX
+ *		semaphores, so outside Windows this is built from a
+ *		mutex and a condition variable.
+ */
+class Semaphore {
+public:
+	Semaphore (int initial_count);
+	~Semaphore ();
+
+	void wait ();
+	void post ();
+
+private:
+#ifdef WIN32
+	void *handle;
+#else
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	int count;
+#endif
+};
+
+/*===========================================================================
+ * Name:	parallel_for
+ * Purpose:	Calls function(arg, i) for i = 0 .. count-1, spread over
+ *		a pool of worker threads and the calling thread, and
+ *		returns when all calls have finished. The order of the
+ *		calls is unspecified. If the pool is already in use,
+ *		e.g. from within a call, the loop simply runs serially.
+ */
+typedef void (*ParallelFunction) (void *arg, int index);
+
+extern void parallel_for (int count, ParallelFunction, void *arg);
+
+#endif
@@ -0,0 +1,665 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "tokenizer.h"
+#include "threads.h"
+#include "zstdfile.h"
+
+//----------------------------------------
+// SSE2 is used to classify 16 bytes at
+// a time where the compiler provides it.
+//
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TOKENIZER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Selects the old character-at-a-time reader and one-word-per-number
+// tree (-per-character-reader).
+bool using_per_character_reader = false;
+
+//----------------------------------------
+// Character classes.
+//
+#define CC_SPACE	(1)	// Ends a word, skipped.
+#define CC_DELIM	(2)	// Ends a word: # " [ ] { }
+#define CC_NUMERIC	(4)	// May be part of a number.
+#define CC_LIST		(8)	// May be part of a word in a list of numbers.
+
+static unsigned char char_class [256];
+static volatile bool char_class_ready = false;
+static Mutex char_class_lock;
+
+//---------------------------------------------------------------------------
+// Name:	init_char_class
+// Purpose:	Sets up the character class table. Files may be opened
+//		on more than one thread, so it is set up under a lock.
+//---------------------------------------------------------------------------
+static void
+init_char_class ()
+{
+	char_class_lock.lock ();
+	if (char_class_ready) {
+		char_class_lock.unlock ();
+		return;
+	}
+
+	memset (char_class, 0, sizeof (char_class));
+	char_class [' '] = char_class ['\t'] = CC_SPACE;
+	char_class ['\r'] = char_class ['\n'] = CC_SPACE;
+	char_class [0xff] = CC_SPACE;
+	char_class ['#'] = char_class ['"'] = CC_DELIM;
+	char_class ['['] = char_class [']'] = CC_DELIM;
+	char_class ['{'] = char_class ['}'] = CC_DELIM;
+	for (int i = '0'; i <= '9'; i++)
+		char_class [i] = CC_NUMERIC;
+	char_class ['.'] = char_class ['-'] = char_class [','] = CC_NUMERIC;
+	for (int i = '0'; i <= '9'; i++)
+		char_class [i] |= CC_LIST;
+	char_class ['.'] |= CC_LIST;
+	char_class ['-'] |= CC_LIST;
+	char_class [','] |= CC_LIST;
+	char_class ['+'] = char_class ['e'] = char_class ['E'] = CC_LIST;
+
+	char_class_ready = true;
+	char_class_lock.unlock ();
+}
+
+#ifdef TOKENIZER_SSE2
+//---------------------------------------------------------------------------
+// Name:	lowest_bit
+// Purpose:	Returns the index of the lowest set bit of a nonzero mask.
+//---------------------------------------------------------------------------
+static inline int
+lowest_bit (int mask)
+{
+#ifdef _MSC_VER
+	unsigned long ix;
+	_BitScanForward (&ix, mask);
+	return (int) ix;
+#else
+	return __builtin_ctz (mask);
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	space_mask
+// Purpose:	Marks the whitespace bytes among 16.
+//---------------------------------------------------------------------------
+static inline __m128i
+space_mask (__m128i v)
+{
+	__m128i m = _mm_cmpeq_epi8 (v, _mm_set1_epi8 (' '));
+	m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\n')));
+	m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\r')));
+	m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('\t')));
+	m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ((char) 0xff)));
+	return m;
+}
+#endif
+
+//---------------------------------------------------------------------------
+// Name:	skip_space
+// Purpose:	Finds the first non-whitespace byte in p[i..n).
+//---------------------------------------------------------------------------
+static unsigned long
+skip_space (const unsigned char *p, unsigned long i, unsigned long n)
+{
+#ifdef TOKENIZER_SSE2
+	while (i + 16 <= n) {
+		__m128i v = _mm_loadu_si128 ((const __m128i*) (p + i));
+		int mask = 0xffff & ~_mm_movemask_epi8 (space_mask (v));
+		if (mask)
+			return i + lowest_bit (mask);
+		i += 16;
+	}
+#endif
+	while (i < n && (char_class [p[i]] & CC_SPACE))
+		i++;
+	return i;
+}
+
+//---------------------------------------------------------------------------
+// Name:	find_word_end
+// Purpose:	Finds the first whitespace or delimiter byte in p[i..n).
+//---------------------------------------------------------------------------
+static unsigned long
+find_word_end (const unsigned char *p, unsigned long i, unsigned long n)
+{
+#ifdef TOKENIZER_SSE2
+	while (i + 16 <= n) {
+		__m128i v = _mm_loadu_si128 ((const __m128i*) (p + i));
+		__m128i m = space_mask (v);
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('#')));
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('"')));
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('[')));
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 (']')));
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('{')));
+		m = _mm_or_si128 (m, _mm_cmpeq_epi8 (v, _mm_set1_epi8 ('}')));
+		int mask = _mm_movemask_epi8 (m);
+		if (mask)
+			return i + lowest_bit (mask);
+		i += 16;
+	}
+#endif
+	while (i < n && !(char_class [p[i]] & (CC_SPACE | CC_DELIM)))
+		i++;
+	return i;
+}
+
+//---------------------------------------------------------------------------
+// Name:	word_is_number
+// Purpose:	Applies getword()'s rules for deciding whether a word
+//		is a number, including a single trailing comma.
+//---------------------------------------------------------------------------
+static bool
+word_is_number (const unsigned char *p, unsigned long n)
+{
+	int commas = 0;
+	for (unsigned long i = 0; i < n; i++) {
+		if (!(char_class [p[i]] & CC_NUMERIC))
+			return false;
+		if (p[i] == ',')
+			commas++;
+	}
+
+	// Too many commas within a number means it is not a number.
+	if (commas > 1)
+		return false;
+
+	// If a number has a comma but it is not the ending char,
+	// or if the string consists only of a comma,
+	// it is not a number.
+	if (commas == 1 && (p[n-1] != ',' || n == 1))
+		return false;
+
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tokenizer_skip_space, tokenizer_word_end,
+//		tokenizer_word_is_number
+// Purpose:	The tokenizer's word splitting rules, for converting
+//		text returned by Tokenizer::numeric_run.
+//---------------------------------------------------------------------------
+unsigned long
+tokenizer_skip_space (const char *p, unsigned long i, unsigned long n)
+{
+	return skip_space ((const unsigned char*) p, i, n);
+}
+
+unsigned long
+tokenizer_word_end (const char *p, unsigned long i, unsigned long n)
+{
+	return find_word_end ((const unsigned char*) p, i, n);
+}
+
+bool
+tokenizer_word_is_number (const char *p, unsigned long n)
+{
+	return word_is_number ((const unsigned char*) p, n);
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::Tokenizer
+// Purpose:	Creates a tokenizer for a file, which is not yet opened.
+//---------------------------------------------------------------------------
+Tokenizer::Tokenizer (InputFile *file_, bool per_character_)
+{
+	ASSERT_NONZERO (file_,"file")
+	//----------
+
+	init_char_class ();
+
+	file = file_;
+	// A file from an archive is only held in memory.
+	per_character = per_character_ && !file->archive;
+	data = NULL;
+	window = NULL;
+	length = ix = 0;
+	consumed = 0;
+	at_eof = true;
+	word[0] = 0;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::~Tokenizer
+// Purpose:	Destroys the tokenizer, closing the file.
+//---------------------------------------------------------------------------
+Tokenizer::~Tokenizer ()
+{
+	close ();
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::open
+// Purpose:	Opens the file for tokenizing.
+//---------------------------------------------------------------------------
+bool
+Tokenizer::open ()
+{
+	if (per_character)
+		return file->open ();
+
+	if (!file->open_mapped ())
+		return false;
+
+	ix = consumed = 0;
+	if (file->mapped) {
+		data = file->mapped;
+		length = file->mapped_size;
+		at_eof = true;
+	} else {
+		window = (unsigned char*) malloc (TOKENIZER_WINDOWSIZE);
+		if (!window)
+			fatal ("Out of memory!");
+		total_allocated += TOKENIZER_WINDOWSIZE;
+		data = window;
+		length = 0;
+		at_eof = false;
+	}
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::close
+// Purpose:	Closes the file and releases the window.
+//---------------------------------------------------------------------------
+void
+Tokenizer::close ()
+{
+	file->close ();
+
+	if (window) {
+		free (window);
+		total_allocated -= TOKENIZER_WINDOWSIZE;
+	}
+	window = NULL;
+	data = NULL;
+	length = ix = 0;
+	at_eof = true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::more
+// Purpose:	Discards the window up to keep_from and fills the rest
+//		with data from the file. Sets at_eof when there is no more.
+// Returns:	True if data was added.
+//---------------------------------------------------------------------------
+bool
+Tokenizer::more (unsigned long keep_from)
+{
+	if (at_eof || !window)
+		return false;
+
+	unsigned long keep = length - keep_from;
+	if (keep)
+		memmove (window, window + keep_from, keep);
+	length = keep;
+	ix -= keep_from;
+	consumed += keep_from;
+
+	int n = file->read_block (window + keep, TOKENIZER_WINDOWSIZE - keep);
+	if (n <= 0) {
+		at_eof = true;
+		return false;
+	}
+	length += n;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::position
+// Purpose:	Gives the number of (decompressed) bytes of the file
+//		that have been scanned.
+//---------------------------------------------------------------------------
+unsigned long
+Tokenizer::position ()
+{
+	if (per_character && file->zstd)
+		return file->zstd->position ();
+	if (per_character)
+		return file->gzfile ? (unsigned long) gztell (file->gzfile) : 0;
+	return consumed + ix;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::seek
+// Purpose:	Continues scanning from an offset in the file's
+//		(decompressed) data, which should be the start of a word.
+// Returns:	False if the offset cannot be reached.
+//---------------------------------------------------------------------------
+bool
+Tokenizer::seek (unsigned long offset)
+{
+	if (per_character || !data)
+		return false;
+
+	if (file->mapped) {
+		if (offset > length)
+			return false;
+		ix = offset;
+		return true;
+	}
+
+	if (!file->seek (offset))
+		return false;
+	length = ix = 0;
+	consumed = offset;
+	at_eof = false;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::size
+// Purpose:	Gives the size of the file's (decompressed) data.
+// Returns:	The size, or 0 if it is not known.
+//---------------------------------------------------------------------------
+unsigned long
+Tokenizer::size ()
+{
+	return file->data_size;
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::numeric_run
+// Purpose:	Locates a run of text, starting at the current position,
+//		that holds nothing but whitespace and words made of the
+//		characters of numbers, and that ends on a word boundary.
+//		Such text can be split into words at any whitespace, so
+//		it may be converted in pieces, in parallel. The run is
+//		consumed, and is valid only until the next call.
+// Returns:	False if there is no such text here.
+//---------------------------------------------------------------------------
+bool
+Tokenizer::numeric_run (const char **str_return, unsigned long *length_return)
+{
+	ASSERT_NONZERO (str_return,"str_return")
+	ASSERT_NONZERO (length_return,"length_return")
+	//----------
+
+	if (per_character || !data)
+		return false;
+
+	while (true) {
+		unsigned long end = ix;
+		while (end < length && (char_class [data[end]] & (CC_SPACE | CC_LIST)))
+			end++;
+
+		//----------------------------------------
+		// At the end of the window, read more
+		// unless the run is already long.
+		//
+		if (end == length && !at_eof && end - ix < TOKENIZER_WINDOWSIZE / 2) {
+			more (ix);
+			continue;
+		}
+
+		//----------------------------------------
+		// The run must end at the end of the file
+		// or at a delimiter other than a quote
+		// (a word ended by a quote is not a number);
+		// otherwise back off to whitespace.
+		//
+		bool boundary;
+		if (end == length)
+			boundary = at_eof;
+		else
+			boundary = (char_class [data[end]] & CC_DELIM) && data[end] != '"';
+		if (!boundary)
+			while (end > ix && !(char_class [data[end-1]] & CC_SPACE))
+				end--;
+
+		if (end == ix)
+			return false;
+
+		*str_return = (const char*) data + ix;
+		*length_return = end - ix;
+		ix = end;
+		return true;
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::next
+// Purpose:	Locates the next word, which is not NUL-terminated and
+//		is only valid until the next call.
+//		Words are split exactly as getword() splits them.
+// Returns:	Length or EOF.
+//---------------------------------------------------------------------------
+int
+Tokenizer::next (const char **str_return, const int len, bool *is_number_return)
+{
+	ASSERT_NONZERO (str_return,"str_return")
+	//----------
+
+	if (is_number_return)
+		*is_number_return = false;
+
+	if (per_character) {
+		int n = ::getword (file, word, len, is_number_return);
+		*str_return = word;
+		return n;
+	}
+
+	const unsigned long maxlen = len - 1;
+
+	while (true) {
+		//----------------------------------------
+		// Skip whitespace and comments.
+		//
+		ix = skip_space (data, ix, length);
+		if (ix >= length) {
+			if (at_eof)
+				return EOF;
+			more (length);
+			continue;
+		}
+		if (data[ix] == '#') {
+			const unsigned char *nl;
+			while (!(nl = (const unsigned char*) memchr (data + ix, '\n', length - ix))) {
+				ix = length;
+				if (!more (length))
+					break;
+			}
+			ix = nl ? (nl - data) + 1 : length;
+			continue;
+		}
+
+		const unsigned long start = ix;
+		const unsigned char ch = data[start];
+		unsigned long end;
+
+		//----------------------------------------
+		// Brackets & braces.
+		//
+		if (ch=='[' || ch==']' || ch=='{' || ch=='}') {
+			*str_return = (const char*) data + start;
+			ix++;
+			return 1;
+		}
+
+		//----------------------------------------
+		// Quoted strings. Any character up to the
+		// closing quote is part of the string.
+		//
+		if (ch == '"') {
+			unsigned long limit = start + 1 + maxlen;
+			if (limit > length)
+				limit = length;
+			const unsigned char *q = (const unsigned char*)
+				memchr (data + start + 1, '"', limit - start - 1);
+			if (q) {
+				*str_return = (const char*) data + start + 1;
+				ix = (q - data) + 1;
+				return (int) (q - data - start - 1);
+			}
+			if (limit < start + 1 + maxlen && !at_eof) {
+				more (start);
+				continue;
+			}
+
+			// Truncated, or unterminated at end of file.
+			*str_return = (const char*) data + start + 1;
+			ix = limit;
+			return limit > start + 1 ? (int) (limit - start - 1) : EOF;
+		}
+
+		//----------------------------------------
+		// Regular words, which may be numbers.
+		//
+		unsigned long limit = start + maxlen;
+		if (limit > length)
+			limit = length;
+		end = find_word_end (data, start, limit);
+		if (end == limit) {
+			if (limit < start + maxlen && !at_eof) {
+				more (start);
+				continue;
+			}
+			if (limit == start + maxlen) {
+				// Truncated words are never numbers.
+				*str_return = (const char*) data + start;
+				ix = end;
+				return (int) maxlen;
+			}
+		}
+
+		*str_return = (const char*) data + start;
+		ix = end;
+
+		// A word ended by a quote is never a number.
+		if (is_number_return && (end == length || data[end] != '"'))
+			*is_number_return = word_is_number (data + start, end - start);
+
+		return (int) (end - start);
+	}
+}
+
+//---------------------------------------------------------------------------
+// Name:	Tokenizer::getword
+// Purpose:	Copies the next word into buf, NUL-terminated.
+// Returns:	Length or EOF.
+//---------------------------------------------------------------------------
+int
+Tokenizer::getword (char *buf, const int len, bool *is_number_return)
+{
+	const char *str;
+
+	ASSERT_NONZERO (buf,"buffer")
+	//----------
+
+	int n = next (&str, len, is_number_return);
+	if (n == EOF)
+		return EOF;
+
+	if (str != buf)
+		memcpy (buf, str, n);
+	buf[n] = 0;
+	return n;
+}
+
+//---------------------------------------------------------------------------
+// Name:	tokenizer_compare
+// Purpose:	Tokenizes a file with both the per-character reader and
+//		the block-scanning Tokenizer and compares the results
+//		word by word, reporting the first difference.
+// Returns:	True if the two token streams are identical.
+//---------------------------------------------------------------------------
+bool
+tokenizer_compare (char *path)
+{
+	char buf1 [MAXWORDLEN];
+	char buf2 [MAXWORDLEN];
+	unsigned long count = 0;
+	bool same = true;
+
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+	InputFile *file1 = new InputFile (path);
+	InputFile *file2 = new InputFile (path);
+	Tokenizer *old_tok = new Tokenizer (file1, true);
+	Tokenizer *new_tok = new Tokenizer (file2, false);
+
+	if (!file1->valid || !file2->valid || !old_tok->open () || !new_tok->open ()) {
+		printf ("Unable to open %s for comparison.\n", path);
+		same = false;
+	}
+
+	while (same) {
+		bool is_number1, is_number2;
+		int n1 = old_tok->getword (buf1, MAXWORDLEN-1, &is_number1);
+		int n2 = new_tok->getword (buf2, MAXWORDLEN-1, &is_number2);
+
+		if (n1 != n2 || (n1 != EOF &&
+		    (memcmp (buf1, buf2, n1) || is_number1 != is_number2))) {
+			printf ("Tokens differ at word %lu:\n", count);
+			printf ("  per-character: %d '%s'%s\n", n1, n1 == EOF ? "" : buf1,
+				is_number1 ? " (number)" : "");
+			printf ("  tokenizer:     %d '%s'%s\n", n2, n2 == EOF ? "" : buf2,
+				is_number2 ? " (number)" : "");
+			same = false;
+			break;
+		}
+		if (n1 == EOF)
+			break;
+		count++;
+	}
+
+	if (same) {
+		const char *l1 = file1->first_line ? file1->first_line : "";
+		const char *l2 = file2->first_line ? file2->first_line : "";
+		if (strcmp (l1, l2)) {
+			printf ("First lines differ: '%s' versus '%s'\n", l1, l2);
+			same = false;
+		}
+	}
+
+	if (same)
+		printf ("Tokenizers agree: %lu words in %s.\n", count, path);
+
+	delete old_tok;
+	delete new_tok;
+	delete file1;
+	delete file2;
+
+	return same;
+}
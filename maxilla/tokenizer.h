@@ -0,0 +1,78 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _TOKENIZER_H
+#define _TOKENIZER_H
+
+class InputFile;
+
+// Size of the sliding window used for compressed files.
+#define TOKENIZER_WINDOWSIZE (4*1024*1024)
+
+#define MAXWORDLEN 1024
+
+/*===========================================================================
+ * Name:	Tokenizer
+ * Purpose:	Splits a VRML file into words by scanning whole blocks
+ *		of memory, rather than fetching one character at a time
+ *		as getword() does. Uncompressed files are scanned in
+ *		place via a memory mapping; compressed files are inflated
+ *		into a large sliding window.
+ *		The token stream is identical to that of getword().
+ */
+class Tokenizer {
+public:
+	Tokenizer (InputFile *, bool per_character = false);
+	~Tokenizer ();
+
+	bool open ();
+	void close ();
+
+	int next (const char **str_return, const int len, bool *is_number_return);
+	int getword (char *buf, const int len, bool *is_number_return);
+	bool numeric_run (const char **str_return, unsigned long *length_return);
+	unsigned long position ();
+	unsigned long size ();
+	bool seek (unsigned long offset);
+
+private:
+	InputFile *file;
+	const unsigned char *data;	// Mapped file or window.
+	unsigned long length;		// Valid bytes in data.
+	unsigned long ix;		// Scanning position in data.
+	unsigned long consumed;		// Bytes before data[0].
+	unsigned char *window;		// Owned buffer when not mapped.
+	bool at_eof;
+	bool per_character;		// Use the old getword() path.
+	char word [MAXWORDLEN];		// Used only by per_character.
+
+	bool more (unsigned long keep_from);
+};
+
+extern bool using_per_character_reader;
+
+extern int getword (InputFile *, char *buf, const int len, bool *is_number_return);
+extern bool tokenizer_compare (char *path);
+
+extern unsigned long tokenizer_skip_space (const char *p, unsigned long i, unsigned long n);
+extern unsigned long tokenizer_word_end (const char *p, unsigned long i, unsigned long n);
+extern bool tokenizer_word_is_number (const char *p, unsigned long n);
+
+#endif
@@ -0,0 +1,390 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+//----------------------------------------------------------------------------
+// Labs often send a case as a ZIP archive holding the two jaw meshes,
+// or a DST with some PDFs. Such an archive is opened directly: its
+// central directory is scanned for the members to read, and those are
+// inflated into memory and handed to the parsers, so that nothing is
+// extracted to disk. The two meshes of a pair are inflated in parallel,
+// each thread through its own handle on the archive.
+//
+// minizip, from zlib's contrib directory, reads the archive. It is
+// built with NOUNCRYPT; encrypted members are not read.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "loader.h"
+#include "ply.h"
+#include "zipfile.h"
+
+#ifdef WIN32
+#include "../../zlib/contrib/minizip/unzip.h"
+#else
+#include "../zlib/contrib/minizip/unzip.h"
+#endif
+
+// Bytes inflated between checks for cancellation.
+#define ZIP_READ_CHUNK (1024*1024)
+
+//---------------------------------------------------------------------------
+// Name:	zip_has_suffix
+// Purpose:	Tells whether a name ends in a suffix, ignoring case.
+//---------------------------------------------------------------------------
+static bool
+zip_has_suffix (const char *name, const char *suffix)
+{
+	int len = strlen (name);
+	int suffix_len = strlen (suffix);
+	if (len < suffix_len)
+		return false;
+
+	name += len - suffix_len;
+	for (int i = 0; i < suffix_len; i++)
+		if (tolower ((unsigned char) name [i]) != tolower ((unsigned char) suffix [i]))
+			return false;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	is_zip_path
+// Purpose:	Tells whether a path names a ZIP archive.
+//---------------------------------------------------------------------------
+bool
+is_zip_path (const char *path)
+{
+	return path && zip_has_suffix (path, ".zip");
+}
+
+//---------------------------------------------------------------------------
+// Name:	zip_member_skipped
+// Purpose:	Tells whether a member is not worth considering: a
+//		directory, an encrypted file, or the resource forks
+//		that the Mac OS X Finder adds to archives.
+//---------------------------------------------------------------------------
+static bool
+zip_member_skipped (const char *name, const unz_file_info *info)
+{
+	const char *base = strrchr (name, '/');
+	base = base ? base + 1 : name;
+
+	return !*base || (info->flag & 1) ||
+		!strncmp (name, "__MACOSX/", 9) || strstr (name, "/__MACOSX/") ||
+		!strncmp (base, "._", 2);
+}
+
+//---------------------------------------------------------------------------
+// Name:	zip_jaw_partner
+// Purpose:	Makes the name of the other member of a jaw pair, by the
+//		same rule as load_stl: a name ending in _Maxillar.stl
+//		pairs with _Mandibular.stl, and likewise for .ply.
+// Returns:	True if the name is one of a pair; is_mandibular_return
+//		then tells which.
+//---------------------------------------------------------------------------
+static bool
+zip_jaw_partner (const char *name, char *partner_return, bool *is_mandibular_return)
+{
+	static const char *maxillar = "_Maxillar";
+	static const char *mandibular = "_Mandibular";
+
+	int len = strlen (name);
+	if (len < 4)
+		return false;
+
+	const char *extension = name + len - 4;
+	char suffix [32];
+	bool is_mandibular;
+
+	sprintf (suffix, "%s%.4s", mandibular, extension);
+	if (zip_has_suffix (name, suffix))
+		is_mandibular = true;
+	else {
+		sprintf (suffix, "%s%.4s", maxillar, extension);
+		if (!zip_has_suffix (name, suffix))
+			return false;
+		is_mandibular = false;
+	}
+
+	if (!zip_has_suffix (name, ".stl") && !is_ply_path (name))
+		return false;
+
+	int prefix_len = len - strlen (suffix);
+	if (prefix_len + strlen (maxillar) + strlen (mandibular) + 4 >= ZIP_NAME_SIZE)
+		return false;
+
+	memcpy (partner_return, name, prefix_len);
+	sprintf (partner_return + prefix_len, "%s%s",
+		is_mandibular ? maxillar : mandibular, extension);
+	*is_mandibular_return = is_mandibular;
+	return true;
+}
+
+//---------------------------------------------------------------------------
+// Name:	zip_bundle_scan
+// Purpose:	Looks through an archive's directory for a case: first a
+//		pair of jaw meshes, else a DST or VRML file, else any
+//		one STL or PLY mesh. Nothing is inflated.
+// Returns:	False if the archive cannot be read or holds none.
+//---------------------------------------------------------------------------
+bool
+zip_bundle_scan (const char *zip_path, ZipBundle *bundle)
+{
+	ASSERT_NONZERO (zip_path,"zip_path")
+	ASSERT_NONZERO (bundle,"bundle")
+	//----------
+
+	memset (bundle, 0, sizeof (ZipBundle));
+
+	unzFile uf = unzOpen (zip_path);
+	if (!uf)
+		return false;
+
+	char name [ZIP_NAME_SIZE];
+	char partner [ZIP_NAME_SIZE];
+	char mesh [ZIP_NAME_SIZE];
+	mesh[0] = 0;
+
+	int err = unzGoToFirstFile (uf);
+	while (err == UNZ_OK) {
+		unz_file_info info;
+		if (UNZ_OK != unzGetCurrentFileInfo (uf, &info, name, sizeof (name), NULL, 0, NULL, 0))
+			break;
+
+		bool is_mandibular;
+		if (zip_member_skipped (name, &info)) {
+			// Nothing to do.
+		}
+		else if (zip_jaw_partner (name, partner, &is_mandibular)) {
+			//----------------------------------------
+			// If found, the partner becomes current,
+			// and its name as stored is fetched.
+			// Otherwise the current member is kept.
+			//
+			if (UNZ_OK == unzLocateFile (uf, partner, 2) &&
+			    UNZ_OK == unzGetCurrentFileInfo (uf, &info, partner, sizeof (partner), NULL, 0, NULL, 0) &&
+			    !zip_member_skipped (partner, &info)) {
+				strcpy (bundle->mesh1, is_mandibular ? name : partner);
+				strcpy (bundle->mesh2, is_mandibular ? partner : name);
+				break;
+			}
+			if (!mesh[0])
+				strcpy (mesh, name);
+		}
+		else if (zip_has_suffix (name, ".dst") || zip_has_suffix (name, ".wrl") ||
+			 zip_has_suffix (name, ".vrml") || zip_has_suffix (name, ".wrl.gz")) {
+			if (!bundle->scene[0])
+				strcpy (bundle->scene, name);
+		}
+		else if (zip_has_suffix (name, ".stl") || is_ply_path (name)) {
+			if (!mesh[0])
+				strcpy (mesh, name);
+		}
+
+		err = unzGoToNextFile (uf);
+	}
+	unzClose (uf);
+
+	if (bundle->mesh2[0])
+		bundle->scene[0] = 0;
+	else if (!bundle->scene[0])
+		strcpy (bundle->mesh1, mesh);
+
+	return bundle->mesh1[0] || bundle->scene[0];
+}
+
+//---------------------------------------------------------------------------
+// Name:	zip_read_member
+// Purpose:	Inflates one member of an archive into memory, checking
+//		its CRC. Each call opens the archive for itself, so
+//		that two threads can read members at once.
+// Returns:	The malloc'd data, counted in total_allocated, or NULL.
+//---------------------------------------------------------------------------
+unsigned char *
+zip_read_member (const char *zip_path, const char *member, unsigned long *size_return)
+{
+	ASSERT_NONZERO (zip_path,"zip_path")
+	ASSERT_NONZERO (member,"member")
+	ASSERT_NONZERO (size_return,"size_return")
+	//----------
+
+	unzFile uf = unzOpen (zip_path);
+	if (!uf) {
+		warning ("Cannot open ZIP file.");
+		return NULL;
+	}
+
+	unz_file_info info;
+	if (UNZ_OK != unzLocateFile (uf, member, 1) ||
+	    UNZ_OK != unzGetCurrentFileInfo (uf, &info, NULL, 0, NULL, 0, NULL, 0) ||
+	    !info.uncompressed_size ||
+	    UNZ_OK != unzOpenCurrentFile (uf)) {
+		unzClose (uf);
+		warning ("Cannot read file from ZIP archive.");
+		return NULL;
+	}
+
+	unsigned long size = info.uncompressed_size;
+	unsigned char *data = (unsigned char*) malloc (size);
+	if (!data) {
+		unzCloseCurrentFile (uf);
+		unzClose (uf);
+		warning ("Out of memory.");
+		return NULL;
+	}
+
+	//----------------------------------------
+	// The size is the one the directory gives;
+	// minizip checks the CRC once all of it
+	// has been read.
+	//
+	unsigned long done = 0;
+	bool ok = true;
+	while (ok && done < size) {
+		if (loader_cancelled ()) {
+			ok = false;
+			break;
+		}
+		loader_progress (done, size);
+
+		unsigned long count = size - done;
+		if (count > ZIP_READ_CHUNK)
+			count = ZIP_READ_CHUNK;
+		int n = unzReadCurrentFile (uf, data + done, (unsigned) count);
+		if (n <= 0)
+			ok = false;
+		else
+			done += n;
+	}
+
+	int err = unzCloseCurrentFile (uf);
+	unzClose (uf);
+
+	if (!ok || err != UNZ_OK) {
+		free (data);
+		if (!loader_cancelled ())
+			warning ("File in ZIP archive is damaged.");
+		return NULL;
+	}
+
+	total_allocated += size;
+	*size_return = size;
+	return data;
+}
+
+//---------------------------------------------------------------------------
+// Name:	gunzip_memory
+// Purpose:	Inflates gzipped data held in memory, such as a DST file
+//		read from an archive. The size stored at the end of the
+//		data, if plausible, sizes the buffer.
+// Returns:	The malloc'd data, counted in total_allocated, or NULL.
+//---------------------------------------------------------------------------
+unsigned char *
+gunzip_memory (const unsigned char *data, unsigned long size, unsigned long *size_return)
+{
+	ASSERT_NONZERO (data,"data")
+	ASSERT_NONZERO (size_return,"size_return")
+	//----------
+
+	if (size < 18)
+		return NULL;
+
+	const unsigned char *trailer = data + size - 4;
+	unsigned long capacity = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) |
+		((unsigned long) trailer[3] << 24);
+	if (capacity < size)
+		capacity = 4 * size;
+
+	unsigned char *out = (unsigned char*) malloc (capacity);
+	if (!out)
+		return NULL;
+
+	z_stream zs;
+	memset (&zs, 0, sizeof (zs));
+	if (Z_OK != inflateInit2 (&zs, 15 + 16)) {
+		free (out);
+		return NULL;
+	}
+	zs.next_in = (Bytef*) data;
+	zs.avail_in = (uInt) size;
+
+	//----------------------------------------
+	// Concatenated gzip members, which zlib
+	// reads as one file, are read likewise;
+	// anything else after a member is not.
+	//
+	unsigned long length = 0;
+	int err = Z_OK;
+	for (;;) {
+		if (length == capacity) {
+			unsigned char *bigger = (unsigned char*) realloc (out, 2 * capacity);
+			if (!bigger) {
+				err = Z_MEM_ERROR;
+				break;
+			}
+			out = bigger;
+			capacity *= 2;
+		}
+		zs.next_out = out + length;
+		zs.avail_out = (uInt) (capacity - length);
+		err = inflate (&zs, Z_NO_FLUSH);
+		length = capacity - zs.avail_out;
+
+		if (err == Z_STREAM_END) {
+			if (zs.avail_in < 2 || zs.next_in[0] != 0x1f || zs.next_in[1] != 0x8b)
+				break;
+			err = inflateReset (&zs);
+		}
+		if (err != Z_OK && !(err == Z_BUF_ERROR && length == capacity))
+			break;
+	}
+	inflateEnd (&zs);
+
+	if (err != Z_STREAM_END || !length) {
+		free (out);
+		return NULL;
+	}
+
+	if (length < capacity) {
+		unsigned char *smaller = (unsigned char*) realloc (out, length);
+		if (smaller)
+			out = smaller;
+	}
+
+	total_allocated += length;
+	*size_return = length;
+	return out;
+}
@@ -0,0 +1,44 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _ZIPFILE_H
+#define _ZIPFILE_H
+
+// Longest member name that minizip reports.
+#define ZIP_NAME_SIZE (256)
+
+/*===========================================================================
+ * Name:	ZipBundle
+ * Purpose:	The members of a case bundle, as found by zip_bundle_scan.
+ *		Names are empty if not present. A jaw pair is read as
+ *		mesh1 and mesh2, a lone mesh as mesh1 only.
+ */
+typedef struct {
+	char mesh1 [ZIP_NAME_SIZE];	// _Mandibular mesh, or the only one.
+	char mesh2 [ZIP_NAME_SIZE];	// _Maxillar mesh.
+	char scene [ZIP_NAME_SIZE];	// DST or VRML file.
+} ZipBundle;
+
+extern bool is_zip_path (const char *path);
+extern bool zip_bundle_scan (const char *zip_path, ZipBundle *bundle);
+extern unsigned char *zip_read_member (const char *zip_path, const char *member, unsigned long *size_return);
+extern unsigned char *gunzip_memory (const unsigned char *data, unsigned long size, unsigned long *size_return);
+
+#endif
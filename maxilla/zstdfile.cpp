@@ -0,0 +1,432 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+//----------------------------------------------------------------------------
+// DST files are normally gzipped, which every VRML tool can read, but
+// zstd inflates several times faster and compresses about as well, so
+// a DST can instead be saved as a single zstd frame (see saving_zstd),
+// followed by a skippable frame that gives the size of its data.
+// A file is recognized by the frame's magic number, not its extension.
+//
+// zstd support is compiled in only when USE_ZSTD is defined, since
+// libzstd is not available everywhere Maxilla is built. Without it such
+// files are recognized but refused.
+//----------------------------------------------------------------------------
+
+#ifdef WIN32
+	#include <windows.h>
+	#define _USE_MATH_DEFINES
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "defs.h"
+
+#ifdef WIN32
+#include "stdafx.h"
+#endif
+
+#include "maxilla.h"
+#include "cache.h"
+#include "threads.h"
+#include "zstdfile.h"
+
+//---------------------------------------------------------------------------
+// Name:	zstd_magic
+// Purpose:	Checks for the magic number that begins a zstd frame.
+//---------------------------------------------------------------------------
+bool
+zstd_magic (const unsigned char *p, unsigned long n)
+{
+	return p && n >= 4 && 
+		p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd;
+}
+
+//---------------------------------------------------------------------------
+// Name:	zstd_path_magic
+// Purpose:	Checks whether a file begins with a zstd frame.
+//---------------------------------------------------------------------------
+bool
+zstd_path_magic (const char *path)
+{
+	FILE *f = path ? fopen (path, "rb") : NULL;
+	if (!f)
+		return false;
+
+	unsigned char magic[4];
+	unsigned long n = (unsigned long) fread (magic, 1, 4, f);
+	fclose (f);
+	return zstd_magic (magic, n);
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::ZstdReader
+//---------------------------------------------------------------------------
+ZstdReader::ZstdReader ()
+{
+	data_size = 0;
+	f = NULL;
+	stream = NULL;
+	input = NULL;
+	input_size = 0;
+	in_length = in_ix = 0;
+	total_out = 0;
+	frame_ended = false;
+	failed = false;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::~ZstdReader
+//---------------------------------------------------------------------------
+ZstdReader::~ZstdReader ()
+{
+#ifdef USE_ZSTD
+	if (stream)
+		ZSTD_freeDStream ((ZSTD_DStream*) stream);
+#endif
+	if (input) {
+		free (input);
+		total_allocated -= input_size;
+	}
+	if (f)
+		fclose (f);
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::open
+// Purpose:	Opens a zstd file and reads the size of its data from
+//		the frame header, when the writer recorded it there,
+//		or else from the skippable frame that ZstdWriter puts
+//		at the end.
+// Returns:	False if the file cannot be read as zstd.
+//---------------------------------------------------------------------------
+bool
+ZstdReader::open (const char *path)
+{
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+#ifndef USE_ZSTD
+	printf ("%s is compressed with zstd, which this build does not support.\n", path);
+	return false;
+#else
+	if (f)
+		return false;
+	f = fopen (path, "rb");
+	if (!f)
+		return false;
+
+	input_size = (unsigned long) ZSTD_DStreamInSize ();
+	input = (unsigned char*) malloc (input_size);
+	stream = ZSTD_createDStream ();
+	if (!input || !stream)
+		fatal ("Out of memory!");
+	total_allocated += input_size;
+
+	unsigned char trailer [ZSTDFILE_TRAILERSIZE];
+	unsigned long trailer_size = 0;
+	if (!fseek (f, -ZSTDFILE_TRAILERSIZE, SEEK_END) &&
+	    ZSTDFILE_TRAILERSIZE == fread (trailer, 1, ZSTDFILE_TRAILERSIZE, f) &&
+	    decode_u32 (trailer) == ZSTDFILE_TRAILERMAGIC &&
+	    decode_u32 (trailer + 4) == 8 &&
+	    decode_u64 (trailer + 8) == (unsigned long) decode_u64 (trailer + 8))
+		trailer_size = (unsigned long) decode_u64 (trailer + 8);
+
+	if (!restart ())
+		return false;
+
+	//----------------------------------------
+	// Peek at the frame header. The sizes
+	// that mean unknown or error are huge.
+	//
+	in_length = (unsigned long) fread (input, 1, ZSTD_FRAMEHEADERSIZE_MAX, f);
+	if (!zstd_magic (input, in_length))
+		return false;
+	unsigned long long size = ZSTD_getFrameContentSize (input, in_length);
+	if (size < ZSTD_CONTENTSIZE_ERROR && size == (unsigned long) size)
+		data_size = (unsigned long) size;
+	else if (size == ZSTD_CONTENTSIZE_UNKNOWN)
+		data_size = trailer_size;
+	return true;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::restart
+// Purpose:	Goes back to the start of the file and the frame.
+//---------------------------------------------------------------------------
+bool
+ZstdReader::restart ()
+{
+#ifdef USE_ZSTD
+	if (!f || !stream || fseek (f, 0, SEEK_SET))
+		return false;
+	if (ZSTD_isError (ZSTD_initDStream ((ZSTD_DStream*) stream)))
+		return false;
+	in_length = in_ix = 0;
+	total_out = 0;
+	frame_ended = false;
+	failed = false;
+	return true;
+#else
+	return false;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::read
+// Purpose:	Reads up to size bytes of decompressed data.
+//		Frames that follow the first, as written by
+//		concatenating zstd files, are read on in turn.
+// Returns:	Number of bytes read, 0 at end of file, -1 on error.
+//---------------------------------------------------------------------------
+int
+ZstdReader::read (unsigned char *dest, int size)
+{
+#ifdef USE_ZSTD
+	if (!f || failed || !dest || size <= 0)
+		return -1;
+
+	ZSTD_outBuffer out;
+	out.dst = dest;
+	out.size = size;
+	out.pos = 0;
+
+	while (out.pos < out.size) {
+		if (in_ix == in_length) {
+			in_length = (unsigned long) fread (input, 1, input_size, f);
+			in_ix = 0;
+			if (!in_length) {
+				//----------------------------------------
+				// A clean end only between frames.
+				//
+				if (ferror (f) || !frame_ended) {
+					printf ("Compressed data is truncated or unreadable.\n");
+					failed = true;
+				}
+				break;
+			}
+		}
+
+		ZSTD_inBuffer in;
+		in.src = input;
+		in.size = in_length;
+		in.pos = in_ix;
+		size_t result = ZSTD_decompressStream ((ZSTD_DStream*) stream, &out, &in);
+		in_ix = (unsigned long) in.pos;
+		if (ZSTD_isError (result)) {
+			printf ("Compressed data is corrupt: %s\n", ZSTD_getErrorName (result));
+			failed = true;
+			break;
+		}
+		frame_ended = !result;
+	}
+
+	total_out += (unsigned long) out.pos;
+	if (out.pos)
+		return (int) out.pos;
+	return failed ? -1 : 0;
+#else
+	return -1;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdReader::seek
+// Purpose:	Makes the next read start at an offset in the
+//		decompressed data.
+// Returns:	False if the offset cannot be reached.
+//---------------------------------------------------------------------------
+bool
+ZstdReader::seek (unsigned long offset)
+{
+	if (offset < total_out && !restart ())
+		return false;
+	if (offset == total_out)
+		return true;
+
+	unsigned char *scratch = (unsigned char*) malloc (INPUTFILE_BUFFERSIZE);
+	if (!scratch)
+		fatal ("Out of memory!");
+
+	while (total_out < offset) {
+		unsigned long left = offset - total_out;
+		int n = read (scratch, left < INPUTFILE_BUFFERSIZE ? (int) left : INPUTFILE_BUFFERSIZE);
+		if (n <= 0)
+			break;
+	}
+	free (scratch);
+	return total_out == offset;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::ZstdWriter
+//---------------------------------------------------------------------------
+ZstdWriter::ZstdWriter ()
+{
+	f = NULL;
+	stream = NULL;
+	output = NULL;
+	output_size = 0;
+	total_in = 0;
+	failed = false;
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::~ZstdWriter
+// Purpose:	Abandons the file if it was not closed.
+//---------------------------------------------------------------------------
+ZstdWriter::~ZstdWriter ()
+{
+#ifdef USE_ZSTD
+	if (stream)
+		ZSTD_freeCCtx ((ZSTD_CCtx*) stream);
+#endif
+	if (output) {
+		free (output);
+		total_allocated -= output_size;
+	}
+	if (f)
+		fclose (f);
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::open
+// Purpose:	Creates a zstd file. Compression is spread over the
+//		processors if libzstd was built to allow that.
+// Returns:	False if the file cannot be created.
+//---------------------------------------------------------------------------
+bool
+ZstdWriter::open (const char *path, int level)
+{
+	ASSERT_NONZERO (path,"path")
+	//----------
+
+#ifndef USE_ZSTD
+	printf ("This build cannot save zstd files.\n");
+	return false;
+#else
+	if (f)
+		return false;
+	f = fopen (path, "wb");
+	if (!f)
+		return false;
+
+	output_size = (unsigned long) ZSTD_CStreamOutSize ();
+	output = (unsigned char*) malloc (output_size);
+	stream = ZSTD_createCCtx ();
+	if (!output || !stream)
+		fatal ("Out of memory!");
+	total_allocated += output_size;
+
+	ZSTD_CCtx *cctx = (ZSTD_CCtx*) stream;
+	ZSTD_CCtx_setParameter (cctx, ZSTD_c_compressionLevel, level);
+	if (processor_count () > 1)
+		ZSTD_CCtx_setParameter (cctx, ZSTD_c_nbWorkers, processor_count ());
+	return true;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::compress
+// Purpose:	Compresses data into the frame and writes out what
+//		libzstd returns, draining it until the input is
+//		consumed, or at the end, until the frame is complete.
+//---------------------------------------------------------------------------
+void
+ZstdWriter::compress (const unsigned char *data, unsigned long size, bool end)
+{
+#ifdef USE_ZSTD
+	if (!f || failed)
+		return;
+
+	ZSTD_inBuffer in;
+	in.src = data;
+	in.size = size;
+	in.pos = 0;
+
+	bool finished;
+	do {
+		ZSTD_outBuffer out;
+		out.dst = output;
+		out.size = output_size;
+		out.pos = 0;
+		size_t remaining = ZSTD_compressStream2 ((ZSTD_CCtx*) stream, &out, &in,
+			end ? ZSTD_e_end : ZSTD_e_continue);
+		if (ZSTD_isError (remaining)) {
+			printf ("Unable to compress: %s\n", ZSTD_getErrorName (remaining));
+			failed = true;
+			break;
+		}
+		if (out.pos != fwrite (output, 1, out.pos, f))
+			failed = true;
+		finished = end ? !remaining : in.pos == in.size;
+	} while (!failed && !finished);
+
+	total_in += size;
+#endif
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::write
+// Purpose:	Adds data to the file.
+//---------------------------------------------------------------------------
+void
+ZstdWriter::write (const unsigned char *data, unsigned long size)
+{
+	if (size)
+		compress (data, size, false);
+}
+
+//---------------------------------------------------------------------------
+// Name:	ZstdWriter::close
+// Purpose:	Ends the frame and closes the file. As the size of
+//		the data was not known when the frame header was
+//		written, it follows the frame in a skippable frame,
+//		where ZstdReader::open looks for it.
+// Returns:	False if anything could not be written.
+//---------------------------------------------------------------------------
+bool
+ZstdWriter::close ()
+{
+	if (!f)
+		return false;
+
+	compress (NULL, 0, true);
+
+	unsigned char trailer [ZSTDFILE_TRAILERSIZE];
+	encode_u32 (trailer, ZSTDFILE_TRAILERMAGIC);
+	encode_u32 (trailer + 4, 8);
+	encode_u64 (trailer + 8, total_in);
+	if (!failed && ZSTDFILE_TRAILERSIZE != fwrite (trailer, 1, ZSTDFILE_TRAILERSIZE, f))
+		failed = true;
+
+	if (fclose (f))
+		failed = true;
+	f = NULL;
+	return !failed;
+}
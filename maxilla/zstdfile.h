@@ -0,0 +1,93 @@
+/*=============================================================================
+  Maxilla, an OpenGL-based 3D program for viewing dentistry-related VRML & STL.
+  Copyright (C) 2008-2013 by Zack T Smith and Ortho Cast Inc.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License version 2
+  as published by the Free Software Foundation.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+  The author may be reached at fbui@comcast.net.
+ *============================================================================*/
+
+#ifndef _ZSTDFILE_H
+#define _ZSTDFILE_H
+
+// Level used when saving; 3 is zstd's own default.
+#define ZSTDFILE_LEVEL (3)
+
+// The skippable frame that ends a saved file and holds the
+// size of its data, as a 64-bit little-endian number.
+#define ZSTDFILE_TRAILERMAGIC (0x184D2A5B)
+#define ZSTDFILE_TRAILERSIZE (16)
+
+/*===========================================================================
+ * Name:	ZstdReader
+ * Purpose:	Reads the decompressed data of a zstd file from the
+ *		start, like gzread() does for a gzip file. Seeking
+ *		forward decompresses and discards; seeking back
+ *		starts again from the beginning.
+ */
+class ZstdReader {
+public:
+	unsigned long data_size;	// From the frame header, else 0.
+
+	ZstdReader ();
+	~ZstdReader ();
+
+	bool open (const char *path);
+	int read (unsigned char *dest, int size);
+	bool seek (unsigned long offset);
+	unsigned long position () { return total_out; }
+
+private:
+	FILE *f;
+	void *stream;			// ZSTD_DStream.
+	unsigned char *input;
+	unsigned long input_size;
+	unsigned long in_length;	// Valid bytes in input.
+	unsigned long in_ix;		// Next byte to decompress.
+	unsigned long total_out;
+	bool frame_ended;
+	bool failed;
+
+	bool restart ();
+};
+
+/*===========================================================================
+ * Name:	ZstdWriter
+ * Purpose:	Writes data to a zstd file as a single frame, compressing
+ *		it as it arrives, like gzwrite() does for a gzip file.
+ */
+class ZstdWriter {
+public:
+	ZstdWriter ();
+	~ZstdWriter ();
+
+	bool open (const char *path, int level);
+	void write (const unsigned char *data, unsigned long size);
+	bool close ();
+
+private:
+	FILE *f;
+	void *stream;			// ZSTD_CCtx.
+	unsigned char *output;
+	unsigned long output_size;
+	unsigned long total_in;
+	bool failed;
+
+	void compress (const unsigned char *data, unsigned long size, bool end);
+};
+
+extern bool zstd_magic (const unsigned char *p, unsigned long n);
+extern bool zstd_path_magic (const char *path);
+
+#endif